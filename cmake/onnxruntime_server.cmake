@@ -111,8 +111,11 @@ endif()
 set(onnxruntime_server_lib_srcs
   "${ONNXRUNTIME_ROOT}/server/http/json_handling.cc"
   "${ONNXRUNTIME_ROOT}/server/http/predict_request_handler.cc"
+  "${ONNXRUNTIME_ROOT}/server/http/metrics_request_handler.cc"
   "${ONNXRUNTIME_ROOT}/server/http/util.cc"
   "${ONNXRUNTIME_ROOT}/server/environment.cc"
+  "${ONNXRUNTIME_ROOT}/server/batcher.cc"
+  "${ONNXRUNTIME_ROOT}/server/model_repository.cc"
   "${ONNXRUNTIME_ROOT}/server/executor.cc"
   "${ONNXRUNTIME_ROOT}/server/converter.cc"
   "${ONNXRUNTIME_ROOT}/server/util.cc"
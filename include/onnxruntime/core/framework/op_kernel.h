@@ -49,6 +49,16 @@ class OpKernel {
     ORT_NOT_IMPLEMENTED(__FUNCTION__, " is not implemented");
   }
 
+  // Override to transform a constant initializer into the layout the kernel computes with, e.g. to pack a weight
+  // for the GEMM routines. Called once for each constant initializer input when the session is initialized, before
+  // the first call to Compute.
+  // Set is_packed to true if the kernel keeps its own copy of the data and no longer reads the input from the
+  // OpKernelContext. The initializer is released if every kernel consuming it has packed it.
+  virtual Status PrePack(const Tensor& /*tensor*/, int /*input_idx*/, /*out*/ bool& is_packed) {
+    is_packed = false;
+    return Status::OK();
+  }
+
   const OrtMemoryInfo& Allocator(int id, OrtMemType mem_type) const {
     return op_kernel_info_.GetMemoryInfo(id, mem_type);
   }
@@ -22,6 +22,10 @@ struct OrtRunOptions {
   // be forced to terminate with an error status.
   bool terminate = false;
 
+  // Set to 'true' to return the memory the arenas of the session hold but don't use to the devices at the end
+  // of the Run, e.g. after an unusually large request. Later Run calls will need to allocate it again.
+  bool shrink_memory_arenas = false;
+
   OrtRunOptions() = default;
   ~OrtRunOptions() = default;
 
@@ -2,7 +2,10 @@
 // Licensed under the MIT License.
 
 #pragma once
+#include <atomic>
+#include <cstddef>
 #include <string>
+#include <thread>
 #include <vector>
 #include <functional>
 #include <memory>
@@ -25,6 +28,20 @@ namespace onnxruntime {
 
 namespace concurrency {
 
+/**
+ * Options applied to the threads created by a ThreadPool.
+ */
+struct ThreadOptions {
+  // Time in microseconds an idle thread keeps polling for new work before it blocks.
+  // Spinning avoids the wakeup latency of blocked threads for short, back-to-back parallel sections.
+  // Zero lets threads block as soon as they run out of work.
+  int spin_duration_us = 0;
+
+  // Logical processors each thread is restricted to; thread i uses affinities[i % affinities.size()].
+  // Empty leaves the threads unpinned.
+  std::vector<std::vector<size_t>> affinities;
+};
+
 /**
  * Generic class for instantiating thread pools.
  * Don't put any object of this type into a global variable in a Win32 DLL.
@@ -34,7 +51,16 @@ class ThreadPool {
   /*
   Initializes a thread pool given the current environment.
   */
-  ThreadPool(const std::string& name, int num_threads);
+  ThreadPool(const std::string& name, int num_threads, const ThreadOptions& thread_options = ThreadOptions());
+
+  /*
+  Initializes a view of a pool shared with other users. Work runs on the threads of shared_pool, but
+  parallel loops issued through this object use at most num_threads of them (in addition to the caller).
+  shared_pool must outlive this object.
+  */
+  ThreadPool(ThreadPool& shared_pool, int num_threads);
+
+  ~ThreadPool();
 
   /*
   Enqueue a unit of work.
@@ -46,13 +72,22 @@ class ThreadPool {
   */
   void ParallelFor(int32_t total, std::function<void(int32_t)> fn);
 
+  /*
+  Schedule work in the interval [0, total), split into a small number of contiguous blocks.
+  cost_per_unit is an estimate of the number of CPU cycles needed for a single iteration. It is used to
+  choose the number of blocks so that cheap loops run inline and expensive ones are spread over the pool.
+  fn is called with [first, last) sub-ranges rather than once per iteration.
+  */
+  void ParallelFor(std::ptrdiff_t total, double cost_per_unit,
+                   const std::function<void(std::ptrdiff_t first, std::ptrdiff_t last)>& fn);
+
   /*
   Schedule work in the interval [0, total), with calls split into (num_batches) batches.
   */
   void BatchParallelFor(int32_t total, std::function<void(int32_t)> fn, int32_t num_batches = 0);
 
   /*
-  Schedule work in the interval [first, last].
+  Schedule work in the interval [first, last), with fn called on contiguous sub-ranges.
   */
   void ParallelForRange(int64_t first, int64_t last, std::function<void(int64_t, int64_t)> fn);
 
@@ -96,14 +131,79 @@ class ThreadPool {
     }
   }
 
+  /**
+  Tries to call the given function in parallel over [0, total), split into blocks based on cost_per_unit.
+  Without a thread pool the function is called once for the whole range.
+  **/
+  template <typename F>
+  inline static void TryParallelFor(concurrency::ThreadPool* tp, std::ptrdiff_t total, double cost_per_unit,
+                                    F&& fn) {
+    if (tp != nullptr) {
+      tp->ParallelFor(total, cost_per_unit, std::forward<F>(fn));
+    } else if (total > 0) {
+      fn(0, total);
+    }
+  }
+
   int NumThreads() const;
 
   int CurrentThreadId() const;
 
-  Eigen::ThreadPool& GetHandler() { return impl_; }
+  Eigen::ThreadPoolInterface& GetHandler() { return *impl_; }
 
  private:
-  Eigen::ThreadPool impl_;
+  // State shared between the pool and its threads for spin-then-block waiting.
+  struct SpinState {
+    // Number of scheduled tasks that have not started yet.
+    std::atomic<int> pending_tasks{0};
+    std::atomic<bool> shutting_down{false};
+  };
+
+  // Eigen thread environment that applies ThreadOptions to the threads of the pool.
+  class Environment {
+   public:
+    struct Task {
+      std::function<void()> f;
+    };
+
+    class EnvThread {
+     public:
+      explicit EnvThread(std::function<void()> f) : thread_(std::move(f)) {}
+      ~EnvThread() { thread_.join(); }
+      void OnCancel() {}
+
+     private:
+      std::thread thread_;
+    };
+
+    Environment(const ThreadOptions& thread_options, SpinState& spin_state)
+        : thread_options_(&thread_options), spin_state_(&spin_state) {}
+
+    EnvThread* CreateThread(std::function<void()> f);
+    Task CreateTask(std::function<void()> f);
+    void ExecuteTask(const Task& t);
+
+   private:
+    // Keeps the calling pool thread busy until new work is scheduled or the spin duration expires.
+    void SpinForWork() const;
+
+    const ThreadOptions* thread_options_;
+    SpinState* spin_state_;
+    size_t next_thread_index_ = 0;
+  };
+
+  // Returns the number of blocks to split [0, total) into given the estimated cost of each iteration.
+  std::ptrdiff_t CalculateNumBlocks(std::ptrdiff_t total, double cost_per_unit) const;
+
+  // Calls fn for each block in [0, num_blocks) using the calling thread and the pool threads.
+  void RunInParallel(std::ptrdiff_t num_blocks, const std::function<void(std::ptrdiff_t block)>& fn);
+
+  const ThreadOptions thread_options_;
+  SpinState spin_state_;
+  // Set when this pool owns its threads; empty for a view of a shared pool.
+  std::unique_ptr<Eigen::ThreadPoolTempl<Environment>> owned_impl_;
+  Eigen::ThreadPoolInterface* impl_;
+  int num_threads_;
 };
 
 }  // namespace concurrency
@@ -7,8 +7,23 @@
 #include <memory>
 #include "core/common/common.h"
 #include "core/common/status.h"
+#include "core/platform/threadpool.h"
 
 namespace onnxruntime {
+/**
+   Configuration of the thread pools an Environment shares across its sessions.
+*/
+struct ThreadingOptions {
+  // number of threads in the shared intra-op pool. 0 lets onnxruntime choose.
+  int intra_op_num_threads = 0;
+
+  // number of threads in the shared inter-op pool. 0 lets onnxruntime choose.
+  int inter_op_num_threads = 0;
+
+  // options for the threads of the shared intra-op pool.
+  concurrency::ThreadOptions intra_op_thread_options;
+};
+
 /**
    Provides the runtime environment for onnxruntime.
    Create one instance for the duration of execution.
@@ -20,6 +35,12 @@ class Environment {
   */
   static Status Create(std::unique_ptr<Environment>& environment);
 
+  /**
+     Create and initialize the runtime environment with thread pools that are shared by all sessions
+     that don't use per-session threads. See SessionOptions::use_per_session_threads.
+  */
+  static Status Create(std::unique_ptr<Environment>& environment, const ThreadingOptions& tp_options);
+
   /**
      This function will call ::google::protobuf::ShutdownProtobufLibrary
   */
@@ -30,12 +51,37 @@ class Environment {
   */
   static bool IsInitialized() { return is_initialized_; }
 
+  /**
+     Returns whether the runtime environment was created with thread pools shared by its sessions.
+  */
+  static bool HasGlobalThreadPools() { return has_global_thread_pools_; }
+
+  /**
+     Returns the shared intra-op thread pool. nullptr if the environment has no global thread pools,
+     or if the pool would consist of the calling thread only.
+  */
+  static concurrency::ThreadPool* GetIntraOpThreadPool() { return global_intra_op_thread_pool_; }
+
+  /**
+     Returns the shared inter-op thread pool. nullptr if the environment has no global thread pools,
+     or if the pool would consist of the calling thread only.
+  */
+  static concurrency::ThreadPool* GetInterOpThreadPool() { return global_inter_op_thread_pool_; }
+
  private:
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(Environment);
 
   Environment() = default;
   Status Initialize();
+  void CreateGlobalThreadPools(const ThreadingOptions& tp_options);
+
+  std::unique_ptr<concurrency::ThreadPool> intra_op_thread_pool_;
+  std::unique_ptr<concurrency::ThreadPool> inter_op_thread_pool_;
+  bool created_global_thread_pools_ = false;
 
   static std::atomic<bool> is_initialized_;
+  static std::atomic<bool> has_global_thread_pools_;
+  static concurrency::ThreadPool* global_intra_op_thread_pool_;
+  static concurrency::ThreadPool* global_inter_op_thread_pool_;
 };
 }  // namespace onnxruntime
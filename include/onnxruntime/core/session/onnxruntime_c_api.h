@@ -7,7 +7,7 @@
 #include <string.h>
 
 // This value is used in structures passed to ORT so that a newer version of ORT will still work with
-#define ORT_API_VERSION 1
+#define ORT_API_VERSION 2
 
 #ifdef __cplusplus
 extern "C" {
@@ -156,6 +156,9 @@ ORT_RUNTIME_CLASS(TypeInfo);
 ORT_RUNTIME_CLASS(TensorTypeAndShapeInfo);
 ORT_RUNTIME_CLASS(SessionOptions);
 ORT_RUNTIME_CLASS(CustomOpDomain);
+ORT_RUNTIME_CLASS(ThreadingOptions);
+ORT_RUNTIME_CLASS(IoBinding);
+ORT_RUNTIME_CLASS(PreparedRun);
 
 // When passing in an allocator to any ORT function, be sure that the allocator object
 // is not destroyed until the last allocated object using it is freed.
@@ -170,6 +173,12 @@ typedef void(ORT_API_CALL* OrtLoggingFunction)(
     void* param, OrtLoggingLevel severity, const char* category, const char* logid, const char* code_location,
     const char* message);
 
+// Invoked on a thread of the session when a run queued by RunAsync completes. outputs is the output array passed to
+// RunAsync. status is nullptr if the run succeeded; otherwise the callback owns it and must release it with
+// ReleaseStatus.
+typedef void(ORT_API_CALL* OrtRunAsyncCallbackFn)(
+    void* user_data, OrtValue** outputs, size_t num_outputs, OrtStatus* status);
+
 // Set Graph optimization level.
 // Refer https://github.com/microsoft/onnxruntime/blob/master/docs/ONNX_Runtime_Graph_Optimizations.md
 // for in-depth undersrtanding of Graph Optimizations in ORT
@@ -185,6 +194,12 @@ typedef enum ExecutionMode {
   ORT_PARALLEL = 1,
 } ExecutionMode;
 
+// How a memory arena grows when it needs more memory
+typedef enum OrtArenaExtendStrategy {
+  ORT_ARENA_EXTEND_NEXT_POWER_OF_TWO = 0,  // each new region doubles the size of the previous one
+  ORT_ARENA_EXTEND_SAME_AS_REQUESTED = 1,  // each new region is the size of the request that triggered it
+} OrtArenaExtendStrategy;
+
 struct OrtKernelInfo;
 typedef struct OrtKernelInfo OrtKernelInfo;
 struct OrtKernelContext;
@@ -645,6 +660,176 @@ struct OrtApi {
   ORT_CLASS_RELEASE(TensorTypeAndShapeInfo);
   ORT_CLASS_RELEASE(SessionOptions);
   ORT_CLASS_RELEASE(CustomOpDomain);
+
+  // End of version 1 - DO NOT MODIFY ABOVE. Binaries built against an older version depend on the field order,
+  // so new functions are only ever appended.
+
+  // Version 2 - In development, feel free to add/remove/rearrange here
+
+  /**
+   * Sets the time in microseconds the intra-op threads keep spinning for new work before they block.
+   * Spinning lowers the latency of graphs with many short ops at the cost of CPU usage.
+   * A value of 0 (the default) disables spinning.
+   */
+  OrtStatus*(ORT_API_CALL* SetIntraOpSpinDuration)(_Inout_ OrtSessionOptions* options, int spin_duration_us)NO_EXCEPTION;
+
+  /**
+   * Pins the intra-op threads to the given logical processors. Thread i is pinned to
+   * logical_processors[i % num_logical_processors]. Pass num_logical_processors = 0 to leave them unpinned.
+   */
+  OrtStatus*(ORT_API_CALL* SetIntraOpThreadAffinity)(_Inout_ OrtSessionOptions* options,
+                                                     _In_ const size_t* logical_processors,
+                                                     size_t num_logical_processors)NO_EXCEPTION;
+
+  /**
+   * Restricts the intra-op threads to the logical processors of a NUMA node.
+   * Ignored if a thread affinity is set. A value of -1 (the default) leaves them unrestricted.
+   */
+  OrtStatus*(ORT_API_CALL* SetIntraOpNumaNode)(_Inout_ OrtSessionOptions* options, int numa_node)NO_EXCEPTION;
+
+  /**
+   * Creates an environment with an intra-op and an inter-op thread pool that are shared by all sessions
+   * created with per-session threads disabled (see DisablePerSessionThreads).
+   */
+  OrtStatus*(ORT_API_CALL* CreateEnvWithGlobalThreadPools)(OrtLoggingLevel default_logging_level,
+                                                           _In_ const char* logid,
+                                                           _In_ const OrtThreadingOptions* tp_options,
+                                                           _Outptr_ OrtEnv** out)NO_EXCEPTION;
+
+  /**
+   * Makes the session use the thread pools of the environment instead of creating its own.
+   * The intra and inter op thread counts of the session options then limit how many of the shared threads
+   * a single parallel loop of the session may use.
+   */
+  OrtStatus*(ORT_API_CALL* DisablePerSessionThreads)(_Inout_ OrtSessionOptions* options)NO_EXCEPTION;
+
+  /**
+   * Creates the options for the global thread pools of an environment.
+   * The returned object should be freed by ReleaseThreadingOptions after use.
+   */
+  OrtStatus*(ORT_API_CALL* CreateThreadingOptions)(_Outptr_ OrtThreadingOptions** out)NO_EXCEPTION;
+
+  // Sets the number of threads of the global intra-op thread pool. A value of 0 means ORT will pick a default.
+  // Negative values are rejected with ORT_INVALID_ARGUMENT.
+  OrtStatus*(ORT_API_CALL* SetGlobalIntraOpNumThreads)(_Inout_ OrtThreadingOptions* tp_options,
+                                                       int intra_op_num_threads)NO_EXCEPTION;
+
+  // Sets the number of threads of the global inter-op thread pool. A value of 0 means ORT will pick a default.
+  // Negative values are rejected with ORT_INVALID_ARGUMENT.
+  OrtStatus*(ORT_API_CALL* SetGlobalInterOpNumThreads)(_Inout_ OrtThreadingOptions* tp_options,
+                                                       int inter_op_num_threads)NO_EXCEPTION;
+
+  ORT_CLASS_RELEASE(ThreadingOptions);
+
+  /**
+   * Keeps up to max_bytes_per_thread bytes of recently freed blocks in a per-thread cache in front of the CPU
+   * memory arena. Reduces contention on the arena when Run is called from multiple threads.
+   * A value of 0 (the default) disables the cache. Has no effect if the CPU memory arena is disabled.
+   */
+  OrtStatus*(ORT_API_CALL* SetCpuMemArenaThreadCacheSize)(_Inout_ OrtSessionOptions* options,
+                                                          size_t max_bytes_per_thread)NO_EXCEPTION;
+
+  /**
+   * Configures the CPU memory arena.
+   * \param max_mem maximum number of bytes the arena may allocate. 0 means no limit.
+   * \param extend_strategy how the arena grows when it needs more memory.
+   * \param initial_chunk_size_bytes size of the first block of memory the arena allocates. Must be positive.
+   */
+  OrtStatus*(ORT_API_CALL* SetCpuMemArenaConfig)(_Inout_ OrtSessionOptions* options, size_t max_mem,
+                                                 OrtArenaExtendStrategy extend_strategy,
+                                                 size_t initial_chunk_size_bytes)NO_EXCEPTION;
+
+  /**
+   * If value is non-zero, Run calls using these options return the memory the arenas of the session hold but
+   * don't use at the end of the Run.
+   */
+  OrtStatus*(ORT_API_CALL* RunOptionsSetShrinkMemoryArenas)(_Inout_ OrtRunOptions* options, int value)NO_EXCEPTION;
+
+  /**
+   * Returns the memory the arenas of the session hold but don't use. Can be called while the session is running.
+   */
+  OrtStatus*(ORT_API_CALL* SessionShrinkMemoryArenas)(_Inout_ OrtSession* sess)NO_EXCEPTION;
+
+  /**
+   * MatMul and Gemm weights with at least this fraction of zero elements are stored in a sparse format and
+   * multiplied with a sparse kernel. Requires ORT_ENABLE_EXTENDED or a higher graph optimization level.
+   * \param threshold in [0, 1]. 0 (the default) disables the conversion.
+   */
+  OrtStatus*(ORT_API_CALL* SetSparseWeightThreshold)(_Inout_ OrtSessionOptions* options, float threshold)NO_EXCEPTION;
+
+  /**
+   * Sessions created with these options save their graph to graph_cache_filepath after the graph optimizations
+   * and the partitioning, and load it from there when the file was created for the same model and options, which
+   * skips the optimizations. The file is replaced when the model or the options change.
+   * Only the graph is cached: the execution plan, the kernels and their pre-packed weights are created again.
+   */
+  OrtStatus*(ORT_API_CALL* SetGraphCacheFilePath)(_Inout_ OrtSessionOptions* options,
+                                                  _In_ const ORTCHAR_T* graph_cache_filepath)NO_EXCEPTION;
+
+  /**
+   * Queues a Run on a thread of the session and returns without waiting for it to complete. callback is invoked
+   * with user_data when the run completes. Up to the inter op number of threads of the session execute at once,
+   * on the global inter op thread pool if per session threads are disabled; the rest wait in an unbounded queue.
+   * The input values may be released once RunAsync returns. run_options and the output array must stay valid until
+   * the callback is invoked; entries of output that are nullptr receive newly allocated values as in Run.
+   * Releasing the session waits for the runs it has queued.
+   */
+  OrtStatus*(ORT_API_CALL* RunAsync)(_Inout_ OrtSession* sess, _In_opt_ const OrtRunOptions* run_options,
+                                     _In_ const char* const* input_names, _In_ const OrtValue* const* input,
+                                     size_t input_len, _In_ const char* const* output_names, size_t output_names_len,
+                                     _Inout_ OrtValue** output, _In_ OrtRunAsyncCallbackFn callback,
+                                     _In_opt_ void* user_data)NO_EXCEPTION;
+
+  /**
+   * An IoBinding holds the inputs and outputs of the runs of a session by name, so that repeated runs reuse the
+   * bound values rather than passing the names and allocating the outputs each time.
+   * The binding must be released before the session.
+   */
+  OrtStatus*(ORT_API_CALL* CreateIoBinding)(_Inout_ OrtSession* sess, _Outptr_ OrtIoBinding** out)NO_EXCEPTION;
+  ORT_CLASS_RELEASE(IoBinding);
+
+  // Binds an input to a value, which is copied to the device the session reads the input from if needed.
+  OrtStatus*(ORT_API_CALL* BindInput)(_Inout_ OrtIoBinding* binding_ptr, _In_ const char* name,
+                                      _In_ const OrtValue* val_ptr)NO_EXCEPTION;
+
+  // Binds an output to a pre-allocated value, which each run writes in place. The shape must match the output.
+  OrtStatus*(ORT_API_CALL* BindOutput)(_Inout_ OrtIoBinding* binding_ptr, _In_ const char* name,
+                                       _In_ const OrtValue* val_ptr)NO_EXCEPTION;
+
+  // Binds an output that each run allocates on the device described by mem_info_ptr.
+  OrtStatus*(ORT_API_CALL* BindOutputToDevice)(_Inout_ OrtIoBinding* binding_ptr, _In_ const char* name,
+                                               _In_ const OrtMemoryInfo* mem_info_ptr)NO_EXCEPTION;
+
+  /**
+   * Returns the values of the bound outputs in the order they were bound. *output is an array of output_count
+   * values allocated with allocator. The caller releases each value and frees the array with allocator.
+   */
+  OrtStatus*(ORT_API_CALL* GetBoundOutputValues)(_In_ const OrtIoBinding* binding_ptr, _Inout_ OrtAllocator* allocator,
+                                                 _Outptr_ OrtValue*** output,
+                                                 _Out_ size_t* output_count)NO_EXCEPTION;
+
+  // Removes all the bound inputs or outputs
+  void(ORT_API_CALL* ClearBoundInputs)(_Inout_ OrtIoBinding* binding_ptr)NO_EXCEPTION ORT_ALL_ARGS_NONNULL;
+  void(ORT_API_CALL* ClearBoundOutputs)(_Inout_ OrtIoBinding* binding_ptr)NO_EXCEPTION ORT_ALL_ARGS_NONNULL;
+
+  // Runs the session with the bound inputs and outputs. The bound output values hold the results.
+  OrtStatus*(ORT_API_CALL* RunWithBinding)(_Inout_ OrtSession* sess, _In_opt_ const OrtRunOptions* run_options,
+                                           _Inout_ OrtIoBinding* binding_ptr)NO_EXCEPTION;
+
+  /**
+   * A PreparedRun holds the input and output names of a Run resolved once by the session, so that repeated runs
+   * with the same names skip the lookups. It may be used by concurrent runs and must be released before the session.
+   */
+  OrtStatus*(ORT_API_CALL* CreatePreparedRun)(_Inout_ OrtSession* sess, _In_ const char* const* input_names,
+                                              size_t input_len, _In_ const char* const* output_names,
+                                              size_t output_names_len, _Outptr_ OrtPreparedRun** out)NO_EXCEPTION;
+
+  ORT_CLASS_RELEASE(PreparedRun);
+
+  // Same as Run, with the inputs and outputs in the order of the names of the prepared run.
+  OrtStatus*(ORT_API_CALL* RunPrepared)(_Inout_ OrtSession* sess, _In_opt_ const OrtRunOptions* run_options,
+                                        _In_ const OrtPreparedRun* prepared_run, _In_ const OrtValue* const* input,
+                                        size_t input_len, _Inout_ OrtValue** output, size_t output_len)NO_EXCEPTION;
 };
 
 /*
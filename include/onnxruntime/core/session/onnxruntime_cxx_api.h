@@ -71,6 +71,9 @@ ORT_DEFINE_RELEASE(SessionOptions);
 ORT_DEFINE_RELEASE(TensorTypeAndShapeInfo);
 ORT_DEFINE_RELEASE(TypeInfo);
 ORT_DEFINE_RELEASE(Value);
+ORT_DEFINE_RELEASE(ThreadingOptions);
+ORT_DEFINE_RELEASE(IoBinding);
+ORT_DEFINE_RELEASE(PreparedRun);
 
 // This is used internally by the C++ API. This is the common base class used by the wrapper objects.
 template <typename T>
@@ -118,11 +121,24 @@ struct MemoryInfo;
 struct Env;
 struct TypeInfo;
 struct Value;
+struct IoBinding;
+struct PreparedRun;
+
+struct ThreadingOptions : Base<OrtThreadingOptions> {
+  explicit ThreadingOptions(std::nullptr_t) {}
+  ThreadingOptions();
+
+  ThreadingOptions& SetGlobalIntraOpNumThreads(int intra_op_num_threads);
+  ThreadingOptions& SetGlobalInterOpNumThreads(int inter_op_num_threads);
+};
 
 struct Env : Base<OrtEnv> {
   Env(std::nullptr_t) {}
   Env(OrtLoggingLevel default_logging_level = ORT_LOGGING_LEVEL_WARNING, _In_ const char* logid = "");
   Env(OrtLoggingLevel default_logging_level, const char* logid, OrtLoggingFunction logging_function, void* logger_param);
+  // creates an environment with thread pools shared by sessions that disable per-session threads
+  Env(const ThreadingOptions& tp_options, OrtLoggingLevel default_logging_level = ORT_LOGGING_LEVEL_WARNING,
+      _In_ const char* logid = "");
   explicit Env(OrtEnv* p) : Base<OrtEnv>{p} {}
 
   Env& EnableTelemetryEvents();
@@ -155,6 +171,9 @@ struct RunOptions : Base<OrtRunOptions> {
   RunOptions& SetTerminate();
   // unset the terminate flag so this RunOptions instance can be used in a new Session::Run call
   RunOptions& UnsetTerminate();
+
+  // release the unused memory of the session's arenas at the end of the Run calls using this RunOptions instance
+  RunOptions& SetShrinkMemoryArenas(bool value);
 };
 
 struct SessionOptions : Base<OrtSessionOptions> {
@@ -166,12 +185,21 @@ struct SessionOptions : Base<OrtSessionOptions> {
 
   SessionOptions& SetIntraOpNumThreads(int intra_op_num_threads);
   SessionOptions& SetInterOpNumThreads(int inter_op_num_threads);
+  SessionOptions& SetIntraOpSpinDuration(int spin_duration_us);
+  SessionOptions& SetIntraOpThreadAffinity(const std::vector<size_t>& logical_processors);
+  SessionOptions& SetIntraOpNumaNode(int numa_node);
+  SessionOptions& DisablePerSessionThreads();
   SessionOptions& SetGraphOptimizationLevel(GraphOptimizationLevel graph_optimization_level);
+  SessionOptions& SetSparseWeightThreshold(float threshold);
 
   SessionOptions& EnableCpuMemArena();
   SessionOptions& DisableCpuMemArena();
+  SessionOptions& SetCpuMemArenaThreadCacheSize(size_t max_bytes_per_thread);
+  SessionOptions& SetCpuMemArenaConfig(size_t max_mem, OrtArenaExtendStrategy extend_strategy,
+                                       size_t initial_chunk_size_bytes);
 
   SessionOptions& SetOptimizedModelFilePath(const ORTCHAR_T* optimized_model_file);
+  SessionOptions& SetGraphCacheFilePath(const ORTCHAR_T* graph_cache_file);
 
   SessionOptions& EnableProfiling(const ORTCHAR_T* profile_file_prefix);
   SessionOptions& DisableProfiling();
@@ -197,6 +225,16 @@ struct Session : Base<OrtSession> {
   // Run for when there is a list of prealloated outputs
   void Run(const RunOptions& run_options, const char* const* input_names, const Value* input_values, size_t input_count,
            const char* const* output_names, Value* output_values, size_t output_count);
+  // Run that returns once the run is queued. callback is invoked with user_data on a thread of the session when the
+  // run completes; run_options and output_values must stay valid until then. Null output values receive the outputs.
+  void RunAsync(const RunOptions& run_options, const char* const* input_names, const Value* input_values, size_t input_count,
+                const char* const* output_names, Value* output_values, size_t output_count,
+                OrtRunAsyncCallbackFn callback, void* user_data);
+  // Run with the inputs and outputs bound to io_binding
+  void Run(const RunOptions& run_options, IoBinding& io_binding);
+  // Run with the input and output names resolved by prepared_run. Null output values receive the outputs.
+  void Run(const RunOptions& run_options, const PreparedRun& prepared_run, const Value* input_values, size_t input_count,
+           Value* output_values, size_t output_count);
 
   size_t GetInputCount() const;
   size_t GetOutputCount() const;
@@ -209,6 +247,28 @@ struct Session : Base<OrtSession> {
   TypeInfo GetInputTypeInfo(size_t index) const;
   TypeInfo GetOutputTypeInfo(size_t index) const;
   TypeInfo GetOverridableInitializerTypeInfo(size_t index) const;
+
+  // release the memory the arenas of the session hold but don't use
+  void ShrinkMemoryArenas();
+};
+
+struct IoBinding : Base<OrtIoBinding> {
+  explicit IoBinding(std::nullptr_t) {}
+  explicit IoBinding(Session& session);
+
+  void BindInput(const char* name, const Value& value);
+  void BindOutput(const char* name, const Value& value);
+  void BindOutput(const char* name, const MemoryInfo& memory_info);
+  // the values of the bound outputs, in the order they were bound
+  std::vector<Value> GetOutputValues() const;
+  void ClearBoundInputs();
+  void ClearBoundOutputs();
+};
+
+struct PreparedRun : Base<OrtPreparedRun> {
+  explicit PreparedRun(std::nullptr_t) {}
+  PreparedRun(Session& session, const char* const* input_names, size_t input_count,
+              const char* const* output_names, size_t output_count);
 };
 
 struct TensorTypeAndShapeInfo : Base<OrtTensorTypeAndShapeInfo> {
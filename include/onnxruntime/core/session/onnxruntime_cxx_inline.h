@@ -84,6 +84,24 @@ inline Env::Env(OrtLoggingLevel default_warning_level, const char* logid, OrtLog
   ThrowOnError(Global<void>::api_.CreateEnvWithCustomLogger(logging_function, logger_param, default_warning_level, logid, &p_));
 }
 
+inline Env::Env(const ThreadingOptions& tp_options, OrtLoggingLevel default_logging_level, _In_ const char* logid) {
+  ThrowOnError(Global<void>::api_.CreateEnvWithGlobalThreadPools(default_logging_level, logid, tp_options, &p_));
+}
+
+inline ThreadingOptions::ThreadingOptions() {
+  ThrowOnError(Global<void>::api_.CreateThreadingOptions(&p_));
+}
+
+inline ThreadingOptions& ThreadingOptions::SetGlobalIntraOpNumThreads(int intra_op_num_threads) {
+  ThrowOnError(Global<void>::api_.SetGlobalIntraOpNumThreads(p_, intra_op_num_threads));
+  return *this;
+}
+
+inline ThreadingOptions& ThreadingOptions::SetGlobalInterOpNumThreads(int inter_op_num_threads) {
+  ThrowOnError(Global<void>::api_.SetGlobalInterOpNumThreads(p_, inter_op_num_threads));
+  return *this;
+}
+
 inline Env& Env::EnableTelemetryEvents() {
   ThrowOnError(Global<void>::api_.EnableTelemetryEvents(p_));
   return *this;
@@ -143,6 +161,11 @@ inline RunOptions& RunOptions::UnsetTerminate() {
   return *this;
 }
 
+inline RunOptions& RunOptions::SetShrinkMemoryArenas(bool value) {
+  ThrowOnError(Global<void>::api_.RunOptionsSetShrinkMemoryArenas(p_, value ? 1 : 0));
+  return *this;
+}
+
 inline SessionOptions::SessionOptions() {
   ThrowOnError(Global<void>::api_.CreateSessionOptions(&p_));
 }
@@ -163,16 +186,46 @@ inline SessionOptions& SessionOptions::SetInterOpNumThreads(int inter_op_num_thr
   return *this;
 }
 
+inline SessionOptions& SessionOptions::SetIntraOpSpinDuration(int spin_duration_us) {
+  ThrowOnError(Global<void>::api_.SetIntraOpSpinDuration(p_, spin_duration_us));
+  return *this;
+}
+
+inline SessionOptions& SessionOptions::SetIntraOpThreadAffinity(const std::vector<size_t>& logical_processors) {
+  ThrowOnError(Global<void>::api_.SetIntraOpThreadAffinity(p_, logical_processors.data(), logical_processors.size()));
+  return *this;
+}
+
+inline SessionOptions& SessionOptions::SetIntraOpNumaNode(int numa_node) {
+  ThrowOnError(Global<void>::api_.SetIntraOpNumaNode(p_, numa_node));
+  return *this;
+}
+
+inline SessionOptions& SessionOptions::DisablePerSessionThreads() {
+  ThrowOnError(Global<void>::api_.DisablePerSessionThreads(p_));
+  return *this;
+}
+
 inline SessionOptions& SessionOptions::SetGraphOptimizationLevel(GraphOptimizationLevel graph_optimization_level) {
   ThrowOnError(Global<void>::api_.SetSessionGraphOptimizationLevel(p_, graph_optimization_level));
   return *this;
 }
 
+inline SessionOptions& SessionOptions::SetSparseWeightThreshold(float threshold) {
+  ThrowOnError(Global<void>::api_.SetSparseWeightThreshold(p_, threshold));
+  return *this;
+}
+
 inline SessionOptions& SessionOptions::SetOptimizedModelFilePath(const ORTCHAR_T* optimized_model_filepath) {
   ThrowOnError(Global<void>::api_.SetOptimizedModelFilePath(p_, optimized_model_filepath));
   return *this;
 }
 
+inline SessionOptions& SessionOptions::SetGraphCacheFilePath(const ORTCHAR_T* graph_cache_filepath) {
+  ThrowOnError(Global<void>::api_.SetGraphCacheFilePath(p_, graph_cache_filepath));
+  return *this;
+}
+
 inline SessionOptions& SessionOptions::EnableProfiling(const ORTCHAR_T* profile_file_prefix) {
   ThrowOnError(Global<void>::api_.EnableProfiling(p_, profile_file_prefix));
   return *this;
@@ -203,6 +256,17 @@ inline SessionOptions& SessionOptions::DisableCpuMemArena() {
   return *this;
 }
 
+inline SessionOptions& SessionOptions::SetCpuMemArenaThreadCacheSize(size_t max_bytes_per_thread) {
+  ThrowOnError(Global<void>::api_.SetCpuMemArenaThreadCacheSize(p_, max_bytes_per_thread));
+  return *this;
+}
+
+inline SessionOptions& SessionOptions::SetCpuMemArenaConfig(size_t max_mem, OrtArenaExtendStrategy extend_strategy,
+                                                            size_t initial_chunk_size_bytes) {
+  ThrowOnError(Global<void>::api_.SetCpuMemArenaConfig(p_, max_mem, extend_strategy, initial_chunk_size_bytes));
+  return *this;
+}
+
 inline SessionOptions& SessionOptions::SetExecutionMode(ExecutionMode execution_mode) {
   ThrowOnError(Global<void>::api_.SetSessionExecutionMode(p_, execution_mode));
   return *this;
@@ -242,6 +306,26 @@ inline void Session::Run(const RunOptions& run_options, const char* const* input
   ThrowOnError(Global<void>::api_.Run(p_, run_options, input_names, ort_input_values, input_count, output_names, output_count, ort_output_values));
 }
 
+inline void Session::RunAsync(const RunOptions& run_options, const char* const* input_names, const Value* input_values, size_t input_count,
+                              const char* const* output_names, Value* output_values, size_t output_count,
+                              OrtRunAsyncCallbackFn callback, void* user_data) {
+  auto ort_input_values = reinterpret_cast<const OrtValue**>(const_cast<Value*>(input_values));
+  auto ort_output_values = reinterpret_cast<OrtValue**>(output_values);
+  ThrowOnError(Global<void>::api_.RunAsync(p_, run_options, input_names, ort_input_values, input_count, output_names, output_count, ort_output_values,
+                                           callback, user_data));
+}
+
+inline void Session::Run(const RunOptions& run_options, IoBinding& io_binding) {
+  ThrowOnError(Global<void>::api_.RunWithBinding(p_, run_options, io_binding));
+}
+
+inline void Session::Run(const RunOptions& run_options, const PreparedRun& prepared_run, const Value* input_values, size_t input_count,
+                         Value* output_values, size_t output_count) {
+  auto ort_input_values = reinterpret_cast<const OrtValue**>(const_cast<Value*>(input_values));
+  auto ort_output_values = reinterpret_cast<OrtValue**>(output_values);
+  ThrowOnError(Global<void>::api_.RunPrepared(p_, run_options, prepared_run, ort_input_values, input_count, ort_output_values, output_count));
+}
+
 inline size_t Session::GetInputCount() const {
   size_t out;
   ThrowOnError(Global<void>::api_.SessionGetInputCount(p_, &out));
@@ -296,6 +380,56 @@ inline TypeInfo Session::GetOverridableInitializerTypeInfo(size_t index) const {
   return TypeInfo{out};
 }
 
+inline void Session::ShrinkMemoryArenas() {
+  ThrowOnError(Global<void>::api_.SessionShrinkMemoryArenas(p_));
+}
+
+inline IoBinding::IoBinding(Session& session) {
+  ThrowOnError(Global<void>::api_.CreateIoBinding(session, &p_));
+}
+
+inline void IoBinding::BindInput(const char* name, const Value& value) {
+  ThrowOnError(Global<void>::api_.BindInput(p_, name, value));
+}
+
+inline void IoBinding::BindOutput(const char* name, const Value& value) {
+  ThrowOnError(Global<void>::api_.BindOutput(p_, name, value));
+}
+
+inline void IoBinding::BindOutput(const char* name, const MemoryInfo& memory_info) {
+  ThrowOnError(Global<void>::api_.BindOutputToDevice(p_, name, memory_info));
+}
+
+inline std::vector<Value> IoBinding::GetOutputValues() const {
+  AllocatorWithDefaultOptions allocator;
+  OrtValue** output_values;
+  size_t output_count;
+  ThrowOnError(Global<void>::api_.GetBoundOutputValues(p_, allocator, &output_values, &output_count));
+
+  std::vector<Value> result;
+  result.reserve(output_count);
+  for (size_t i = 0; i < output_count; i++) {
+    result.emplace_back(output_values[i]);
+  }
+  if (output_values != nullptr) {
+    allocator.Free(output_values);
+  }
+  return result;
+}
+
+inline void IoBinding::ClearBoundInputs() {
+  Global<void>::api_.ClearBoundInputs(p_);
+}
+
+inline void IoBinding::ClearBoundOutputs() {
+  Global<void>::api_.ClearBoundOutputs(p_);
+}
+
+inline PreparedRun::PreparedRun(Session& session, const char* const* input_names, size_t input_count,
+                                const char* const* output_names, size_t output_count) {
+  ThrowOnError(Global<void>::api_.CreatePreparedRun(session, input_names, input_count, output_names, output_count, &p_));
+}
+
 inline ONNXTensorElementDataType TensorTypeAndShapeInfo::GetElementType() const {
   ONNXTensorElementDataType out;
   ThrowOnError(Global<void>::api_.GetTensorElementType(p_, &out));
@@ -8,9 +8,11 @@
 #include "core/util/math.h"
 #include "core/util/math_cpuonly.h"
 #include "core/providers/cpu/math/gemm_helper.h"
-#include "core/providers/cpu/math/softmax.h"
 #include "core/providers/cpu/tensor/transpose.h"
 
+#include <algorithm>
+#include <limits>
+
 namespace onnxruntime {
 namespace contrib {
 // These ops are internal-only, so register outside of onnx
@@ -176,116 +178,133 @@ Status Attention<T>::Compute(OpKernelContext* context) const {
     });
   }
 
-  // STEP.2: scratch(B, N, S, S) = 1/sqrt(H) x Q(B, N, S, H) x K'(B, N, S, H -> B, N, H, S) + 1 x mask_index(B -> B, 1, 1, 1)
-  auto scratch_data = allocator->Alloc(batch_size * num_heads_ * sequence_length * sequence_length * element_size);
-  BufferUniquePtr scratch_buffer(scratch_data, BufferDeleter(allocator));
-
+  // STEP.2: out(B, S, N, H) = Softmax(1/sqrt(H) x Q(B, N, S, H) x K'(B, N, H, S) + mask) x V(B, N, S, H)
+  //
+  // The scores are computed for one block of queries and one block of keys at a time, with a running (online)
+  // softmax: each query row keeps the maximum and the sum of the exponentials seen so far, and its partial
+  // output is rescaled when a later block raises the maximum. The (B, N, S, S) score tensor is never
+  // materialized, and the output is accumulated in place.
+  //
+  // The mask adds a large negative value to the scores of keys at or after mask_index, so their exponentials
+  // underflow to zero and those keys are skipped. If every key is masked all the exponentials underflow, and the
+  // softmax falls back to the same weight 1/S for every key, so each output row is the mean of the values.
   {
-    auto scratch_broadcast_data = allocator->Alloc(batch_size * sequence_length * element_size);
-    BufferUniquePtr scratch_broadcast_buffer(scratch_broadcast_data, BufferDeleter(allocator));
-    memset(scratch_broadcast_data, 0, batch_size * sequence_length * element_size);
-    T* p_scratch_broadcast_current_data = reinterpret_cast<T*>(scratch_broadcast_data);
-    for (int b_i = 0; b_i < batch_size; b_i++) {
-      // TODO: mask_index can be used in softmax to save some calculation.
-      int mask = mask_index->template Data<int32_t>()[b_i];
-      for (int m_i = mask; m_i < sequence_length; m_i++) {
-        p_scratch_broadcast_current_data[m_i] = static_cast<T>(-10000.0);
-      }
-      p_scratch_broadcast_current_data += sequence_length;
-    }
+    constexpr int kQueryBlockSize = 64;
+    constexpr int kKeyBlockSize = 128;
 
-    const int loop_len = batch_size * num_heads_;
+    const int query_blocks = (sequence_length + kQueryBlockSize - 1) / kQueryBlockSize;
+    const int loop_len = batch_size * num_heads_ * query_blocks;
     const float alpha = 1.0f / sqrt(static_cast<float>(head_size));
-
-    concurrency::ThreadPool::TryParallelFor(context->GetOperatorThreadPool(), loop_len, [&](int32_t i) {
-      const int batch_index = i / num_heads_;
-      // broadcast masks (B) -> (B.N.)S.S
-      const T* broadcast_data_src = reinterpret_cast<T*>(scratch_broadcast_data) + batch_index * sequence_length;
-      T* broadcast_data_dest = reinterpret_cast<T*>(scratch_data) + sequence_length * sequence_length * i;
-      for (int seq_index = 0; seq_index < sequence_length; seq_index++) {
-        memcpy(broadcast_data_dest, broadcast_data_src, sequence_length * sizeof(T));
-        broadcast_data_dest += sequence_length;
-      }
-
-      // gemm
-
-      //                   original           transposed            iteration
-      // A: Q              (BxNxSxH)          (B.N.)S x H            S x H
-      // B: K'             (BxNxSxH)          (B.N.)H x S            H x S
-      // C: scratch_data   (BxNxSxS)          (B.N.)S x S            S x S
-
-      math::Gemm<T, concurrency::ThreadPool>(
-          CblasNoTrans,
-          CblasTrans,
-          sequence_length,
-          sequence_length,
-          head_size,
-          alpha,
-          Q + sequence_length * head_size * i,
-          K + sequence_length * head_size * i,
-          1.0,
-          reinterpret_cast<T*>(scratch_data) + sequence_length * sequence_length * i,
-          nullptr);
-    });
+    const int32_t* mask_data = mask_index->template Data<int32_t>();
+    T* output_data = output->template MutableData<T>();
+
+    // multiply-adds of the two gemms plus the cost of an exponential for each score
+    const double cost_per_block = static_cast<double>(kQueryBlockSize) * sequence_length * (4.0 * head_size + 20.0);
+
+    concurrency::ThreadPool::TryParallelFor(
+        context->GetOperatorThreadPool(), loop_len, cost_per_block, [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+          // scores(kQueryBlockSize, kKeyBlockSize), then the running maximum and sum of each query row
+          auto block_data = allocator->Alloc((kQueryBlockSize * kKeyBlockSize + 2 * kQueryBlockSize) * element_size);
+          BufferUniquePtr block_buffer(block_data, BufferDeleter(allocator));
+          T* scores = reinterpret_cast<T*>(block_data);
+          T* row_max = scores + kQueryBlockSize * kKeyBlockSize;
+          T* row_sum = row_max + kQueryBlockSize;
+
+          for (std::ptrdiff_t i = first; i < last; i++) {
+            const int batch_head_index = static_cast<int>(i / query_blocks);
+            const int batch_index = batch_head_index / num_heads_;
+            const int head_index = batch_head_index % num_heads_;
+            const int query_start = static_cast<int>(i % query_blocks) * kQueryBlockSize;
+            const int query_length = std::min(kQueryBlockSize, sequence_length - query_start);
+
+            const int mask = mask_data[batch_index];
+            const int key_length = std::min(mask, sequence_length);
+
+            const T* q = Q + (batch_head_index * sequence_length + query_start) * head_size;
+            const T* k = K + batch_head_index * sequence_length * head_size;
+            const T* v = V + batch_head_index * sequence_length * head_size;
+            // out(B, S, N, H) is written directly, so the rows of a head are hidden_size apart
+            T* out = output_data + (batch_index * sequence_length + query_start) * hidden_size + head_index * head_size;
+
+            if (key_length <= 0) {
+              EigenVectorArrayMap<T>(out, head_size) =
+                  ConstEigenMatrixMapRowMajor<T>(v, sequence_length, head_size).colwise().mean().transpose().array();
+              for (int r = 1; r < query_length; r++) {
+                std::copy_n(out, head_size, out + r * hidden_size);
+              }
+              continue;
+            }
+
+            std::fill_n(row_max, query_length, std::numeric_limits<T>::lowest());
+            std::fill_n(row_sum, query_length, static_cast<T>(0));
+
+            for (int key_start = 0; key_start < key_length; key_start += kKeyBlockSize) {
+              const int block_length = std::min(kKeyBlockSize, key_length - key_start);
+
+              //                   original           transposed            iteration
+              // A: Q              (BxNxSxH)          (B.N.)S x H            Sq x H
+              // B: K'             (BxNxSxH)          (B.N.)H x S            H x Sk
+              // C: scores                                                   Sq x Sk
+
+              math::GemmEx<float, concurrency::ThreadPool>(CblasNoTrans,
+                                                           CblasTrans,
+                                                           query_length,
+                                                           block_length,
+                                                           head_size,
+                                                           alpha,
+                                                           q,
+                                                           head_size,
+                                                           k + key_start * head_size,
+                                                           head_size,
+                                                           0.0f,
+                                                           scores,
+                                                           block_length,
+                                                           nullptr);
+
+              for (int r = 0; r < query_length; r++) {
+                EigenVectorArrayMap<T> p(scores + r * block_length, block_length);
+                const T new_max = std::max(row_max[r], p.maxCoeff());
+                p = (p - new_max).exp();
+
+                // rescale what was accumulated with the previous maximum. the first block has nothing to rescale.
+                if (key_start > 0) {
+                  const T scale = std::exp(row_max[r] - new_max);
+                  EigenVectorArrayMap<T>(out + r * hidden_size, head_size) *= scale;
+                  row_sum[r] *= scale;
+                }
+
+                row_sum[r] += p.sum();
+                row_max[r] = new_max;
+              }
+
+              //                   original           transposed            iteration
+              // A: P                                                        Sq x Sk
+              // B: V              (BxNxSxH)          (B.N.)S x H            Sk x H
+              // C: out            (BxSxNxH)          (B.)S x (N.)H          Sq x H
+
+              math::GemmEx<float, concurrency::ThreadPool>(CblasNoTrans,
+                                                           CblasNoTrans,
+                                                           query_length,
+                                                           head_size,
+                                                           block_length,
+                                                           1.0f,
+                                                           scores,
+                                                           block_length,
+                                                           v + key_start * head_size,
+                                                           head_size,
+                                                           key_start > 0 ? 1.0f : 0.0f,
+                                                           out,
+                                                           hidden_size,
+                                                           nullptr);
+            }
+
+            for (int r = 0; r < query_length; r++) {
+              EigenVectorArrayMap<T>(out + r * hidden_size, head_size) /= row_sum[r];
+            }
+          }
+        });
   }
 
-  // STEP.3: P(B, N, S, S) = Softmax(scratch)
-  {
-    const int N = batch_size * num_heads_ * sequence_length;
-    const int D = sequence_length;
-
-    concurrency::ThreadPool::TryBatchParallelFor(context->GetOperatorThreadPool(), N, [&](int j) {
-      float* x = reinterpret_cast<T*>(scratch_data) + j * D;
-      float* y = x;
-
-      for (int i = 0; i < D; i++)
-        y[i] = expf(x[i]);
-
-      double sum = 0.0;
-
-      for (int i = 0; i < D; i++) {
-        sum += x[i];
-      }
-
-      if (sum == 0) {
-        for (int i = 0; i < D; i++) {
-          y[i] = 1.0f / (float)D;
-        }
-      } else {
-        for (int i = 0; i < D; i++) {
-          y[i] = x[i] / (float)sum;
-        }
-      }
-    });
-  }
-
-  // STEP.4: out_tmp(B, N, S, H) = P(B, N, S, S) x V(B, N, S, H)
-  auto out_tmp_data = allocator->Alloc(batch_size * num_heads_ * sequence_length * head_size * element_size);
-  BufferUniquePtr out_tmp_buffer(out_tmp_data, BufferDeleter(allocator));
-
-  concurrency::ThreadPool::TryParallelFor(context->GetOperatorThreadPool(), batch_size * num_heads_, [&](int i) {
-    T* current_tmp_data = reinterpret_cast<T*>(out_tmp_data) + sequence_length * head_size * i;
-    math::MatMul<T>(
-        sequence_length,
-        head_size,
-        sequence_length,
-        reinterpret_cast<T*>(scratch_data) + sequence_length * sequence_length * i,
-        V + sequence_length * head_size * i,
-        current_tmp_data,
-        nullptr);
-
-    // transpose: out(B, S, N, H) = transpose out_tmp(B, N, S, H)
-    const int batch_index = i / num_heads_;
-    const int head_index = i % num_heads_;
-    T* src = current_tmp_data;
-    T* dest = output->template MutableData<T>() + (batch_index * sequence_length * num_heads_ + head_index) * head_size;
-    for (int j = 0; j < sequence_length; j++) {
-      memcpy(dest, src, head_size * sizeof(T));
-      src += head_size;
-      dest += hidden_size;
-    }
-  });
-
   return Status::OK();
 }
 
@@ -0,0 +1,162 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "contrib_ops/cpu/sparse_matmul.h"
+#include "core/mlas/inc/mlas.h"
+#include "core/util/math_cpuonly.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+ONNX_CPU_OPERATOR_TYPED_MS_KERNEL(
+    SparseMatMul,
+    1,
+    float,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    SparseMatMul<float>);
+
+// Checks the shapes of the sparse inputs, which is cheap enough to do on every Run.
+static Status ValidateSparseShapes(const Tensor& values, const Tensor& row_offsets, const Tensor& column_indices) {
+  if (values.Shape().NumDimensions() != 1 || column_indices.Shape().NumDimensions() != 1 ||
+      row_offsets.Shape().NumDimensions() != 1 || row_offsets.Shape()[0] < 1) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "SparseMatMul: B_values, B_row_offsets and B_column_indices must be 1-D and "
+                           "B_row_offsets must not be empty.");
+  }
+
+  if (column_indices.Shape()[0] != values.Shape()[0]) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "SparseMatMul: B_values and B_column_indices have different sizes: ",
+                           values.Shape()[0], " != ", column_indices.Shape()[0]);
+  }
+
+  return Status::OK();
+}
+
+// Checks the offsets and indices, as invalid ones would make MLAS read outside of A. This is linear in the number
+// of nonzero values, as expensive as the multiplication of a single row of A, so it is done once in the constructor
+// when B is made of initializers.
+static Status ValidateSparseMatrix(const Tensor& values, const Tensor& row_offsets, const Tensor& column_indices,
+                                   int64_t K) {
+  ORT_RETURN_IF_ERROR(ValidateSparseShapes(values, row_offsets, column_indices));
+
+  const int64_t nnz = values.Shape()[0];
+  const int64_t N = row_offsets.Shape()[0] - 1;
+  const int32_t* offsets = row_offsets.template Data<int32_t>();
+  if (offsets[0] != 0 || offsets[N] != nnz) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "SparseMatMul: B_row_offsets must start at 0 and end at the number of values.");
+  }
+
+  for (int64_t n = 0; n < N; ++n) {
+    if (offsets[n] > offsets[n + 1]) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "SparseMatMul: B_row_offsets is not sorted.");
+    }
+  }
+
+  const int32_t* indices = column_indices.template Data<int32_t>();
+  for (int64_t j = 0; j < nnz; ++j) {
+    if (indices[j] < 0 || indices[j] >= K) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                             "SparseMatMul: column index ", indices[j], " is out of range for K=", K);
+    }
+  }
+
+  return Status::OK();
+}
+
+template <typename T>
+SparseMatMul<T>::SparseMatMul(const OpKernelInfo& info) : OpKernel(info) {
+  ORT_ENFORCE(info.GetAttr<int64_t>("K", &k_).IsOK() && k_ > 0, "Attribute K must be positive.");
+  alpha_ = info.GetAttrOrDefault<float>("alpha", 1.0f);
+  beta_ = info.GetAttrOrDefault<float>("beta", 1.0f);
+
+  const Tensor* values = nullptr;
+  const Tensor* row_offsets = nullptr;
+  const Tensor* column_indices = nullptr;
+  if (info.TryGetConstantInput(1, &values) && info.TryGetConstantInput(2, &row_offsets) &&
+      info.TryGetConstantInput(3, &column_indices)) {
+    ORT_THROW_IF_ERROR(ValidateSparseMatrix(*values, *row_offsets, *column_indices, k_));
+    b_is_constant_ = true;
+  }
+}
+
+template <>
+Status SparseMatMul<float>::Compute(OpKernelContext* context) const {
+  concurrency::ThreadPool* tp = context->GetOperatorThreadPool();
+
+  const auto* A = context->Input<Tensor>(0);
+  const auto* values = context->Input<Tensor>(1);
+  const auto* row_offsets = context->Input<Tensor>(2);
+  const auto* column_indices = context->Input<Tensor>(3);
+  const auto* C = context->Input<Tensor>(4);
+
+  if (b_is_constant_) {
+    ORT_RETURN_IF_ERROR(ValidateSparseShapes(*values, *row_offsets, *column_indices));
+  } else {
+    ORT_RETURN_IF_ERROR(ValidateSparseMatrix(*values, *row_offsets, *column_indices, k_));
+  }
+
+  const auto& a_shape = A->Shape();
+  if (a_shape.NumDimensions() < 1 || a_shape[a_shape.NumDimensions() - 1] != k_) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "SparseMatMul: the last dimension of A does not match K=", k_, ". A: ", a_shape);
+  }
+
+  const int64_t M = a_shape.SizeToDimension(a_shape.NumDimensions() - 1);
+  const int64_t N = row_offsets->Shape()[0] - 1;
+
+  std::vector<int64_t> y_dims(a_shape.GetDims());
+  y_dims.back() = N;
+  Tensor* Y = context->Output(0, TensorShape(y_dims));
+  if (M == 0 || N == 0) {
+    return Status::OK();
+  }
+
+  float* y_data = Y->template MutableData<float>();
+
+  // Broadcast the bias into the output, same as Gemm.
+  float beta = 0.0f;
+  if (C != nullptr && beta_ != 0) {
+    const auto& c_shape = C->Shape();
+    const float* c_data = C->template Data<float>();
+    auto output_mat = EigenMatrixMapRowMajor<float>(y_data, M, N);
+    if (c_shape.Size() == 1) {
+      // C is (), (1,) or (1, 1), set the scalar
+      output_mat.setConstant(*c_data);
+    } else if ((c_shape.NumDimensions() == 1 && c_shape[0] == N) ||
+               (c_shape.NumDimensions() == 2 && c_shape[0] == 1 && c_shape[1] == N)) {
+      // C is (N,) or (1, N)
+      output_mat.rowwise() = ConstEigenVectorMap<float>(c_data, N).transpose();
+    } else if (c_shape.NumDimensions() == 2 && c_shape[0] == M && c_shape[1] == 1) {
+      // C is (M, 1)
+      output_mat.colwise() = ConstEigenVectorMap<float>(c_data, M);
+    } else if (c_shape.NumDimensions() == 2 && c_shape[0] == M && c_shape[1] == N) {
+      output_mat = ConstEigenMatrixMapRowMajor<float>(c_data, M, N);
+    } else {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                             "SparseMatMul: invalid shape for C: ", c_shape, ". M=", M, " N=", N);
+    }
+
+    beta = beta_;
+  }
+
+  MlasSparseGemm(static_cast<size_t>(M),
+                 static_cast<size_t>(N),
+                 static_cast<size_t>(k_),
+                 alpha_,
+                 A->template Data<float>(),
+                 static_cast<size_t>(k_),
+                 row_offsets->template Data<int32_t>(),
+                 column_indices->template Data<int32_t>(),
+                 values->template Data<float>(),
+                 beta,
+                 y_data,
+                 static_cast<size_t>(N),
+                 tp);
+
+  return Status::OK();
+}
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,30 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/common/common.h"
+#include "core/framework/op_kernel.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+// Y = alpha * A * B + beta * C where B is supplied transposed in CSR format.
+// Created by the SparseWeightTransformer from MatMul/Gemm nodes with pruned weights.
+template <typename T>
+class SparseMatMul final : public OpKernel {
+ public:
+  SparseMatMul(const OpKernelInfo& info);
+
+  Status Compute(OpKernelContext* context) const override;
+
+ private:
+  int64_t k_;
+  float alpha_;
+  float beta_;
+  // whether B is made of initializers, whose offsets and indices are validated once in the constructor
+  bool b_is_constant_{false};
+};
+
+}  // namespace contrib
+}  // namespace onnxruntime
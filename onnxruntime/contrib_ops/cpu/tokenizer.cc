@@ -1,6 +1,8 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <algorithm>
+
 #include "core/common/common.h"
 #include "core/framework/tensor.h"
 #include "core/framework/op_kernel.h"
@@ -8,11 +10,41 @@
 #include "onnx/defs/schema.h"
 
 #include "core/common/utf8_util.h"
+#include "core/platform/threadpool.h"
 #include "re2/re2.h"
 
 namespace onnxruntime {
 namespace contrib {
 
+namespace tokenizer_details {
+const char start_text = 0x2;
+const char end_text = 0x3;
+
+// The rows are tokenized in blocks of rows, in parallel on the intra-op thread pool.
+constexpr size_t kRowBlockSize = 64;
+
+// The tokens of a block of rows, as spans of the input strings rather than copies of them. The tokens of all the rows
+// are stored one after the other, and the buffers are reused from row to row.
+struct TokenBlock {
+  std::vector<re2::StringPiece> tokens;
+  // end of the tokens of each row of the block in tokens
+  std::vector<size_t> row_ends;
+  size_t max_tokens = 0;
+  Status status;
+  // the pieces of the row split by the separators applied so far, and by the next one
+  std::vector<re2::StringPiece> pieces;
+  std::vector<re2::StringPiece> split_pieces;
+};
+
+// A separator without any regex special characters is searched as a plain string, which is faster than matching it
+// with RE2 and finds the same matches.
+bool IsLiteralSeparator(const std::string& separator) {
+  return !separator.empty() && separator.find_first_of("\\.^$|?*+()[]{}") == std::string::npos;
+}
+}  // namespace tokenizer_details
+
+using namespace tokenizer_details;
+
 class Tokenizer final : public OpKernel {
  public:
   explicit Tokenizer(const OpKernelInfo& info);
@@ -23,21 +55,31 @@ class Tokenizer final : public OpKernel {
   Status Compute(OpKernelContext* context) const override;
 
  private:
-  Status CharTokenize(OpKernelContext* context, size_t N, size_t C,
-                      const std::vector<int64_t>& input_dims) const;
+  // Tokenizes the rows with tokenize_row, which appends the tokens of a row to a block, then writes the tokens of
+  // each row to the output, padded to the largest number of tokens.
+  template <typename TokenizeRow>
+  Status TokenizeRows(OpKernelContext* context, size_t N, size_t C,
+                      const std::vector<int64_t>& input_dims, const TokenizeRow& tokenize_row) const;
+
+  Status CharTokenize(const std::string& s, TokenBlock& block) const;
+
+  Status SeparatorExpressionTokenizer(const std::string& s, TokenBlock& block) const;
+
+  Status TokenExpression(const std::string& s, TokenBlock& block) const;
 
-  Status SeparatorExpressionTokenizer(OpKernelContext* context, size_t N, size_t C,
-                                      const std::vector<int64_t>& input_dims) const;
+  Status SplitByExpression(const re2::StringPiece& text, const re2::RE2& separator,
+                           std::vector<re2::StringPiece>& tokens) const;
 
-  Status TokenExpression(OpKernelContext* ctx,
-                         size_t N, size_t C,
-                         const std::vector<int64_t>& input_dims) const;
+  Status SplitByLiteral(const re2::StringPiece& text, const std::string& separator,
+                        std::vector<re2::StringPiece>& tokens) const;
 
   bool mark_{false};
   std::string pad_value_;
   int64_t mincharnum_{0};
   bool char_tokenezation_{false};
   std::vector<std::unique_ptr<re2::RE2>> separators_;
+  // the separators searched as plain strings, empty for those matched with their regex
+  std::vector<std::string> literal_separators_;
   std::unique_ptr<re2::RE2> regex_;
 };
 
@@ -51,13 +93,6 @@ ONNX_CPU_OPERATOR_TYPED_MS_KERNEL(
         .TypeConstraint("T", DataTypeImpl::GetTensorType<std::string>()),
     contrib::Tokenizer);
 
-namespace tokenizer_details {
-const char start_text = 0x2;
-const char end_text = 0x3;
-}  // namespace tokenizer_details
-
-using namespace tokenizer_details;
-
 Tokenizer::Tokenizer(const OpKernelInfo& info) : OpKernel(info) {
   int64_t mark = 0;
   auto status = info.GetAttr("mark", &mark);
@@ -101,6 +136,7 @@ Tokenizer::Tokenizer(const OpKernelInfo& info) : OpKernel(info) {
           ORT_THROW("Can not digest separators: ", sep, " ", regex->error());
         }
         separators_.push_back(std::move(regex));
+        literal_separators_.push_back(IsLiteralSeparator(sep) ? sep : std::string());
       }
     } else {
       // Use tokenexp
@@ -116,165 +152,51 @@ Tokenizer::Tokenizer(const OpKernelInfo& info) : OpKernel(info) {
   }
 }
 
-Status Tokenizer::CharTokenize(OpKernelContext* ctx, size_t N, size_t C,
-                               const std::vector<int64_t>& input_dims) const {
-  // With char tokenzation we get as many tokens as the number of
-  // utf8 characters in the string. So for every string we calculate its character(utf8) length
-  // add padding and add start/end test separators if necessary
-  size_t max_tokens = 0;
+template <typename TokenizeRow>
+Status Tokenizer::TokenizeRows(OpKernelContext* ctx, size_t N, size_t C,
+                               const std::vector<int64_t>& input_dims, const TokenizeRow& tokenize_row) const {
   auto X = ctx->Input<Tensor>(0);
   auto const input_data = X->template Data<std::string>();
-  auto curr_input = input_data;
-  auto const last = input_data + N * C;
-  while (curr_input != last) {
-    const auto& s = *curr_input;
-    size_t tokens = 0;  // length in utf8 chars
-    if (!utf8_validate(reinterpret_cast<const unsigned char*>(s.data()), s.size(),
-                       tokens)) {
-      return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
-                    "Input string contains invalid utf8 chars: " + s);
-    }
-    max_tokens = std::max(max_tokens, tokens);
-    ++curr_input;
-  }
-
-  std::vector<int64_t> output_dims(input_dims);
-  // Check if we have no output due to apparently empty strings input.
-  if (max_tokens == 0) {
-    output_dims.push_back(0);
-    TensorShape output_shape(output_dims);
-    ctx->Output(0, output_shape);
-    return Status::OK();
+  const size_t rows = N * C;
+  const size_t num_blocks = (rows + kRowBlockSize - 1) / kRowBlockSize;
+  std::vector<TokenBlock> blocks(num_blocks);
+  concurrency::ThreadPool* tp = ctx->GetOperatorThreadPool();
+
+  size_t input_bytes = 0;
+  for (size_t row = 0; row < rows; ++row) {
+    input_bytes += input_data[row].size();
   }
-
-  if (mark_) {
-    max_tokens += 2;  // Start/end markers as separate tokens
-  }
-
-  output_dims.push_back(max_tokens);
-  TensorShape output_shape(output_dims);
-  auto output_tensor = ctx->Output(0, output_shape);
-  auto const output_data = output_tensor->template MutableData<std::string>();
-  size_t output_index = 0;
-  curr_input = input_data;
-  while (curr_input != last) {
-    const auto& s = *curr_input;
-    if (mark_) {
-      (output_data + output_index)->assign(&start_text, 1);
-      ++output_index;
-    }
-    size_t tokens = 0;
-    const size_t str_len = s.size();
-    for (size_t token_idx = 0; token_idx < str_len;) {
-      size_t tlen = 0;
-      bool result = utf8_bytes(static_cast<unsigned char>(s[token_idx]), tlen);
-      assert(result);
-      (void)result;
-      assert(token_idx + tlen <= str_len);
-      *(output_data + output_index) = s.substr(token_idx, tlen);
-      ++output_index;
-      token_idx += tlen;
-      ++tokens;
-    }
-    if (mark_) {
-      (output_data + output_index)->assign(&end_text, 1);
-      ++output_index;
-    }
-    // Padding strings
-    assert(tokens + (mark_ * 2) <= max_tokens);
-    const size_t pads = max_tokens - (mark_ * 2) - tokens;
-    for (size_t p = 0; p < pads; ++p) {
-      *(output_data + output_index) = pad_value_;
-      ++output_index;
-    }
-    ++curr_input;
-  }
-  return Status::OK();
-}
-
-Status Tokenizer::SeparatorExpressionTokenizer(OpKernelContext* ctx,
-                                               size_t N, size_t C,
-                                               const std::vector<int64_t>& input_dims) const {
-  using namespace re2;
-  std::vector<std::vector<StringPiece>> rows;
-  rows.reserve(N * C);
-
-  // We do not constraint the search to match
-  // on the beginning or end of the string
-  const RE2::Anchor anchor = RE2::UNANCHORED;
-
-  // Scan all strings and attempt to find separators in them
-  // collect all the output tokens here
-  size_t max_tokens = 0;
-  auto X = ctx->Input<Tensor>(0);
-  auto const input_data = X->template Data<std::string>();
-  auto curr_input = input_data;
-  auto const last = input_data + N * C;
-  while (curr_input != last) {
-    const auto& s = *curr_input;
-    size_t utf8_chars = 0;  // length in utf8 chars
-    if (!utf8_validate(reinterpret_cast<const unsigned char*>(s.data()), s.size(),
-                       utf8_chars)) {
-      return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
-                    "Input string contains invalid utf8 chars: " + s);
-    }
-
-    std::vector<StringPiece> row{s};
-
-    for (const auto& sep : separators_) {
-      std::vector<StringPiece> tokens;
-      for (const auto& text : row) {
-        const auto end_pos = text.length();
-        size_t start_pos = 0;
-        StringPiece submatch;
-
-        bool match = true;
-        do {
-          match = sep->Match(text, start_pos, end_pos, anchor, &submatch, 1);
-          if (match) {
-            // Record  pos/len
-            assert(submatch.data() != nullptr);
-            size_t match_pos = submatch.data() - text.data();
-            assert(match_pos >= start_pos);
-            auto token_len = match_pos - start_pos;
-            utf8_chars = 0;
-            bool valid = utf8_len(reinterpret_cast<const unsigned char*>(text.data() + start_pos),
-                                  token_len, utf8_chars);
-            if (!valid) {
-              return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
-                            "Match contains invalid utf8 chars: " + submatch.as_string());
-            }
-            if (utf8_chars >= size_t(mincharnum_)) {
-              tokens.emplace_back(text.data() + start_pos, token_len);
+  // the cost of a block grows with the length of its strings
+  const double block_cost = static_cast<double>(input_bytes + rows) / rows * kRowBlockSize * 16;
+
+  concurrency::ThreadPool::TryParallelFor(
+      tp, static_cast<std::ptrdiff_t>(num_blocks), block_cost, [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        for (auto b = static_cast<size_t>(first); b < static_cast<size_t>(last); ++b) {
+          TokenBlock& block = blocks[b];
+          for (size_t row = b * kRowBlockSize, end = std::min(rows, row + kRowBlockSize); row < end; ++row) {
+            const auto& s = input_data[row];
+            size_t utf8_chars = 0;  // length in utf8 chars
+            if (!utf8_validate(reinterpret_cast<const unsigned char*>(s.data()), s.size(), utf8_chars)) {
+              block.status = Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
+                                    "Input string contains invalid utf8 chars: " + s);
+              break;
             }
-            // Update starting position
-            // Guard against empty string match
-            auto match_len = submatch.length();
-            if (match_len > 0) {
-              start_pos = match_pos + match_len;
-            } else {
-              size_t bytes = 0;
-              utf8_bytes(*submatch.data(), bytes);
-              start_pos = match_pos + bytes;
-            }
-          } else {
-            // record trailing token
-            auto trailing_len = end_pos - start_pos;
-            utf8_chars = 0;
-            utf8_len(reinterpret_cast<const unsigned char*>(text.data() + start_pos),
-                     trailing_len, utf8_chars);
-            if (utf8_chars >= size_t(mincharnum_)) {
-              tokens.emplace_back(text.data() + start_pos, trailing_len);
+            const size_t row_begin = block.tokens.size();
+            block.status = tokenize_row(s, block);
+            if (!block.status.IsOK()) {
+              break;
             }
+            block.row_ends.push_back(block.tokens.size());
+            block.max_tokens = std::max(block.max_tokens, block.tokens.size() - row_begin);
           }
-        } while (match);
-      }  // row
-      // Replace the row with the results of this tokenezation
-      row.swap(tokens);
-    }  // separators_
-    max_tokens = std::max(max_tokens, row.size());
-    rows.push_back(std::move(row));
-    ++curr_input;
+        }
+      });
+
+  // the error of the first row that failed, as when the rows are tokenized one by one
+  size_t max_tokens = 0;
+  for (const auto& block : blocks) {
+    ORT_RETURN_IF_ERROR(block.status);
+    max_tokens = std::max(max_tokens, block.max_tokens);
   }
 
   std::vector<int64_t> output_dims(input_dims);
@@ -297,165 +219,191 @@ Status Tokenizer::SeparatorExpressionTokenizer(OpKernelContext* ctx,
   auto output_tensor = ctx->Output(0, output_shape);
   auto const output_data = output_tensor->template MutableData<std::string>();
 
-#ifdef _DEBUG
-  const size_t max_output_index = N * C * max_tokens;
-#endif
-  size_t output_index = 0;
-  curr_input = input_data;
-  for (auto& row : rows) {
-#ifdef _DEBUG
-    size_t c_idx = output_index;
-#endif
-    if (mark_) {
-      (output_data + output_index)->assign(&start_text, 1);
-      ++output_index;
-    }
-    // Output tokens for this row
-    for (const auto& token : row) {
-      (output_data + output_index)->assign(token.data(), token.size());
-      ++output_index;
-    }
-    if (mark_) {
-      (output_data + output_index)->assign(&end_text, 1);
-      ++output_index;
-    }
-    const size_t pads = max_tokens - (mark_ * 2) - row.size();
-    for (size_t p = 0; p < pads; ++p) {
-      *(output_data + output_index) = pad_value_;
-      ++output_index;
-    }
-#ifdef _DEBUG
-    assert(output_index <= max_output_index);
-    assert((output_index - c_idx) <= max_tokens);
-#endif
-    ++curr_input;
+  concurrency::ThreadPool::TryParallelFor(
+      tp, static_cast<std::ptrdiff_t>(num_blocks), static_cast<double>(kRowBlockSize * max_tokens) * 16,
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        for (auto b = static_cast<size_t>(first); b < static_cast<size_t>(last); ++b) {
+          const TokenBlock& block = blocks[b];
+          size_t token = 0;
+          for (size_t r = 0; r < block.row_ends.size(); ++r) {
+            const size_t row = b * kRowBlockSize + r;
+            std::string* output = output_data + row * max_tokens;
+            std::string* const row_end = output + max_tokens;
+            if (mark_) {
+              (output++)->assign(&start_text, 1);
+            }
+            // Output tokens for this row
+            for (; token < block.row_ends[r]; ++token) {
+              (output++)->assign(block.tokens[token].data(), block.tokens[token].size());
+            }
+            if (mark_) {
+              (output++)->assign(&end_text, 1);
+            }
+            assert(output <= row_end);
+            // Padding strings
+            while (output != row_end) {
+              *(output++) = pad_value_;
+            }
+          }
+        }
+      });
+  return Status::OK();
+}
+
+Status Tokenizer::CharTokenize(const std::string& s, TokenBlock& block) const {
+  // With char tokenzation we get as many tokens as the number of
+  // utf8 characters in the string.
+  const size_t str_len = s.size();
+  for (size_t token_idx = 0; token_idx < str_len;) {
+    size_t tlen = 0;
+    bool result = utf8_bytes(static_cast<unsigned char>(s[token_idx]), tlen);
+    assert(result);
+    (void)result;
+    assert(token_idx + tlen <= str_len);
+    block.tokens.emplace_back(s.data() + token_idx, tlen);
+    token_idx += tlen;
   }
   return Status::OK();
 }
 
-Status Tokenizer::TokenExpression(OpKernelContext* ctx,
-                                  size_t N, size_t C,
-                                  const std::vector<int64_t>& input_dims) const {
+Status Tokenizer::SplitByExpression(const re2::StringPiece& text, const re2::RE2& separator,
+                                    std::vector<re2::StringPiece>& tokens) const {
   using namespace re2;
-  // Represents a token that will be output after
-  // first is the index, second is the size;
-  std::vector<std::vector<StringPiece>> tokens;
-  tokens.reserve(N * C);
-
-  size_t max_tokens = 0;
-  auto X = ctx->Input<Tensor>(0);
-  auto const input_data = X->template Data<std::string>();
-  auto curr_input = input_data;
-  auto const last = input_data + N * C;
-
   // We do not constraint the search to match
   // on the beginning or end of the string
   const RE2::Anchor anchor = RE2::UNANCHORED;
 
-  while (curr_input != last) {
-    const auto& s = *curr_input;
+  const auto end_pos = text.length();
+  size_t start_pos = 0;
+  StringPiece submatch;
+  size_t utf8_chars = 0;
+
+  bool match = true;
+  do {
+    match = separator.Match(text, start_pos, end_pos, anchor, &submatch, 1);
+    if (match) {
+      // Record  pos/len
+      assert(submatch.data() != nullptr);
+      size_t match_pos = submatch.data() - text.data();
+      assert(match_pos >= start_pos);
+      auto token_len = match_pos - start_pos;
+      utf8_chars = 0;
+      bool valid = utf8_len(reinterpret_cast<const unsigned char*>(text.data() + start_pos),
+                            token_len, utf8_chars);
+      if (!valid) {
+        return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
+                      "Match contains invalid utf8 chars: " + submatch.as_string());
+      }
+      if (utf8_chars >= size_t(mincharnum_)) {
+        tokens.emplace_back(text.data() + start_pos, token_len);
+      }
+      // Update starting position
+      // Guard against empty string match
+      auto match_len = submatch.length();
+      if (match_len > 0) {
+        start_pos = match_pos + match_len;
+      } else {
+        size_t bytes = 0;
+        utf8_bytes(*submatch.data(), bytes);
+        start_pos = match_pos + bytes;
+      }
+    } else {
+      // record trailing token
+      auto trailing_len = end_pos - start_pos;
+      utf8_chars = 0;
+      utf8_len(reinterpret_cast<const unsigned char*>(text.data() + start_pos),
+               trailing_len, utf8_chars);
+      if (utf8_chars >= size_t(mincharnum_)) {
+        tokens.emplace_back(text.data() + start_pos, trailing_len);
+      }
+    }
+  } while (match);
+  return Status::OK();
+}
 
+Status Tokenizer::SplitByLiteral(const re2::StringPiece& text, const std::string& separator,
+                                 std::vector<re2::StringPiece>& tokens) const {
+  const re2::StringPiece sep(separator);
+  size_t start_pos = 0;
+  while (true) {
+    const auto match_pos = text.find(sep, start_pos);
+    const auto token_len = (match_pos == re2::StringPiece::npos ? text.length() : match_pos) - start_pos;
     size_t utf8_chars = 0;
-    if (!utf8_validate(reinterpret_cast<const unsigned char*>(s.data()), s.size(),
-                       utf8_chars)) {
+    if (!utf8_len(reinterpret_cast<const unsigned char*>(text.data() + start_pos), token_len, utf8_chars)) {
       return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
-                    "Input string contains invalid utf8 chars: " + s);
+                    "Match contains invalid utf8 chars: " + separator);
     }
-
-    tokens.emplace_back();
-    auto& row = tokens.back();
-
-    StringPiece text(s);
-    const auto end_pos = s.length();
-    size_t start_pos = 0;
-    StringPiece submatch;
-
-    bool match = true;
-    do {
-      match = regex_->Match(text, start_pos, end_pos, anchor, &submatch, 1);
-      if (match) {
-        // Record  pos/len
-        assert(submatch.data() != nullptr);
-        size_t match_pos = submatch.data() - s.data();
-        assert(match_pos >= start_pos);
-        // Guard against empty match and make
-        // sure we make progress either way
-        auto token_len = submatch.length();
-        utf8_chars = 0;
-        if (!utf8_len(reinterpret_cast<const unsigned char*>(submatch.data()), token_len, utf8_chars)) {
-          return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
-                        "Match contains invalid utf8 chars: " + submatch.as_string());
-        }
-        if (utf8_chars >= size_t(mincharnum_)) {
-          row.push_back(submatch);
-          start_pos = match_pos + token_len;
-        } else {
-          size_t bytes = 0;
-          utf8_bytes(*submatch.data(), bytes);
-          start_pos = match_pos + bytes;
-        }
-      }
-    } while (match);
-    max_tokens = std::max(max_tokens, row.size());
-    ++curr_input;
-  }
-
-  // Check for empty output
-  std::vector<int64_t> output_dims(input_dims);
-  // Check if we have no output due to either empty input
-  // everything is a separator
-  if (max_tokens == 0) {
-    output_dims.push_back(0);
-    TensorShape output_shape(output_dims);
-    ctx->Output(0, output_shape);
-    return Status::OK();
+    if (utf8_chars >= size_t(mincharnum_)) {
+      tokens.emplace_back(text.data() + start_pos, token_len);
+    }
+    if (match_pos == re2::StringPiece::npos) {
+      return Status::OK();
+    }
+    start_pos = match_pos + sep.length();
   }
+}
 
-  if (mark_) {
-    max_tokens += 2;  // Start/end markers as separate tokens
+Status Tokenizer::SeparatorExpressionTokenizer(const std::string& s, TokenBlock& block) const {
+  // Each separator splits the pieces the previous ones produced
+  auto& row = block.pieces;
+  row.clear();
+  row.emplace_back(s);
+
+  for (size_t i = 0; i < separators_.size(); ++i) {
+    auto& tokens = block.split_pieces;
+    tokens.clear();
+    for (const auto& text : row) {
+      if (!literal_separators_[i].empty()) {
+        ORT_RETURN_IF_ERROR(SplitByLiteral(text, literal_separators_[i], tokens));
+      } else {
+        ORT_RETURN_IF_ERROR(SplitByExpression(text, *separators_[i], tokens));
+      }
+    }
+    // Replace the row with the results of this tokenezation
+    row.swap(tokens);
   }
 
-  output_dims.push_back(max_tokens);
-  TensorShape output_shape(output_dims);
+  block.tokens.insert(block.tokens.end(), row.begin(), row.end());
+  return Status::OK();
+}
 
-  auto output_tensor = ctx->Output(0, output_shape);
-  auto const output_data = output_tensor->template MutableData<std::string>();
+Status Tokenizer::TokenExpression(const std::string& s, TokenBlock& block) const {
+  using namespace re2;
+  // We do not constraint the search to match
+  // on the beginning or end of the string
+  const RE2::Anchor anchor = RE2::UNANCHORED;
 
-#ifdef _DEBUG
-  const size_t max_output_index = N * C * max_tokens;
-#endif
-  curr_input = input_data;
-  size_t output_index = 0;
-  for (const auto& row : tokens) {
-    assert(curr_input != last);
-#ifdef _DEBUG
-    size_t c_idx = output_index;
-#endif
-    if (mark_) {
-      (output_data + output_index)->assign(&start_text, 1);
-      ++output_index;
-    }
-    // Output tokens for this row
-    for (const auto& token : row) {
-      (output_data + output_index)->assign(token.data(), token.length());
-      ++output_index;
-    }
-    if (mark_) {
-      (output_data + output_index)->assign(&end_text, 1);
-      ++output_index;
-    }
-    const size_t pads = max_tokens - (mark_ * 2) - row.size();
-    for (size_t p = 0; p < pads; ++p) {
-      *(output_data + output_index) = pad_value_;
-      ++output_index;
+  StringPiece text(s);
+  const auto end_pos = s.length();
+  size_t start_pos = 0;
+  StringPiece submatch;
+
+  bool match = true;
+  do {
+    match = regex_->Match(text, start_pos, end_pos, anchor, &submatch, 1);
+    if (match) {
+      // Record  pos/len
+      assert(submatch.data() != nullptr);
+      size_t match_pos = submatch.data() - s.data();
+      assert(match_pos >= start_pos);
+      // Guard against empty match and make
+      // sure we make progress either way
+      auto token_len = submatch.length();
+      size_t utf8_chars = 0;
+      if (!utf8_len(reinterpret_cast<const unsigned char*>(submatch.data()), token_len, utf8_chars)) {
+        return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
+                      "Match contains invalid utf8 chars: " + submatch.as_string());
+      }
+      if (utf8_chars >= size_t(mincharnum_)) {
+        block.tokens.push_back(submatch);
+        start_pos = match_pos + token_len;
+      } else {
+        size_t bytes = 0;
+        utf8_bytes(*submatch.data(), bytes);
+        start_pos = match_pos + bytes;
+      }
     }
-#ifdef _DEBUG
-    assert(output_index <= max_output_index);
-    assert((output_index - c_idx) <= max_tokens);
-#endif
-    ++curr_input;
-  }
-
+  } while (match);
   return Status::OK();
 }
 
@@ -498,13 +446,19 @@ Status Tokenizer::Compute(OpKernelContext* ctx) const {
   }
 
   if (char_tokenezation_) {
-    s = CharTokenize(ctx, N, C, input_dims);
+    s = TokenizeRows(ctx, N, C, input_dims, [this](const std::string& str, TokenBlock& block) {
+      return CharTokenize(str, block);
+    });
   } else {
     if (!separators_.empty()) {
-      s = SeparatorExpressionTokenizer(ctx, N, C, input_dims);
+      s = TokenizeRows(ctx, N, C, input_dims, [this](const std::string& str, TokenBlock& block) {
+        return SeparatorExpressionTokenizer(str, block);
+      });
     } else {
       assert(regex_ != nullptr);
-      s = TokenExpression(ctx, N, C, input_dims);
+      s = TokenizeRows(ctx, N, C, input_dims, [this](const std::string& str, TokenBlock& block) {
+        return TokenExpression(str, block);
+      });
     }
   }
   return s;
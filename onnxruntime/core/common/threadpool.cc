@@ -3,8 +3,19 @@
 
 #include "core/platform/threadpool.h"
 #include "core/common/common.h"
+#include "core/platform/env.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <chrono>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#include <emmintrin.h>
+#define ORT_CPU_RELAX() _mm_pause()
+#else
+#define ORT_CPU_RELAX()
+#endif
 
 #if defined(__GNUC__)
 #pragma GCC diagnostic push
@@ -25,12 +36,90 @@ using Eigen::Barrier;
 namespace onnxruntime {
 
 namespace concurrency {
+// Spin state of the pool the calling thread belongs to, nullptr if it isn't a pool thread.
+static thread_local const void* current_pool_spin_state = nullptr;
+
+//
+// ThreadPool::Environment
+//
+ThreadPool::Environment::EnvThread* ThreadPool::Environment::CreateThread(std::function<void()> f) {
+  const void* spin_state = spin_state_;
+  const auto& affinities = thread_options_->affinities;
+  if (affinities.empty()) {
+    return new EnvThread([spin_state, f]() {
+      current_pool_spin_state = spin_state;
+      f();
+    });
+  }
+
+  const std::vector<size_t>& affinity = affinities[next_thread_index_++ % affinities.size()];
+  return new EnvThread([spin_state, affinity, f]() {
+    current_pool_spin_state = spin_state;
+    // Affinity is a placement hint only; if the platform rejects it the thread simply runs unpinned.
+    Env::Default().SetThreadAffinity(affinity).IsOK();
+    f();
+  });
+}
+
+ThreadPool::Environment::Task ThreadPool::Environment::CreateTask(std::function<void()> f) {
+  if (thread_options_->spin_duration_us > 0) {
+    spin_state_->pending_tasks.fetch_add(1, std::memory_order_relaxed);
+  }
+  return Task{std::move(f)};
+}
+
+void ThreadPool::Environment::ExecuteTask(const Task& t) {
+  if (thread_options_->spin_duration_us <= 0) {
+    t.f();
+    return;
+  }
+
+  spin_state_->pending_tasks.fetch_sub(1, std::memory_order_relaxed);
+  t.f();
+  // Eigen runs a task on the thread that schedules it when the queue is full. That thread has its own work to get
+  // back to, so only the threads of the pool spin.
+  if (current_pool_spin_state == spin_state_) {
+    SpinForWork();
+  }
+}
+
+void ThreadPool::Environment::SpinForWork() const {
+  // The clock is only read every few iterations as it is much more expensive than polling the counter.
+  constexpr unsigned kIterationsPerClockCheck = 256;
+  const auto deadline = std::chrono::steady_clock::now() +
+                        std::chrono::microseconds(thread_options_->spin_duration_us);
+  for (unsigned iteration = 1;; ++iteration) {
+    // Returning lets the Eigen worker loop pick up the new task from the queues without blocking.
+    if (spin_state_->pending_tasks.load(std::memory_order_relaxed) > 0 ||
+        spin_state_->shutting_down.load(std::memory_order_relaxed)) {
+      return;
+    }
+    if (iteration % kIterationsPerClockCheck == 0 && std::chrono::steady_clock::now() >= deadline) {
+      return;
+    }
+    ORT_CPU_RELAX();
+  }
+}
+
 //
 // ThreadPool
 //
-ThreadPool::ThreadPool(const std::string&, int num_threads) : impl_(num_threads) {}
+ThreadPool::ThreadPool(const std::string&, int num_threads, const ThreadOptions& thread_options)
+    : thread_options_(thread_options),
+      owned_impl_(new Eigen::ThreadPoolTempl<Environment>(num_threads, Environment(thread_options_, spin_state_))),
+      impl_(owned_impl_.get()),
+      num_threads_(owned_impl_->NumThreads()) {}
 
-void ThreadPool::Schedule(std::function<void()> fn) { impl_.Schedule(fn); }
+ThreadPool::ThreadPool(ThreadPool& shared_pool, int num_threads)
+    : impl_(shared_pool.impl_),
+      num_threads_(num_threads > 0 ? std::min(num_threads, shared_pool.NumThreads()) : shared_pool.NumThreads()) {}
+
+ThreadPool::~ThreadPool() {
+  // Stop threads from spinning so that shutting down the Eigen pool isn't delayed by the spin duration.
+  spin_state_.shutting_down.store(true, std::memory_order_relaxed);
+}
+
+void ThreadPool::Schedule(std::function<void()> fn) { impl_->Schedule(fn); }
 
 void ThreadPool::ParallelFor(int32_t total, std::function<void(int32_t)> fn) {
   if (total <= 0)
@@ -41,20 +130,27 @@ void ThreadPool::ParallelFor(int32_t total, std::function<void(int32_t)> fn) {
     return;
   }
 
-  // TODO: Eigen supports a more efficient ThreadPoolDevice mechanism
-  // We will simply rely on the work queue and stealing in the short term.
-  Barrier barrier(static_cast<unsigned int>(total - 1));
-  std::function<void(int32_t)> handle_iteration = [&barrier, &fn](int iteration) {
-    fn(iteration);
-    barrier.Notify();
-  };
+  // Each iteration is assumed to be expensive enough to be worth its own block, so hand them out one at a time.
+  // Only one task per helper thread is scheduled; the helpers then claim iterations from a shared counter.
+  RunInParallel(total, [&fn](std::ptrdiff_t iteration) { fn(static_cast<int32_t>(iteration)); });
+}
+
+void ThreadPool::ParallelFor(std::ptrdiff_t total, double cost_per_unit,
+                             const std::function<void(std::ptrdiff_t first, std::ptrdiff_t last)>& fn) {
+  if (total <= 0)
+    return;
 
-  for (int32_t id = 1; id < total; ++id) {
-    Schedule([=, &handle_iteration]() { handle_iteration(id); });
+  const std::ptrdiff_t num_blocks = CalculateNumBlocks(total, cost_per_unit);
+  if (num_blocks <= 1) {
+    fn(0, total);
+    return;
   }
 
-  fn(0);
-  barrier.Wait();
+  const std::ptrdiff_t block_size = (total + num_blocks - 1) / num_blocks;
+  RunInParallel((total + block_size - 1) / block_size, [block_size, total, &fn](std::ptrdiff_t block) {
+    const std::ptrdiff_t first = block * block_size;
+    fn(first, std::min(total, first + block_size));
+  });
 }
 
 void ThreadPool::BatchParallelFor(int32_t total, std::function<void(int32_t)> fn, int32_t num_batches) {
@@ -89,24 +185,66 @@ void ThreadPool::BatchParallelFor(int32_t total, std::function<void(int32_t)> fn
 
 void ThreadPool::ParallelForRange(int64_t first, int64_t last, std::function<void(int64_t, int64_t)> fn) {
   if (last <= first) return;
-  if (last - first == 1) {
+
+  // The cost of a single unit is unknown, so split the range evenly across all available threads.
+  const std::ptrdiff_t total = static_cast<std::ptrdiff_t>(last - first);
+  const std::ptrdiff_t num_blocks = std::min<std::ptrdiff_t>(total, NumThreads() + 1);
+  if (num_blocks <= 1) {
     fn(first, last);
     return;
   }
 
-  // TODO: Eigen supports a more efficient ThreadPoolDevice mechanism
-  // We will simply rely on the work queue and stealing in the short term.
-  Barrier barrier(static_cast<unsigned int>(last - first));
-  std::function<void(int64_t, int64_t)> handle_range = [&barrier, &fn](int64_t first, int64_t last) {
-    fn(first, last);
-    barrier.Notify();
+  RunInParallel(num_blocks, [first, total, num_blocks, &fn](std::ptrdiff_t block) {
+    fn(first + block * total / num_blocks, first + (block + 1) * total / num_blocks);
+  });
+}
+
+std::ptrdiff_t ThreadPool::CalculateNumBlocks(std::ptrdiff_t total, double cost_per_unit) const {
+  // Blocks cheaper than this (in cycles) are merged, as the cost of handing a block to another thread
+  // would be a significant fraction of the work done for it.
+  constexpr double kMinCostPerBlock = 20000.0;
+  // Creating a few blocks per thread lets threads that finish early pick up the remaining blocks of
+  // slower threads instead of idling.
+  constexpr std::ptrdiff_t kBlocksPerThread = 4;
+
+  const std::ptrdiff_t degree_of_parallelism = static_cast<std::ptrdiff_t>(NumThreads()) + 1;
+  if (degree_of_parallelism <= 1 || total <= 1) {
+    return 1;
+  }
+
+  std::ptrdiff_t num_blocks = std::min(total, degree_of_parallelism * kBlocksPerThread);
+  const double total_cost = static_cast<double>(total) * std::max(cost_per_unit, 0.0);
+  if (total_cost < kMinCostPerBlock * static_cast<double>(num_blocks)) {
+    num_blocks = static_cast<std::ptrdiff_t>(total_cost / kMinCostPerBlock);
+  }
+
+  return std::max<std::ptrdiff_t>(num_blocks, 1);
+}
+
+void ThreadPool::RunInParallel(std::ptrdiff_t num_blocks, const std::function<void(std::ptrdiff_t block)>& fn) {
+  // Blocks are claimed from a shared counter by the calling thread and by at most one helper task per
+  // pool thread, so a thread that finishes its block early steals the next unclaimed one.
+  std::atomic<std::ptrdiff_t> next_block{0};
+  auto run_blocks = [&next_block, num_blocks, &fn]() {
+    for (;;) {
+      const std::ptrdiff_t block = next_block.fetch_add(1, std::memory_order_relaxed);
+      if (block >= num_blocks) {
+        break;
+      }
+      fn(block);
+    }
   };
 
-  for (int64_t id = first + 1; id <= last; ++id) {
-    Schedule([=, &handle_range]() { handle_range(id, id + 1); });
+  const std::ptrdiff_t num_helpers = std::min<std::ptrdiff_t>(num_blocks - 1, NumThreads());
+  Barrier barrier(static_cast<unsigned int>(num_helpers));
+  for (std::ptrdiff_t i = 0; i < num_helpers; ++i) {
+    Schedule([&run_blocks, &barrier]() {
+      run_blocks();
+      barrier.Notify();
+    });
   }
 
-  fn(first, first + 1);
+  run_blocks();
   barrier.Wait();
 }
 
@@ -114,8 +252,8 @@ void ThreadPool::ParallelForRange(int64_t first, int64_t last, std::function<voi
 //   impl_->SetStealPartitions(partitions);
 // }
 
-int ThreadPool::NumThreads() const { return impl_.NumThreads(); }
+int ThreadPool::NumThreads() const { return num_threads_; }
 
-int ThreadPool::CurrentThreadId() const { return impl_.CurrentThreadId(); }
+int ThreadPool::CurrentThreadId() const { return impl_->CurrentThreadId(); }
 }  // namespace concurrency
 }  // namespace onnxruntime
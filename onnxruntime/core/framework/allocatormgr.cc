@@ -4,6 +4,7 @@
 #include "core/framework/allocatormgr.h"
 #include "core/framework/bfc_arena.h"
 #include "core/framework/mimalloc_arena.h"
+#include "core/framework/thread_caching_arena.h"
 #include <mutex>
 #include <sstream>
 #include <unordered_map>
@@ -11,19 +12,24 @@
 
 namespace onnxruntime {
 
-#ifdef USE_MIMALLOC
-  using TArenaAllocator = MiMallocArena;
-#else
-  using TArenaAllocator = BFCArena;
-#endif
-
 using namespace ::onnxruntime::common;
 
 AllocatorPtr CreateAllocator(DeviceAllocatorRegistrationInfo info, int device_id) {
   auto device_allocator = std::unique_ptr<IDeviceAllocator>(info.factory(device_id));
   if (device_allocator->AllowsArena()) {
-    return std::shared_ptr<IArenaAllocator>(
-          onnxruntime::make_unique<TArenaAllocator>(std::move(device_allocator), info.max_mem));
+#ifdef USE_MIMALLOC
+    std::unique_ptr<IArenaAllocator> arena =
+        onnxruntime::make_unique<MiMallocArena>(std::move(device_allocator), info.max_mem);
+#else
+    std::unique_ptr<IArenaAllocator> arena =
+        onnxruntime::make_unique<BFCArena>(std::move(device_allocator), info.max_mem, info.arena_extend_strategy,
+                                           info.arena_initial_chunk_size_bytes);
+#endif
+    if (info.arena_thread_cache_max_bytes > 0) {
+      arena = onnxruntime::make_unique<ThreadCachingArena>(std::move(arena), info.arena_thread_cache_max_bytes);
+    }
+
+    return std::shared_ptr<IArenaAllocator>(std::move(arena));
   }
 
   return AllocatorPtr(std::move(device_allocator));
@@ -14,6 +14,11 @@ struct DeviceAllocatorRegistrationInfo {
   OrtMemType mem_type;
   DeviceAllocatorFactory factory;
   size_t max_mem;
+  ArenaExtendStrategy arena_extend_strategy = ArenaExtendStrategy::kNextPowerOfTwo;
+  size_t arena_initial_chunk_size_bytes = ArenaConfig::kDefaultInitialChunkSizeBytes;
+  // if non-zero, put a per-thread cache of freed blocks holding up to this many bytes in front of the arena.
+  // see ThreadCachingArena.
+  size_t arena_thread_cache_max_bytes = 0;
 };
 
 AllocatorPtr CreateAllocator(DeviceAllocatorRegistrationInfo info, int device_id = 0);
@@ -7,6 +7,7 @@
 
 #include "core/common/common.h"
 #include "core/framework/allocator.h"
+#include "core/framework/arena_config.h"
 
 namespace onnxruntime {
 // The interface for arena which manage memory allocations
@@ -27,6 +28,11 @@ class IArenaAllocator : public IAllocator {
   virtual size_t Used() const = 0;
   virtual size_t Max() const = 0;
   const OrtMemoryInfo& Info() const override = 0;
+  // Return the memory the arena holds but doesn't use to the device.
+  // Shrink call need to be thread safe. Arenas that don't pool memory have nothing to release.
+  virtual Status Shrink() { return Status::OK(); }
+  // The limit and growth settings the arena was created with. Arenas without any report the defaults.
+  virtual ArenaConfig GetConfig() const { return ArenaConfig(); }
   // allocate host pinned memory?
 };
 
@@ -0,0 +1,32 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace onnxruntime {
+
+// How an arena sizes the regions it allocates from the device when it runs out of memory.
+enum class ArenaExtendStrategy : int32_t {
+  // each new region is double the size of the previous one (and large enough for the request).
+  // fewer, larger regions. best when memory is plentiful and the peak is reached quickly.
+  kNextPowerOfTwo = 0,
+  // each new region is exactly the size of the request that could not be satisfied.
+  // keeps the footprint close to the actual usage, at the cost of more regions.
+  kSameAsRequested = 1,
+};
+
+// Configuration for an arena allocator.
+struct ArenaConfig {
+  static constexpr size_t kDefaultInitialChunkSizeBytes = 1 << 20;
+
+  // maximum number of bytes the arena may allocate from the device. 0 means no limit.
+  size_t max_mem = 0;
+  ArenaExtendStrategy extend_strategy = ArenaExtendStrategy::kNextPowerOfTwo;
+  // size of the first region allocated from the device.
+  size_t initial_chunk_size_bytes = kDefaultInitialChunkSizeBytes;
+};
+
+}  // namespace onnxruntime
@@ -5,12 +5,17 @@
 
 namespace onnxruntime {
 BFCArena::BFCArena(std::unique_ptr<IDeviceAllocator> resource_allocator,
-                   size_t total_memory)
-    : device_allocator_(std::move(resource_allocator)),
+                   size_t total_memory,
+                   ArenaExtendStrategy arena_extend_strategy,
+                   size_t initial_chunk_size_bytes)
+    : arena_extend_strategy_(arena_extend_strategy),
+      device_allocator_(std::move(resource_allocator)),
       free_chunks_list_(kInvalidChunkHandle),
       next_allocation_id_(1),
       info_(device_allocator_->Info().name, OrtAllocatorType::OrtArenaAllocator, device_allocator_->Info().device, device_allocator_->Info().id, device_allocator_->Info().mem_type) {
-  curr_region_allocation_bytes_ = RoundedBytes(std::min(total_memory, size_t{1048576}));
+  ORT_ENFORCE(initial_chunk_size_bytes > 0, "initial_chunk_size_bytes must be positive");
+  initial_region_allocation_bytes_ = RoundedBytes(std::min(total_memory, initial_chunk_size_bytes));
+  curr_region_allocation_bytes_ = initial_region_allocation_bytes_;
 
   // Allocate the requested amount of memory.
   memory_limit_ = total_memory;
@@ -64,17 +69,25 @@ bool BFCArena::Extend(size_t rounded_bytes) {
     return false;
   }
 
-  // If curr_region_allocation_bytes_ is not enough to satisfy the
-  // allocation, keep multiplying by a power of two until that is
-  // sufficient.
   bool increased_allocation = false;
-  while (rounded_bytes > curr_region_allocation_bytes_) {
-    curr_region_allocation_bytes_ *= 2;
-    increased_allocation = true;
+  size_t bytes = 0;
+  if (arena_extend_strategy_ == ArenaExtendStrategy::kSameAsRequested && !region_manager_.regions().empty()) {
+    // Allocate exactly what is needed. Only the first region uses the initial chunk size.
+    bytes = rounded_bytes;
+  } else {
+    // If curr_region_allocation_bytes_ is not enough to satisfy the
+    // allocation, keep multiplying by a power of two until that is
+    // sufficient.
+    while (rounded_bytes > curr_region_allocation_bytes_) {
+      curr_region_allocation_bytes_ *= 2;
+      increased_allocation = true;
+    }
+
+    bytes = curr_region_allocation_bytes_;
   }
 
   // Try allocating.
-  size_t bytes = std::min(curr_region_allocation_bytes_, available_bytes);
+  bytes = std::min(bytes, available_bytes);
   auto safe_alloc = [this](size_t alloc_bytes) {
     void* new_mem = nullptr;
     try {
@@ -107,7 +120,7 @@ bool BFCArena::Extend(size_t rounded_bytes) {
   }
 
   // we allocated the same number of bytes as the current region, so we have 2x that now
-  if (!increased_allocation) {
+  if (arena_extend_strategy_ == ArenaExtendStrategy::kNextPowerOfTwo && !increased_allocation) {
     curr_region_allocation_bytes_ *= 2;
   }
 
@@ -191,6 +204,38 @@ void* BFCArena::Reserve(size_t size) {
   return ptr;
 }
 
+Status BFCArena::Shrink() {
+  std::lock_guard<OrtMutex> lock(lock_);
+
+  // A region is unused when it consists of a single free chunk. Chunks never span regions.
+  std::vector<std::pair<void*, size_t>> unused_regions;
+  for (const auto& region : region_manager_.regions()) {
+    const Chunk* c = ChunkFromHandle(region_manager_.get_handle(region.ptr()));
+    if (!c->in_use() && c->size == region.memory_size()) {
+      unused_regions.emplace_back(region.ptr(), region.memory_size());
+    }
+  }
+
+  for (const auto& region : unused_regions) {
+    ChunkHandle h = region_manager_.get_handle(region.first);
+    RemoveFreeChunkFromBin(h);
+    DeleteChunk(h);
+    region_manager_.RemoveAllocationRegion(region.first);
+    device_allocator_->Free(region.first);
+    stats_.total_allocated_bytes -= region.second;
+
+    LOGS_DEFAULT(INFO) << "Freed region of " << region.second << " bytes at " << region.first;
+  }
+
+  if (!unused_regions.empty()) {
+    // grow from the initial size again so a single large request doesn't inflate all future regions
+    curr_region_allocation_bytes_ = initial_region_allocation_bytes_;
+    LOGS_DEFAULT(INFO) << "Total allocated bytes after shrinking: " << stats_.total_allocated_bytes;
+  }
+
+  return Status::OK();
+}
+
 size_t BFCArena::RequestedSize(const void* ptr) {
   std::lock_guard<OrtMutex> lock(lock_);
   BFCArena::ChunkHandle h = region_manager_.get_handle(ptr);
@@ -48,7 +48,10 @@ namespace onnxruntime {
 // all requests to allocate memory go through this interface.
 class BFCArena : public IArenaAllocator {
  public:
-  BFCArena(std::unique_ptr<IDeviceAllocator> resource_allocator, size_t total_memory);
+  BFCArena(std::unique_ptr<IDeviceAllocator> resource_allocator,
+           size_t total_memory,
+           ArenaExtendStrategy arena_extend_strategy = ArenaExtendStrategy::kNextPowerOfTwo,
+           size_t initial_chunk_size_bytes = ArenaConfig::kDefaultInitialChunkSizeBytes);
 
   ~BFCArena() override;
 
@@ -62,6 +65,9 @@ class BFCArena : public IArenaAllocator {
 
   void* Reserve(size_t size) override;
 
+  // Frees the regions in which no chunk is in use, returning their memory to the device allocator.
+  Status Shrink() override;
+
   size_t Used() const override {
     return stats_.bytes_in_use;
   }
@@ -70,6 +76,14 @@ class BFCArena : public IArenaAllocator {
     return memory_limit_;
   }
 
+  ArenaConfig GetConfig() const override {
+    ArenaConfig config;
+    config.max_mem = memory_limit_;
+    config.extend_strategy = arena_extend_strategy_;
+    config.initial_chunk_size_bytes = initial_region_allocation_bytes_;
+    return config;
+  }
+
   const OrtMemoryInfo& Info() const override {
     return info_;
   }
@@ -271,6 +285,14 @@ class BFCArena : public IArenaAllocator {
       regions_.insert(entry, AllocationRegion(ptr, memory_size));
     }
 
+    void RemoveAllocationRegion(void* ptr) {
+      auto entry =
+          std::upper_bound(regions_.begin(), regions_.end(), ptr, &Comparator);
+      ORT_ENFORCE(entry != regions_.end() && entry->ptr() == ptr,
+                  "Could not find Region for ", ptr);
+      regions_.erase(entry);
+    }
+
     ChunkHandle get_handle(const void* p) const {
       return RegionFor(p)->get_handle(p);
     }
@@ -422,6 +444,11 @@ class BFCArena : public IArenaAllocator {
   // The size of the current region allocation.
   size_t curr_region_allocation_bytes_;
 
+  // The size of the first region allocation. Used again after the arena shrinks.
+  size_t initial_region_allocation_bytes_;
+
+  const ArenaExtendStrategy arena_extend_strategy_;
+
   std::unique_ptr<IDeviceAllocator> device_allocator_;
 
   mutable OrtMutex lock_;
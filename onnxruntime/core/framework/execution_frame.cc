@@ -173,7 +173,6 @@ ExecutionFrame::ExecutionFrame(const std::vector<int>& feed_mlvalue_idxs, const
     : IExecutionFrame(feed_mlvalue_idxs, feeds, session_state.GetInitializedTensors(), fetch_mlvalue_idxs, fetches,
                       session_state.GetOrtValueNameIdxMap(), session_state.GetNodeIndexInfo()),
       session_state_(session_state),
-      mem_patterns_(nullptr),
       planner_(nullptr) {
   // map the custom allocators to ort_value_idx entries
   if (!fetch_allocators.empty()) {
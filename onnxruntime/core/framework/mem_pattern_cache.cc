@@ -0,0 +1,213 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/mem_pattern_cache.h"
+
+#include <limits>
+
+namespace onnxruntime {
+
+constexpr size_t MemoryPatternCache::kDefaultCapacity;
+constexpr size_t MemoryPatternCache::kReaderStripes;
+
+MemoryPatternCache::Entry::Entry(const InputShapes& input_shapes,
+                                 std::shared_ptr<const MemoryPatternGroup> patterns,
+                                 uint64_t epoch)
+    : shapes([&input_shapes]() {
+        std::vector<std::vector<int64_t>> result;
+        result.reserve(input_shapes.size());
+        for (const auto& shape : input_shapes) {
+          result.push_back(shape.get().GetDims());
+        }
+        return result;
+      }()),
+      mem_patterns(std::move(patterns)),
+      last_used(epoch) {
+}
+
+bool MemoryPatternCache::Entry::Matches(const InputShapes& input_shapes) const {
+  if (shapes.size() != input_shapes.size()) {
+    return false;
+  }
+
+  for (size_t i = 0; i < shapes.size(); ++i) {
+    if (shapes[i] != input_shapes[i].get().GetDims()) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+MemoryPatternCache::MemoryPatternCache(size_t capacity)
+    : capacity_(capacity), table_(new Table()) {
+}
+
+MemoryPatternCache::~MemoryPatternCache() {
+  // no reader is left, the replaced tables are freed with retired_tables_ and expiring_tables_
+  delete table_.load();
+}
+
+MemoryPatternCache::ReaderStripe& MemoryPatternCache::GetReaderStripe() const {
+  static std::atomic<size_t> next_stripe{0};
+  static thread_local const size_t stripe = next_stripe.fetch_add(1, std::memory_order_relaxed) % kReaderStripes;
+  return readers_[stripe];
+}
+
+size_t MemoryPatternCache::Hash(const InputShapes& input_shapes) {
+  // include the rank of each shape so that e.g. {2, 3} and {2}, {3} hash differently
+  size_t hash = input_shapes.size();
+  const auto combine = [&hash](size_t value) {
+    hash ^= value + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+  };
+
+  for (const auto& shape : input_shapes) {
+    const auto& dims = shape.get().GetDims();
+    combine(dims.size());
+    for (auto dim : dims) {
+      combine(static_cast<size_t>(dim));
+    }
+  }
+
+  return hash;
+}
+
+std::shared_ptr<const MemoryPatternGroup> MemoryPatternCache::Find(const InputShapes& input_shapes) const {
+  ReaderStripe& stripe = GetReaderStripe();
+  if (capacity_ == 0) {
+    stripe.misses.fetch_add(1, std::memory_order_relaxed);
+    return nullptr;
+  }
+
+  const size_t hash = Hash(input_shapes);
+  std::shared_ptr<const MemoryPatternGroup> result;
+
+  // announce the reader before loading the table, so that the writer replacing it either sees the reader or
+  // the reader loads the new table. a reader that counted itself in a phase that was flipped meanwhile counts
+  // itself again, so that the counters of the previous phase only decrease once it was flipped.
+  size_t phase = phase_.load();
+  stripe.active[phase].fetch_add(1);
+  for (size_t current = phase_.load(); current != phase; current = phase_.load()) {
+    stripe.active[current].fetch_add(1);
+    stripe.active[phase].fetch_sub(1);
+    phase = current;
+  }
+  const Table* table = table_.load();
+  auto range = table->equal_range(hash);
+  for (auto it = range.first; it != range.second; ++it) {
+    const Entry& entry = *it->second;
+    if (entry.Matches(input_shapes)) {
+      // only write the entry when it wasn't already marked since the last insert
+      const uint64_t epoch = epoch_.load(std::memory_order_relaxed);
+      if (entry.last_used.load(std::memory_order_relaxed) != epoch) {
+        entry.last_used.store(epoch, std::memory_order_relaxed);
+      }
+      // the entry may be evicted once we stop reading the table, but the patterns are kept alive by the result
+      result = entry.mem_patterns;
+      break;
+    }
+  }
+  stripe.active[phase].fetch_sub(1, std::memory_order_release);
+
+  (result ? stripe.hits : stripe.misses).fetch_add(1, std::memory_order_relaxed);
+
+  // free the replaced tables this reader may have been the last one to use, unless a writer is already at it
+  if (num_retired_tables_.load(std::memory_order_relaxed) != 0) {
+    std::unique_lock<OrtMutex> lock(write_lock_, std::try_to_lock);
+    if (lock.owns_lock()) {
+      FreeRetiredTables();
+    }
+  }
+
+  return result;
+}
+
+void MemoryPatternCache::Insert(const InputShapes& input_shapes, std::unique_ptr<MemoryPatternGroup> mem_patterns) {
+  if (capacity_ == 0 || !mem_patterns) {
+    return;
+  }
+
+  const size_t hash = Hash(input_shapes);
+
+  std::lock_guard<OrtMutex> lock(write_lock_);
+
+  // we're the only writer so this is the latest table
+  const Table* current = table_.load(std::memory_order_relaxed);
+  auto range = current->equal_range(hash);
+  for (auto it = range.first; it != range.second; ++it) {
+    if (it->second->Matches(input_shapes)) {
+      return;
+    }
+  }
+
+  std::unique_ptr<Table> updated(new Table(*current));
+
+  if (updated->size() >= capacity_) {
+    auto lru = updated->end();
+    uint64_t oldest = std::numeric_limits<uint64_t>::max();
+    for (auto it = updated->begin(); it != updated->end(); ++it) {
+      const uint64_t last_used = it->second->last_used.load(std::memory_order_relaxed);
+      if (last_used < oldest) {
+        oldest = last_used;
+        lru = it;
+      }
+    }
+
+    updated->erase(lru);
+    evictions_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  // hits after this insert are more recent than the ones before it
+  const uint64_t epoch = epoch_.load(std::memory_order_relaxed);
+  updated->emplace(hash, std::make_shared<const Entry>(input_shapes,
+                                                       std::shared_ptr<const MemoryPatternGroup>(std::move(mem_patterns)),
+                                                       epoch));
+  epoch_.store(epoch + 1, std::memory_order_relaxed);
+  size_.store(updated->size(), std::memory_order_relaxed);
+
+  table_.store(updated.release());
+  retired_tables_.emplace_back(current);
+  FreeRetiredTables();
+}
+
+void MemoryPatternCache::FreeRetiredTables() const {
+  while (!expiring_tables_.empty() || !retired_tables_.empty()) {
+    if (!expiring_tables_.empty()) {
+      // A reader that saw an expiring table started before the phase was flipped, so it is counted in the previous
+      // phase until it's done. The readers that start after the flip only load later tables, and the counters of the
+      // previous phase only decrease, so each stripe can be checked on its own.
+      const size_t previous_phase = 1 - phase_.load(std::memory_order_relaxed);
+      for (const auto& stripe : readers_) {
+        if (stripe.active[previous_phase].load() != 0) {
+          // try again when a reader exits or at the next insert
+          num_retired_tables_.store(expiring_tables_.size() + retired_tables_.size(), std::memory_order_relaxed);
+          return;
+        }
+      }
+      expiring_tables_.clear();
+    }
+
+    // the readers of the previous phase are done, so the phase can be flipped to wait for the readers of the
+    // tables replaced since the last flip
+    if (!retired_tables_.empty()) {
+      expiring_tables_.swap(retired_tables_);
+      phase_.store(1 - phase_.load(std::memory_order_relaxed));
+    }
+  }
+
+  num_retired_tables_.store(0, std::memory_order_relaxed);
+}
+
+MemoryPatternCache::Stats MemoryPatternCache::GetStats() const {
+  Stats stats{};
+  for (const auto& stripe : readers_) {
+    stats.hits += stripe.hits.load(std::memory_order_relaxed);
+    stats.misses += stripe.misses.load(std::memory_order_relaxed);
+  }
+  stats.evictions = evictions_.load(std::memory_order_relaxed);
+  stats.size = size_.load(std::memory_order_relaxed);
+  stats.retired_tables = num_retired_tables_.load(std::memory_order_relaxed);
+  return stats;
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,135 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/framework/mem_pattern.h"
+#include "core/framework/tensor_shape.h"
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+
+/**
+ * Bounded cache of the memory patterns generated for a session, keyed by the shapes of the feeds.
+ *
+ * Lookups happen on every Run and don't take a lock: readers load the current table through an atomic pointer
+ * and never block each other or an insert in progress. Inserts are rare (one per new set of input shapes), so they
+ * copy the table, modify the copy under a writer lock and publish it (copy-on-write). A replaced table is freed
+ * once no reader can still be using it. Readers announce themselves on one of a few stripes of counters, each on
+ * its own cache line, and count themselves in the counter of the current phase. To free the replaced tables the
+ * phase is flipped: new readers count themselves in the other counter and can only load the latest table, so the
+ * replaced tables are freed once the counters of the previous phase drain. This is checked at each insert and when a
+ * reader exits while tables are waiting to be freed, so they are freed under steady lookup traffic and after the
+ * inserts stop.
+ *
+ * When the cache is full the least recently used entry is evicted. Recency is tracked at the granularity of
+ * inserts: a hit marks its entry with the number of inserts so far, which only writers advance, so readers never
+ * write to a location shared by all of them. Entries are handed out as shared_ptr so an evicted pattern stays
+ * alive until the last Run using it completes.
+ */
+class MemoryPatternCache {
+ public:
+  using InputShapes = std::vector<std::reference_wrapper<const TensorShape>>;
+
+  static constexpr size_t kDefaultCapacity = 64;
+
+  struct Stats {
+    size_t hits;
+    size_t misses;
+    size_t evictions;
+    size_t size;
+    // replaced tables that readers may still be using
+    size_t retired_tables;
+  };
+
+  // capacity of 0 disables caching: every Find is a miss and Insert is a no-op.
+  explicit MemoryPatternCache(size_t capacity = kDefaultCapacity);
+  ~MemoryPatternCache();
+
+  /** Return the cached patterns for the input shapes, or nullptr if there are none. */
+  std::shared_ptr<const MemoryPatternGroup> Find(const InputShapes& input_shapes) const;
+
+  /**
+  Add patterns for the input shapes. If an entry for the shapes already exists (e.g. another Run generated
+  the patterns concurrently) the existing entry is kept.
+  */
+  void Insert(const InputShapes& input_shapes, std::unique_ptr<MemoryPatternGroup> mem_patterns);
+
+  size_t Capacity() const { return capacity_; }
+
+  Stats GetStats() const;
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(MemoryPatternCache);
+
+  struct Entry {
+    Entry(const InputShapes& input_shapes, std::shared_ptr<const MemoryPatternGroup> patterns, uint64_t epoch);
+
+    bool Matches(const InputShapes& input_shapes) const;
+
+    // full copy of the shapes, compared on every hit so a hash collision never returns patterns for other shapes
+    const std::vector<std::vector<int64_t>> shapes;
+    const std::shared_ptr<const MemoryPatternGroup> mem_patterns;
+    // insert epoch of the last hit. used to pick the LRU entry when evicting.
+    mutable std::atomic<uint64_t> last_used;
+  };
+
+  // entries with colliding hashes are all kept and told apart by their shapes. immutable once published.
+  using Table = std::unordered_multimap<size_t, std::shared_ptr<const Entry>>;
+
+  // counters of the readers that use it, on a cache line of their own
+  struct ReaderStripe {
+    // readers in progress, counted in the counter of the phase they started in
+    std::atomic<size_t> active[2];
+    std::atomic<size_t> hits{0};
+    std::atomic<size_t> misses{0};
+    char padding[64 - 4 * sizeof(std::atomic<size_t>)];
+
+    ReaderStripe() {
+      active[0] = 0;
+      active[1] = 0;
+    }
+  };
+
+  static constexpr size_t kReaderStripes = 16;
+
+  static size_t Hash(const InputShapes& input_shapes);
+
+  // stripe of the calling thread
+  ReaderStripe& GetReaderStripe() const;
+
+  // frees the replaced tables that no reader can be using, and flips the phase to start waiting for the others.
+  // called with write_lock_ held.
+  void FreeRetiredTables() const;
+
+  const size_t capacity_;
+
+  // current table. replaced tables are kept until no reader can be using them.
+  std::atomic<const Table*> table_;
+  mutable ReaderStripe readers_[kReaderStripes];
+  // counter of the stripes that new readers count themselves in. changed by writers only.
+  mutable std::atomic<size_t> phase_{0};
+
+  // serializes writers. readers only try to take it to free the replaced tables.
+  mutable OrtMutex write_lock_;
+  // tables replaced since the last flip of the phase
+  mutable std::vector<std::unique_ptr<const Table>> retired_tables_;  // GUARDED_BY(write_lock_)
+  // tables replaced before the last flip, freed once the readers of the previous phase are done
+  mutable std::vector<std::unique_ptr<const Table>> expiring_tables_;  // GUARDED_BY(write_lock_)
+  // number of tables in retired_tables_ and expiring_tables_, read by the readers without the lock
+  mutable std::atomic<size_t> num_retired_tables_{0};
+
+  // number of inserts, advanced by writers only
+  std::atomic<uint64_t> epoch_{0};
+  std::atomic<size_t> evictions_{0};
+  std::atomic<size_t> size_{0};
+};
+
+}  // namespace onnxruntime
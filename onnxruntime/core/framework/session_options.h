@@ -7,6 +7,7 @@
 #include <vector>
 #include "core/session/onnxruntime_c_api.h"
 #include "core/optimizer/graph_transformer_level.h"
+#include "core/framework/arena_config.h"
 
 namespace onnxruntime {
 struct FreeDimensionOverride {
@@ -26,6 +27,11 @@ struct SessionOptions {
   // non empty filepath enables serialization of the transformed optimized model to the specified filepath.
   std::basic_string<ORTCHAR_T> optimized_model_filepath;
 
+  // non empty filepath enables the graph cache. The graph is saved to the file after the graph transformations
+  // and the partitioning, and sessions created later for the same model and configuration load it instead of
+  // transforming the graph again. The execution plan and the kernels are still created. See GraphCache.
+  std::basic_string<ORTCHAR_T> graph_cache_filepath;
+
   // enable the memory pattern optimization.
   // The idea is if the input shapes are the same, we could trace the internal memory allocation
   // and generate a memory pattern for future request. So next time we could just do one allocation
@@ -33,11 +39,24 @@ struct SessionOptions {
   // See class 'OrtValuePatternPlanner'.
   bool enable_mem_pattern = true;
 
+  // maximum number of memory patterns (one per distinct set of input shapes) cached by the session.
+  // the least recently used pattern is evicted once the limit is reached. 0 disables the cache.
+  size_t mem_pattern_cache_capacity = 64;
+
   // enable the memory arena on CPU
   // Arena may pre-allocate memory for future usage.
   // set this option to false if you don't want it.
   bool enable_cpu_mem_arena = true;
 
+  // if non-zero, each thread keeps up to this many bytes of recently freed small blocks in front of the CPU
+  // memory arena, which avoids contention on the arena lock when Run is called concurrently.
+  // Only used when enable_cpu_mem_arena is true. See ThreadCachingArena.
+  size_t cpu_mem_arena_thread_cache_max_bytes = 0;
+
+  // memory limit, extend strategy and initial chunk size of the CPU memory arena.
+  // Only used when enable_cpu_mem_arena is true.
+  ArenaConfig cpu_mem_arena_config;
+
   // the prefix of the profile file. The current time will be appended to the file name.
   std::basic_string<ORTCHAR_T> profile_file_prefix = ORT_TSTR("onnxruntime_profile_");
 
@@ -54,13 +73,34 @@ struct SessionOptions {
   // set graph optimization level
   TransformerLevel graph_optimization_level = TransformerLevel::Level1;
 
+  // MatMul and Gemm weights with at least this fraction of zero elements are converted to a sparse format
+  // and multiplied with a sparse kernel. Applied with the level 2 optimizations. 0 disables the conversion.
+  float sparse_weight_threshold = 0.0f;
+
   // controls the size of the thread pool used to parallelize the execution of tasks within individual nodes (ops)
   int intra_op_num_threads = 0;
 
+  // time in microseconds the intra-op threads keep spinning for new work before they block.
+  // spinning avoids a wakeup per op for graphs with many short ops, at the cost of CPU usage. 0 disables it.
+  int intra_op_spin_duration_us = 0;
+
+  // logical processors to pin the intra-op threads to. thread i is pinned to entry i % size.
+  // empty leaves the threads unpinned.
+  std::vector<size_t> intra_op_thread_affinity;
+
+  // NUMA node to restrict the intra-op threads to. -1 leaves them unrestricted.
+  // ignored if intra_op_thread_affinity is set.
+  int intra_op_numa_node = -1;
+
   // controls the size of the thread pool used to parallelize the execution of nodes (ops)
   // configuring this makes sense only when you're using parallel executor
   int inter_op_num_threads = 0;
 
+  // if false, the session runs on the thread pools of the environment, which must have been created with
+  // global thread pools. intra_op_num_threads and inter_op_num_threads then limit the number of those
+  // threads a single parallel loop of this session may use, and the other intra-op thread options are ignored.
+  bool use_per_session_threads = true;
+
   // For models with free input dimensions (most commonly batch size), specifies a set of values to override those
   // free dimensions with, keyed by dimension denotation.
   std::vector<FreeDimensionOverride> free_dimension_overrides;
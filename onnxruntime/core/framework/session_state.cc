@@ -3,6 +3,7 @@
 
 #include "core/framework/session_state.h"
 
+#include <algorithm>
 #include <sstream>
 
 #include "core/common/logging/logging.h"
@@ -103,6 +104,99 @@ Status SessionState::CreateKernels(const KernelRegistryManager& custom_registry_
   return Status::OK();
 }
 
+Status SessionState::PrePackInitializedTensors(bool free_weights_buffers, size_t& num_removed) {
+  num_removed = 0;
+  // number of consumers of each constant initializer, and how many of them packed it
+  struct Uses {
+    size_t consumers = 0;
+    size_t packed = 0;
+  };
+  std::unordered_map<int, Uses> uses;
+
+  auto find_constant_initializer = [this](const NodeArg& arg, int& ort_value_idx) {
+    return arg.Exists() && ort_value_name_idx_map_.GetIdx(arg.Name(), ort_value_idx).IsOK() &&
+           constant_initialized_tensors_.count(ort_value_idx) > 0;
+  };
+
+  for (const auto& node : graph_viewer_->Nodes()) {
+    OpKernel* kernel = session_kernels_[node.Index()];
+    int ort_value_idx;
+
+    const auto& input_defs = node.InputDefs();
+    for (size_t input_idx = 0, end = input_defs.size(); input_idx < end; ++input_idx) {
+      if (!find_constant_initializer(*input_defs[input_idx], ort_value_idx)) {
+        continue;
+      }
+
+      auto& value_uses = uses[ort_value_idx];
+      ++value_uses.consumers;
+
+      const OrtValue& value = constant_initialized_tensors_[ort_value_idx];
+      if (kernel == nullptr || !value.IsTensor()) {
+        continue;
+      }
+
+      bool is_packed = false;
+      ORT_RETURN_IF_ERROR(kernel->PrePack(value.Get<Tensor>(), static_cast<int>(input_idx), is_packed));
+      if (is_packed) {
+        ++value_uses.packed;
+      }
+    }
+
+    // the subgraphs read implicit inputs from the execution frame
+    for (const auto* implicit_input : node.ImplicitInputDefs()) {
+      if (find_constant_initializer(*implicit_input, ort_value_idx)) {
+        ++uses[ort_value_idx].consumers;
+      }
+    }
+  }
+
+  for (const auto* output : graph_viewer_->GetOutputs()) {
+    int ort_value_idx;
+    if (find_constant_initializer(*output, ort_value_idx)) {
+      ++uses[ort_value_idx].consumers;
+    }
+  }
+
+  for (const auto& entry : uses) {
+    if (entry.second.packed == 0 || entry.second.packed != entry.second.consumers) {
+      continue;
+    }
+
+    const int ort_value_idx = entry.first;
+    ++num_removed;
+    const void* data = constant_initialized_tensors_[ort_value_idx].Get<Tensor>().DataRaw();
+    initialized_tensors_.erase(ort_value_idx);
+    constant_initialized_tensors_.erase(ort_value_idx);
+
+    auto deleter = deleter_for_initialized_tensors_.find(ort_value_idx);
+    if (deleter != deleter_for_initialized_tensors_.end()) {
+      deleter->second.f(deleter->second.param);
+      deleter_for_initialized_tensors_.erase(deleter);
+    }
+
+    if (free_weights_buffers && data != nullptr) {
+      auto buffer = std::find_if(weights_buffers_.begin(), weights_buffers_.end(),
+                                 [data](const BufferUniquePtr& b) { return b.get() == data; });
+      if (buffer != weights_buffers_.end()) {
+        weights_buffers_.erase(buffer);
+      }
+    }
+  }
+
+  return Status::OK();
+}
+
+void SessionState::ClearInitializedTensors() {
+  initialized_tensors_.clear();
+  constant_initialized_tensors_.clear();
+  for (auto& entry : deleter_for_initialized_tensors_) {
+    entry.second.f(entry.second.param);
+  }
+  deleter_for_initialized_tensors_.clear();
+  weights_buffers_.clear();
+}
+
 void SessionState::SetExecutionPlan(std::unique_ptr<SequentialExecutionPlan> p_seq_exec_plan) {
   p_seq_exec_plan_ = std::move(p_seq_exec_plan);
 }
@@ -148,36 +242,15 @@ void SessionState::SetProfiler(profiling::Profiler& profiler) { profiler_ = &pro
 
 ::onnxruntime::profiling::Profiler& SessionState::Profiler() const { return *profiler_; }
 
-static int64_t CalculateMemoryPatternsKey(const std::vector<std::reference_wrapper<const TensorShape>>& shapes) {
-  int64_t key = 0;
-  for (auto shape : shapes) {
-    for (auto dim : shape.get().GetDims()) key ^= dim;
-  }
-  return key;
-}
-
-const MemoryPatternGroup* SessionState::GetMemoryPatternGroup(
+std::shared_ptr<const MemoryPatternGroup> SessionState::GetMemoryPatternGroup(
     const std::vector<std::reference_wrapper<const TensorShape>>& input_shapes) const {
-  int64_t key = CalculateMemoryPatternsKey(input_shapes);
-
-  std::lock_guard<OrtMutex> lock(mem_patterns_lock_);
-  auto it = mem_patterns_.find(key);
-  if (it == mem_patterns_.end()) return nullptr;
-
-  return it->second.get();
+  return mem_patterns_.Find(input_shapes);
 }
 
 Status SessionState::UpdateMemoryPatternGroupCache(
     const std::vector<std::reference_wrapper<const TensorShape>>& input_shapes,
     std::unique_ptr<MemoryPatternGroup> mem_patterns) const {
-  int64_t key = CalculateMemoryPatternsKey(input_shapes);
-
-  std::lock_guard<OrtMutex> lock(mem_patterns_lock_);
-  auto it = mem_patterns_.find(key);
-  if (it == mem_patterns_.end()) {
-    mem_patterns_[key] = std::move(mem_patterns);
-  }
-
+  mem_patterns_.Insert(input_shapes, std::move(mem_patterns));
   return Status::OK();
 }
 
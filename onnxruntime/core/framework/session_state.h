@@ -19,6 +19,7 @@
 #include "core/framework/feeds_fetches_manager.h"
 #include "core/framework/kernel_registry_manager.h"
 #include "core/framework/mem_pattern.h"
+#include "core/framework/mem_pattern_cache.h"
 #include "core/framework/ml_value.h"
 #include "core/framework/callback.h"
 #include "core/framework/ort_value_name_idx_map.h"
@@ -52,9 +53,11 @@ class SessionState {
   SessionState(const ExecutionProviders& execution_providers,
                bool enable_mem_pattern,
                concurrency::ThreadPool* thread_pool,
-               concurrency::ThreadPool* inter_op_thread_pool)
+               concurrency::ThreadPool* inter_op_thread_pool,
+               size_t mem_pattern_cache_capacity = MemoryPatternCache::kDefaultCapacity)
       : execution_providers_(execution_providers),
         enable_mem_pattern_(enable_mem_pattern),
+        mem_patterns_(mem_pattern_cache_capacity),
         thread_pool_(thread_pool),
         inter_op_thread_pool_(inter_op_thread_pool) {
   }
@@ -97,6 +100,22 @@ class SessionState {
 
   Status SetGraph(const Graph& graph);
   Status CreateKernels(const KernelRegistryManager& custom_registry_manager);
+
+  /**
+   * Calls OpKernel::PrePack for each constant initialized tensor consumed by a kernel. Must be called after
+   * CreateKernels. A tensor is removed once every kernel consuming it has packed it, unless it is a graph output
+   * or an implicit input of a subgraph.
+   * If 'free_weights_buffers' is true, each initialized tensor was allocated in its own buffer of
+   * GetMutableWeightsBuffers() and the buffer of a removed tensor is freed as well.
+   * 'num_removed' is set to the number of tensors removed.
+   */
+  Status PrePackInitializedTensors(bool free_weights_buffers, /*out*/ size_t& num_removed);
+
+  /**
+   * Removes all initialized tensors and frees the weights buffers, so that the remaining tensors can be saved again
+   * into smaller buffers after some were removed by PrePackInitializedTensors.
+   */
+  void ClearInitializedTensors();
   Status SetGraphAndCreateKernels(const Graph& graph, const KernelRegistryManager& custom_registry_manager) {
     ORT_RETURN_IF_ERROR(SetGraph(graph));
     return CreateKernels(custom_registry_manager);
@@ -142,9 +161,10 @@ class SessionState {
   profiling::Profiler& Profiler() const;
 
   /**
-  Get cached memory pattern based on input shapes
+  Get cached memory pattern based on input shapes.
+  The returned pointer keeps the patterns alive even if they are evicted from the cache while in use.
   */
-  const MemoryPatternGroup* GetMemoryPatternGroup(
+  std::shared_ptr<const MemoryPatternGroup> GetMemoryPatternGroup(
       const std::vector<std::reference_wrapper<const TensorShape>>& input_shapes) const;
 
   /**
@@ -154,6 +174,16 @@ class SessionState {
   Status UpdateMemoryPatternGroupCache(const std::vector<std::reference_wrapper<const TensorShape>>& input_shape,
                                        std::unique_ptr<MemoryPatternGroup> mem_patterns) const;
 
+  /**
+  Get the hit/miss/eviction counters of the memory pattern cache
+  */
+  MemoryPatternCache::Stats GetMemoryPatternCacheStats() const { return mem_patterns_.GetStats(); }
+
+  /**
+  Get the maximum number of memory patterns cached
+  */
+  size_t GetMemoryPatternCacheCapacity() const { return mem_patterns_.Capacity(); }
+
   /**
   Get enable memory pattern flag
   */
@@ -244,10 +274,8 @@ class SessionState {
 
   // switch for enable memory pattern optimization or not.
   const bool enable_mem_pattern_;
-  // lock for the mem_patterns_
-  mutable OrtMutex mem_patterns_lock_;
-  // cache for the generated mem_patterns. key is calculated based on input shapes.
-  mutable std::map<int64_t, std::unique_ptr<MemoryPatternGroup>> mem_patterns_;
+  // bounded cache for the generated mem_patterns, keyed on input shapes. lookups take no lock.
+  mutable MemoryPatternCache mem_patterns_;
 
   NameNodeInfoMapType input_names_to_nodeinfo_mapping_;
   NameNodeInfoMapType output_names_to_nodeinfo_mapping_;
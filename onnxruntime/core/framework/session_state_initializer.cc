@@ -6,6 +6,7 @@
 
 #include <functional>
 #include <limits>
+#include <unordered_set>
 #include <core/common/status.h>
 
 #include "core/common/common.h"
@@ -34,7 +35,8 @@ static common::Status SaveInitializedTensors(const Env& env, const std::basic_st
                                              const OrtValueNameIdxMap& ort_value_name_idx_map,
                                              ITensorAllocator* planner, const T& save_tensor_func,
                                              const logging::Logger& logger,
-                                             const DataTransferManager& data_transfer_mgr);
+                                             const DataTransferManager& data_transfer_mgr,
+                                             const std::unordered_set<int>* ort_value_indices = nullptr);
 
 static common::Status SaveInputOutputNamesToNodeMapping(
     const onnxruntime::Graph& graph,
@@ -92,18 +94,39 @@ common::Status SessionStateInitializer::CreatePlan(
 
   // lambda to save initialized tensors into SessionState directly
   const Env& env = Env::Default();
-  ORT_RETURN_IF_ERROR(SaveInitializedTensors(
-      env, graph_loc_, graph_, execution_providers_, ort_value_name_idx_map, tensor_allocator_.get(),
-      [this](int idx, const OrtValue& value, const OrtCallback& d, bool constant) -> Status {
-        return session_state_.AddInitializedTensor(idx, value, &d, constant);
-      },
-      logger_, session_state_.GetDataTransferMgr()));
+  auto save_tensor_func = [this](int idx, const OrtValue& value, const OrtCallback& d, bool constant) -> Status {
+    return session_state_.AddInitializedTensor(idx, value, &d, constant);
+  };
+  ORT_RETURN_IF_ERROR(SaveInitializedTensors(env, graph_loc_, graph_, execution_providers_, ort_value_name_idx_map,
+                                             tensor_allocator_.get(), save_tensor_func, logger_,
+                                             session_state_.GetDataTransferMgr()));
+
+  ORT_RETURN_IF_ERROR(session_state_.CreateKernels(kernel_registry_manager_));
+
+  // let the kernels pack their constant weights. a weight every consumer has packed is released: without the memory
+  // pattern each weight has its own buffer, which is freed directly. with it, the weights of a location share one
+  // buffer, so the remaining weights are saved again into buffers planned without the packed ones.
+  size_t num_packed = 0;
+  ORT_RETURN_IF_ERROR(session_state_.PrePackInitializedTensors(!enable_mem_pattern_, num_packed));
+  if (enable_mem_pattern_ && num_packed > 0) {
+    std::unordered_set<int> remaining;
+    for (const auto& entry : session_state_.GetInitializedTensors()) {
+      remaining.insert(entry.first);
+    }
+
+    session_state_.ClearInitializedTensors();
+    tensor_allocator_ = ITensorAllocator::Create(enable_mem_pattern_, *exec_plan_ptr, execution_providers_,
+                                                 session_state_.GetMutableWeightsBuffers());
+    ORT_RETURN_IF_ERROR(SaveInitializedTensors(env, graph_loc_, graph_, execution_providers_, ort_value_name_idx_map,
+                                               tensor_allocator_.get(), save_tensor_func, logger_,
+                                               session_state_.GetDataTransferMgr(), &remaining));
+  }
+
   // remove weights from the graph now to save memory but in many cases it won't save memory, if the tensor was
   // preallocated with the some other tensors in a single 'allocate' call, which is very common.
   // TODO: make it better
   graph_.CleanAllInitializedTensors();
 
-  ORT_RETURN_IF_ERROR(session_state_.CreateKernels(kernel_registry_manager_));
   ORT_RETURN_IF_ERROR(
       SaveInputOutputNamesToNodeMapping(graph_, kernel_registry_manager_, session_state_, outer_scope_node_args));
   return Status::OK();
@@ -175,7 +198,8 @@ common::Status SaveInitializedTensors(const Env& env, const std::basic_string<PA
                                       const Graph& graph, const ExecutionProviders& exec_providers,
                                       const OrtValueNameIdxMap& ort_value_name_idx_map, ITensorAllocator* planner,
                                       const T& save_tensor_func, const logging::Logger& logger,
-                                      const DataTransferManager& data_transfer_mgr) {
+                                      const DataTransferManager& data_transfer_mgr,
+                                      const std::unordered_set<int>* ort_value_indices) {
   LOGS(logger, INFO) << "Saving initialized tensors.";
   ORT_ENFORCE(ort_value_name_idx_map.MaxIdx() > 0, "OrtValue indexes should have been populated.");
 
@@ -185,7 +209,10 @@ common::Status SaveInitializedTensors(const Env& env, const std::basic_string<PA
   for (const auto& entry : initialized_tensor_set) {
     int ort_value_index;
     ORT_RETURN_IF_ERROR(ort_value_name_idx_map.GetIdx(entry.first, ort_value_index));
-    id_to_initialized_tensor[ort_value_index] = entry.second;
+    // only save the given subset, if any
+    if (ort_value_indices == nullptr || ort_value_indices->count(ort_value_index) > 0) {
+      id_to_initialized_tensor[ort_value_index] = entry.second;
+    }
   }
   for (const auto& entry : id_to_initialized_tensor) {
     ORT_RETURN_IF_ERROR(planner->Trace(entry.first, entry.second));
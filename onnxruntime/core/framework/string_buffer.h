@@ -0,0 +1,92 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "core/common/common.h"
+
+namespace onnxruntime {
+
+// Strings stored compactly: the characters of all the strings one after the other in a single buffer, and the offset
+// of each string in it. Appending a string copies its characters to the end of the buffer, so once the buffer has
+// grown a kernel builds its strings without allocating, whereas each std::string longer than the small string buffer
+// is a separate allocation. StringNormalizer builds the strings it converts in it, and the lookup tables of
+// LabelEncoder and CategoryMapper keep their keys in it.
+// The strings are read as views, a pointer to their characters and their length, which stay valid until the buffer is
+// modified.
+// This is not a string tensor representation. String tensors store one std::string per element, so a kernel still
+// allocates for each long string it writes to an output tensor, with CopyTo or from the views.
+class StringBuffer {
+ public:
+  StringBuffer() : offsets_(1, 0) {}
+
+  void Reserve(size_t count, size_t length) {
+    offsets_.reserve(count + 1);
+    chars_.reserve(length);
+  }
+
+  // Removes the strings, keeping the memory for the next ones.
+  void Clear() {
+    offsets_.resize(1);
+    chars_.clear();
+  }
+
+  void Append(const char* data, size_t length) {
+    chars_.insert(chars_.end(), data, data + length);
+    offsets_.push_back(chars_.size());
+  }
+
+  void Append(const std::string& s) {
+    Append(s.data(), s.size());
+  }
+
+  // Appends the characters to the last string.
+  void Extend(const char* data, size_t length) {
+    ORT_ENFORCE(Size() > 0, "There's no string to extend.");
+    chars_.insert(chars_.end(), data, data + length);
+    offsets_.back() = chars_.size();
+  }
+
+  size_t Size() const { return offsets_.size() - 1; }
+
+  // The characters of string i, which aren't null terminated.
+  const char* Data(size_t i) const { return chars_.data() + offsets_[i]; }
+  size_t Length(size_t i) const { return offsets_[i + 1] - offsets_[i]; }
+
+  std::string String(size_t i) const { return std::string(Data(i), Length(i)); }
+
+  // The characters of all the strings, and the offset of each string followed by the total length, the layout of
+  // GetStringTensorContent in the C API.
+  const std::vector<char>& Chars() const { return chars_; }
+  const std::vector<size_t>& Offsets() const { return offsets_; }
+
+  // Replaces the strings with a copy of count strings.
+  void Assign(const std::string* strings, size_t count) {
+    size_t length = 0;
+    for (size_t i = 0; i < count; ++i) {
+      length += strings[i].size();
+    }
+
+    Clear();
+    Reserve(count, length);
+    for (size_t i = 0; i < count; ++i) {
+      Append(strings[i]);
+    }
+  }
+
+  // Assigns the strings to the first Size() elements of strings, such as those of a string tensor.
+  void CopyTo(std::string* strings) const {
+    for (size_t i = 0, count = Size(); i < count; ++i) {
+      strings[i].assign(Data(i), Length(i));
+    }
+  }
+
+ private:
+  std::vector<char> chars_;
+  std::vector<size_t> offsets_;
+};
+
+}  // namespace onnxruntime
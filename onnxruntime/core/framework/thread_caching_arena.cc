@@ -0,0 +1,261 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/thread_caching_arena.h"
+
+#include <algorithm>
+
+namespace onnxruntime {
+
+constexpr size_t ThreadCachingArena::kHeaderSize;
+constexpr size_t ThreadCachingArena::kMaxCachedBlockSize;
+constexpr size_t ThreadCachingArena::kFlushInterval;
+constexpr size_t ThreadCachingArena::kNumSizeClasses;
+constexpr uint32_t ThreadCachingArena::kNotCached;
+
+thread_local std::unique_ptr<ThreadCachingArena::ThreadCacheMap> ThreadCachingArena::thread_caches_;
+std::atomic<uint64_t> ThreadCachingArena::next_id_{0};
+
+static_assert(sizeof(uint32_t) <= ThreadCachingArena::kHeaderSize, "Block header does not fit.");
+
+ThreadCachingArena::ThreadCachingArena(std::unique_ptr<IArenaAllocator> arena, size_t max_cached_bytes_per_thread)
+    : id_(next_id_++),
+      max_cached_bytes_per_thread_(max_cached_bytes_per_thread),
+      arena_(std::move(arena)) {
+  ORT_ENFORCE(arena_ != nullptr);
+}
+
+ThreadCachingArena::~ThreadCachingArena() {
+  // blocks cached by other threads are released with the wrapped arena.
+  if (thread_caches_ != nullptr) {
+    auto it = thread_caches_->find(id_);
+    if (it != thread_caches_->end()) {
+      it->second->Flush();
+      thread_caches_->erase(it);
+    }
+  }
+}
+
+size_t ThreadCachingArena::SizeClassForBytes(size_t bytes) {
+  if (bytes <= 1024) {
+    return (bytes + 255) / 256 - 1;
+  }
+
+  // bytes is in (2^k, 2^(k+1)], which is split into 4 classes of 2^(k-2) bytes
+  size_t k = 10;
+  while ((size_t{1} << (k + 1)) < bytes) {
+    ++k;
+  }
+
+  const size_t step = size_t{1} << (k - 2);
+  const size_t multiple = (bytes + step - 1) / step;  // 5 to 8
+  return 4 + (k - 10) * 4 + (multiple - 5);
+}
+
+size_t ThreadCachingArena::SizeClassToBytes(size_t size_class) {
+  if (size_class < 4) {
+    return (size_class + 1) * 256;
+  }
+
+  const size_t k = 10 + (size_class - 4) / 4;
+  const size_t multiple = 5 + (size_class - 4) % 4;
+  return multiple << (k - 2);
+}
+
+ThreadCachingArena::ThreadCache& ThreadCachingArena::GetThreadCache() const {
+  if (thread_caches_ == nullptr) {
+    thread_caches_ = onnxruntime::make_unique<ThreadCacheMap>();
+  }
+
+  const uint64_t flush_epoch = flush_epoch_.load(std::memory_order_relaxed);
+
+  auto it = thread_caches_->find(id_);
+  if (it != thread_caches_->end()) {
+    ThreadCache& cache = *it->second;
+    if (cache.flush_epoch != flush_epoch) {
+      cache.Flush();
+      cache.flush_epoch = flush_epoch;
+    }
+
+    return cache;
+  }
+
+  // this is the first use of this arena on the thread. drop the caches of arenas that no longer exist.
+  for (auto cur = thread_caches_->begin(); cur != thread_caches_->end();) {
+    if (cur->second->ArenaExpired()) {
+      cur = thread_caches_->erase(cur);
+    } else {
+      ++cur;
+    }
+  }
+
+  auto result = thread_caches_->emplace(id_, onnxruntime::make_unique<ThreadCache>(arena_));
+  result.first->second->flush_epoch = flush_epoch;
+  return *result.first->second;
+}
+
+void* ThreadCachingArena::Alloc(size_t size) {
+  if (size == 0) {
+    return nullptr;
+  }
+
+  const size_t total_size = size + kHeaderSize;
+  void* block = nullptr;
+  uint32_t size_class = kNotCached;
+
+  if (total_size <= kMaxCachedBlockSize && max_cached_bytes_per_thread_ > 0) {
+    size_class = static_cast<uint32_t>(SizeClassForBytes(total_size));
+    block = GetThreadCache().Pop(size_class);
+    if (block != nullptr) {
+      // the header is still valid from when the block was first allocated
+      return static_cast<char*>(block) + kHeaderSize;
+    }
+
+    block = arena_->Alloc(SizeClassToBytes(size_class));
+  } else {
+    block = arena_->Alloc(total_size);
+  }
+
+  if (block == nullptr) {
+    return nullptr;
+  }
+
+  static_cast<BlockHeader*>(block)->size_class = size_class;
+  return static_cast<char*>(block) + kHeaderSize;
+}
+
+void* ThreadCachingArena::Reserve(size_t size) {
+  if (size == 0) {
+    return nullptr;
+  }
+
+  void* block = arena_->Reserve(size + kHeaderSize);
+  if (block == nullptr) {
+    return nullptr;
+  }
+
+  static_cast<BlockHeader*>(block)->size_class = kNotCached;
+  return static_cast<char*>(block) + kHeaderSize;
+}
+
+void ThreadCachingArena::Free(void* p) {
+  if (p == nullptr) {
+    return;
+  }
+
+  void* block = static_cast<char*>(p) - kHeaderSize;
+  const uint32_t size_class = static_cast<BlockHeader*>(block)->size_class;
+  if (size_class == kNotCached || !GetThreadCache().Push(size_class, block, max_cached_bytes_per_thread_)) {
+    arena_->Free(block);
+  }
+}
+
+Status ThreadCachingArena::Shrink() {
+  ++flush_epoch_;
+  FlushThreadCache();
+  return arena_->Shrink();
+}
+
+void ThreadCachingArena::FlushThreadCache() {
+  if (thread_caches_ != nullptr) {
+    auto it = thread_caches_->find(id_);
+    if (it != thread_caches_->end()) {
+      it->second->Flush();
+    }
+  }
+}
+
+size_t ThreadCachingArena::ThreadCachedBytes() const {
+  if (thread_caches_ != nullptr) {
+    auto it = thread_caches_->find(id_);
+    if (it != thread_caches_->end()) {
+      return it->second->CachedBytes();
+    }
+  }
+
+  return 0;
+}
+
+ThreadCachingArena::ThreadCache::~ThreadCache() {
+  Flush();
+}
+
+void* ThreadCachingArena::ThreadCache::Pop(size_t size_class) {
+  auto& blocks = free_blocks_[size_class];
+  if (blocks.empty()) {
+    low_water_marks_[size_class] = 0;
+    return nullptr;
+  }
+
+  void* block = blocks.back();
+  blocks.pop_back();
+  cached_bytes_ -= SizeClassToBytes(size_class);
+  low_water_marks_[size_class] = std::min(low_water_marks_[size_class], blocks.size());
+
+  if (++ops_since_flush_ >= kFlushInterval) {
+    ReleaseUnusedBlocks();
+  }
+
+  return block;
+}
+
+bool ThreadCachingArena::ThreadCache::Push(size_t size_class, void* block, size_t max_cached_bytes) {
+  const size_t block_size = SizeClassToBytes(size_class);
+  if (cached_bytes_ + block_size > max_cached_bytes) {
+    return false;
+  }
+
+  free_blocks_[size_class].push_back(block);
+  cached_bytes_ += block_size;
+
+  if (++ops_since_flush_ >= kFlushInterval) {
+    ReleaseUnusedBlocks();
+  }
+
+  return true;
+}
+
+void ThreadCachingArena::ThreadCache::ReleaseBlocks(IArenaAllocator& arena, size_t size_class, size_t count) {
+  auto& blocks = free_blocks_[size_class];
+  for (size_t i = 0; i < count; ++i) {
+    arena.Free(blocks.back());
+    blocks.pop_back();
+  }
+
+  cached_bytes_ -= count * SizeClassToBytes(size_class);
+}
+
+void ThreadCachingArena::ThreadCache::ReleaseUnusedBlocks() {
+  ops_since_flush_ = 0;
+
+  auto arena = arena_.lock();
+  if (!arena) {
+    return;
+  }
+
+  // blocks that stayed in the cache for the whole interval are not needed by this thread. give them back so the
+  // arena can coalesce them and hand them to other threads.
+  for (size_t size_class = 0; size_class < kNumSizeClasses; ++size_class) {
+    ReleaseBlocks(*arena, size_class, low_water_marks_[size_class]);
+    low_water_marks_[size_class] = free_blocks_[size_class].size();
+  }
+}
+
+void ThreadCachingArena::ThreadCache::Flush() {
+  ops_since_flush_ = 0;
+
+  auto arena = arena_.lock();
+  for (size_t size_class = 0; size_class < kNumSizeClasses; ++size_class) {
+    if (arena) {
+      ReleaseBlocks(*arena, size_class, free_blocks_[size_class].size());
+    } else {
+      free_blocks_[size_class].clear();
+    }
+
+    low_water_marks_[size_class] = 0;
+  }
+
+  cached_bytes_ = 0;
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,141 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/framework/arena.h"
+
+namespace onnxruntime {
+
+// Front-end for an arena that keeps recently freed small blocks in a per-thread cache, so that concurrent
+// Alloc/Free calls from different threads mostly avoid the lock in the wrapped arena (e.g. BFCArena).
+//
+// Small requests are rounded up to a size class. A block freed into the cache can be handed out for any later
+// request of the same class on that thread without touching the wrapped arena. Each thread cache is bounded by
+// max_cached_bytes_per_thread, and blocks that were not needed since the previous flush are periodically returned
+// to the wrapped arena so they can be coalesced and reused by other threads.
+//
+// Every block is prefixed by a small header recording its size class, so Free needs no lookup in the wrapped arena
+// and a block may be freed on a different thread than the one that allocated it.
+class ThreadCachingArena : public IArenaAllocator {
+ public:
+  // Size of the header in front of each block. Keeps the returned pointers aligned for MLAS.
+  static constexpr size_t kHeaderSize = 64;
+  // Requests larger than this (including the header) bypass the thread cache.
+  static constexpr size_t kMaxCachedBlockSize = 64 * 1024;
+  // Number of cache operations on a thread between flushes of its unused blocks.
+  static constexpr size_t kFlushInterval = 4096;
+
+  ThreadCachingArena(std::unique_ptr<IArenaAllocator> arena, size_t max_cached_bytes_per_thread);
+
+  ~ThreadCachingArena() override;
+
+  void* Alloc(size_t size) override;
+
+  void Free(void* p) override;
+
+  void* Reserve(size_t size) override;
+
+  // Flushes the cache of the calling thread and asks the other threads to flush theirs on their next Alloc/Free,
+  // then shrinks the wrapped arena. Blocks still cached by other threads keep their regions alive until then.
+  Status Shrink() override;
+
+  // Includes the blocks held in thread caches, which the wrapped arena still considers in use.
+  size_t Used() const override {
+    return arena_->Used();
+  }
+
+  size_t Max() const override {
+    return arena_->Max();
+  }
+
+  ArenaConfig GetConfig() const override {
+    return arena_->GetConfig();
+  }
+
+  const OrtMemoryInfo& Info() const override {
+    return arena_->Info();
+  }
+
+  FencePtr CreateFence(const SessionState* session_state) override {
+    return arena_->CreateFence(session_state);
+  }
+
+  // Return all blocks cached by the calling thread to the wrapped arena.
+  void FlushThreadCache();
+
+  // Number of bytes currently cached by the calling thread.
+  size_t ThreadCachedBytes() const;
+
+  IArenaAllocator& GetArena() const { return *arena_; }
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(ThreadCachingArena);
+
+  // 4 classes for each power of two above 1KB, multiples of 256 bytes below.
+  static constexpr size_t kNumSizeClasses = 28;
+  static constexpr uint32_t kNotCached = static_cast<uint32_t>(-1);
+
+  struct BlockHeader {
+    uint32_t size_class;
+  };
+
+  static size_t SizeClassForBytes(size_t bytes);
+  static size_t SizeClassToBytes(size_t size_class);
+
+  class ThreadCache {
+   public:
+    explicit ThreadCache(std::weak_ptr<IArenaAllocator> arena) : arena_(std::move(arena)) {
+      low_water_marks_.fill(0);
+    }
+
+    ~ThreadCache();
+
+    void* Pop(size_t size_class);
+    bool Push(size_t size_class, void* block, size_t max_cached_bytes);
+    void Flush();
+    bool ArenaExpired() const { return arena_.expired(); }
+    size_t CachedBytes() const { return cached_bytes_; }
+
+    // value of the arena's flush_epoch_ when this cache was last flushed
+    uint64_t flush_epoch = 0;
+
+   private:
+    ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(ThreadCache);
+
+    void ReleaseUnusedBlocks();
+    void ReleaseBlocks(IArenaAllocator& arena, size_t size_class, size_t count);
+
+    // the caches of a thread may outlive the arena, in which case the cached blocks were already released with it.
+    std::weak_ptr<IArenaAllocator> arena_;
+    std::array<std::vector<void*>, kNumSizeClasses> free_blocks_;
+    // smallest number of free blocks in each class since the last flush. that many blocks were not needed.
+    std::array<size_t, kNumSizeClasses> low_water_marks_;
+    size_t cached_bytes_ = 0;
+    size_t ops_since_flush_ = 0;
+  };
+
+  // Thread caches of the calling thread, keyed by the id of the arena they belong to.
+  // Ids are used instead of pointers as a new arena may be created at the address of a destroyed one.
+  using ThreadCacheMap = std::unordered_map<uint64_t, std::unique_ptr<ThreadCache>>;
+  static thread_local std::unique_ptr<ThreadCacheMap> thread_caches_;
+
+  ThreadCache& GetThreadCache() const;
+
+  static std::atomic<uint64_t> next_id_;
+
+  const uint64_t id_;
+  const size_t max_cached_bytes_per_thread_;
+  // incremented to make all threads flush their caches
+  std::atomic<uint64_t> flush_epoch_{0};
+  std::shared_ptr<IArenaAllocator> arena_;
+};
+
+}  // namespace onnxruntime
@@ -1085,6 +1085,62 @@ activation and leaky_relu_alpha.)DOC")
         }
       });
 
+  ONNX_CONTRIB_OPERATOR_SCHEMA(SparseMatMul)
+      .SetDomain(kMSDomain)
+      .SinceVersion(1)
+      .SetDoc(R"DOC(
+Computes Y = alpha * A * B + beta * C where B is a sparse (K, N) matrix.
+B is supplied transposed in compressed sparse row (CSR) format: the nonzero elements of
+row n of the (N, K) matrix B' are B_values[j] at column B_column_indices[j] for
+B_row_offsets[n] <= j < B_row_offsets[n + 1].
+A is treated as a (M, K) matrix where M is the product of all but the last dimension, so
+the op can replace a MatMul or Gemm whose weights are a pruned initializer.)DOC")
+      .Input(0, "A", "Input tensor A of shape (..., K).", "T")
+      .Input(1, "B_values", "1-D tensor with the nonzero values of B'.", "T")
+      .Input(2, "B_row_offsets", "1-D tensor of N + 1 offsets into B_values for the rows of B'.", "tensor(int32)")
+      .Input(3, "B_column_indices", "1-D tensor with the column of each value in B'.", "tensor(int32)")
+      .Input(4, "C", "Optional input tensor C. Must be unidirectional broadcastable to (M, N).", "T",
+             OpSchema::Optional)
+      .Output(0, "Y", "Output tensor of shape (..., N).", "T")
+      .TypeConstraint("T", {"tensor(float)"}, "Constrain input and output types to float tensors.")
+      .Attr("K", "Number of rows of B.", AttributeProto::INT)
+      .Attr("alpha", "Scalar multiplier for the product of input tensors A * B.", AttributeProto::FLOAT, 1.0f)
+      .Attr("beta", "Scalar multiplier for input tensor C.", AttributeProto::FLOAT, 1.0f)
+      .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+        propagateElemTypeFromInputToOutput(ctx, 0, 0);
+        if (!hasInputShape(ctx, 0) || !hasInputShape(ctx, 2)) {
+          return;
+        }
+
+        auto& a_shape = getInputShape(ctx, 0);
+        auto& row_offsets_shape = getInputShape(ctx, 2);
+        if (a_shape.dim_size() < 1) {
+          fail_shape_inference("A must have at least one dimension");
+        }
+        if (row_offsets_shape.dim_size() != 1) {
+          fail_shape_inference("B_row_offsets must be 1-D");
+        }
+
+        const auto& k_dim = a_shape.dim(a_shape.dim_size() - 1);
+        auto k_attr = ctx.getAttribute("K");
+        if (k_attr != nullptr && k_dim.has_dim_value() && k_dim.dim_value() != k_attr->i()) {
+          fail_shape_inference("The last dimension of A does not match K");
+        }
+
+        ONNX_NAMESPACE::TensorShapeProto output_shape;
+        for (int i = 0; i < a_shape.dim_size() - 1; ++i) {
+          *output_shape.add_dim() = a_shape.dim(i);
+        }
+
+        auto* n_dim = output_shape.add_dim();
+        const auto& offsets_dim = row_offsets_shape.dim(0);
+        if (offsets_dim.has_dim_value()) {
+          n_dim->set_dim_value(offsets_dim.dim_value() - 1);
+        }
+
+        updateOutputShape(ctx, 0, output_shape);
+      });
+
   ONNX_CONTRIB_OPERATOR_SCHEMA(ExpandDims)
       .SetDomain(kMSDomain)
       .SinceVersion(1)
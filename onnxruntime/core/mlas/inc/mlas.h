@@ -181,6 +181,140 @@ MlasGemm(
     MLAS_THREADPOOL* ThreadPool
     );
 
+//
+// Packed matrix/matrix multiply routines.
+//
+// A constant matrix B can be packed once to the layout used by the kernels,
+// which removes the copy of matrix B from every call to MlasGemm. The packed
+// buffer must be aligned to MlasGetPreferredBufferAlignment. The layout of the
+// packed buffer is specific to the platform and must not be persisted.
+//
+
+size_t
+MLASCALL
+MlasGemmPackBSize(
+    size_t N,
+    size_t K
+    );
+
+void
+MLASCALL
+MlasGemmPackB(
+    CBLAS_TRANSPOSE TransB,
+    size_t N,
+    size_t K,
+    const float* B,
+    size_t ldb,
+    void* PackedB
+    );
+
+void
+MLASCALL
+MlasGemm(
+    CBLAS_TRANSPOSE TransA,
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const void* PackedB,
+    float beta,
+    float* C,
+    size_t ldc,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
+size_t
+MLASCALL
+MlasGemmPackBSize(
+    size_t N,
+    size_t K,
+    bool BIsSigned
+    );
+
+void
+MLASCALL
+MlasGemmPackB(
+    size_t N,
+    size_t K,
+    const uint8_t* B,
+    size_t ldb,
+    bool BIsSigned,
+    void* PackedB
+    );
+
+void
+MLASCALL
+MlasGemm(
+    size_t M,
+    size_t N,
+    size_t K,
+    const uint8_t* A,
+    size_t lda,
+    uint8_t offa,
+    const void* PackedB,
+    uint8_t offb,
+    bool BIsSigned,
+    int32_t* C,
+    size_t ldc,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
+//
+// Quantization routines.
+//
+// The 32-bit accumulators of a quantized matrix multiply are requantized to
+// 8 bits as Output = Saturate(Round((Input + Bias) * Scale) + ZeroPoint),
+// where Round rounds half to even. Bias holds one value per row and may be
+// null. Scale holds one value for the matrix, per row or per column.
+//
+
+enum MLAS_QUANTIZATION_GRANULARITY {
+    MlasPerMatrix,
+    MlasPerRow,
+    MlasPerColumn,
+};
+
+void
+MLASCALL
+MlasRequantizeOutput(
+    const int32_t* Input,
+    uint8_t* Output,
+    const int32_t* Bias,
+    size_t M,
+    size_t N,
+    const float* Scale,
+    MLAS_QUANTIZATION_GRANULARITY ScaleGranularity,
+    uint8_t ZeroPoint
+    );
+
+//
+// Sparse matrix/matrix multiply routines.
+//
+// Matrix B is supplied transposed (N rows of K elements) in compressed sparse
+// row (CSR) format: the nonzero elements of row n are Values[j] at column
+// ColumnIndices[j] for RowOffsets[n] <= j < RowOffsets[n + 1].
+//
+
+void
+MLASCALL
+MlasSparseGemm(
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const int32_t* RowOffsets,
+    const int32_t* ColumnIndices,
+    const float* Values,
+    float beta,
+    float* C,
+    size_t ldc,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
 //
 // Convolution routines.
 //
@@ -252,6 +386,77 @@ MlasConv(
     MLAS_THREADPOOL* ThreadPool
     );
 
+//
+// Quantized convolution routines.
+//
+// The convolution of an unsigned 8-bit input and filter produces 32-bit
+// accumulators, which may be requantized with MlasRequantizeOutput. The input
+// is never expanded to a column buffer as a whole: pointwise convolutions
+// multiply the input directly, depthwise convolutions accumulate the input
+// rows directly, and other convolutions expand a slice of the output columns
+// at a time to the working buffer of each thread.
+//
+
+enum MLAS_QCONV_ALGORITHM {
+    MlasQConvAlgorithmGemmDirect,
+    MlasQConvAlgorithmDepthwise,
+    MlasQConvAlgorithmExpandThenGemmSegmented,
+};
+
+struct MLAS_QCONV_PARAMETERS {
+    size_t BatchCount;
+    size_t GroupCount;
+    size_t InputChannels;
+    size_t InputShape[2];
+    size_t KernelShape[2];
+    size_t DilationShape[2];
+    size_t Padding[4];
+    size_t StrideShape[2];
+    size_t FilterCount;
+    size_t OutputShape[2];
+    size_t InputSize;
+    size_t OutputSize;
+    size_t K;
+    uint8_t InputZeroPoint;
+    MLAS_QCONV_ALGORITHM Algorithm;
+    size_t StrideN;
+    size_t StrideM;
+    int32_t ThreadCount;
+};
+
+void
+MLASCALL
+MlasQConvPrepare(
+    MLAS_QCONV_PARAMETERS* Parameters,
+    size_t Dimensions,
+    size_t BatchCount,
+    size_t GroupCount,
+    size_t InputChannels,
+    const int64_t* InputShape,
+    const int64_t* KernelShape,
+    const int64_t* DilationShape,
+    const int64_t* Padding,
+    const int64_t* StrideShape,
+    const int64_t* OutputShape,
+    size_t FilterCount,
+    uint8_t InputZeroPoint,
+    size_t* WorkingBufferSize,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
+void
+MLASCALL
+MlasQConv(
+    const MLAS_QCONV_PARAMETERS* Parameters,
+    const uint8_t* Input,
+    const uint8_t* Filter,
+    const uint8_t* FilterZeroPoint,
+    bool PerChannelFilterZeroPoint,
+    uint8_t* WorkingBuffer,
+    int32_t* Output,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
 //
 // Pooling routines.
 //
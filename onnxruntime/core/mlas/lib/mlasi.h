@@ -571,6 +571,23 @@ extern "C" {
 
 #define MLAS_DGEMM_THREAD_COMPLEXITY                (64 * 1024)
 
+//
+// Define the number of multiply/add operations of a sparse SGEMM operation
+// to assign to each thread.
+//
+
+#define MLAS_SPARSE_SGEMM_THREAD_COMPLEXITY         (64 * 1024)
+
+//
+// Define the number of multiply/add operations of a quantized convolution to
+// assign to each thread, and the number of bytes of the working buffer used
+// by each thread to expand slices of the convolution input.
+//
+
+#define MLAS_QCONV_THREAD_COMPLEXITY                (64 * 1024)
+
+#define MLAS_QCONV_WORKING_BUFFER_SIZE_PER_THREAD   (128 * 1024)
+
 //
 // Single-threaded single precision matrix/matrix multiply operation.
 //
@@ -0,0 +1,852 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    qconv.cpp
+
+Abstract:
+
+    This module implements the quantized convolution operation.
+
+--*/
+
+#include "mlasi.h"
+
+#ifdef MLAS_TARGET_AMD64_IX86
+
+//
+// Define the maximum and minimum number of output columns processed by a
+// thread at a time.
+//
+
+#define MLAS_QCONV_MAXIMUM_STRIDEN                  256
+#define MLAS_QCONV_MINIMUM_STRIDEN                  16
+
+//
+// Define the minimum number of filters processed by a thread at a time when the
+// filters are split across threads.
+//
+
+#define MLAS_QCONV_MINIMUM_STRIDEM                  16
+
+//
+// Define the parameters to execute tiles of a convolution operation on worker
+// threads.
+//
+
+struct MLAS_QCONV_WORK_BLOCK {
+    const MLAS_QCONV_PARAMETERS* Parameters;
+    const uint8_t* Input;
+    const uint8_t* Filter;
+    const uint8_t* FilterZeroPoint;
+    bool PerChannelFilterZeroPoint;
+    uint8_t* WorkingBuffer;
+    int32_t* Output;
+    size_t TileCountPerBatchGroup;
+    size_t FilterTileCount;
+    size_t TileCount;
+};
+
+void
+MlasQConvIm2Col(
+    const MLAS_QCONV_PARAMETERS* Parameters,
+    const uint8_t* Input,
+    uint8_t* ColumnBuffer,
+    size_t n,
+    size_t CountN
+    )
+/*++
+
+Routine Description:
+
+    This routine converts a slice of the output columns of the input image to
+    a set of convolution patches appropriate for use with a GEMM operation.
+    Patches that extend into the padding region are filled with the input
+    zero point.
+
+Arguments:
+
+    Parameters - Supplies the structure that contains the convolution
+        parameters.
+
+    Input - Supplies the input tensor of the batch and group.
+
+    ColumnBuffer - Supplies the buffer to receive the K rows of CountN
+        convolution patches.
+
+    n - Supplies the N to begin sampling the convolution patches.
+
+    CountN - Supplies the count of N to sample for the convolution patches.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    constexpr size_t HeightShapeIndex = 0;
+    constexpr size_t WidthShapeIndex = 1;
+
+    const size_t OutputWidth = Parameters->OutputShape[WidthShapeIndex];
+
+    const size_t InputHeight = Parameters->InputShape[HeightShapeIndex];
+    const size_t InputWidth = Parameters->InputShape[WidthShapeIndex];
+    const size_t InputSize = Parameters->InputSize;
+
+    const size_t KernelHeight = Parameters->KernelShape[HeightShapeIndex];
+    const size_t KernelWidth = Parameters->KernelShape[WidthShapeIndex];
+
+    const size_t DilationHeight = Parameters->DilationShape[HeightShapeIndex];
+    const size_t DilationWidth = Parameters->DilationShape[WidthShapeIndex];
+
+    const size_t PaddingLeftY = Parameters->Padding[HeightShapeIndex];
+    const size_t PaddingLeftX = Parameters->Padding[WidthShapeIndex];
+
+    const size_t StrideHeight = Parameters->StrideShape[HeightShapeIndex];
+    const size_t StrideWidth = Parameters->StrideShape[WidthShapeIndex];
+
+    const uint8_t ZeroPoint = Parameters->InputZeroPoint;
+
+    for (size_t c = 0; c < Parameters->InputChannels; c++) {
+
+        for (size_t ky = 0; ky < KernelHeight; ky++) {
+
+            for (size_t kx = 0; kx < KernelWidth; kx++) {
+
+                size_t ox = n % OutputWidth;
+                size_t oy = n / OutputWidth;
+                size_t RemainingN = CountN;
+
+                while (RemainingN > 0) {
+
+                    size_t CountX = OutputWidth - ox;
+
+                    if (CountX > RemainingN) {
+                        CountX = RemainingN;
+                    }
+
+                    RemainingN -= CountX;
+
+                    //
+                    // Check if the input row is in the top/bottom padding
+                    // region. The unsigned arithmetic wraps for the top
+                    // padding region.
+                    //
+
+                    size_t InputY = (oy * StrideHeight) + (ky * DilationHeight) - PaddingLeftY;
+
+                    if (InputY >= InputHeight) {
+
+                        std::fill_n(ColumnBuffer, CountX, ZeroPoint);
+                        ColumnBuffer += CountX;
+
+                    } else {
+
+                        const uint8_t* InputRow = &Input[InputY * InputWidth];
+                        ptrdiff_t InputX = ptrdiff_t((ox * StrideWidth) + (kx * DilationWidth)) - ptrdiff_t(PaddingLeftX);
+
+                        if (StrideWidth == 1) {
+
+                            //
+                            // Split the row into the left padding region, the
+                            // elements copied from the input row and the right
+                            // padding region.
+                            //
+
+                            size_t CountPadX = 0;
+
+                            if (InputX < 0) {
+                                CountPadX = (std::min)(CountX, size_t(-InputX));
+                            }
+
+                            std::fill_n(ColumnBuffer, CountPadX, ZeroPoint);
+                            ColumnBuffer += CountPadX;
+                            InputX += CountPadX;
+                            CountX -= CountPadX;
+
+                            size_t CountCopyX = 0;
+
+                            if (InputX < ptrdiff_t(InputWidth)) {
+                                CountCopyX = (std::min)(CountX, size_t(ptrdiff_t(InputWidth) - InputX));
+                            }
+
+                            std::copy_n(&InputRow[InputX], CountCopyX, ColumnBuffer);
+                            ColumnBuffer += CountCopyX;
+                            CountX -= CountCopyX;
+
+                            std::fill_n(ColumnBuffer, CountX, ZeroPoint);
+                            ColumnBuffer += CountX;
+
+                        } else {
+
+                            for (; CountX > 0; CountX--) {
+                                *ColumnBuffer++ = (size_t(InputX) < InputWidth) ? InputRow[InputX] : ZeroPoint;
+                                InputX += StrideWidth;
+                            }
+                        }
+                    }
+
+                    ox = 0;
+                    oy++;
+                }
+            }
+        }
+
+        Input += InputSize;
+    }
+}
+
+void
+MlasQConvGemm(
+    const MLAS_QCONV_PARAMETERS* Parameters,
+    const uint8_t* Filter,
+    const uint8_t* FilterZeroPoint,
+    bool PerChannelFilterZeroPoint,
+    const uint8_t* B,
+    size_t ldb,
+    size_t CountM,
+    size_t CountN,
+    int32_t* Output
+    )
+/*++
+
+Routine Description:
+
+    This routine multiplies a slice of the filters of a group with a slice of
+    the convolution patches.
+
+Arguments:
+
+    Parameters - Supplies the structure that contains the convolution
+        parameters.
+
+    Filter - Supplies the first filter of the slice.
+
+    FilterZeroPoint - Supplies the zero point of the filter, or the zero point
+        of each filter of the slice if PerChannelFilterZeroPoint is true.
+
+    PerChannelFilterZeroPoint - Supplies true if each filter has a zero point.
+
+    B - Supplies the K rows of the convolution patches.
+
+    ldb - Supplies the first dimension of the convolution patches.
+
+    CountM - Supplies the count of filters.
+
+    CountN - Supplies the count of convolution patches.
+
+    Output - Supplies the output of the first filter and patch.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t OutputSize = Parameters->OutputSize;
+    const size_t K = Parameters->K;
+    const uint8_t InputZeroPoint = Parameters->InputZeroPoint;
+
+    MlasGemm(CountM, CountN, K, Filter, K,
+        PerChannelFilterZeroPoint ? 0 : FilterZeroPoint[0], B, ldb,
+        InputZeroPoint, Output, OutputSize, nullptr);
+
+    if (PerChannelFilterZeroPoint) {
+
+        //
+        // The GEMM was computed without the filter zero points, so subtract
+        // the product of each zero point and the sum of each patch.
+        //
+
+        int32_t ColumnSums[MLAS_QCONV_MAXIMUM_STRIDEN];
+
+        std::fill_n(ColumnSums, CountN, -int32_t(K) * int32_t(InputZeroPoint));
+
+        for (size_t k = 0; k < K; k++) {
+            for (size_t n = 0; n < CountN; n++) {
+                ColumnSums[n] += B[n];
+            }
+            B += ldb;
+        }
+
+        for (size_t f = 0; f < CountM; f++) {
+
+            const int32_t ZeroPoint = FilterZeroPoint[f];
+
+            for (size_t n = 0; n < CountN; n++) {
+                Output[n] -= ZeroPoint * ColumnSums[n];
+            }
+
+            Output += OutputSize;
+        }
+    }
+}
+
+void
+MlasQConvDepthwise(
+    const MLAS_QCONV_PARAMETERS* Parameters,
+    const uint8_t* Input,
+    const uint8_t* Filter,
+    uint8_t FilterZeroPoint,
+    int32_t* Output
+    )
+/*++
+
+Routine Description:
+
+    This routine convolves a single channel with its filter by accumulating
+    the input rows that contribute to each output row.
+
+Arguments:
+
+    Parameters - Supplies the structure that contains the convolution
+        parameters.
+
+    Input - Supplies the input channel.
+
+    Filter - Supplies the filter of the channel.
+
+    FilterZeroPoint - Supplies the zero point of the filter.
+
+    Output - Supplies the output channel.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    constexpr size_t HeightShapeIndex = 0;
+    constexpr size_t WidthShapeIndex = 1;
+
+    const ptrdiff_t InputHeight = ptrdiff_t(Parameters->InputShape[HeightShapeIndex]);
+    const ptrdiff_t InputWidth = ptrdiff_t(Parameters->InputShape[WidthShapeIndex]);
+
+    const size_t OutputHeight = Parameters->OutputShape[HeightShapeIndex];
+    const size_t OutputWidth = Parameters->OutputShape[WidthShapeIndex];
+
+    const size_t KernelHeight = Parameters->KernelShape[HeightShapeIndex];
+    const size_t KernelWidth = Parameters->KernelShape[WidthShapeIndex];
+
+    const ptrdiff_t DilationHeight = ptrdiff_t(Parameters->DilationShape[HeightShapeIndex]);
+    const ptrdiff_t DilationWidth = ptrdiff_t(Parameters->DilationShape[WidthShapeIndex]);
+
+    const ptrdiff_t PaddingLeftY = ptrdiff_t(Parameters->Padding[HeightShapeIndex]);
+    const ptrdiff_t PaddingLeftX = ptrdiff_t(Parameters->Padding[WidthShapeIndex]);
+
+    const ptrdiff_t StrideHeight = ptrdiff_t(Parameters->StrideShape[HeightShapeIndex]);
+    const ptrdiff_t StrideWidth = ptrdiff_t(Parameters->StrideShape[WidthShapeIndex]);
+
+    const int32_t InputZeroPoint = Parameters->InputZeroPoint;
+
+    for (size_t oy = 0; oy < OutputHeight; oy++) {
+
+        int32_t* OutputRow = Output + oy * OutputWidth;
+
+        std::fill_n(OutputRow, OutputWidth, 0);
+
+        for (size_t ky = 0; ky < KernelHeight; ky++) {
+
+            //
+            // Input rows in the padding region hold the input zero point and
+            // do not contribute to the output.
+            //
+
+            const ptrdiff_t InputY = ptrdiff_t(oy) * StrideHeight + ptrdiff_t(ky) * DilationHeight - PaddingLeftY;
+
+            if (InputY < 0 || InputY >= InputHeight) {
+                continue;
+            }
+
+            const uint8_t* InputRow = Input + InputY * InputWidth;
+
+            for (size_t kx = 0; kx < KernelWidth; kx++) {
+
+                const int32_t FilterValue = int32_t(Filter[ky * KernelWidth + kx]) - int32_t(FilterZeroPoint);
+
+                if (FilterValue == 0) {
+                    continue;
+                }
+
+                //
+                // Compute the range of output columns that read from inside
+                // the input row.
+                //
+
+                const ptrdiff_t OffsetX = ptrdiff_t(kx) * DilationWidth - PaddingLeftX;
+
+                size_t StartX = 0;
+
+                if (OffsetX < 0) {
+                    StartX = size_t((-OffsetX + StrideWidth - 1) / StrideWidth);
+                }
+
+                size_t EndX = 0;
+
+                if (OffsetX < InputWidth) {
+                    EndX = (std::min)(OutputWidth, size_t((InputWidth - OffsetX + StrideWidth - 1) / StrideWidth));
+                }
+
+                if (StrideWidth == 1) {
+
+                    const uint8_t* in = InputRow + OffsetX;
+
+                    for (size_t ox = StartX; ox < EndX; ox++) {
+                        OutputRow[ox] += (int32_t(in[ox]) - InputZeroPoint) * FilterValue;
+                    }
+
+                } else {
+
+                    for (size_t ox = StartX; ox < EndX; ox++) {
+                        OutputRow[ox] += (int32_t(InputRow[ptrdiff_t(ox) * StrideWidth + OffsetX]) - InputZeroPoint) * FilterValue;
+                    }
+                }
+            }
+        }
+    }
+}
+
+void
+MlasQConvThreaded(
+    void* Context,
+    int32_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a range of tiles
+    of a convolution operation.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const MLAS_QCONV_WORK_BLOCK* WorkBlock = (const MLAS_QCONV_WORK_BLOCK*)Context;
+
+    const MLAS_QCONV_PARAMETERS* Parameters = WorkBlock->Parameters;
+
+    //
+    // Compute the range of tiles to use for this thread.
+    //
+
+    const size_t TileCount = WorkBlock->TileCount;
+    const size_t ThreadCount = size_t(Parameters->ThreadCount);
+
+    const size_t TileCountPerThread = TileCount / ThreadCount;
+    const size_t TileCountExtra = TileCount % ThreadCount;
+
+    size_t TileStart;
+    size_t TileEnd;
+
+    if (uint32_t(Index) < TileCountExtra) {
+        TileStart = (TileCountPerThread + 1) * Index;
+        TileEnd = TileStart + TileCountPerThread + 1;
+    } else {
+        TileStart = TileCountPerThread * Index + TileCountExtra;
+        TileEnd = TileStart + TileCountPerThread;
+    }
+
+    const size_t GroupCount = Parameters->GroupCount;
+    const size_t FilterCount = Parameters->FilterCount;
+    const size_t OutputSize = Parameters->OutputSize;
+    const size_t K = Parameters->K;
+    const size_t StrideN = Parameters->StrideN;
+    const size_t StrideM = Parameters->StrideM;
+    const size_t FilterTileCount = WorkBlock->FilterTileCount;
+
+    const size_t InputGroupSize = Parameters->InputChannels * Parameters->InputSize;
+    const size_t OutputGroupSize = FilterCount * OutputSize;
+    const size_t FilterGroupSize = FilterCount * K;
+
+    uint8_t* ColumnBuffer = nullptr;
+
+    if (Parameters->Algorithm == MlasQConvAlgorithmExpandThenGemmSegmented) {
+        ColumnBuffer = WorkBlock->WorkingBuffer + Index * K * StrideN;
+    }
+
+    //
+    // The tiles of filters are the innermost, so the convolution patches in
+    // the column buffer are reused by the consecutive tiles of this thread.
+    //
+
+    size_t ColumnBufferTile = TileEnd;
+
+    for (size_t tile = TileStart; tile < TileEnd; tile++) {
+
+        const size_t ColumnTile = tile / FilterTileCount;
+        const size_t bg = ColumnTile / WorkBlock->TileCountPerBatchGroup;
+        const size_t group = bg % GroupCount;
+
+        const size_t m = (tile % FilterTileCount) * StrideM;
+        const size_t CountM = (std::min)(StrideM, FilterCount - m);
+
+        const uint8_t* input = WorkBlock->Input + bg * InputGroupSize;
+        const uint8_t* filter = WorkBlock->Filter + group * FilterGroupSize + m * K;
+        int32_t* output = WorkBlock->Output + bg * OutputGroupSize + m * OutputSize;
+
+        const uint8_t* FilterZeroPoint = WorkBlock->FilterZeroPoint;
+
+        if (WorkBlock->PerChannelFilterZeroPoint) {
+            FilterZeroPoint += group * FilterCount + m;
+        }
+
+        const size_t n = (ColumnTile % WorkBlock->TileCountPerBatchGroup) * StrideN;
+        const size_t CountN = (std::min)(StrideN, OutputSize - n);
+
+        switch (Parameters->Algorithm) {
+
+            case MlasQConvAlgorithmGemmDirect:
+            {
+                //
+                // The input channels of a pointwise convolution are the
+                // convolution patches.
+                //
+
+                MlasQConvGemm(Parameters, filter, FilterZeroPoint,
+                    WorkBlock->PerChannelFilterZeroPoint, input + n, OutputSize,
+                    CountM, CountN, output + n);
+
+                break;
+            }
+
+            case MlasQConvAlgorithmDepthwise:
+            {
+                MlasQConvDepthwise(Parameters, input, filter, FilterZeroPoint[0], output);
+
+                break;
+            }
+
+            case MlasQConvAlgorithmExpandThenGemmSegmented:
+            {
+                if (ColumnBufferTile != ColumnTile) {
+                    MlasQConvIm2Col(Parameters, input, ColumnBuffer, n, CountN);
+                    ColumnBufferTile = ColumnTile;
+                }
+
+                MlasQConvGemm(Parameters, filter, FilterZeroPoint,
+                    WorkBlock->PerChannelFilterZeroPoint, ColumnBuffer, CountN,
+                    CountM, CountN, output + n);
+
+                break;
+            }
+        }
+    }
+}
+
+void
+MLASCALL
+MlasQConvPrepare(
+    MLAS_QCONV_PARAMETERS* Parameters,
+    size_t Dimensions,
+    size_t BatchCount,
+    size_t GroupCount,
+    size_t InputChannels,
+    const int64_t* InputShape,
+    const int64_t* KernelShape,
+    const int64_t* DilationShape,
+    const int64_t* Padding,
+    const int64_t* StrideShape,
+    const int64_t* OutputShape,
+    size_t FilterCount,
+    uint8_t InputZeroPoint,
+    size_t* WorkingBufferSize,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine prepares for a quantized convolution operation by computing
+    required parameters including the required working buffer size for the
+    convolution patches.
+
+Arguments:
+
+    Parameters - Supplies the structure that stores the provided and computed
+        parameters for the convolution operation.
+
+    Dimensions - Supplies the number of dimensions (must be 1 or 2). A one
+        dimensional convolution is computed as a two dimensional convolution
+        with a height of one.
+
+    BatchCount - Supplies the number of batches to the processed.
+
+    GroupCount - Supplies the number of channel groups.
+
+    InputChannels - Supplies the number of input channels per group.
+
+    InputShape - Supplies the shape of the input tensor.
+
+    KernelShape - Supplies the shape of the kernel transform.
+
+    DilationShape - Supplies the shape of the dilation.
+
+    Padding - Supplies the number of padding elements at the edge of the input
+        tensor.
+
+    StrideShape - Supplies the shape of the stride.
+
+    OutputShape - Supplies the shape of the output tensor.
+
+    FilterCount - Supplies the number of rows of the filter matrix per group.
+
+    InputZeroPoint - Supplies the zero point of the input tensor, which is
+        also the value of the padding elements.
+
+    WorkingBufferSize - Receives the number of bytes to allocate for the
+        working buffer for the convolution patches.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    //
+    // Save the convolution parameters. A one dimensional convolution is
+    // stored as a two dimensional convolution with a height of one.
+    //
+
+    Parameters->BatchCount = BatchCount;
+    Parameters->GroupCount = GroupCount;
+    Parameters->InputChannels = InputChannels;
+    Parameters->FilterCount = FilterCount;
+    Parameters->InputZeroPoint = InputZeroPoint;
+
+    const size_t FirstDimension = 2 - Dimensions;
+
+    for (size_t dim = 0; dim < FirstDimension; dim++) {
+        Parameters->InputShape[dim] = 1;
+        Parameters->OutputShape[dim] = 1;
+        Parameters->KernelShape[dim] = 1;
+        Parameters->DilationShape[dim] = 1;
+        Parameters->Padding[dim] = 0;
+        Parameters->Padding[dim + 2] = 0;
+        Parameters->StrideShape[dim] = 1;
+    }
+
+    size_t InputSize = 1;
+    size_t OutputSize = 1;
+    size_t K = InputChannels;
+
+    bool AllStridesAreOne = true;
+    bool AllPaddingIsZero = true;
+
+    for (size_t dim = 0; dim < Dimensions; dim++) {
+
+        const size_t ParameterDim = FirstDimension + dim;
+
+        Parameters->InputShape[ParameterDim] = size_t(InputShape[dim]);
+        Parameters->OutputShape[ParameterDim] = size_t(OutputShape[dim]);
+        Parameters->KernelShape[ParameterDim] = size_t(KernelShape[dim]);
+        Parameters->DilationShape[ParameterDim] = size_t(DilationShape[dim]);
+        Parameters->Padding[ParameterDim] = size_t(Padding[dim]);
+        Parameters->Padding[ParameterDim + 2] = size_t(Padding[dim + Dimensions]);
+        Parameters->StrideShape[ParameterDim] = size_t(StrideShape[dim]);
+
+        InputSize *= size_t(InputShape[dim]);
+        OutputSize *= size_t(OutputShape[dim]);
+        K *= size_t(KernelShape[dim]);
+
+        AllStridesAreOne &= (StrideShape[dim] == 1);
+        AllPaddingIsZero &= (Padding[dim] == 0 && Padding[dim + Dimensions] == 0);
+    }
+
+    Parameters->InputSize = InputSize;
+    Parameters->OutputSize = OutputSize;
+    Parameters->K = K;
+
+    //
+    // Evaluate how the convolution will be performed and how many output
+    // columns are processed at a time.
+    //
+
+    size_t StrideN = MLAS_QCONV_MAXIMUM_STRIDEN;
+    size_t TileCountPerBatchGroup;
+
+    if (AllStridesAreOne && AllPaddingIsZero && K == InputChannels) {
+
+        Parameters->Algorithm = MlasQConvAlgorithmGemmDirect;
+
+    } else if (InputChannels == 1 && FilterCount == 1) {
+
+        Parameters->Algorithm = MlasQConvAlgorithmDepthwise;
+
+        StrideN = OutputSize;
+
+    } else {
+
+        Parameters->Algorithm = MlasQConvAlgorithmExpandThenGemmSegmented;
+
+        //
+        // Bound the convolution patches of each thread to the working buffer
+        // size, unless the patches are too long to hold the minimum number of
+        // columns.
+        //
+
+        StrideN = MLAS_QCONV_WORKING_BUFFER_SIZE_PER_THREAD / K;
+
+        if (StrideN > MLAS_QCONV_MAXIMUM_STRIDEN) {
+            StrideN = MLAS_QCONV_MAXIMUM_STRIDEN;
+        } else if (StrideN < MLAS_QCONV_MINIMUM_STRIDEN) {
+            StrideN = MLAS_QCONV_MINIMUM_STRIDEN;
+        } else {
+            StrideN &= ~size_t(MLAS_QCONV_MINIMUM_STRIDEN - 1);
+        }
+    }
+
+    if (StrideN > OutputSize) {
+        StrideN = OutputSize;
+    }
+
+    Parameters->StrideN = StrideN;
+
+    TileCountPerBatchGroup = (StrideN > 0) ? (OutputSize + StrideN - 1) / StrideN : 0;
+
+    //
+    // Compute the number of target threads given the complexity of the
+    // convolution operation. Small requests should run using the single
+    // threaded path.
+    //
+
+    double Complexity = double(BatchCount) * double(GroupCount) * double(FilterCount) *
+        double(OutputSize) * double(K);
+
+    int32_t TargetThreadCount;
+
+    if (Complexity < double(MLAS_QCONV_THREAD_COMPLEXITY * MLAS_MAXIMUM_THREAD_COUNT)) {
+        TargetThreadCount = int32_t(Complexity / double(MLAS_QCONV_THREAD_COMPLEXITY)) + 1;
+    } else {
+        TargetThreadCount = MLAS_MAXIMUM_THREAD_COUNT;
+    }
+
+    int32_t MaximumThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+    if (TargetThreadCount >= MaximumThreadCount) {
+        TargetThreadCount = MaximumThreadCount;
+    }
+
+    //
+    // Split the filters across threads if there are fewer tiles of output
+    // columns than threads, such as for a single image with a small output.
+    //
+
+    size_t TileCount = BatchCount * GroupCount * TileCountPerBatchGroup;
+    size_t StrideM = FilterCount;
+
+    if (TileCount > 0 && TileCount < size_t(TargetThreadCount) &&
+        FilterCount > MLAS_QCONV_MINIMUM_STRIDEM) {
+
+        const size_t FilterTileCount = (size_t(TargetThreadCount) + TileCount - 1) / TileCount;
+
+        StrideM = (FilterCount + FilterTileCount - 1) / FilterTileCount;
+
+        if (StrideM < MLAS_QCONV_MINIMUM_STRIDEM) {
+            StrideM = MLAS_QCONV_MINIMUM_STRIDEM;
+        }
+
+        TileCount *= (FilterCount + StrideM - 1) / StrideM;
+    }
+
+    Parameters->StrideM = StrideM;
+
+    if (size_t(TargetThreadCount) >= TileCount) {
+        TargetThreadCount = int32_t((std::max)(TileCount, size_t(1)));
+    }
+
+    Parameters->ThreadCount = TargetThreadCount;
+
+    *WorkingBufferSize = 0;
+
+    if (Parameters->Algorithm == MlasQConvAlgorithmExpandThenGemmSegmented) {
+        *WorkingBufferSize = size_t(TargetThreadCount) * K * StrideN;
+    }
+}
+
+void
+MLASCALL
+MlasQConv(
+    const MLAS_QCONV_PARAMETERS* Parameters,
+    const uint8_t* Input,
+    const uint8_t* Filter,
+    const uint8_t* FilterZeroPoint,
+    bool PerChannelFilterZeroPoint,
+    uint8_t* WorkingBuffer,
+    int32_t* Output,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the quantized convolution operation.
+
+Arguments:
+
+    Parameters - Supplies the structure that contains the convolution
+        parameters.
+
+    Input - Supplies the input tensor.
+
+    Filter - Supplies the filter tensor.
+
+    FilterZeroPoint - Supplies the zero point of the filter tensor, or the
+        zero point of each filter (output channel) if PerChannelFilterZeroPoint
+        is true.
+
+    PerChannelFilterZeroPoint - Supplies true if each filter has a zero point.
+
+    WorkingBuffer - Supplies a working buffer sized to the number of bytes
+        returned by MlasQConvPrepare.
+
+    Output - Supplies the output tensor.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used. This must be the thread
+        pool supplied to MlasQConvPrepare.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_QCONV_WORK_BLOCK WorkBlock;
+
+    WorkBlock.Parameters = Parameters;
+    WorkBlock.Input = Input;
+    WorkBlock.Filter = Filter;
+    WorkBlock.FilterZeroPoint = FilterZeroPoint;
+    WorkBlock.PerChannelFilterZeroPoint = PerChannelFilterZeroPoint;
+    WorkBlock.WorkingBuffer = WorkingBuffer;
+    WorkBlock.Output = Output;
+
+    if (Parameters->StrideN == 0 || Parameters->StrideM == 0) {
+        return;
+    }
+
+    WorkBlock.TileCountPerBatchGroup = (Parameters->OutputSize + Parameters->StrideN - 1) / Parameters->StrideN;
+    WorkBlock.FilterTileCount = (Parameters->FilterCount + Parameters->StrideM - 1) / Parameters->StrideM;
+    WorkBlock.TileCount = Parameters->BatchCount * Parameters->GroupCount * WorkBlock.TileCountPerBatchGroup *
+        WorkBlock.FilterTileCount;
+
+    MlasExecuteThreaded(MlasQConvThreaded, &WorkBlock, Parameters->ThreadCount, ThreadPool);
+}
+
+#endif
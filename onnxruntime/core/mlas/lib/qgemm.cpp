@@ -1286,4 +1286,360 @@ MlasGemm(
     }
 }
 
+//
+// Packed matrix B implementation.
+//
+// The packed buffer stores matrix B as slices of MLAS_GEMM_U8X8_STRIDEK rows.
+// Each slice holds the columns as packed by the platform copy routine over the
+// full width of the matrix, followed after the last slice by the sums of the
+// columns of each slice. The sums are stored without the zero point offset of
+// matrix A, which is applied when the packed matrix is multiplied.
+//
+
+#define MLAS_GEMM_U8X8_PACKED_STRIDEK       128
+
+static_assert(MLAS_GEMM_U8S8_STRIDEK == MLAS_GEMM_U8X8_PACKED_STRIDEK &&
+              MLAS_GEMM_U8U8_STRIDEK == MLAS_GEMM_U8X8_PACKED_STRIDEK,
+              "The packed slices must match the strides of the kernels");
+
+inline
+size_t
+MlasGemmU8X8PackedCountK(
+    size_t CountK,
+    bool BIsSigned
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the number of rows of a slice of the packed matrix
+    B. The copy routines pad the rows to a multiple of four for U8S8 and a
+    multiple of two for U8U8.
+
+Arguments:
+
+    CountK - Supplies the number of rows of the slice of matrix B.
+
+    BIsSigned - Supplies true if matrix B is signed.
+
+Return Value:
+
+    Returns the number of rows of the packed slice.
+
+--*/
+{
+    return BIsSigned ? (CountK + 3) & ~size_t(3) : (CountK + 1) & ~size_t(1);
+}
+
+inline
+size_t
+MlasGemmU8X8PackedColumnSumOffset(
+    size_t N,
+    size_t K,
+    bool BIsSigned
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the byte offset of the column sums in the packed
+    buffer.
+
+Arguments:
+
+    N - Supplies the number of columns of matrix B.
+
+    K - Supplies the number of rows of matrix B.
+
+    BIsSigned - Supplies true if matrix B is signed.
+
+Return Value:
+
+    Returns the offset of the column sums.
+
+--*/
+{
+    const size_t AlignedN = (N + 15) & ~size_t(15);
+
+    return AlignedN * MlasGemmU8X8PackedCountK(K, BIsSigned);
+}
+
+size_t
+MLASCALL
+MlasGemmPackBSize(
+    size_t N,
+    size_t K,
+    bool BIsSigned
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the number of bytes required to pack matrix B for
+    the quantized integer matrix/matrix multiply operation (QGEMM).
+
+Arguments:
+
+    N - Supplies the number of columns of matrix B.
+
+    K - Supplies the number of rows of matrix B.
+
+    BIsSigned - Supplies true if matrix B is signed (U8S8), else false (U8U8).
+
+Return Value:
+
+    Returns the size of the packed buffer in bytes.
+
+--*/
+{
+    const size_t AlignedN = (N + 15) & ~size_t(15);
+    const size_t SliceCount = (K + MLAS_GEMM_U8X8_PACKED_STRIDEK - 1) / MLAS_GEMM_U8X8_PACKED_STRIDEK;
+
+    return MlasGemmU8X8PackedColumnSumOffset(N, K, BIsSigned) + AlignedN * SliceCount * sizeof(int32_t);
+}
+
+void
+MLASCALL
+MlasGemmPackB(
+    size_t N,
+    size_t K,
+    const uint8_t* B,
+    size_t ldb,
+    bool BIsSigned,
+    void* PackedB
+    )
+/*++
+
+Routine Description:
+
+    This routine packs matrix B for the quantized integer matrix/matrix
+    multiply operation (QGEMM), so that the packing work done for every call
+    to MlasGemm is done once for a constant matrix.
+
+Arguments:
+
+    N - Supplies the number of columns of matrix B.
+
+    K - Supplies the number of rows of matrix B.
+
+    B - Supplies the address of matrix B. The elements are reinterpreted as
+        int8_t if BIsSigned is true.
+
+    ldb - Supplies the first dimension of matrix B.
+
+    BIsSigned - Supplies true if matrix B is signed (U8S8), else false (U8U8).
+
+    PackedB - Supplies the address of the packed buffer. The buffer must be
+        MlasGemmPackBSize bytes and aligned to MlasGetPreferredBufferAlignment.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t AlignedN = (N + 15) & ~size_t(15);
+
+    uint8_t* D = (uint8_t*)PackedB;
+    int32_t* ColumnSums = (int32_t*)(D + MlasGemmU8X8PackedColumnSumOffset(N, K, BIsSigned));
+
+    size_t CountK;
+
+    for (size_t k = 0; k < K; k += CountK) {
+
+        CountK = MLAS_GEMM_U8X8_PACKED_STRIDEK;
+
+        if (CountK > (K - k)) {
+            CountK = K - k;
+        }
+
+        //
+        // Pack the slice with an offset of one so that the plain sums of the
+        // columns are stored.
+        //
+
+        if (BIsSigned) {
+            MlasPlatform.GemmU8S8CopyPackBRoutine((int8_t*)D, (const int8_t*)B + k * ldb, ldb, N, CountK, ColumnSums, 1);
+        } else {
+            MlasPlatform.GemmU8U8CopyPackBRoutine(D, B + k * ldb, ldb, N, CountK, ColumnSums, 1);
+        }
+
+        D += AlignedN * MlasGemmU8X8PackedCountK(CountK, BIsSigned);
+        ColumnSums += AlignedN;
+    }
+}
+
+void
+MLASCALL
+MlasGemm(
+    size_t M,
+    size_t N,
+    size_t K,
+    const uint8_t* A,
+    size_t lda,
+    uint8_t offa,
+    const void* PackedB,
+    uint8_t offb,
+    bool BIsSigned,
+    int32_t* C,
+    size_t ldc,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the quantized integer matrix/matrix multiply
+    operation (QGEMM) with a matrix B packed by MlasGemmPackB.
+
+Arguments:
+
+    M - Supplies the number of rows of matrix A and matrix C.
+
+    N - Supplies the number of columns of matrix B and matrix C.
+
+    K - Supplies the number of columns of matrix A and the number of rows of
+        matrix B.
+
+    A - Supplies the address of matrix A.
+
+    lda - Supplies the first dimension of matrix A.
+
+    offa - Supplies the zero point offset of matrix A.
+
+    PackedB - Supplies the address of the packed matrix B.
+
+    offb - Supplies the zero point offset of matrix B. The offset is
+        reinterpreted as int8_t if BIsSigned is true.
+
+    BIsSigned - Supplies true if matrix B is signed (U8S8), else false (U8U8).
+
+    C - Supplies the address of matrix C.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_DECLSPEC_ALIGN(int16_t PanelA[MLAS_GEMM_U8U8_STRIDEM * MLAS_GEMM_U8X8_PACKED_STRIDEK], 64);
+
+    MLAS_DECLSPEC_ALIGN(int32_t RowSumVector[MLAS_GEMM_U8S8_STRIDEM], 16);
+    MLAS_DECLSPEC_ALIGN(int32_t ColumnSumVector[MLAS_GEMM_U8S8_STRIDEN], 16);
+
+    static_assert(MLAS_GEMM_U8S8_STRIDEM == MLAS_GEMM_U8U8_STRIDEM &&
+                  MLAS_GEMM_U8S8_STRIDEN == MLAS_GEMM_U8U8_STRIDEN,
+                  "The packed operation shares the buffers of both kernels");
+
+    const size_t StrideM = MLAS_GEMM_U8S8_STRIDEM;
+    const size_t StrideN = MLAS_GEMM_U8S8_STRIDEN;
+
+    const size_t AlignedN = (N + 15) & ~size_t(15);
+    const int32_t OffsetB = BIsSigned ? int32_t(int8_t(offb)) : int32_t(offb);
+
+    const uint8_t* PackedData = (const uint8_t*)PackedB;
+    const int32_t* PackedColumnSums =
+        (const int32_t*)(PackedData + MlasGemmU8X8PackedColumnSumOffset(N, K, BIsSigned));
+
+    MLAS_UNREFERENCED_PARAMETER(ThreadPool);
+
+    size_t CountK;
+
+    for (size_t k = 0; k < K; k += CountK) {
+
+        CountK = MLAS_GEMM_U8X8_PACKED_STRIDEK;
+
+        if (CountK > (K - k)) {
+            CountK = K - k;
+        }
+
+        const size_t PackedCountK = MlasGemmU8X8PackedCountK(CountK, BIsSigned);
+
+        size_t CountN;
+
+        for (size_t n = 0; n < N; n += CountN) {
+
+            CountN = StrideN;
+
+            if (CountN > (N - n)) {
+                CountN = N - n;
+            }
+
+            //
+            // Address the panel of the packed slice and apply the zero point
+            // offset of matrix A to the sums of its columns.
+            //
+
+            const uint8_t* PanelB = PackedData + AlignedN * k + PackedCountK * n;
+
+            const int32_t* PackedSums = PackedColumnSums + AlignedN * (k / MLAS_GEMM_U8X8_PACKED_STRIDEK) + n;
+            const size_t AlignedCountN = (CountN + 15) & ~size_t(15);
+
+            for (size_t i = 0; i < AlignedCountN; i++) {
+                ColumnSumVector[i] = PackedSums[i] * -int32_t(offa);
+            }
+
+            size_t CountM;
+
+            for (size_t m = 0; m < M; m += CountM) {
+
+                CountM = StrideM;
+
+                if (CountM > (M - m)) {
+                    CountM = M - m;
+                }
+
+                int32_t* c = C + n + m * ldc;
+
+                int32_t* RowSums = RowSumVector;
+
+                size_t RowsRemaining = CountM;
+                size_t RowsHandled;
+
+                if (BIsSigned) {
+
+                    uint8_t* pa = (uint8_t*)PanelA;
+
+                    MlasPlatform.GemmU8S8CopyPackARoutine(pa, A + k + m * lda, lda, CountM, CountK, RowSumVector, -int16_t(OffsetB));
+
+                    size_t QuadCountK = PackedCountK / 4;
+
+                    while (RowsRemaining > 0) {
+
+                        RowsHandled = MlasPlatform.GemmU8S8Kernel(pa, (const int8_t*)PanelB, c, QuadCountK, RowsRemaining, CountN, ldc, RowSums, ColumnSumVector, int32_t(CountK) * offa * OffsetB, k == 0);
+
+                        RowsRemaining -= RowsHandled;
+                        c += ldc * RowsHandled;
+                        pa += 4 * QuadCountK * RowsHandled;
+                        RowSums += RowsHandled;
+                    }
+
+                } else {
+
+                    int16_t* pa = PanelA;
+
+                    MlasPlatform.GemmU8U8CopyPackARoutine(pa, A + k + m * lda, lda, CountM, CountK, RowSumVector, -int16_t(OffsetB));
+
+                    size_t PairCountK = PackedCountK / 2;
+
+                    while (RowsRemaining > 0) {
+
+                        RowsHandled = MlasPlatform.GemmU8U8Kernel(pa, PanelB, c, PairCountK, RowsRemaining, CountN, ldc, RowSums, ColumnSumVector, int32_t(CountK) * offa * OffsetB, k == 0);
+
+                        RowsRemaining -= RowsHandled;
+                        c += ldc * RowsHandled;
+                        pa += 2 * PairCountK * RowsHandled;
+                        RowSums += RowsHandled;
+                    }
+                }
+            }
+        }
+    }
+}
+
 #endif
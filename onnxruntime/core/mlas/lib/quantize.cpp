@@ -0,0 +1,185 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    quantize.cpp
+
+Abstract:
+
+    This module implements routines to requantize the 32-bit output of a
+    quantized matrix multiply to 8 bits.
+
+--*/
+
+#include "mlasi.h"
+#include <cmath>
+
+void
+MlasRequantizeOutputRow(
+    const int32_t* Input,
+    uint8_t* Output,
+    int32_t Bias,
+    size_t N,
+    const float* Scale,
+    bool PerColumnScale,
+    uint8_t ZeroPoint
+    )
+/*++
+
+Routine Description:
+
+    This routine requantizes a row of 32-bit accumulators to 8 bits.
+
+Arguments:
+
+    Input - Supplies the input row.
+
+    Output - Supplies the output row.
+
+    Bias - Supplies the bias added to every element of the row.
+
+    N - Supplies the number of elements in the row.
+
+    Scale - Supplies the scale of the row, or the scale of each column if
+        PerColumnScale is true.
+
+    PerColumnScale - Supplies true if Scale holds one value per column.
+
+    ZeroPoint - Supplies the zero point of the output.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    //
+    // The scaled value is clamped to the output range before it is rounded,
+    // which keeps large accumulators from overflowing the conversion to an
+    // integer. Clamping to integral bounds does not change the rounded value.
+    //
+
+    const float MinimumValue = float(0 - int32_t(ZeroPoint));
+    const float MaximumValue = float(255 - int32_t(ZeroPoint));
+
+#if defined(MLAS_SSE2_INTRINSICS)
+
+    const __m128i BiasVector = _mm_set1_epi32(Bias);
+    const __m128i ZeroPointVector = _mm_set1_epi16(int16_t(ZeroPoint));
+    const MLAS_FLOAT32X4 MinimumVector = MlasBroadcastFloat32x4(MinimumValue);
+    const MLAS_FLOAT32X4 MaximumVector = MlasBroadcastFloat32x4(MaximumValue);
+    MLAS_FLOAT32X4 ScaleVector = MlasBroadcastFloat32x4(Scale);
+
+    while (N >= 8) {
+
+        __m128i IntegerVector0 = _mm_add_epi32(_mm_loadu_si128((const __m128i*)&Input[0]), BiasVector);
+        __m128i IntegerVector1 = _mm_add_epi32(_mm_loadu_si128((const __m128i*)&Input[4]), BiasVector);
+
+        MLAS_FLOAT32X4 FloatVector0 = _mm_cvtepi32_ps(IntegerVector0);
+        MLAS_FLOAT32X4 FloatVector1 = _mm_cvtepi32_ps(IntegerVector1);
+
+        if (PerColumnScale) {
+            FloatVector0 = MlasMultiplyFloat32x4(FloatVector0, MlasLoadFloat32x4(&Scale[0]));
+            FloatVector1 = MlasMultiplyFloat32x4(FloatVector1, MlasLoadFloat32x4(&Scale[4]));
+            Scale += 8;
+        } else {
+            FloatVector0 = MlasMultiplyFloat32x4(FloatVector0, ScaleVector);
+            FloatVector1 = MlasMultiplyFloat32x4(FloatVector1, ScaleVector);
+        }
+
+        FloatVector0 = MlasMinimumFloat32x4(MlasMaximumFloat32x4(FloatVector0, MinimumVector), MaximumVector);
+        FloatVector1 = MlasMinimumFloat32x4(MlasMaximumFloat32x4(FloatVector1, MinimumVector), MaximumVector);
+
+        //
+        // Convert with the default rounding mode (round half to even), then
+        // add the zero point and narrow to 8 bits.
+        //
+
+        IntegerVector0 = _mm_cvtps_epi32(FloatVector0);
+        IntegerVector1 = _mm_cvtps_epi32(FloatVector1);
+
+        __m128i WordVector = _mm_adds_epi16(_mm_packs_epi32(IntegerVector0, IntegerVector1), ZeroPointVector);
+        __m128i ByteVector = _mm_packus_epi16(WordVector, WordVector);
+
+        _mm_storel_epi64((__m128i*)Output, ByteVector);
+
+        Input += 8;
+        Output += 8;
+        N -= 8;
+    }
+
+#endif
+
+    for (size_t n = 0; n < N; n++) {
+
+        float FloatValue = float(Input[n] + Bias) * (PerColumnScale ? Scale[n] : Scale[0]);
+
+        FloatValue = (std::min)((std::max)(FloatValue, MinimumValue), MaximumValue);
+
+        Output[n] = uint8_t(int32_t(std::nearbyint(FloatValue)) + int32_t(ZeroPoint));
+    }
+}
+
+void
+MLASCALL
+MlasRequantizeOutput(
+    const int32_t* Input,
+    uint8_t* Output,
+    const int32_t* Bias,
+    size_t M,
+    size_t N,
+    const float* Scale,
+    MLAS_QUANTIZATION_GRANULARITY ScaleGranularity,
+    uint8_t ZeroPoint
+    )
+/*++
+
+Routine Description:
+
+    This routine requantizes the 32-bit output of a quantized matrix multiply
+    to 8 bits. Each element is computed as:
+
+        Output = Saturate(Round((Input + Bias) * Scale) + ZeroPoint)
+
+Arguments:
+
+    Input - Supplies the M rows by N columns input matrix.
+
+    Output - Supplies the M rows by N columns output matrix. The output may
+        not overlap the input.
+
+    Bias - Optionally supplies the bias for each row of the matrix.
+
+    M - Supplies the number of rows of the matrix.
+
+    N - Supplies the number of columns of the matrix.
+
+    Scale - Supplies the scale for the matrix, for each row or for each
+        column of the matrix, as selected by ScaleGranularity.
+
+    ScaleGranularity - Supplies the granularity of the scale.
+
+    ZeroPoint - Supplies the zero point of the output.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    for (size_t m = 0; m < M; m++) {
+
+        const int32_t RowBias = (Bias != nullptr) ? Bias[m] : 0;
+        const float* RowScale = (ScaleGranularity == MlasPerRow) ? &Scale[m] : Scale;
+
+        MlasRequantizeOutputRow(Input, Output, RowBias, N, RowScale,
+            ScaleGranularity == MlasPerColumn, ZeroPoint);
+
+        Input += N;
+        Output += N;
+    }
+}
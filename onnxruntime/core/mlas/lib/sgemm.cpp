@@ -40,12 +40,15 @@ struct MLAS_SGEMM_WORK_BLOCK {
     size_t ldc;
     float alpha;
     float beta;
+    const float* PackedB;
+    size_t PackedN;
     struct SEGMENT {
         size_t M;
         size_t N;
         const float* A;
         const float* B;
         float* C;
+        size_t StartN;
     } Segments[MLAS_MAXIMUM_THREAD_COUNT];
 };
 
@@ -762,6 +765,148 @@ Return Value:
     }
 }
 
+void
+MlasSgemmMultiplyPanel(
+    CBLAS_TRANSPOSE TransA,
+    size_t M,
+    size_t CountN,
+    size_t CountK,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const float* PanelB,
+    float* C,
+    size_t ldc,
+    bool ZeroMode
+    )
+/*++
+
+Routine Description:
+
+    This routine multiplies a slice of matrix A with a packed panel of matrix
+    B and stores or accumulates the result to the output matrix.
+
+Arguments:
+
+    TransA - Supplies the transpose operation for matrix A.
+
+    M - Supplies the number of rows of matrix A and matrix C.
+
+    CountN - Supplies the number of columns of the packed panel and matrix C.
+
+    CountK - Supplies the number of rows of the packed panel and the number of
+        elements of matrix A to multiply with each of its columns.
+
+    alpha - Supplies the scalar alpha multiplier (see SGEMM definition).
+
+    A - Supplies the address of the slice of matrix A.
+
+    lda - Supplies the first dimension of matrix A.
+
+    PanelB - Supplies the address of the packed panel of matrix B.
+
+    C - Supplies the address of matrix C.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    ZeroMode - Supplies true if the output matrix must be zero initialized,
+        else false if the output matrix is accumulated into.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    float PanelA[MLAS_SGEMM_TRANSA_ROWS * MLAS_SGEMM_STRIDEK];
+
+    //
+    // Step through each slice of matrix A along the M dimension.
+    //
+
+    float* c = C;
+
+    size_t RowsRemaining = M;
+    size_t RowsHandled;
+
+    if (TransA == CblasNoTrans) {
+
+        const float* a = A;
+
+        //
+        // Step through the rows of matrix A.
+        //
+
+        do {
+
+#if defined(MLAS_TARGET_AMD64_IX86)
+            RowsHandled = MlasPlatform.GemmFloatKernel(a, PanelB, c, CountK, RowsRemaining, CountN, lda, ldc, alpha, ZeroMode);
+#else
+            if (ZeroMode) {
+                RowsHandled = MlasSgemmKernelZero(a, PanelB, c, CountK, RowsRemaining, CountN, lda, ldc, alpha);
+            } else {
+                RowsHandled = MlasSgemmKernelAdd(a, PanelB, c, CountK, RowsRemaining, CountN, lda, ldc, alpha);
+            }
+#endif
+
+            c += ldc * RowsHandled;
+            a += lda * RowsHandled;
+
+            RowsRemaining -= RowsHandled;
+
+        } while (RowsRemaining > 0);
+
+    } else {
+
+        const float* a = A;
+
+        do {
+
+            //
+            // Transpose elements from matrix A into a local buffer.
+            //
+
+            size_t RowsTransposed = RowsRemaining;
+
+            if (RowsTransposed > MLAS_SGEMM_TRANSA_ROWS) {
+                RowsTransposed = MLAS_SGEMM_TRANSA_ROWS;
+            }
+
+            RowsRemaining -= RowsTransposed;
+
+            MlasSgemmTransposeA(PanelA, a, lda, RowsTransposed, CountK);
+
+            a += RowsTransposed;
+
+            //
+            // Step through the rows of the local buffer.
+            //
+
+            const float* pa = PanelA;
+
+            do {
+
+#if defined(MLAS_TARGET_AMD64_IX86)
+                RowsHandled = MlasPlatform.GemmFloatKernel(pa, PanelB, c, CountK, RowsTransposed, CountN, CountK, ldc, alpha, ZeroMode);
+#else
+                if (ZeroMode) {
+                    RowsHandled = MlasSgemmKernelZero(pa, PanelB, c, CountK, RowsTransposed, CountN, CountK, ldc, alpha);
+                } else {
+                    RowsHandled = MlasSgemmKernelAdd(pa, PanelB, c, CountK, RowsTransposed, CountN, CountK, ldc, alpha);
+                }
+#endif
+
+                c += ldc * RowsHandled;
+                pa += CountK * RowsHandled;
+
+                RowsTransposed -= RowsHandled;
+
+            } while (RowsTransposed > 0);
+
+        } while (RowsRemaining > 0);
+    }
+}
+
 void
 MlasSgemmOperation(
     CBLAS_TRANSPOSE TransA,
@@ -820,7 +965,6 @@ Return Value:
 
 --*/
 {
-    float PanelA[MLAS_SGEMM_TRANSA_ROWS * MLAS_SGEMM_STRIDEK];
     MLAS_DECLSPEC_ALIGN(float PanelB[MLAS_SGEMM_STRIDEN * MLAS_SGEMM_STRIDEK], 16 * sizeof(float));
 
     //
@@ -924,90 +1068,122 @@ Return Value:
             }
 
             //
-            // Step through each slice of matrix A along the M dimension.
+            // Multiply the panel of matrix B with the slice of matrix A.
             //
 
-            float* c = C + n;
+            const float* a = (TransA == CblasNoTrans) ? A + k : A + k * lda;
 
-            size_t RowsRemaining = M;
-            size_t RowsHandled;
+            MlasSgemmMultiplyPanel(TransA, M, CountN, CountK, alpha, a, lda, PanelB, C + n, ldc, ZeroMode);
+        }
+    }
+}
 
-            if (TransA == CblasNoTrans) {
+void
+MlasSgemmPackedOperation(
+    CBLAS_TRANSPOSE TransA,
+    size_t M,
+    size_t StartN,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const float* PackedB,
+    size_t PackedN,
+    float beta,
+    float* C,
+    size_t ldc
+    )
+/*++
 
-                const float* a = A + k;
+Routine Description:
 
-                //
-                // Step through the rows of matrix A.
-                //
+    This routine implements the single precision matrix/matrix multiply
+    operation (SGEMM) for a range of columns of a matrix B that has been
+    packed by MlasGemmPackB.
 
-                do {
+Arguments:
 
-#if defined(MLAS_TARGET_AMD64_IX86)
-                    RowsHandled = MlasPlatform.GemmFloatKernel(a, PanelB, c, CountK, RowsRemaining, CountN, lda, ldc, alpha, ZeroMode);
-#else
-                    if (ZeroMode) {
-                        RowsHandled = MlasSgemmKernelZero(a, PanelB, c, CountK, RowsRemaining, CountN, lda, ldc, alpha);
-                    } else {
-                        RowsHandled = MlasSgemmKernelAdd(a, PanelB, c, CountK, RowsRemaining, CountN, lda, ldc, alpha);
-                    }
-#endif
+    TransA - Supplies the transpose operation for matrix A.
 
-                    c += ldc * RowsHandled;
-                    a += lda * RowsHandled;
+    M - Supplies the number of rows of matrix A and matrix C.
 
-                    RowsRemaining -= RowsHandled;
+    StartN - Supplies the first column of the packed matrix B to multiply.
+        The column must be a multiple of 16.
 
-                } while (RowsRemaining > 0);
+    N - Supplies the number of columns of matrix B and matrix C to compute.
 
-            } else {
+    K - Supplies the number of columns of matrix A and the number of rows of
+        matrix B.
 
-                const float* a = A + k * lda;
+    alpha - Supplies the scalar alpha multiplier (see SGEMM definition).
 
-                do {
+    A - Supplies the address of matrix A.
 
-                    //
-                    // Transpose elements from matrix A into a local buffer.
-                    //
+    lda - Supplies the first dimension of matrix A.
 
-                    size_t RowsTransposed = RowsRemaining;
+    PackedB - Supplies the address of the packed matrix B.
 
-                    if (RowsTransposed > MLAS_SGEMM_TRANSA_ROWS) {
-                        RowsTransposed = MLAS_SGEMM_TRANSA_ROWS;
-                    }
+    PackedN - Supplies the number of columns of the packed matrix B rounded
+        up to a multiple of 16.
 
-                    RowsRemaining -= RowsTransposed;
+    beta - Supplies the scalar beta multiplier (see SGEMM definition).
 
-                    MlasSgemmTransposeA(PanelA, a, lda, RowsTransposed, CountK);
+    C - Supplies the address of matrix C.
 
-                    a += RowsTransposed;
+    ldc - Supplies the first dimension of matrix C.
 
-                    //
-                    // Step through the rows of the local buffer.
-                    //
+Return Value:
 
-                    const float* pa = PanelA;
+    None.
 
-                    do {
+--*/
+{
+    //
+    // Step through each slice of matrix B along the N dimension.
+    //
 
-#if defined(MLAS_TARGET_AMD64_IX86)
-                        RowsHandled = MlasPlatform.GemmFloatKernel(pa, PanelB, c, CountK, RowsTransposed, CountN, CountK, ldc, alpha, ZeroMode);
-#else
-                        if (ZeroMode) {
-                            RowsHandled = MlasSgemmKernelZero(pa, PanelB, c, CountK, RowsTransposed, CountN, CountK, ldc, alpha);
-                        } else {
-                            RowsHandled = MlasSgemmKernelAdd(pa, PanelB, c, CountK, RowsTransposed, CountN, CountK, ldc, alpha);
-                        }
-#endif
+    size_t CountN;
+    size_t CountK;
+
+    for (size_t n = 0; n < N; n += CountN) {
+
+        CountN = MLAS_SGEMM_STRIDEN;
+
+        if (CountN > (N - n)) {
+            CountN = N - n;
+        }
+
+        //
+        // Multiply the output matrix by beta as needed.
+        //
 
-                        c += ldc * RowsHandled;
-                        pa += CountK * RowsHandled;
+        if (beta != 0.0f && beta != 1.0f) {
+            MlasSgemmMultiplyBeta(C + n, M, CountN, ldc, beta);
+        }
+
+        //
+        // Step through each slice of matrix B along the K dimension. The
+        // packed matrix stores each slice of MLAS_SGEMM_STRIDEK rows with the
+        // columns unrolled in blocks of 16, so the panel for this slice is
+        // addressed directly.
+        //
 
-                        RowsTransposed -= RowsHandled;
+        for (size_t k = 0; k < K; k += CountK) {
 
-                    } while (RowsTransposed > 0);
+            bool ZeroMode = (k == 0 && beta == 0.0f);
 
-                } while (RowsRemaining > 0);
+            CountK = MLAS_SGEMM_STRIDEK;
+
+            if (CountK > (K - k)) {
+                CountK = K - k;
             }
+
+            const float* PanelB = PackedB + PackedN * k + CountK * (StartN + n);
+
+            const float* a = (TransA == CblasNoTrans) ? A + k : A + k * lda;
+
+            MlasSgemmMultiplyPanel(TransA, M, CountN, CountK, alpha, a, lda, PanelB, C + n, ldc, ZeroMode);
         }
     }
 }
@@ -1040,10 +1216,20 @@ Return Value:
 
     MLAS_SGEMM_WORK_BLOCK::SEGMENT* Segment = &WorkBlock->Segments[Index];
 
-    MlasSgemmOperation(WorkBlock->TransA, WorkBlock->TransB, Segment->M,
-        Segment->N, WorkBlock->K, WorkBlock->alpha, Segment->A, WorkBlock->lda,
-        Segment->B, WorkBlock->ldb, WorkBlock->beta, Segment->C,
-        WorkBlock->ldc);
+    if (WorkBlock->PackedB != nullptr) {
+
+        MlasSgemmPackedOperation(WorkBlock->TransA, Segment->M, Segment->StartN,
+            Segment->N, WorkBlock->K, WorkBlock->alpha, Segment->A, WorkBlock->lda,
+            WorkBlock->PackedB, WorkBlock->PackedN, WorkBlock->beta, Segment->C,
+            WorkBlock->ldc);
+
+    } else {
+
+        MlasSgemmOperation(WorkBlock->TransA, WorkBlock->TransB, Segment->M,
+            Segment->N, WorkBlock->K, WorkBlock->alpha, Segment->A, WorkBlock->lda,
+            Segment->B, WorkBlock->ldb, WorkBlock->beta, Segment->C,
+            WorkBlock->ldc);
+    }
 }
 
 inline
@@ -1059,6 +1245,7 @@ MlasSgemmTryMultithread(
     size_t lda,
     const float* B,
     size_t ldb,
+    const float* PackedB,
     float beta,
     float* C,
     size_t ldc,
@@ -1094,6 +1281,9 @@ Arguments:
 
     ldb - Supplies the first dimension of matrix B.
 
+    PackedB - Supplies the address of matrix B packed by MlasGemmPackB, else
+        nullptr if matrix B is supplied by B and ldb.
+
     beta - Supplies the scalar beta multiplier (see SGEMM definition).
 
     C - Supplies the address of matrix C.
@@ -1148,6 +1338,8 @@ Return Value:
     WorkBlock.ldc = ldc;
     WorkBlock.alpha = alpha;
     WorkBlock.beta = beta;
+    WorkBlock.PackedB = PackedB;
+    WorkBlock.PackedN = (N + 15) & ~size_t(15);
 
     //
     // Segment the operation across multiple threads.
@@ -1179,8 +1371,9 @@ Return Value:
             WorkBlock.Segments[Index].M = M;
             WorkBlock.Segments[Index].N = CountN;
             WorkBlock.Segments[Index].A = A;
-            WorkBlock.Segments[Index].B = B + n * pldb;
+            WorkBlock.Segments[Index].B = (PackedB == nullptr) ? B + n * pldb : nullptr;
             WorkBlock.Segments[Index].C = C + n;
+            WorkBlock.Segments[Index].StartN = n;
 
             Index++;
         }
@@ -1208,6 +1401,7 @@ Return Value:
             WorkBlock.Segments[Index].A = A + m * plda;
             WorkBlock.Segments[Index].B = B;
             WorkBlock.Segments[Index].C = C + m * ldc;
+            WorkBlock.Segments[Index].StartN = 0;
 
             Index++;
         }
@@ -1286,7 +1480,178 @@ Return Value:
     // single thread based on the GEMM parameters and system configuration.
     //
 
-    if (!MlasSgemmTryMultithread(TransA, TransB, M, N, K, alpha, A, lda, B, ldb, beta, C, ldc, ThreadPool)) {
+    if (!MlasSgemmTryMultithread(TransA, TransB, M, N, K, alpha, A, lda, B, ldb, nullptr, beta, C, ldc, ThreadPool)) {
         MlasSgemmOperation(TransA, TransB, M, N, K, alpha, A, lda, B, ldb, beta, C, ldc);
     }
 }
+
+size_t
+MLASCALL
+MlasGemmPackBSize(
+    size_t N,
+    size_t K
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the number of bytes required to pack matrix B for
+    the single precision matrix/matrix multiply operation (SGEMM).
+
+Arguments:
+
+    N - Supplies the number of columns of matrix B.
+
+    K - Supplies the number of rows of matrix B.
+
+Return Value:
+
+    Returns the size of the packed buffer in bytes.
+
+--*/
+{
+    //
+    // Compute the number of bytes required to hold the packed buffer. The
+    // columns are padded to a multiple of 16 for the panels consumed by the
+    // kernels.
+    //
+
+    const size_t AlignedN = (N + 15) & ~size_t(15);
+
+    return AlignedN * K * sizeof(float);
+}
+
+void
+MLASCALL
+MlasGemmPackB(
+    CBLAS_TRANSPOSE TransB,
+    size_t N,
+    size_t K,
+    const float* B,
+    size_t ldb,
+    void* PackedB
+    )
+/*++
+
+Routine Description:
+
+    This routine packs matrix B for the single precision matrix/matrix
+    multiply operation (SGEMM), so that the packing work done for every call
+    to MlasGemm is done once for a constant matrix.
+
+    The packed matrix is stored as slices of MLAS_SGEMM_STRIDEK rows. Each
+    slice holds the panels that MlasGemm would otherwise copy to its local
+    buffer for that slice.
+
+Arguments:
+
+    TransB - Supplies the transpose operation for matrix B.
+
+    N - Supplies the number of columns of matrix B.
+
+    K - Supplies the number of rows of matrix B.
+
+    B - Supplies the address of matrix B.
+
+    ldb - Supplies the first dimension of matrix B.
+
+    PackedB - Supplies the address of the packed buffer. The buffer must be
+        MlasGemmPackBSize bytes and aligned to MlasGetPreferredBufferAlignment.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t AlignedN = (N + 15) & ~size_t(15);
+
+    float* D = (float*)PackedB;
+
+    size_t CountK;
+
+    for (size_t k = 0; k < K; k += CountK) {
+
+        CountK = MLAS_SGEMM_STRIDEK;
+
+        if (CountK > (K - k)) {
+            CountK = K - k;
+        }
+
+        if (TransB == CblasNoTrans) {
+            MlasSgemmCopyPackB(D, B + k * ldb, ldb, N, CountK);
+        } else {
+            MlasSgemmTransposePackB(D, B + k, ldb, N, CountK);
+        }
+
+        D += AlignedN * CountK;
+    }
+}
+
+void
+MLASCALL
+MlasGemm(
+    CBLAS_TRANSPOSE TransA,
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const void* PackedB,
+    float beta,
+    float* C,
+    size_t ldc,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the single precision matrix/matrix multiply
+    operation (SGEMM) with a matrix B packed by MlasGemmPackB.
+
+Arguments:
+
+    TransA - Supplies the transpose operation for matrix A.
+
+    M - Supplies the number of rows of matrix A and matrix C.
+
+    N - Supplies the number of columns of matrix B and matrix C.
+
+    K - Supplies the number of columns of matrix A and the number of rows of
+        matrix B.
+
+    alpha - Supplies the scalar alpha multiplier (see SGEMM definition).
+
+    A - Supplies the address of matrix A.
+
+    lda - Supplies the first dimension of matrix A.
+
+    PackedB - Supplies the address of the packed matrix B.
+
+    beta - Supplies the scalar beta multiplier (see SGEMM definition).
+
+    C - Supplies the address of matrix C.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    //
+    // Try to run the operation across multiple threads or fall back to a
+    // single thread based on the GEMM parameters and system configuration.
+    //
+
+    if (!MlasSgemmTryMultithread(TransA, CblasNoTrans, M, N, K, alpha, A, lda, nullptr, 0, (const float*)PackedB, beta, C, ldc, ThreadPool)) {
+        const size_t AlignedN = (N + 15) & ~size_t(15);
+        MlasSgemmPackedOperation(TransA, M, 0, N, K, alpha, A, lda, (const float*)PackedB, AlignedN, beta, C, ldc);
+    }
+}
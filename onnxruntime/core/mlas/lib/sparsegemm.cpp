@@ -0,0 +1,446 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    sparsegemm.cpp
+
+Abstract:
+
+    This module implements the single precision matrix/matrix multiply
+    operation where matrix B is sparse and supplied in compressed sparse row
+    format (sparse SGEMM).
+
+--*/
+
+#include "mlasi.h"
+
+//
+// Define the number of rows from matrix A to process for each pass over the
+// sparse elements of matrix B. The sparse indices are loaded once for each
+// block of rows.
+//
+
+#define MLAS_SPARSE_SGEMM_ROWS              4
+
+//
+// Define the parameters to execute segments of a sparse SGEMM operation on
+// worker threads.
+//
+
+struct MLAS_SPARSE_SGEMM_WORK_BLOCK {
+    size_t lda;
+    size_t ldc;
+    float alpha;
+    float beta;
+    const int32_t* ColumnIndices;
+    const float* Values;
+    struct SEGMENT {
+        size_t M;
+        size_t N;
+        const float* A;
+        const int32_t* RowOffsets;
+        float* C;
+    } Segments[MLAS_MAXIMUM_THREAD_COUNT];
+};
+
+template<size_t RowCount>
+void
+MlasSparseGemmRows(
+    size_t N,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const int32_t* RowOffsets,
+    const int32_t* ColumnIndices,
+    const float* Values,
+    float beta,
+    float* C,
+    size_t ldc
+    )
+/*++
+
+Routine Description:
+
+    This routine computes RowCount rows of matrix C.
+
+Arguments:
+
+    N - Supplies the number of columns of matrix C.
+
+    alpha - Supplies the scalar alpha multiplier.
+
+    A - Supplies the address of the first row of matrix A to process.
+
+    lda - Supplies the first dimension of matrix A.
+
+    RowOffsets - Supplies the offsets of the sparse rows of transposed matrix
+        B, starting at the first column of matrix C to compute.
+
+    ColumnIndices - Supplies the column indices of the sparse elements.
+
+    Values - Supplies the values of the sparse elements.
+
+    beta - Supplies the scalar beta multiplier.
+
+    C - Supplies the address of the first row of matrix C to compute.
+
+    ldc - Supplies the first dimension of matrix C.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    for (size_t n = 0; n < N; n++) {
+
+        float Accumulators[RowCount];
+
+        for (size_t r = 0; r < RowCount; r++) {
+            Accumulators[r] = 0.0f;
+        }
+
+        const int32_t End = RowOffsets[n + 1];
+
+        for (int32_t j = RowOffsets[n]; j < End; j++) {
+
+            const size_t k = size_t(ColumnIndices[j]);
+            const float Value = Values[j];
+
+            for (size_t r = 0; r < RowCount; r++) {
+                Accumulators[r] += A[r * lda + k] * Value;
+            }
+        }
+
+        //
+        // The output buffer is not read if beta is zero, so that it may be
+        // uninitialized.
+        //
+
+        for (size_t r = 0; r < RowCount; r++) {
+
+            float* c = C + r * ldc + n;
+
+            if (beta == 0.0f) {
+                *c = alpha * Accumulators[r];
+            } else {
+                *c = alpha * Accumulators[r] + beta * (*c);
+            }
+        }
+    }
+}
+
+void
+MlasSparseGemmOperation(
+    size_t M,
+    size_t N,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const int32_t* RowOffsets,
+    const int32_t* ColumnIndices,
+    const float* Values,
+    float beta,
+    float* C,
+    size_t ldc
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the sparse SGEMM operation on a single thread.
+
+Arguments:
+
+    See MlasSparseGemm.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    while (M >= MLAS_SPARSE_SGEMM_ROWS) {
+
+        MlasSparseGemmRows<MLAS_SPARSE_SGEMM_ROWS>(N, alpha, A, lda, RowOffsets,
+            ColumnIndices, Values, beta, C, ldc);
+
+        A += lda * MLAS_SPARSE_SGEMM_ROWS;
+        C += ldc * MLAS_SPARSE_SGEMM_ROWS;
+        M -= MLAS_SPARSE_SGEMM_ROWS;
+    }
+
+    switch (M) {
+
+        case 3:
+            MlasSparseGemmRows<3>(N, alpha, A, lda, RowOffsets, ColumnIndices, Values, beta, C, ldc);
+            break;
+
+        case 2:
+            MlasSparseGemmRows<2>(N, alpha, A, lda, RowOffsets, ColumnIndices, Values, beta, C, ldc);
+            break;
+
+        case 1:
+            MlasSparseGemmRows<1>(N, alpha, A, lda, RowOffsets, ColumnIndices, Values, beta, C, ldc);
+            break;
+    }
+}
+
+void
+MlasSparseGemmOperationThreaded(
+    void* Context,
+    int32_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a segment of a
+    sparse SGEMM operation.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_SPARSE_SGEMM_WORK_BLOCK* WorkBlock = (MLAS_SPARSE_SGEMM_WORK_BLOCK*)Context;
+
+    MLAS_SPARSE_SGEMM_WORK_BLOCK::SEGMENT* Segment = &WorkBlock->Segments[Index];
+
+    MlasSparseGemmOperation(Segment->M, Segment->N, WorkBlock->alpha,
+        Segment->A, WorkBlock->lda, Segment->RowOffsets,
+        WorkBlock->ColumnIndices, WorkBlock->Values, WorkBlock->beta,
+        Segment->C, WorkBlock->ldc);
+}
+
+inline
+bool
+MlasSparseGemmTryMultithread(
+    size_t M,
+    size_t N,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const int32_t* RowOffsets,
+    const int32_t* ColumnIndices,
+    const float* Values,
+    float beta,
+    float* C,
+    size_t ldc,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine attempts to launch a sparse SGEMM operation across multiple
+    threads.
+
+Arguments:
+
+    See MlasSparseGemm.
+
+Return Value:
+
+    Returns true if the operation was completed across multiple threads, else
+    false if the operation should fall back to a single thread.
+
+--*/
+{
+    MLAS_SPARSE_SGEMM_WORK_BLOCK WorkBlock;
+    int32_t TargetThreadCount;
+
+    //
+    // Compute the number of target threads given the number of multiply/add
+    // operations. Each output element is also counted so that a very sparse
+    // matrix B with a large output is still split.
+    //
+
+    double Complexity = double(M) * (double(RowOffsets[N] - RowOffsets[0]) + double(N));
+
+    if (Complexity < double(MLAS_SPARSE_SGEMM_THREAD_COMPLEXITY * MLAS_MAXIMUM_THREAD_COUNT)) {
+        TargetThreadCount = int32_t(Complexity / double(MLAS_SPARSE_SGEMM_THREAD_COMPLEXITY)) + 1;
+    } else {
+        TargetThreadCount = MLAS_MAXIMUM_THREAD_COUNT;
+    }
+
+    int32_t MaximumThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+    if (TargetThreadCount >= MaximumThreadCount) {
+        TargetThreadCount = MaximumThreadCount;
+    }
+
+    if (TargetThreadCount == 1) {
+        return false;
+    }
+
+    //
+    // Initialize the common fields of the work block.
+    //
+
+    WorkBlock.lda = lda;
+    WorkBlock.ldc = ldc;
+    WorkBlock.alpha = alpha;
+    WorkBlock.beta = beta;
+    WorkBlock.ColumnIndices = ColumnIndices;
+    WorkBlock.Values = Values;
+
+    //
+    // Segment the operation across multiple threads. Splitting along M keeps
+    // whole blocks of rows together, which amortizes the loads of the sparse
+    // elements. Small batches are split along N instead.
+    //
+
+    int32_t Index = 0;
+
+    if (M >= size_t(TargetThreadCount) * MLAS_SPARSE_SGEMM_ROWS) {
+
+        size_t StrideM = M / TargetThreadCount;
+
+        if ((StrideM * TargetThreadCount) != M) {
+            StrideM++;
+        }
+
+        StrideM =
+            (StrideM + MLAS_SPARSE_SGEMM_ROWS - 1) / MLAS_SPARSE_SGEMM_ROWS * MLAS_SPARSE_SGEMM_ROWS;
+
+        for (size_t CountM, m = 0; m < M; m += CountM) {
+
+            CountM = StrideM;
+
+            if (CountM > (M - m)) {
+                CountM = M - m;
+            }
+
+            WorkBlock.Segments[Index].M = CountM;
+            WorkBlock.Segments[Index].N = N;
+            WorkBlock.Segments[Index].A = A + m * lda;
+            WorkBlock.Segments[Index].RowOffsets = RowOffsets;
+            WorkBlock.Segments[Index].C = C + m * ldc;
+
+            Index++;
+        }
+
+    } else {
+
+        size_t StrideN = N / TargetThreadCount;
+
+        if ((StrideN * TargetThreadCount) != N) {
+            StrideN++;
+        }
+
+        for (size_t CountN, n = 0; n < N; n += CountN) {
+
+            CountN = StrideN;
+
+            if (CountN > (N - n)) {
+                CountN = N - n;
+            }
+
+            WorkBlock.Segments[Index].M = M;
+            WorkBlock.Segments[Index].N = CountN;
+            WorkBlock.Segments[Index].A = A;
+            WorkBlock.Segments[Index].RowOffsets = RowOffsets + n;
+            WorkBlock.Segments[Index].C = C + n;
+
+            Index++;
+        }
+    }
+
+    MlasExecuteThreaded(MlasSparseGemmOperationThreaded, &WorkBlock, Index, ThreadPool);
+
+    return true;
+}
+
+void
+MLASCALL
+MlasSparseGemm(
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const int32_t* RowOffsets,
+    const int32_t* ColumnIndices,
+    const float* Values,
+    float beta,
+    float* C,
+    size_t ldc,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the single precision matrix/matrix multiply
+    operation C = alpha * A * B + beta * C, where matrix B is sparse.
+
+    The cost of the operation is proportional to the number of nonzero
+    elements of matrix B instead of N * K.
+
+Arguments:
+
+    M - Supplies the number of rows of matrix A and matrix C.
+
+    N - Supplies the number of columns of matrix B and matrix C.
+
+    K - Supplies the number of columns of matrix A and the number of rows of
+        matrix B.
+
+    alpha - Supplies the scalar alpha multiplier.
+
+    A - Supplies the address of matrix A.
+
+    lda - Supplies the first dimension of matrix A.
+
+    RowOffsets - Supplies the N + 1 offsets of the sparse rows of the
+        transposed matrix B.
+
+    ColumnIndices - Supplies the column indices of the sparse elements of the
+        transposed matrix B. Each index must be less than K.
+
+    Values - Supplies the values of the sparse elements of the transposed
+        matrix B.
+
+    beta - Supplies the scalar beta multiplier.
+
+    C - Supplies the address of matrix C.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_UNREFERENCED_PARAMETER(K);
+
+    if (M == 0 || N == 0) {
+        return;
+    }
+
+    //
+    // Try to run the operation across multiple threads or fall back to a
+    // single thread based on the operation size and system configuration.
+    //
+
+    if (!MlasSparseGemmTryMultithread(M, N, alpha, A, lda, RowOffsets, ColumnIndices, Values, beta, C, ldc, ThreadPool)) {
+        MlasSparseGemmOperation(M, N, alpha, A, lda, RowOffsets, ColumnIndices, Values, beta, C, ldc);
+    }
+}
@@ -0,0 +1,196 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/sparse_weight_transformer.h"
+#include "core/graph/graph_utils.h"
+#include "core/optimizer/initializer.h"
+
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <unordered_map>
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+namespace onnxruntime {
+
+namespace {
+
+struct SparseWeight {
+  NodeArg* values;
+  NodeArg* row_offsets;
+  NodeArg* column_indices;
+};
+
+ONNX_NAMESPACE::TensorProto CreateTensorProto(Graph& graph, const std::string& name,
+                                              ONNX_NAMESPACE::TensorProto_DataType data_type,
+                                              const void* data, size_t count, size_t element_size) {
+  ONNX_NAMESPACE::TensorProto tensor_proto;
+  tensor_proto.set_name(graph.GenerateNodeArgName(name));
+  tensor_proto.set_data_type(data_type);
+  tensor_proto.add_dims(static_cast<int64_t>(count));
+  // set_raw_data with a null pointer and zero length is fine for an all zero weight
+  tensor_proto.set_raw_data(data, count * element_size);
+  return tensor_proto;
+}
+
+// Convert the (K, N) weight, or (N, K) if trans_b is set, to the transposed CSR format used by
+// SparseMatMul. Returns false if the weight is not sparse enough or too large for 32 bit indices.
+bool ConvertWeight(Graph& graph, const ONNX_NAMESPACE::TensorProto& weight_proto, bool trans_b,
+                   float sparsity_threshold, SparseWeight& sparse_weight) {
+  Initializer weight{weight_proto};
+  const int64_t K = trans_b ? weight.dims()[1] : weight.dims()[0];
+  const int64_t N = trans_b ? weight.dims()[0] : weight.dims()[1];
+  if (K <= 0 || N <= 0 || K * N > std::numeric_limits<int32_t>::max()) {
+    return false;
+  }
+
+  const float* data = weight.data<float>();
+  const int64_t size = K * N;
+  const int64_t nnz = size - std::count(data, data + size, 0.0f);
+  if (static_cast<float>(size - nnz) < sparsity_threshold * static_cast<float>(size)) {
+    return false;
+  }
+
+  std::vector<float> values;
+  std::vector<int32_t> row_offsets;
+  std::vector<int32_t> column_indices;
+  values.reserve(static_cast<size_t>(nnz));
+  column_indices.reserve(static_cast<size_t>(nnz));
+  row_offsets.reserve(static_cast<size_t>(N + 1));
+
+  row_offsets.push_back(0);
+  for (int64_t n = 0; n < N; ++n) {
+    for (int64_t k = 0; k < K; ++k) {
+      const float value = trans_b ? data[n * K + k] : data[k * N + n];
+      if (value != 0.0f) {
+        values.push_back(value);
+        column_indices.push_back(static_cast<int32_t>(k));
+      }
+    }
+    row_offsets.push_back(static_cast<int32_t>(values.size()));
+  }
+
+  const std::string& name = weight_proto.name();
+  sparse_weight.values = &graph_utils::AddInitializer(
+      graph, CreateTensorProto(graph, name + "_values", TensorProto_DataType_FLOAT,
+                               values.data(), values.size(), sizeof(float)));
+  sparse_weight.row_offsets = &graph_utils::AddInitializer(
+      graph, CreateTensorProto(graph, name + "_row_offsets", TensorProto_DataType_INT32,
+                               row_offsets.data(), row_offsets.size(), sizeof(int32_t)));
+  sparse_weight.column_indices = &graph_utils::AddInitializer(
+      graph, CreateTensorProto(graph, name + "_column_indices", TensorProto_DataType_INT32,
+                               column_indices.data(), column_indices.size(), sizeof(int32_t)));
+  return true;
+}
+
+}  // namespace
+
+Status SparseWeightTransformer::ApplyImpl(Graph& graph, bool& modified, int graph_level,
+                                          const logging::Logger& logger) const {
+  GraphViewer graph_viewer(graph);
+  const auto& node_topology_list = graph_viewer.GetNodesInTopologicalOrder();
+
+  // weights shared by several nodes are only converted once. nullptr if the weight was rejected.
+  std::unordered_map<std::string, std::unique_ptr<SparseWeight>> converted_weights;
+
+  for (auto node_index : node_topology_list) {
+    auto* node_ptr = graph.GetNode(node_index);
+    if (!node_ptr)
+      continue;  // node was removed
+
+    auto& node = *node_ptr;
+
+    ORT_RETURN_IF_ERROR(Recurse(node, modified, graph_level, logger));
+
+    const bool is_gemm = graph_utils::IsSupportedOptypeVersionAndDomain(node, "Gemm", {7, 9, 11});
+    if ((!is_gemm && !graph_utils::IsSupportedOptypeVersionAndDomain(node, "MatMul", {1, 9})) ||
+        !graph_utils::IsSupportedProvider(node, GetCompatibleExecutionProviders())) {
+      continue;
+    }
+
+    auto& input_defs = node.MutableInputDefs();
+    const auto* a_type = input_defs[0]->Type();
+    if (a_type == nullptr || *a_type != "tensor(float)") {
+      continue;
+    }
+
+    bool trans_b = false;
+    float alpha = 1.0f;
+    float beta = 1.0f;
+    if (is_gemm) {
+      // SparseMatMul keeps the leading dimensions of A, so a 1-D A (accepted by the Gemm kernel) would
+      // produce an output of a different rank
+      const auto* a_shape = input_defs[0]->Shape();
+      if (a_shape != nullptr && a_shape->dim_size() != 2) {
+        continue;
+      }
+
+      const auto& attributes = node.GetAttributes();
+      auto attr = attributes.find("transA");
+      if (attr != attributes.end() && attr->second.i() != 0) {
+        continue;
+      }
+      attr = attributes.find("transB");
+      trans_b = attr != attributes.end() && attr->second.i() != 0;
+      attr = attributes.find("alpha");
+      alpha = attr != attributes.end() ? attr->second.f() : 1.0f;
+      attr = attributes.find("beta");
+      beta = attr != attributes.end() ? attr->second.f() : 1.0f;
+    }
+
+    // the B input must be a 2D float weight that can't be overridden at runtime
+    const auto* weight_proto = graph_utils::GetConstantInitializer(graph, input_defs[1]->Name());
+    if (weight_proto == nullptr || weight_proto->data_type() != TensorProto_DataType_FLOAT ||
+        weight_proto->dims_size() != 2) {
+      continue;
+    }
+
+    // the conversion depends on whether B is transposed
+    const std::string weight_key = input_defs[1]->Name() + (trans_b ? "_T" : "");
+    auto converted = converted_weights.find(weight_key);
+    if (converted == converted_weights.end()) {
+      auto sparse_weight = onnxruntime::make_unique<SparseWeight>();
+      if (!ConvertWeight(graph, *weight_proto, trans_b, sparsity_threshold_, *sparse_weight)) {
+        sparse_weight.reset();
+      }
+      converted = converted_weights.emplace(weight_key, std::move(sparse_weight)).first;
+    }
+
+    if (converted->second == nullptr) {
+      continue;
+    }
+
+    const SparseWeight& sparse_weight = *converted->second;
+    std::vector<NodeArg*> sparse_inputs{input_defs[0], sparse_weight.values, sparse_weight.row_offsets,
+                                        sparse_weight.column_indices};
+    if (is_gemm && input_defs.size() > 2 && input_defs[2]->Exists()) {
+      sparse_inputs.push_back(input_defs[2]);
+    }
+
+    const int64_t K = trans_b ? weight_proto->dims(1) : weight_proto->dims(0);
+
+    Node& sparse_node = graph.AddNode(graph.GenerateNodeName(node.Name() + "_sparse"),
+                                      "SparseMatMul",
+                                      node.OpType() + " with sparse weights",
+                                      sparse_inputs,
+                                      node.MutableOutputDefs(),
+                                      nullptr,
+                                      kMSDomain);
+    sparse_node.AddAttribute("K", K);
+    sparse_node.AddAttribute("alpha", alpha);
+    sparse_node.AddAttribute("beta", beta);
+    sparse_node.SetExecutionProviderType(node.GetExecutionProviderType());
+
+    // the edges are rebuilt from the node args when the graph is resolved
+    graph_utils::RemoveNodeOutputEdges(graph, node);
+    graph.RemoveNode(node.Index());
+
+    modified = true;
+  }
+
+  // the dense weights are removed with the other unused initializers when the graph is resolved
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,32 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@class SparseWeightTransformer
+
+Replaces MatMul and Gemm nodes whose B input is a constant float initializer with at least
+sparsity_threshold of its elements equal to zero by a com.microsoft.SparseMatMul node. The weights are
+converted to compressed sparse row format, so the cost of the multiplication scales with the number of
+nonzero weights instead of the dense size.
+*/
+class SparseWeightTransformer : public GraphTransformer {
+ public:
+  SparseWeightTransformer(float sparsity_threshold,
+                          const std::unordered_set<std::string>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("SparseWeightTransformer", compatible_execution_providers),
+        sparsity_threshold_(sparsity_threshold) {}
+
+ private:
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
+
+  // fraction of zero elements in [0, 1] above which a weight is converted
+  const float sparsity_threshold_;
+};
+
+}  // namespace onnxruntime
@@ -77,6 +77,17 @@ class Env {
   /// On Windows, it's the min time to sleep, not the actual one.
   virtual void SleepForMicroseconds(int64_t micros) const = 0;
 
+  /**
+   * Restricts the calling thread to run only on the given logical processors.
+   * Returns NOT_IMPLEMENTED on platforms without thread affinity support.
+   */
+  virtual common::Status SetThreadAffinity(const std::vector<size_t>& logical_processors) const = 0;
+
+  /**
+   * Gets the logical processors that belong to the given NUMA node.
+   */
+  virtual common::Status GetNumaNodeProcessors(int numa_node, std::vector<size_t>& logical_processors) const = 0;
+
   /**
    * Gets the length of the specified file.
    */
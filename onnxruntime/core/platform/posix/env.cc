@@ -26,6 +26,11 @@ limitations under the License.
 #include <fcntl.h>
 #include <dlfcn.h>
 #include <string.h>
+#ifdef __linux__
+#include <sched.h>
+#endif
+#include <fstream>
+#include <sstream>
 #include <thread>
 #include <utility>  // for std::forward
 #include <vector>
@@ -121,6 +126,64 @@ class PosixEnv : public Env {
     return getpid();
   }
 
+  Status SetThreadAffinity(const std::vector<size_t>& logical_processors) const override {
+#ifdef __linux__
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    for (size_t processor : logical_processors) {
+      if (processor >= CPU_SETSIZE) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Logical processor ", processor, " is out of range");
+      }
+      CPU_SET(processor, &cpu_set);
+    }
+    // pid 0 applies the mask to the calling thread only.
+    if (sched_setaffinity(0, sizeof(cpu_set), &cpu_set) != 0) {
+      const int err = errno;
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "sched_setaffinity failed. error code: ", err);
+    }
+    return Status::OK();
+#else
+    ORT_UNUSED_PARAMETER(logical_processors);
+    return ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED, "Thread affinity is not supported on this platform");
+#endif
+  }
+
+  Status GetNumaNodeProcessors(int numa_node, std::vector<size_t>& logical_processors) const override {
+    logical_processors.clear();
+#ifdef __linux__
+    // The node's cpulist has the form "0-15,32-47".
+    std::ifstream cpu_list_file("/sys/devices/system/node/node" + std::to_string(numa_node) + "/cpulist");
+    if (numa_node < 0 || !cpu_list_file) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "NUMA node ", numa_node, " does not exist");
+    }
+
+    std::string range;
+    while (std::getline(cpu_list_file, range, ',')) {
+      size_t first = 0;
+      size_t last = 0;
+      char separator = 0;
+      std::istringstream range_stream(range);
+      if (!(range_stream >> first)) {
+        continue;
+      }
+      if (!(range_stream >> separator >> last) || separator != '-') {
+        last = first;
+      }
+      for (size_t processor = first; processor <= last; ++processor) {
+        logical_processors.push_back(processor);
+      }
+    }
+
+    if (logical_processors.empty()) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "NUMA node ", numa_node, " has no logical processors");
+    }
+    return Status::OK();
+#else
+    ORT_UNUSED_PARAMETER(numa_node);
+    return ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED, "NUMA nodes are not supported on this platform");
+#endif
+  }
+
   Status GetFileLength(const ORTCHAR_T* file_path, size_t& length) const override {
     ScopedFileDescriptor file_descriptor{open(file_path, O_RDONLY)};
     if (file_descriptor.Get() < 0) {
@@ -87,6 +87,37 @@ class WindowsEnv : public Env {
     return GetCurrentProcessId();
   }
 
+  Status SetThreadAffinity(const std::vector<size_t>& logical_processors) const override {
+    // Only processors in the current processor group can be addressed with a thread affinity mask.
+    DWORD_PTR mask = 0;
+    for (size_t processor : logical_processors) {
+      if (processor >= sizeof(DWORD_PTR) * 8) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Logical processor ", processor, " is out of range");
+      }
+      mask |= static_cast<DWORD_PTR>(1) << processor;
+    }
+    if (SetThreadAffinityMask(GetCurrentThread(), mask) == 0) {
+      const int err = GetLastError();
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "SetThreadAffinityMask failed. error code: ", err);
+    }
+    return Status::OK();
+  }
+
+  Status GetNumaNodeProcessors(int numa_node, std::vector<size_t>& logical_processors) const override {
+    logical_processors.clear();
+    ULONGLONG mask = 0;
+    if (numa_node < 0 || numa_node > MAXUCHAR || !GetNumaNodeProcessorMask(static_cast<UCHAR>(numa_node), &mask) ||
+        mask == 0) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "NUMA node ", numa_node, " does not exist");
+    }
+    for (size_t processor = 0; processor < sizeof(mask) * 8; ++processor) {
+      if (mask & (static_cast<ULONGLONG>(1) << processor)) {
+        logical_processors.push_back(processor);
+      }
+    }
+    return Status::OK();
+  }
+
   Status GetFileLength(const ORTCHAR_T* file_path, size_t& length) const override {
     ScopedFileHandle file_handle{CreateFileW(
         file_path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL)};
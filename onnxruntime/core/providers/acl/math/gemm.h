@@ -52,6 +52,12 @@ class Gemm : public onnxruntime::Gemm<T> {
   }
 
 #ifdef GEMM_ACL
+  // the ACL GEMM reads W from the context, so it must not be packed for MLAS
+  Status PrePack(const Tensor& /*tensor*/, int /*input_idx*/, bool& is_packed) override {
+    is_packed = false;
+    return Status::OK();
+  }
+
   Status Compute(OpKernelContext* context) const override {
     const auto X = context->Input<Tensor>(0);
     const auto W = context->Input<Tensor>(1);
@@ -12,6 +12,10 @@ namespace onnxruntime {
 // Information needed to construct CPU execution providers.
 struct CPUExecutionProviderInfo {
   bool create_arena{true};
+  // maximum bytes of freed blocks cached per thread in front of the arena. 0 disables the thread cache.
+  size_t arena_thread_cache_max_bytes{0};
+  // limit and growth strategy of the arena
+  ArenaConfig arena_config;
 
   explicit CPUExecutionProviderInfo(bool use_arena)
       : create_arena(use_arena) {}
@@ -29,7 +33,12 @@ class CPUExecutionProvider : public IExecutionProvider {
       : IExecutionProvider{onnxruntime::kCpuExecutionProvider} {
     DeviceAllocatorRegistrationInfo device_info{OrtMemTypeDefault,
                                                 [](int) { return onnxruntime::make_unique<TAllocator>(); },
-                                                std::numeric_limits<size_t>::max()};
+                                                info.arena_config.max_mem == 0
+                                                    ? std::numeric_limits<size_t>::max()
+                                                    : info.arena_config.max_mem,
+                                                info.arena_config.extend_strategy,
+                                                info.arena_config.initial_chunk_size_bytes,
+                                                info.arena_thread_cache_max_bytes};
 
 #ifdef USE_JEMALLOC
 #if defined(USE_MIMALLOC)
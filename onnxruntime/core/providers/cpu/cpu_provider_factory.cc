@@ -10,22 +10,36 @@
 namespace onnxruntime {
 
 struct CpuProviderFactory : IExecutionProviderFactory {
-  CpuProviderFactory(bool create_arena) : create_arena_(create_arena) {}
+  CpuProviderFactory(bool create_arena, size_t arena_thread_cache_max_bytes, const ArenaConfig& arena_config)
+      : create_arena_(create_arena),
+        arena_thread_cache_max_bytes_(arena_thread_cache_max_bytes),
+        arena_config_(arena_config) {}
   ~CpuProviderFactory() override = default;
   std::unique_ptr<IExecutionProvider> CreateProvider() override;
 
  private:
   bool create_arena_;
+  size_t arena_thread_cache_max_bytes_;
+  ArenaConfig arena_config_;
 };
 
 std::unique_ptr<IExecutionProvider> CpuProviderFactory::CreateProvider() {
   CPUExecutionProviderInfo info;
   info.create_arena = create_arena_;
+  info.arena_thread_cache_max_bytes = arena_thread_cache_max_bytes_;
+  info.arena_config = arena_config_;
   return onnxruntime::make_unique<CPUExecutionProvider>(info);
 }
 
 std::shared_ptr<IExecutionProviderFactory> CreateExecutionProviderFactory_CPU(int use_arena) {
-  return std::make_shared<onnxruntime::CpuProviderFactory>(use_arena != 0);
+  return std::make_shared<onnxruntime::CpuProviderFactory>(use_arena != 0, 0, ArenaConfig());
+}
+
+std::shared_ptr<IExecutionProviderFactory> CreateExecutionProviderFactory_CPU(int use_arena,
+                                                                              size_t arena_thread_cache_max_bytes,
+                                                                              const ArenaConfig& arena_config) {
+  return std::make_shared<onnxruntime::CpuProviderFactory>(use_arena != 0, arena_thread_cache_max_bytes,
+                                                           arena_config);
 }
 
 }  // namespace onnxruntime
@@ -249,6 +249,9 @@ Status Sqrt<T>::Compute(OpKernelContext* ctx) const {
   return Status::OK();
 }
 
+// pow is computed as exp(log(x) * y)
+constexpr double kPowCostPerElement = 40.0;
+
 template <typename T>
 Status Pow<T>::Compute(OpKernelContext* context) const {
   const Tensor& Y = *context->Input<Tensor>(1);
@@ -267,7 +270,8 @@ Status Pow<T>::Compute(OpKernelContext* context) const {
       *context,
       [](EigenVectorMap<T> output, T input0, ConstEigenVectorMap<T> input1) { output = Eigen::pow(input0, input1.array()); },
       input1scalar,
-      [](EigenVectorMap<T> output, ConstEigenVectorMap<T> input0, ConstEigenVectorMap<T> input1) { output = Eigen::pow(input0.array(), input1.array()); });
+      [](EigenVectorMap<T> output, ConstEigenVectorMap<T> input0, ConstEigenVectorMap<T> input1) { output = Eigen::pow(input0.array(), input1.array()); },
+      kPowCostPerElement);
 }
 
 template <typename T>
@@ -511,7 +515,14 @@ Status Mean_8<float>::Compute(OpKernelContext* context) const {
     return status;
 
   // Now divide by the input count to get the mean
-  EigenMap<float>(*context->Output<Tensor>(0)) *= 1.0f / static_cast<float>(Node().InputArgCount().front());
+  auto& mean = *context->Output<Tensor>(0);
+  float* mean_data = mean.MutableData<float>();
+  const float weight = 1.0f / static_cast<float>(Node().InputArgCount().front());
+  concurrency::ThreadPool::TryParallelFor(
+      context->GetOperatorThreadPool(), static_cast<std::ptrdiff_t>(mean.Shape().Size()), 1.0,
+      [mean_data, weight](std::ptrdiff_t first, std::ptrdiff_t last) {
+        EigenVectorArrayMap<float>(mean_data + first, last - first) *= weight;
+      });
   return Status::OK();
 }
 
@@ -5,6 +5,7 @@
 
 #include "core/common/common.h"
 #include "core/framework/op_kernel.h"
+#include "core/platform/threadpool.h"
 #include "core/util/math_cpuonly.h"
 
 namespace onnxruntime {
@@ -330,6 +331,21 @@ struct BroadcastIterator {
     return index;
   }
 
+  // Moves to the given element of the output, as if AdvanceBy had been called until reaching it.
+  // Counter i is incremented once every counts_[0] * ... * counts_[i - 1] elements.
+  void Seek(size_t position) {
+    ptrdiff_t index = deltas_[0] * static_cast<ptrdiff_t>(position);
+    size_t count = static_cast<size_t>(counts_[0]);
+    counters_[0] = static_cast<int64_t>(position % count);
+    for (size_t counterIndex = 1; counterIndex < counters_.size(); counterIndex++) {
+      size_t increments = position / count;
+      index += deltas_[counterIndex] * static_cast<ptrdiff_t>(increments);
+      counters_[counterIndex] = static_cast<int64_t>(increments % counts_[counterIndex]);
+      count *= static_cast<size_t>(counts_[counterIndex]);
+    }
+    index_ = static_cast<size_t>(index);
+  }
+
   void Reserve(int64_t max_dims) {
     deltas_.reserve(static_cast<size_t>(max_dims));
     counts_.reserve(static_cast<size_t>(max_dims));
@@ -509,6 +525,16 @@ struct TBroadcaster {
   ConstEigenVectorMap<T0> NextEigen0() { return ConstEigenVectorMap<T0>(Next0(), span_size_); }
   ConstEigenVectorMap<T1> NextEigen1() { return ConstEigenVectorMap<T1>(Next1(), span_size_); }
 
+  // Part of the next span, starting at offset within it
+  ConstEigenVectorMap<T0> NextEigen0(size_t offset, size_t size) { return ConstEigenVectorMap<T0>(Next0() + offset, size); }
+  ConstEigenVectorMap<T1> NextEigen1(size_t offset, size_t size) { return ConstEigenVectorMap<T1>(Next1() + offset, size); }
+
+  // Moves to the span holding the given element of the output, which must be the first element of a span
+  void Seek(size_t output_offset) {
+    broadcaster_.iterator1_.Seek(output_offset);
+    broadcaster_.iterator2_.Seek(output_offset);
+  }
+
  private:
   const T0* Next0() { return input0_ + broadcaster_.iterator1_.AdvanceBy(span_size_); }
   const T1* Next1() { return input1_ + broadcaster_.iterator2_.AdvanceBy(span_size_); }
@@ -610,17 +636,55 @@ void BroadcastLoopSpan(TBroadcaster& bc, Output& output, Input0Scalar input0scal
   }
 }
 
+// Broadcast loop over the elements [first, last) of the output, with the same functions as BroadcastLoop.
+// The range can start and end within a span, so that a large span can be split between threads.
+template <typename TBroadcaster, typename TOutput, typename Input0Scalar, typename Input1Scalar, typename General>
+void BroadcastLoopRange(TBroadcaster& bc, TOutput* output, size_t first, size_t last,
+                        Input0Scalar input0scalar, Input1Scalar input1scalar, General general) {
+  const size_t span_size = bc.GetSpanSize();
+  const bool input0_scalar = bc.IsInput0Scalar();
+  const bool input1_scalar = bc.IsInput1Scalar();
+
+  size_t offset = first % span_size;
+  bc.Seek(first - offset);
+  for (size_t position = first; position < last; position += span_size - offset, offset = 0) {
+    const size_t size = std::min(span_size - offset, last - position);
+    EigenVectorMap<TOutput> output_span(output + position, size);
+    if (input0_scalar)
+      input0scalar(output_span, bc.NextScalar0(), bc.NextEigen1(offset, size));
+    else if (input1_scalar)
+      input1scalar(output_span, bc.NextEigen0(offset, size), bc.NextScalar1());
+    else
+      general(output_span, bc.NextEigen0(offset, size), bc.NextEigen1(offset, size));
+  }
+}
+
+// unit_cost is the rough number of cycles to compute an element of the output. Large outputs are split in ranges
+// computed in parallel.
 template <typename TInput, typename TOutput, typename Input0Scalar, typename Input1Scalar, typename General>
-Status BroadcastTwo(OpKernelContext& context, Input0Scalar input0scalar, Input1Scalar input1scalar, General general) {
-  TBroadcaster<TInput, TInput> bc(*context.Input<Tensor>(0), *context.Input<Tensor>(1));
-  TBroadcastOutput<TOutput> output(bc.GetSpanSize(), *context.Output(0, bc.GetOutputShape()));
-  BroadcastLoop(bc, output, input0scalar, input1scalar, general);
+Status BroadcastTwo(OpKernelContext& context, Input0Scalar input0scalar, Input1Scalar input1scalar, General general,
+                    double unit_cost = 1.0) {
+  const TBroadcaster<TInput, TInput> bc(*context.Input<Tensor>(0), *context.Input<Tensor>(1));
+  Tensor& output_tensor = *context.Output(0, bc.GetOutputShape());
+  TOutput* output = output_tensor.template MutableData<TOutput>();
+
+  concurrency::ThreadPool::TryParallelFor(
+      context.GetOperatorThreadPool(), static_cast<std::ptrdiff_t>(output_tensor.Shape().Size()), unit_cost,
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        TBroadcaster<TInput, TInput> range_bc(bc);
+        BroadcastLoopRange(range_bc, output, static_cast<size_t>(first), static_cast<size_t>(last),
+                           input0scalar, input1scalar, general);
+      });
 
   return Status::OK();
 }
 
+// Combines all the inputs of the node, broadcast to a common shape. Each range of the output is computed for all
+// the inputs before moving to the next one, so it stays in the cache and no temporary tensors are needed.
 template <typename TInput, typename TOutput, typename Input0Scalar, typename Input1Scalar, typename General>
 Status BroadcastVariadic(const Node& node, OpKernelContext& context, Input0Scalar input0scalar, Input1Scalar input1scalar, General general) {
+  static_assert(std::is_same<TInput, TOutput>::value, "The inputs are accumulated in the output");
+
   auto input_count = node.InputArgCount().front();
   ORT_ENFORCE(input_count >= 1, "Must have 1 or more inputs");
 
@@ -630,33 +694,50 @@ Status BroadcastVariadic(const Node& node, OpKernelContext& context, Input0Scala
     return Status::OK();
   }
 
-  std::unique_ptr<Tensor> tempInput;
-  std::unique_ptr<Tensor> tempOutput;
-
-  TensorAllocator<TOutput> tensorAllocator(context);
+  std::vector<int64_t> output_dims = context.Input<Tensor>(0)->Shape().GetDims();
+  for (int i = 1; i < input_count; i++) {
+    output_dims = Broadcaster(output_dims, context.Input<Tensor>(i)->Shape().GetDims()).output_shape_;
+  }
 
-  // For more than 2 tensors, we sum the first two into a temporary tensor, then sum the next with the temporary tensor
-  for (int i = 0; i < input_count - 1; i++) {
-    auto& tensor0 = tempInput ? *tempInput : *context.Input<Tensor>(0);
-    auto& tensor1 = *context.Input<Tensor>(i + 1);
+  Tensor& output_tensor = *context.Output(0, TensorShape(output_dims));
+  TOutput* output = output_tensor.template MutableData<TOutput>();
 
-    TBroadcaster<TInput, TInput> bc(tensor0, tensor1);
+  // The first two inputs are combined directly if they broadcast to the output shape, otherwise the first input is
+  // copied to the output. The remaining inputs are then combined with the output, in place.
+  const TBroadcaster<TInput, TInput> first_bc(*context.Input<Tensor>(0), *context.Input<Tensor>(1));
+  const bool combine_first = first_bc.GetOutputShape() == output_tensor.Shape();
+  const TBroadcaster<TInput, TInput> copy_bc(*context.Input<Tensor>(0), output_tensor);
 
-    // Create a temporary output for all but the last iteration, which goes to the real output
-    Tensor* p_output{};
-    if (i == input_count - 2)
-      p_output = context.Output(0, bc.GetOutputShape());
-    else {
-      tempOutput = tensorAllocator.Allocate(bc.GetOutputShape());
-      p_output = tempOutput.get();
-    }
+  std::vector<TBroadcaster<TInput, TInput>> accumulate_bcs;
+  accumulate_bcs.reserve(input_count);
+  for (int i = combine_first ? 2 : 1; i < input_count; i++) {
+    accumulate_bcs.emplace_back(output_tensor, *context.Input<Tensor>(i));
+  }
 
-    TBroadcastOutput<TOutput> output(bc.GetSpanSize(), *p_output);
+  concurrency::ThreadPool::TryParallelFor(
+      context.GetOperatorThreadPool(), static_cast<std::ptrdiff_t>(output_tensor.Shape().Size()),
+      static_cast<double>(input_count - 1),
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        if (combine_first) {
+          TBroadcaster<TInput, TInput> range_bc(first_bc);
+          BroadcastLoopRange(range_bc, output, static_cast<size_t>(first), static_cast<size_t>(last),
+                             input0scalar, input1scalar, general);
+        } else {
+          TBroadcaster<TInput, TInput> range_bc(copy_bc);
+          BroadcastLoopRange(
+              range_bc, output, static_cast<size_t>(first), static_cast<size_t>(last),
+              [](EigenVectorMap<TOutput> output, TInput input0, ConstEigenVectorMap<TInput>) { output.setConstant(input0); },
+              [](EigenVectorMap<TOutput> output, ConstEigenVectorMap<TInput> input0, TInput) { output = input0; },
+              [](EigenVectorMap<TOutput> output, ConstEigenVectorMap<TInput> input0, ConstEigenVectorMap<TInput>) { output = input0; });
+        }
 
-    BroadcastLoop(bc, output, input0scalar, input1scalar, general);
+        for (const auto& accumulate_bc : accumulate_bcs) {
+          TBroadcaster<TInput, TInput> range_bc(accumulate_bc);
+          BroadcastLoopRange(range_bc, output, static_cast<size_t>(first), static_cast<size_t>(last),
+                             input0scalar, input1scalar, general);
+        }
+      });
 
-    tempInput = std::move(tempOutput);
-  }
   return Status::OK();
 }
 
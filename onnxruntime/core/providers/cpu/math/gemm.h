@@ -5,6 +5,7 @@
 
 #include "core/common/common.h"
 #include "core/framework/op_kernel.h"
+#include "core/mlas/inc/mlas.h"
 #include "core/util/math.h"
 #include "core/util/math_cpuonly.h"
 #include "gemm_helper.h"
@@ -27,15 +28,41 @@ class Gemm : public OpKernel {
     ORT_ENFORCE(info.GetAttr<float>("beta", &beta_).IsOK());
   }
 
+  // packs a constant W for MLAS so that it is not copied to the GEMM panels on every call
+  Status PrePack(const Tensor& tensor, int input_idx, bool& is_packed) override {
+    is_packed = false;
+
+    if (input_idx != 1 || tensor.Shape().NumDimensions() != 2) {
+      return Status::OK();
+    }
+
+    const bool trans_b = trans_B_ != CblasNoTrans;
+    const size_t K = static_cast<size_t>(trans_b ? tensor.Shape()[1] : tensor.Shape()[0]);
+    const size_t N = static_cast<size_t>(trans_b ? tensor.Shape()[0] : tensor.Shape()[1]);
+    const size_t packed_w_size = MlasGemmPackBSize(N, K);
+    if (packed_w_size == 0) {
+      return Status::OK();
+    }
+
+    auto alloc = Info().GetAllocator(0, OrtMemTypeDefault);
+    auto* packed_w_data = alloc->Alloc(packed_w_size);
+    packed_w_ = BufferUniquePtr(packed_w_data, BufferDeleter(alloc));
+    MlasGemmPackB(trans_B_, N, K, tensor.template Data<T>(), trans_b ? K : N, packed_w_data);
+
+    w_shape_ = tensor.Shape();
+    is_packed = true;
+    return Status::OK();
+  }
+
   Status Compute(OpKernelContext* context) const override {
     concurrency::ThreadPool* tp = context->GetOperatorThreadPool();
 
     const auto* X = context->Input<Tensor>(0);
-    const auto* W = context->Input<Tensor>(1);
+    const auto* W = packed_w_ ? nullptr : context->Input<Tensor>(1);
     const auto* B = context->Input<Tensor>(2);
     // Bias could be missing. Treat as scalar 0 if that is the case.
-    GemmHelper helper(X->Shape(), trans_A_ != CblasNoTrans, W->Shape(), trans_B_ != CblasNoTrans,
-                      B != nullptr ? B->Shape() : TensorShape({}));
+    GemmHelper helper(X->Shape(), trans_A_ != CblasNoTrans, packed_w_ ? w_shape_ : W->Shape(),
+                      trans_B_ != CblasNoTrans, B != nullptr ? B->Shape() : TensorShape({}));
 
     if (!helper.State().IsOK())
       return helper.State();
@@ -69,20 +96,27 @@ class Gemm : public OpKernel {
     }
 
     // W * x
-    math::Gemm<T>(
-        trans_A_,
-        trans_B_,
-        M,
-        N,
-        helper.K(),
-        alpha_,
-        X->template Data<T>(),
-        W->template Data<T>(),
-        // ideally we need to set the output buffer contents to 0 if bias is missing,
-        // but passing 0 for beta is cheaper and it will ignore any junk in the output buffer
-        B != nullptr ? beta_ : 0,
-        y_data,
-        tp);
+    // ideally we need to set the output buffer contents to 0 if bias is missing,
+    // but passing 0 for beta is cheaper and it will ignore any junk in the output buffer
+    if (packed_w_) {
+      const int64_t K = helper.K();
+      MlasGemm(trans_A_, static_cast<size_t>(M), static_cast<size_t>(N), static_cast<size_t>(K), alpha_,
+               X->template Data<T>(), static_cast<size_t>(trans_A_ == CblasNoTrans ? K : M), packed_w_.get(),
+               B != nullptr ? beta_ : 0, y_data, static_cast<size_t>(N), tp);
+    } else {
+      math::Gemm<T>(
+          trans_A_,
+          trans_B_,
+          M,
+          N,
+          helper.K(),
+          alpha_,
+          X->template Data<T>(),
+          W->template Data<T>(),
+          B != nullptr ? beta_ : 0,
+          y_data,
+          tp);
+    }
 
     FuseActivation<T>(activation_, y_data, M * N, leaky_relu_alpha_);
 
@@ -95,6 +129,9 @@ class Gemm : public OpKernel {
   float alpha_;
   float beta_;
 
+  TensorShape w_shape_;
+  BufferUniquePtr packed_w_;
+
  protected:
   // For fused gemm + activation
   std::string activation_;
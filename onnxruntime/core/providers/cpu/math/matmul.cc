@@ -3,6 +3,7 @@
 #include "core/framework/op_kernel_context_internal.h"
 #include "core/providers/cpu/math/matmul.h"
 
+#include "core/mlas/inc/mlas.h"
 #include "core/util/math.h"
 #include "core/util/math_cpuonly.h"
 #include "matmul_helper.h"
@@ -92,4 +93,61 @@ Status MatMul<T>::Compute(OpKernelContext* ctx) const {
   return Status::OK();
 }
 
+Status MatMul<float>::PrePack(const Tensor& tensor, int input_idx, bool& is_packed) {
+  is_packed = false;
+
+  // only pack Matrix B, and only if it is 2-D. a batch of B matrices is multiplied one at a time.
+  if (input_idx != 1 || tensor.Shape().NumDimensions() != 2) {
+    return Status::OK();
+  }
+
+  const size_t K = static_cast<size_t>(tensor.Shape()[0]);
+  const size_t N = static_cast<size_t>(tensor.Shape()[1]);
+  const size_t packed_b_size = MlasGemmPackBSize(N, K);
+  if (packed_b_size == 0) {
+    return Status::OK();
+  }
+
+  auto alloc = Info().GetAllocator(0, OrtMemTypeDefault);
+  auto* packed_b_data = alloc->Alloc(packed_b_size);
+  packed_b_ = BufferUniquePtr(packed_b_data, BufferDeleter(alloc));
+  MlasGemmPackB(CblasNoTrans, N, K, tensor.Data<float>(), N, packed_b_data);
+
+  b_shape_ = tensor.Shape();
+  is_packed = true;
+  return Status::OK();
+}
+
+Status MatMul<float>::Compute(OpKernelContext* ctx) const {
+  concurrency::ThreadPool* thread_pool = ctx->GetOperatorThreadPool();
+
+  const auto* left_X = ctx->Input<Tensor>(0);
+  const auto* right_X = packed_b_ ? nullptr : ctx->Input<Tensor>(1);
+
+  MatMulComputeHelper helper;
+  ORT_RETURN_IF_ERROR(helper.Compute(left_X->Shape(), packed_b_ ? b_shape_ : right_X->Shape()));
+
+  Tensor* Y = ctx->Output(0, helper.OutputShape());
+
+  const auto M = static_cast<size_t>(helper.M());
+  const auto N = static_cast<size_t>(helper.N());
+  const auto K = static_cast<size_t>(helper.K());
+
+  size_t max_len = helper.OutputOffsets().size();
+  for (size_t i = 0; i < max_len; i++) {
+    const float* a_data = left_X->Data<float>() + helper.LeftOffsets()[i];
+    float* y_data = Y->MutableData<float>() + helper.OutputOffsets()[i];
+
+    if (packed_b_) {
+      // a 2-D B is shared by every matrix of A
+      MlasGemm(CblasNoTrans, M, N, K, 1.0f, a_data, K, packed_b_.get(), 0.0f, y_data, N, thread_pool);
+    } else {
+      math::MatMul<float>(static_cast<int>(M), static_cast<int>(N), static_cast<int>(K), a_data,
+                          right_X->Data<float>() + helper.RightOffsets()[i], y_data, thread_pool);
+    }
+  }
+
+  return Status::OK();
+}
+
 }  // namespace onnxruntime
@@ -18,4 +18,21 @@ class MatMul final : public OpKernel {
   Status Compute(OpKernelContext* context) const override;
 };
 
+template <>
+class MatMul<float> final : public OpKernel {
+ public:
+  MatMul(const OpKernelInfo& info)
+      : OpKernel(info) {
+  }
+
+  // packs a constant 2-D B for MLAS so that it is not copied to the GEMM panels on every call
+  Status PrePack(const Tensor& tensor, int input_idx, bool& is_packed) override;
+
+  Status Compute(OpKernelContext* context) const override;
+
+ private:
+  TensorShape b_shape_;
+  BufferUniquePtr packed_b_;
+};
+
 }  // namespace onnxruntime
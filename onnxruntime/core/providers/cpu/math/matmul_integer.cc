@@ -1,12 +1,15 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <type_traits>
+
 #include "core/framework/data_types_internal.h"
 #include "core/framework/op_kernel_context_internal.h"
 #include "core/providers/cpu/math/matmul_integer.h"
 #include "core/providers/cpu/math/matmul_helper.h"
 #include "core/util/qmath.h"
 #include "core/providers/common.h"
+#include "core/mlas/inc/mlas.h"
 
 namespace onnxruntime {
 
@@ -35,16 +38,49 @@ ONNX_OPERATOR_TYPED_KERNEL_EX(
         .TypeConstraint("T3", DataTypeImpl::GetTensorType<int32_t>()),
     MatMulInteger<uint8_t, int8_t>);
 
+template <typename T1, typename T2>
+Status MatMulInteger<T1, T2>::PrePack(const Tensor& tensor, int input_idx, bool& is_packed) {
+  is_packed = false;
+
+#ifdef MLAS_SUPPORTS_GEMM_U8X8
+  // only pack Matrix B, and only if it is 2-D. a batch of B matrices is multiplied one at a time.
+  if (input_idx != 1 || tensor.Shape().NumDimensions() != 2) {
+    return Status::OK();
+  }
+
+  const size_t K = static_cast<size_t>(tensor.Shape()[0]);
+  const size_t N = static_cast<size_t>(tensor.Shape()[1]);
+  const bool b_is_signed = std::is_signed<T2>::value;
+  const size_t packed_b_size = MlasGemmPackBSize(N, K, b_is_signed);
+  if (packed_b_size == 0) {
+    return Status::OK();
+  }
+
+  auto alloc = Info().GetAllocator(0, OrtMemTypeDefault);
+  auto* packed_b_data = alloc->Alloc(packed_b_size);
+  packed_b_ = BufferUniquePtr(packed_b_data, BufferDeleter(alloc));
+  MlasGemmPackB(N, K, reinterpret_cast<const uint8_t*>(tensor.Data<T2>()), N, b_is_signed, packed_b_data);
+
+  b_shape_ = tensor.Shape();
+  is_packed = true;
+#else
+  ORT_UNUSED_PARAMETER(tensor);
+  ORT_UNUSED_PARAMETER(input_idx);
+#endif
+
+  return Status::OK();
+}
+
 template <>
 Status MatMulInteger<uint8_t, uint8_t>::Compute(OpKernelContext* ctx) const {
   concurrency::ThreadPool* thread_pool = ctx->GetOperatorThreadPool();
 
   auto a = ctx->Input<Tensor>(0);
-  auto b = ctx->Input<Tensor>(1);
-  ORT_ENFORCE(a != nullptr && b != nullptr);
+  auto b = packed_b_ ? nullptr : ctx->Input<Tensor>(1);
+  ORT_ENFORCE(a != nullptr && (packed_b_ || b != nullptr));
 
   MatMulComputeHelper helper;
-  ORT_RETURN_IF_ERROR(helper.Compute(a->Shape(), b->Shape()));
+  ORT_RETURN_IF_ERROR(helper.Compute(a->Shape(), packed_b_ ? b_shape_ : b->Shape()));
   Tensor* y = ctx->Output(0, helper.OutputShape());
 
   // validate zero points
@@ -64,6 +100,17 @@ Status MatMulInteger<uint8_t, uint8_t>::Compute(OpKernelContext* ctx) const {
   }
 
   for (size_t i = 0; i < helper.OutputOffsets().size(); i++) {
+#ifdef MLAS_SUPPORTS_GEMM_U8X8
+    if (packed_b_) {
+      MlasGemm(static_cast<size_t>(helper.M()), static_cast<size_t>(helper.N()), static_cast<size_t>(helper.K()),
+               a->template Data<uint8_t>() + helper.LeftOffsets()[i], static_cast<size_t>(helper.K()), a_offset,
+               packed_b_.get(), b_offset, false,
+               y->template MutableData<int32_t>() + helper.OutputOffsets()[i], static_cast<size_t>(helper.N()),
+               thread_pool);
+      continue;
+    }
+#endif
+
     QGemmu8u8_s32(static_cast<int>(helper.M()),
                   static_cast<int>(helper.N()),
                   static_cast<int>(helper.K()),
@@ -85,11 +132,11 @@ Status MatMulInteger<uint8_t, int8_t>::Compute(OpKernelContext* ctx) const {
   concurrency::ThreadPool* thread_pool = ctx->GetOperatorThreadPool();
 
   auto a = ctx->Input<Tensor>(0);
-  auto b = ctx->Input<Tensor>(1);
-  ORT_ENFORCE(a != nullptr && b != nullptr);
+  auto b = packed_b_ ? nullptr : ctx->Input<Tensor>(1);
+  ORT_ENFORCE(a != nullptr && (packed_b_ || b != nullptr));
 
   MatMulComputeHelper helper;
-  ORT_RETURN_IF_ERROR(helper.Compute(a->Shape(), b->Shape()));
+  ORT_RETURN_IF_ERROR(helper.Compute(a->Shape(), packed_b_ ? b_shape_ : b->Shape()));
   Tensor* y = ctx->Output(0, helper.OutputShape());
 
   if (has_a_zero_point_ || has_b_zero_point_) {
@@ -114,6 +161,17 @@ Status MatMulInteger<uint8_t, int8_t>::Compute(OpKernelContext* ctx) const {
   }
 
   for (int i = 0; i < static_cast<int>(helper.OutputOffsets().size()); i++) {
+#ifdef MLAS_SUPPORTS_GEMM_U8X8
+    if (packed_b_) {
+      MlasGemm(static_cast<size_t>(helper.M()), static_cast<size_t>(helper.N()), static_cast<size_t>(helper.K()),
+               a->template Data<uint8_t>() + helper.LeftOffsets()[i], static_cast<size_t>(helper.K()), 0,
+               packed_b_.get(), 0, true,
+               y->template MutableData<int32_t>() + helper.OutputOffsets()[i], static_cast<size_t>(helper.N()),
+               thread_pool);
+      continue;
+    }
+#endif
+
     QGemmu8s8_s32(static_cast<int>(helper.M()),
                   static_cast<int>(helper.N()),
                   static_cast<int>(helper.K()),
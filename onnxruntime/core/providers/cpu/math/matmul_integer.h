@@ -23,10 +23,15 @@ class MatMulInteger final : public OpKernel {
     }
   }
 
+  // packs a constant 2-D B for MLAS so that it is not copied to the GEMM panels on every call
+  Status PrePack(const Tensor& tensor, int input_idx, bool& is_packed) override;
+
   Status Compute(OpKernelContext* context) const override;
 
  private:
   bool has_a_zero_point_;
   bool has_b_zero_point_;
+  TensorShape b_shape_;
+  BufferUniquePtr packed_b_;
 };
 }  // namespace onnxruntime
@@ -2,16 +2,23 @@
 // Licensed under the MIT License.
 
 #include "core/providers/cpu/math/quantize_linear_matmul.h"
+
+#include <type_traits>
+#include <vector>
+
 #include "core/providers/cpu/math/matmul_helper.h"
 #include "core/providers/common.h"
+#include "core/util/qmath.h"
+#include "core/mlas/inc/mlas.h"
 
 namespace onnxruntime {
 
 // only register this operator if low precision computation is enabled.
-ONNX_OPERATOR_KERNEL_EX(
+ONNX_OPERATOR_TYPED_KERNEL_EX(
     QLinearMatMul,
     kOnnxDomain,
     10,
+    uint8_t,
     kCpuExecutionProvider,
     KernelDefBuilder()
         .TypeConstraint("T1", DataTypeImpl::GetTensorType<uint8_t>())
@@ -19,59 +26,168 @@ ONNX_OPERATOR_KERNEL_EX(
         .TypeConstraint("T3", DataTypeImpl::GetTensorType<uint8_t>()),
     QLinearMatMul<uint8_t, uint8_t, uint8_t>);
 
-template <>
-Status QLinearMatMul<uint8_t, uint8_t, uint8_t>::Compute(OpKernelContext* ctx) const {
+ONNX_OPERATOR_TYPED_KERNEL_EX(
+    QLinearMatMul,
+    kOnnxDomain,
+    10,
+    int8_t,
+    kCpuExecutionProvider,
+    KernelDefBuilder()
+        .TypeConstraint("T1", DataTypeImpl::GetTensorType<uint8_t>())
+        .TypeConstraint("T2", DataTypeImpl::GetTensorType<int8_t>())
+        .TypeConstraint("T3", DataTypeImpl::GetTensorType<uint8_t>()),
+    QLinearMatMul<uint8_t, int8_t, uint8_t>);
+
+namespace {
+
+void QGemm(int M, int N, int K, const uint8_t* lhs_data, int lda, const uint8_t lhs_offset,
+           const uint8_t* rhs_data, int ldb, const uint8_t rhs_offset, int32_t* result_data, int ldc,
+           concurrency::ThreadPool* thread_pool) {
+  QGemmu8u8_s32(M, N, K, lhs_data, lda, lhs_offset, rhs_data, ldb, rhs_offset, result_data, ldc, thread_pool);
+}
+
+void QGemm(int M, int N, int K, const uint8_t* lhs_data, int lda, const uint8_t lhs_offset,
+           const int8_t* rhs_data, int ldb, const int8_t rhs_offset, int32_t* result_data, int ldc,
+           concurrency::ThreadPool* thread_pool) {
+  QGemmu8s8_s32(M, N, K, lhs_data, lda, lhs_offset, rhs_data, ldb, rhs_offset, result_data, ldc, thread_pool);
+}
+
+bool IsScalarOrColumnVector(const Tensor* input, int64_t columns) {
+  const auto& shape = input->Shape();
+  return shape.NumDimensions() == 0 ||
+         (shape.NumDimensions() == 1 && (shape[0] == 1 || shape[0] == columns));
+}
+
+}  // namespace
+
+template <typename T1, typename T2, typename T3>
+Status QLinearMatMul<T1, T2, T3>::PrePack(const Tensor& tensor, int input_idx, bool& is_packed) {
+  is_packed = false;
+
+#ifdef MLAS_SUPPORTS_GEMM_U8X8
+  // only pack Matrix B, and only if it is 2-D. a batch of B matrices is multiplied one at a time.
+  if (input_idx != 3 || tensor.Shape().NumDimensions() != 2) {
+    return Status::OK();
+  }
+
+  const size_t K = static_cast<size_t>(tensor.Shape()[0]);
+  const size_t N = static_cast<size_t>(tensor.Shape()[1]);
+  const bool b_is_signed = std::is_signed<T2>::value;
+  const size_t packed_b_size = MlasGemmPackBSize(N, K, b_is_signed);
+  if (packed_b_size == 0) {
+    return Status::OK();
+  }
+
+  auto alloc = Info().GetAllocator(0, OrtMemTypeDefault);
+  auto* packed_b_data = alloc->Alloc(packed_b_size);
+  packed_b_ = BufferUniquePtr(packed_b_data, BufferDeleter(alloc));
+  MlasGemmPackB(N, K, reinterpret_cast<const uint8_t*>(tensor.Data<T2>()), N, b_is_signed, packed_b_data);
+
+  b_shape_ = tensor.Shape();
+  is_packed = true;
+#else
+  ORT_UNUSED_PARAMETER(tensor);
+  ORT_UNUSED_PARAMETER(input_idx);
+#endif
+
+  return Status::OK();
+}
+
+template <typename T1, typename T2, typename T3>
+Status QLinearMatMul<T1, T2, T3>::Compute(OpKernelContext* ctx) const {
+  concurrency::ThreadPool* thread_pool = ctx->GetOperatorThreadPool();
+
   auto a = ctx->Input<Tensor>(0);
-  auto b = ctx->Input<Tensor>(3);
-  ORT_ENFORCE(a != nullptr && b != nullptr);
+  auto b = packed_b_ ? nullptr : ctx->Input<Tensor>(3);
+  ORT_ENFORCE(a != nullptr && (packed_b_ || b != nullptr));
 
   MatMulComputeHelper helper;
-  ORT_RETURN_IF_ERROR(helper.Compute(a->Shape(), b->Shape()));
+  ORT_RETURN_IF_ERROR(helper.Compute(a->Shape(), packed_b_ ? b_shape_ : b->Shape()));
   Tensor* y = ctx->Output(0, helper.OutputShape());
 
-  // validate offsets
+  const int M = static_cast<int>(helper.M());
+  const int N = static_cast<int>(helper.N());
+  const int K = static_cast<int>(helper.K());
+
+  // validate offsets. matrix B may be quantized per column.
   auto a_offset = ctx->Input<Tensor>(2);
   auto b_offset = ctx->Input<Tensor>(5);
   auto y_offset = ctx->Input<Tensor>(7);
-  ORT_ENFORCE(IsScalarOr1ElementVector(a_offset),
+  ORT_ENFORCE(IsScalarOr1ElementVector(a_offset) && a_offset->Shape().Size() == 1,
               "QLinearMatmul : input zero point must be a scalar or 1D tensor of size 1");
-  ORT_ENFORCE(IsScalarOr1ElementVector(b_offset),
-              "QLinearMatmul : weight zero point must be a scalar or 1D tensor of size 1");
-  ORT_ENFORCE(IsScalarOr1ElementVector(y_offset),
+  ORT_ENFORCE(IsScalarOrColumnVector(b_offset, N),
+              "QLinearMatmul : weight zero point must be a scalar, a 1D tensor of size 1 or a 1D tensor with one "
+              "element per column");
+  ORT_ENFORCE(IsScalarOr1ElementVector(y_offset) && y_offset->Shape().Size() == 1,
               "QLinearMatmul : result zero point must be a scalar or 1D tensor of size 1");
 
   // validate scale
   auto a_scale = ctx->Input<Tensor>(1);
   auto b_scale = ctx->Input<Tensor>(4);
   auto y_scale = ctx->Input<Tensor>(6);
-  ORT_ENFORCE(IsScalarOr1ElementVector(a_scale),
+  ORT_ENFORCE(IsScalarOr1ElementVector(a_scale) && a_scale->Shape().Size() == 1,
               "QLinearMatmul : input scale must be a scalar or 1D tensor of size 1");
-  ORT_ENFORCE(IsScalarOr1ElementVector(b_scale),
-              "QLinearMatmul : weight scale must be a scalar or 1D tensor of size 1");
-  ORT_ENFORCE(IsScalarOr1ElementVector(y_scale),
+  ORT_ENFORCE(IsScalarOrColumnVector(b_scale, N),
+              "QLinearMatmul : weight scale must be a scalar, a 1D tensor of size 1 or a 1D tensor with one "
+              "element per column");
+  ORT_ENFORCE(IsScalarOr1ElementVector(y_scale) && y_scale->Shape().Size() == 1,
               "QLinearMatmul : result scale must be a scalar or 1D tensor of size 1");
 
-  auto a_scale_data = *(a_scale->template Data<float>());
-  auto b_scale_data = *(b_scale->template Data<float>());
-  auto y_scale_data = *(y_scale->template Data<float>());
+  const uint8_t a_offset_data = *a_offset->template Data<uint8_t>();
+  const T2* b_offset_data = b_offset->template Data<T2>();
+  const uint8_t y_offset_data = *y_offset->template Data<uint8_t>();
+  const bool b_offset_per_column = b_offset->Shape().Size() > 1;
+
+  // the scale that maps the integer product of A and B to Y, for the whole matrix or for each column
+  const float a_scale_data = *a_scale->template Data<float>();
+  const float* b_scale_data = b_scale->template Data<float>();
+  const float y_scale_data = *y_scale->template Data<float>();
+  std::vector<float> output_scales(static_cast<size_t>(b_scale->Shape().Size()));
+  for (size_t i = 0; i < output_scales.size(); i++) {
+    output_scales[i] = (a_scale_data * b_scale_data[i]) / y_scale_data;
+  }
+  const auto scale_granularity = output_scales.size() > 1 ? MlasPerColumn : MlasPerMatrix;
 
-  const float real_multiplier = (a_scale_data * b_scale_data) / y_scale_data;
-  int32_t integer_multiplier;
-  int right_shift;
-  QuantizeMultiplier(real_multiplier, &integer_multiplier, &right_shift);
+  AllocatorPtr alloc;
+  ORT_RETURN_IF_ERROR(ctx->GetTempSpaceAllocator(&alloc));
+  auto gemm_output_data = alloc->Alloc(sizeof(int32_t) * static_cast<size_t>(M) * static_cast<size_t>(N));
+  BufferUniquePtr gemm_output_buffer(gemm_output_data, BufferDeleter(alloc));
+  auto* gemm_output = static_cast<int32_t*>(gemm_output_buffer.get());
 
   for (size_t i = 0; i < helper.OutputOffsets().size(); i++) {
-    GemmlowpMultiplyu8u8_u8(a->template Data<uint8_t>() + helper.LeftOffsets()[i],
-                            b->template Data<uint8_t>() + helper.RightOffsets()[i],
-                            y->template MutableData<uint8_t>() + helper.OutputOffsets()[i],
-                            *a_offset->template Data<uint8_t>(),
-                            *b_offset->template Data<uint8_t>(),
-                            *y_offset->template Data<uint8_t>(),
-                            static_cast<int>(helper.M()),
-                            static_cast<int>(helper.N()),
-                            static_cast<int>(helper.K()),
-                            integer_multiplier,
-                            right_shift);
+    const auto* a_data = a->template Data<uint8_t>() + helper.LeftOffsets()[i];
+
+    // the integer product is computed with MLAS on x86 and requantized to Y in a single pass over the output
+    const T2 b_offset_matrix = b_offset_per_column ? T2(0) : *b_offset_data;
+#ifdef MLAS_SUPPORTS_GEMM_U8X8
+    if (packed_b_) {
+      MlasGemm(static_cast<size_t>(M), static_cast<size_t>(N), static_cast<size_t>(K),
+               a_data, static_cast<size_t>(K), a_offset_data,
+               packed_b_.get(), static_cast<uint8_t>(b_offset_matrix), std::is_signed<T2>::value,
+               gemm_output, static_cast<size_t>(N),
+               thread_pool);
+    } else
+#endif
+    {
+      QGemm(M, N, K,
+            a_data, K, a_offset_data,
+            b->template Data<T2>() + helper.RightOffsets()[i], N, b_offset_matrix,
+            gemm_output, N,
+            thread_pool);
+    }
+
+    if (b_offset_per_column) {
+      QGemmApplyRhsColumnOffsets(M, N, K, a_data, K, a_offset_data, b_offset_data, gemm_output, N);
+    }
+
+    MlasRequantizeOutput(gemm_output,
+                         y->template MutableData<uint8_t>() + helper.OutputOffsets()[i],
+                         nullptr,
+                         static_cast<size_t>(M),
+                         static_cast<size_t>(N),
+                         output_scales.data(),
+                         scale_granularity,
+                         y_offset_data);
   }
 
   return Status::OK();
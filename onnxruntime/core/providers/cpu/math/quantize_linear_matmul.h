@@ -5,8 +5,6 @@
 
 #include "core/common/common.h"
 #include "core/framework/op_kernel.h"
-#include "core/util/math_cpuonly.h"
-#include "core/util/gemmlowp_common.h"
 
 namespace onnxruntime {
 
@@ -16,7 +14,13 @@ class QLinearMatMul final : public OpKernel {
   QLinearMatMul(const OpKernelInfo& info) : OpKernel(info) {
   }
 
+  // packs a constant 2-D B for MLAS so that it is not copied to the GEMM panels on every call
+  Status PrePack(const Tensor& tensor, int input_idx, bool& is_packed) override;
+
   Status Compute(OpKernelContext* context) const override;
 
+ private:
+  TensorShape b_shape_;
+  BufferUniquePtr packed_b_;
 };
 }  // namespace onnxruntime
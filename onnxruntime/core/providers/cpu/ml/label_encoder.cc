@@ -2,8 +2,6 @@
 // Licensed under the MIT License.
 
 #include "core/providers/cpu/ml/label_encoder.h"
-#include <algorithm>
-#include <gsl/gsl>
 using namespace ::onnxruntime::common;
 
 namespace onnxruntime {
@@ -34,35 +32,24 @@ Status LabelEncoder::Compute(OpKernelContext* context) const {
     if (!utils::IsPrimitiveDataType<int64_t>(Y.DataType()))
       return Status(ONNXRUNTIME, FAIL, "Input of tensor(string) must have output of tensor(int64)");
 
-    auto input = gsl::make_span(X.template Data<std::string>(), shape.Size());
-    auto output = gsl::make_span(Y.template MutableData<int64_t>(), shape.Size());
-    auto out = output.begin();
-
-    // map isn't going to change so get end() once instead of calling inside the for_each loop
-    const auto map_end = string_to_int_map_.end();
-
-    std::for_each(input.cbegin(), input.cend(),
-                  [&out, &map_end, this](const std::string& value) {
-                    auto map_to = string_to_int_map_.find(value);
-                    *out = map_to == map_end ? default_int_ : map_to->second;
-                    ++out;
-                  });
+    string_to_int_map_.Lookup(X.template Data<std::string>(), Y.template MutableData<int64_t>(), shape.Size(),
+                              default_int_, context->GetOperatorThreadPool());
   } else {
     if (!utils::IsDataTypeString(Y.DataType()))
       return Status(ONNXRUNTIME, FAIL, "Input of tensor(int64) must have output of tensor(string)");
 
-    auto input = gsl::make_span(X.template Data<int64_t>(), shape.Size());
-    auto output = gsl::make_span(Y.template MutableData<std::string>(), shape.Size());
-    auto out = output.begin();
-
-    const auto map_end = int_to_string_map_.end();
-
-    std::for_each(input.cbegin(), input.cend(),
-                  [&out, &map_end, this](const int64_t& value) {
-                    auto map_to = int_to_string_map_.find(value);
-                    *out = map_to == map_end ? default_string_ : map_to->second;
-                    ++out;
-                  });
+    const auto* input = X.template Data<int64_t>();
+    auto* output = Y.template MutableData<std::string>();
+    const auto num_classes = static_cast<int64_t>(classes_strings_.size());
+
+    concurrency::ThreadPool::TryParallelFor(
+        context->GetOperatorThreadPool(), static_cast<std::ptrdiff_t>(shape.Size()), 16.0,
+        [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+          for (std::ptrdiff_t i = first; i < last; ++i) {
+            const int64_t value = input[i];
+            output[i] = value >= 0 && value < num_classes ? classes_strings_[static_cast<size_t>(value)] : default_string_;
+          }
+        });
   }
 
   return Status::OK();
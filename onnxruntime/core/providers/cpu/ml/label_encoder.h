@@ -5,6 +5,7 @@
 
 #include "core/common/common.h"
 #include "core/framework/op_kernel.h"
+#include "core/providers/cpu/ml/lookup_table.h"
 #include "core/providers/cpu/ml/ml_common.h"
 
 namespace onnxruntime {
@@ -20,24 +21,21 @@ class LabelEncoder final : public OpKernel {
     ORT_ENFORCE(info.GetAttr<std::string>("default_string", &default_string_).IsOK());
     ORT_ENFORCE(info.GetAttr<int64_t>("default_int64", &default_int_).IsOK());
 
-    auto num_entries = string_classes.size();
-
-    string_to_int_map_.reserve(num_entries);
-    int_to_string_map_.reserve(num_entries);
-
-    for (size_t i = 0; i < num_entries; ++i) {
-      const std::string& str = string_classes[i];
-
-      string_to_int_map_[str] = i;
-      int_to_string_map_[i] = str;
+    std::vector<int64_t> indices(string_classes.size());
+    for (size_t i = 0; i < indices.size(); ++i) {
+      indices[i] = static_cast<int64_t>(i);
     }
+
+    string_to_int_map_ = LookupTable<std::string, int64_t>(string_classes, indices);
+    // the classes are indexed by their position
+    classes_strings_ = std::move(string_classes);
   }
 
   Status Compute(OpKernelContext* context) const override;
 
  private:
-  std::unordered_map<std::string, int64_t> string_to_int_map_;
-  std::unordered_map<int64_t, std::string> int_to_string_map_;
+  LookupTable<std::string, int64_t> string_to_int_map_;
+  std::vector<std::string> classes_strings_;
 
   std::string default_string_;
   int64_t default_int_;
@@ -64,8 +62,7 @@ class LabelEncoder_2 final : public OpKernel {
                 "However, the number of key is ", num_keys, " and the number of ",
                 "values is ", num_values, ".");
 
-    for (size_t i = 0; i < num_keys; ++i)
-      _map[keys[i]] = values[i];
+    _map = LookupTable<TKey, TValue>(keys, values);
   }
 
   Status Compute(OpKernelContext* context) const override {
@@ -75,16 +72,8 @@ class LabelEncoder_2 final : public OpKernel {
     const TensorShape& shape = X.Shape();
     Tensor& Y = *context->Output(0, TensorShape(shape));
 
-    auto input = X.template DataAsSpan<TKey>();
-    auto output = Y.template MutableDataAsSpan<TValue>();
-
-    for (int64_t i = 0; i < shape.Size(); ++i) {
-      const auto found = _map.find(input[i]);
-      if (found == _map.end())
-        output[i] = _default_value;
-      else
-        output[i] = found->second;
-    }
+    _map.Lookup(X.template Data<TKey>(), Y.template MutableData<TValue>(), shape.Size(), _default_value,
+                context->GetOperatorThreadPool());
 
     return Status::OK();
   }
@@ -98,7 +87,7 @@ class LabelEncoder_2 final : public OpKernel {
   // A collection of key-value pairs. Each (a_key, a_value) pair
   // means that the "a_key" in the input would be mapped to "a_value".
   // If _map doesn't contain "a_key", we use _default_value as its output.
-  std::unordered_map<TKey, TValue> _map;
+  LookupTable<TKey, TValue> _map;
   TValue _default_value;
   // ONNX attribute name to load keys.
   std::string _key_field_name;
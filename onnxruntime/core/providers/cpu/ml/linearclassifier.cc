@@ -52,6 +52,17 @@ LinearClassifier<T>::LinearClassifier(const OpKernelInfo& info) : OpKernel(info)
   class_count_ = static_cast<int64_t>(intercepts_.size());
 }
 
+static const float* InputAsFloats(const float* x_data, int64_t, std::vector<float>&) {
+  return x_data;
+}
+
+template <typename T>
+static const float* InputAsFloats(const T* x_data, int64_t count, std::vector<float>& buffer) {
+  buffer.resize(static_cast<size_t>(count));
+  EigenVectorArrayMap<float>(buffer.data(), count) = ConstEigenVectorArrayMap<T>(x_data, count).template cast<float>();
+  return buffer.data();
+}
+
 template <typename T>
 Status LinearClassifier<T>::Compute(OpKernelContext* ctx) const {
   const auto* X = ctx->Input<Tensor>(0);
@@ -63,6 +74,11 @@ Status LinearClassifier<T>::Compute(OpKernelContext* ctx) const {
 
   int64_t stride = shape.NumDimensions() == 1 ? shape[0] : shape[1];
   int64_t N = shape.NumDimensions() == 1 ? 1 : shape[0];
+  if (static_cast<int64_t>(coefficients_.size()) != class_count_ * stride) {
+    return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
+                  "Input has " + std::to_string(stride) + " features, the coefficients expect " +
+                      std::to_string(class_count_ == 0 ? 0 : coefficients_.size() / static_cast<size_t>(class_count_)) + ".");
+  }
   Tensor* Y = ctx->Output(0, TensorShape({N}));
 
   int64_t output_classes = class_count_;
@@ -72,79 +88,83 @@ Status LinearClassifier<T>::Compute(OpKernelContext* ctx) const {
     add_second_class = true;
   }
   Tensor* Z = ctx->Output(1, TensorShape({N, output_classes}));
+  if (N == 0) {
+    return Status::OK();
+  }
 
-  int64_t zindex = 0;
-  const auto* x_data = X->template Data<T>();
-
-  auto class_count = static_cast<size_t>(class_count_);
-  std::vector<float> scores;
-  scores.reserve(class_count);
-  for (int64_t i = 0; i < N; i++)  //for each point
-  {
-    scores.clear();
-    size_t current_weight_0 = i * stride;
-    int maxclass = -1;
-    float maxweight = 0.f;
-    for (int j = 0; j < class_count_; j++)  // for each class
-    {
-      size_t current_coeff_0 = j * stride;
-      float weight = 0.f;
-      for (int64_t k = 0; k < stride; k++)  //for each weight
-      {
-        weight += static_cast<float>(x_data[current_weight_0 + k] * coefficients_[current_coeff_0 + k]);
-      }
-      if (intercepts_.size() == class_count) {
-        weight += intercepts_[j];
-      }
-      scores.push_back(weight);
-      if (weight > maxweight || maxclass == -1) {
-        maxweight = weight;
-        maxclass = j;
-      }
-    }
-    //write top class
-    if (intercepts_.size() == 1)  //binary
-    {
-      if (using_strings_) {
-        if (classlabels_strings_.size() == 2 && maxweight > 0) {
-          Y->template MutableData<std::string>()[i] = classlabels_strings_[1];  //positive label
-        } else if (classlabels_strings_.size() == 2) {
-          Y->template MutableData<std::string>()[i] = classlabels_strings_[0];  //negative label
-        } else if (maxweight > 0) {
-          Y->template MutableData<std::string>()[i] = "1";  //positive label
+  // scores of all the points and classes with one matrix multiplication, into Z unless a second class is added
+  std::vector<float> x_buffer;
+  const float* x_data = InputAsFloats(X->template Data<T>(), N * stride, x_buffer);
+  float* z_data = Z->template MutableData<float>();
+  std::vector<float> scores_buffer;
+  float* scores = z_data;
+  if (add_second_class) {
+    scores_buffer.resize(static_cast<size_t>(N));
+    scores = scores_buffer.data();
+  }
+  concurrency::ThreadPool* tp = ctx->GetOperatorThreadPool();
+  MlasGemm(CblasNoTrans, CblasTrans, static_cast<size_t>(N), static_cast<size_t>(class_count_),
+           static_cast<size_t>(stride), 1.f, x_data, static_cast<size_t>(stride), coefficients_.data(),
+           static_cast<size_t>(stride), 0.f, scores, static_cast<size_t>(class_count_), tp);
+
+  // labels of a binary classifier, negative first
+  std::string negative_string("0");
+  std::string positive_string("1");
+  int64_t negative_int = 0;
+  int64_t positive_int = 1;
+  if (classlabels_strings_.size() == 2) {
+    negative_string = classlabels_strings_[0];
+    positive_string = classlabels_strings_[1];
+  }
+  if (classlabels_ints_.size() == 2) {
+    negative_int = classlabels_ints_[0];
+    positive_int = classlabels_ints_[1];
+  }
+
+  // adds the intercepts, then picks the top class and transforms the scores of each point
+  ConstEigenVectorArrayMap<float> intercepts(intercepts_.data(), class_count_);
+  auto process_points = [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+    const int64_t begin = first;
+    const int64_t end = last;
+    for (int64_t i = begin; i < end; i++) {  //for each point
+      float* point_scores = scores + i * class_count_;
+      EigenVectorArrayMap<float>(point_scores, class_count_) += intercepts;
+
+      if (class_count_ == 1) {  //binary
+        const bool positive = point_scores[0] > 0;
+        if (using_strings_) {
+          Y->template MutableData<std::string>()[i] = positive ? positive_string : negative_string;
         } else {
-          Y->template MutableData<std::string>()[i] = "0";  //negative label
+          Y->template MutableData<int64_t>()[i] = positive ? positive_int : negative_int;
         }
-      } else  //no strings
-      {
-        if (classlabels_ints_.size() == 2 && maxweight > 0) {
-          Y->template MutableData<int64_t>()[i] = classlabels_ints_[1];  //positive label
-        } else if (classlabels_ints_.size() == 2) {
-          Y->template MutableData<int64_t>()[i] = classlabels_ints_[0];  //negative label
-        } else if (maxweight > 0) {
-          Y->template MutableData<int64_t>()[i] = 1;  //positive label
+      } else {  //multiclass
+        int64_t maxclass = 0;
+        for (int64_t j = 1; j < class_count_; j++) {
+          if (point_scores[j] > point_scores[maxclass]) {
+            maxclass = j;
+          }
+        }
+        if (using_strings_) {
+          Y->template MutableData<std::string>()[i] = classlabels_strings_[maxclass];
         } else {
-          Y->template MutableData<int64_t>()[i] = 0;  //negative label
+          Y->template MutableData<int64_t>()[i] = classlabels_ints_[maxclass];
         }
       }
-    } else  //multiclass
-    {
-      if (using_strings_) {
-        Y->template MutableData<std::string>()[i] = classlabels_strings_[maxclass];
-      } else {
-        Y->template MutableData<int64_t>()[i] = classlabels_ints_[maxclass];
+
+      // the second class is written as write_scores does for a single score
+      if (add_second_class && post_transform_ == POST_EVAL_TRANSFORM::PROBIT) {
+        z_data[i] = ComputeProbit(point_scores[0]);
+      } else if (add_second_class) {
+        z_data[2 * i] = 1.f - point_scores[0];
+        z_data[2 * i + 1] = point_scores[0];
       }
     }
-    //write float values
-    if (add_second_class && maxweight > 0) {
-      ::onnxruntime::ml::write_scores(scores, post_transform_, zindex, Z, 0);
-    } else if (add_second_class) {
-      ::onnxruntime::ml::write_scores(scores, post_transform_, zindex, Z, 1);
-    } else {
-      ::onnxruntime::ml::write_scores(scores, post_transform_, zindex, Z, -1);
+    if (!add_second_class) {
+      transform_scores(scores + begin * class_count_, end - begin, class_count_, post_transform_);
     }
-    zindex += scores.size();
-  }  //for each point
+  };
+  concurrency::ThreadPool::TryParallelFor(tp, static_cast<std::ptrdiff_t>(N),
+                                          static_cast<double>(class_count_ * 8), process_points);
   return Status::OK();
 }
 
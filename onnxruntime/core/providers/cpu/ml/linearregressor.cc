@@ -30,31 +30,39 @@ Status LinearRegressor<float>::Compute(OpKernelContext* ctx) const {
 
   int64_t stride = X->Shape().NumDimensions() == 1 ? X->Shape()[0] : X->Shape()[1];
   int64_t N = X->Shape().NumDimensions() == 1 ? 1 : X->Shape()[0];
+  if (static_cast<int64_t>(coefficients_.size()) != targets_ * stride) {
+    return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
+                  "Input has " + std::to_string(stride) + " features, the coefficients expect " +
+                      std::to_string(targets_ == 0 ? 0 : coefficients_.size() / static_cast<size_t>(targets_)) + ".");
+  }
   Tensor* Y = ctx->Output(0, TensorShape({N, targets_}));
+  if (N == 0) {
+    return Status::OK();
+  }
+
+  // scores of all the points and targets with one matrix multiplication
   const auto* Xdata = X->template Data<float>();
-  int64_t yindex = 0;
+  float* Ydata = Y->template MutableData<float>();
+  concurrency::ThreadPool* tp = ctx->GetOperatorThreadPool();
+  MlasGemm(CblasNoTrans, CblasTrans, static_cast<size_t>(N), static_cast<size_t>(targets_),
+           static_cast<size_t>(stride), 1.f, Xdata, static_cast<size_t>(stride), coefficients_.data(),
+           static_cast<size_t>(stride), 0.f, Ydata, static_cast<size_t>(targets_), tp);
 
+  // adds the intercepts and transforms the scores of each point
   bool useIntercepts = intercepts_.size() == static_cast<size_t>(targets_);
-  for (int64_t i = 0; i < N; i++)  //for each point
-  {
-    std::vector<float> scores;
-    int64_t current_weight_0 = i * stride;
-    for (int j = 0; j < targets_; j++)  //for each target
-    {
-      int64_t current_coeff_0 = j * stride;
-      float weight = 0.f;
-      for (int64_t k = 0; k < stride; k++)  //for each weight
-      {
-        weight = weight + Xdata[current_weight_0 + k] * coefficients_[current_coeff_0 + k];
-      }
-      if (useIntercepts) {
-        weight = weight + intercepts_[j];
-      }
-      scores.push_back(weight);
-    }
-    ::onnxruntime::ml::write_scores(scores, post_transform_, yindex, Y, -1);
-    yindex += scores.size();
-  }
+  concurrency::ThreadPool::TryParallelFor(
+      tp, static_cast<std::ptrdiff_t>(N), static_cast<double>(targets_ * 8),
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        const int64_t begin = first;
+        const int64_t end = last;
+        if (useIntercepts) {
+          ConstEigenVectorArrayMap<float> intercepts(intercepts_.data(), targets_);
+          for (int64_t i = begin; i < end; i++) {
+            EigenVectorArrayMap<float>(Ydata + i * targets_, targets_) += intercepts;
+          }
+        }
+        transform_scores(Ydata + begin * targets_, end - begin, targets_, post_transform_);
+      });
   return Status::OK();
 }
 
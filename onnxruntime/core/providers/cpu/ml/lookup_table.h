@@ -0,0 +1,153 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/framework/string_buffer.h"
+#include "core/platform/threadpool.h"
+
+namespace onnxruntime {
+namespace ml {
+
+// The distinct keys of a LookupTable, by index. Numbers are kept in an array.
+template <typename TKey>
+class LookupTableKeys {
+ public:
+  size_t Size() const { return keys_.size(); }
+  void Add(const TKey& key) { keys_.push_back(key); }
+  bool Equals(size_t i, const TKey& key) const { return keys_[i] == key; }
+
+ private:
+  std::vector<TKey> keys_;
+};
+
+// Strings are kept one after the other in a single buffer, so that the keys of a large vocabulary don't each have
+// their own allocation to chase.
+template <>
+class LookupTableKeys<std::string> {
+ public:
+  size_t Size() const { return keys_.Size(); }
+  void Add(const std::string& key) { keys_.Append(key); }
+  bool Equals(size_t i, const std::string& key) const {
+    return keys_.Length(i) == key.size() && memcmp(keys_.Data(i), key.data(), key.size()) == 0;
+  }
+
+ private:
+  StringBuffer keys_;
+};
+
+// A read-only hash table from keys to values, built once by a kernel constructor and read concurrently by its runs.
+// It uses open addressing with linear probing over an array of slots, each holding a key index and the high bits of
+// the key hash, so that a lookup reads one or two adjacent slots and compares the key itself only when those bits
+// match. Equal keys follow the semantics of std::unordered_map with the same key type, -0.0 and 0.0 being the same
+// float key and NaN matching nothing.
+template <typename TKey, typename TValue>
+class LookupTable {
+ public:
+  LookupTable() = default;
+
+  // Maps keys[i] to values[i]. A key that appears more than once maps to its last value.
+  LookupTable(const std::vector<TKey>& keys, const std::vector<TValue>& values) {
+    ORT_ENFORCE(keys.size() == values.size(), "The number of keys and values must match.");
+    ORT_ENFORCE(keys.size() < std::numeric_limits<uint32_t>::max(), "Too many keys: ", keys.size());
+
+    // at most half of the slots are used, which keeps the probe sequences short
+    size_t capacity = 16;
+    while (capacity < keys.size() * 2) {
+      capacity *= 2;
+    }
+    slots_.resize(capacity);
+    mask_ = capacity - 1;
+    values_.reserve(keys.size());
+
+    for (size_t i = 0; i < keys.size(); ++i) {
+      const uint64_t hash = Hash(keys[i]);
+      Slot& slot = slots_[FindSlot(keys[i], hash)];
+      if (slot.index != kEmpty) {
+        values_[slot.index] = values[i];
+      } else {
+        slot.index = static_cast<uint32_t>(keys_.Size());
+        slot.tag = static_cast<uint32_t>(hash >> 32);
+        keys_.Add(keys[i]);
+        values_.push_back(values[i]);
+      }
+    }
+  }
+
+  size_t Size() const { return values_.size(); }
+
+  // Returns the value of the key, or nullptr if the key isn't in the table.
+  const TValue* Find(const TKey& key) const {
+    if (slots_.empty()) {
+      return nullptr;
+    }
+    const Slot& slot = slots_[FindSlot(key, Hash(key))];
+    return slot.index == kEmpty ? nullptr : &values_[slot.index];
+  }
+
+  // Writes the value of each of the count keys to output, or default_value for the keys that aren't in the table.
+  // The keys are looked up in parallel on the thread pool.
+  void Lookup(const TKey* keys, TValue* output, int64_t count, const TValue& default_value,
+              concurrency::ThreadPool* tp) const {
+    concurrency::ThreadPool::TryParallelFor(
+        tp, static_cast<std::ptrdiff_t>(count), kLookupCost, [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+          for (std::ptrdiff_t i = first; i < last; ++i) {
+            const TValue* value = Find(keys[i]);
+            output[i] = value == nullptr ? default_value : *value;
+          }
+        });
+  }
+
+ private:
+  struct Slot {
+    uint32_t tag = 0;
+    uint32_t index = kEmpty;
+  };
+
+  static constexpr uint32_t kEmpty = std::numeric_limits<uint32_t>::max();
+  // rough cost of a lookup, which misses the cache for a large table
+  static constexpr double kLookupCost = 64.0;
+
+  static uint64_t Hash(const TKey& key) {
+    // std::hash of an integer is the integer itself, so the bits are mixed before they select a slot
+    uint64_t h = static_cast<uint64_t>(std::hash<TKey>()(key));
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+  }
+
+  // Position of the slot of the key, or of the empty slot that ends its probe sequence.
+  size_t FindSlot(const TKey& key, uint64_t hash) const {
+    const auto tag = static_cast<uint32_t>(hash >> 32);
+    for (size_t i = static_cast<size_t>(hash) & mask_;; i = (i + 1) & mask_) {
+      const Slot& slot = slots_[i];
+      if (slot.index == kEmpty || (slot.tag == tag && keys_.Equals(slot.index, key))) {
+        return i;
+      }
+    }
+  }
+
+  std::vector<Slot> slots_;
+  size_t mask_ = 0;
+  LookupTableKeys<TKey> keys_;
+  std::vector<TValue> values_;
+};
+
+template <typename TKey, typename TValue>
+constexpr uint32_t LookupTable<TKey, TValue>::kEmpty;
+
+template <typename TKey, typename TValue>
+constexpr double LookupTable<TKey, TValue>::kLookupCost;
+
+}  // namespace ml
+}  // namespace onnxruntime
@@ -4,6 +4,7 @@
 #pragma once
 #include "core/common/common.h"
 #include "core/framework/op_kernel.h"
+#include "core/mlas/inc/mlas.h"
 #include "core/util/math_cpuonly.h"
 
 namespace onnxruntime {
@@ -15,7 +16,7 @@ enum class OUTPUT_MODE {
   ALL_SCORES
 };
 
-enum class NODE_MODE {
+enum class NODE_MODE : uint8_t {
   BRANCH_LEQ,
   BRANCH_LT,
   BRANCH_GTE,
@@ -267,16 +268,17 @@ static inline void ComputeSoftmax(std::vector<float>& values) {
 }
 
 //this function skips zero values (since exp(0) is non zero)
-static inline void ComputeSoftmaxZero(std::vector<float>& values) {
+static inline void ComputeSoftmaxZero(float* values, int64_t count) {
   // compute exp with negative number to be numerically stable
   float v_max = -std::numeric_limits<float>::max();
-  for (float value : values) {
-    if (value > v_max)
-      v_max = value;
+  for (int64_t i = 0; i < count; ++i) {
+    if (values[i] > v_max)
+      v_max = values[i];
   }
   float exp_neg_v_max = std::exp(-v_max);
   float this_sum = 0.f;
-  for (float& value : values) {
+  for (int64_t i = 0; i < count; ++i) {
+    float& value = values[i];
     if (value > 0.0000001f || value < -0.0000001f) {
       value = std::exp(value - v_max);
       this_sum += value;
@@ -284,8 +286,12 @@ static inline void ComputeSoftmaxZero(std::vector<float>& values) {
       value *= exp_neg_v_max;
     }
   }
-  for (float& value : values)
-    value /= this_sum;
+  for (int64_t i = 0; i < count; ++i)
+    values[i] /= this_sum;
+}
+
+static inline void ComputeSoftmaxZero(std::vector<float>& values) {
+  ComputeSoftmaxZero(values.data(), static_cast<int64_t>(values.size()));
 }
 
 template <typename T>
@@ -349,5 +355,43 @@ void write_scores(std::vector<T>& scores, POST_EVAL_TRANSFORM post_transform, in
   memcpy(out_p, scores.data(), len);
 }
 
+// Applies the post transform to the rows of a row-major rows x cols matrix of scores in place, as write_scores does
+// for each row when there's no second class to add. The exponentials are computed on whole rows or on the whole
+// matrix rather than value by value.
+static inline void transform_scores(float* scores, int64_t rows, int64_t cols, POST_EVAL_TRANSFORM post_transform) {
+  const int64_t count = rows * cols;
+  if (cols == 1) {
+    if (post_transform == POST_EVAL_TRANSFORM::PROBIT) {
+      for (int64_t i = 0; i < count; ++i)
+        scores[i] = ComputeProbit(scores[i]);
+    }
+    return;
+  }
+
+  switch (post_transform) {
+    case POST_EVAL_TRANSFORM::PROBIT:
+      for (int64_t i = 0; i < count; ++i)
+        scores[i] = ComputeProbit(scores[i]);
+      break;
+    case POST_EVAL_TRANSFORM::LOGISTIC:
+      MlasComputeLogistic(scores, scores, static_cast<size_t>(count));
+      break;
+    case POST_EVAL_TRANSFORM::SOFTMAX:
+      for (int64_t i = 0; i < rows; ++i) {
+        EigenVectorArrayMap<float> row(scores + i * cols, cols);
+        row = (row - row.maxCoeff()).exp();
+        row /= row.sum();
+      }
+      break;
+    case POST_EVAL_TRANSFORM::SOFTMAX_ZERO:
+      for (int64_t i = 0; i < rows; ++i)
+        ComputeSoftmaxZero(scores + i * cols, cols);
+      break;
+    default:
+    case POST_EVAL_TRANSFORM::NONE:
+      break;
+  }
+}
+
 }  // namespace ml
 }  // namespace onnxruntime
@@ -26,10 +26,11 @@ SVMClassifier<T>::SVMClassifier(const OpKernelInfo& info)
       vectors_per_class_(info.GetAttrsOrDefault<int64_t>("vectors_per_class")),
       proba_(info.GetAttrsOrDefault<float>("prob_a")),
       probb_(info.GetAttrsOrDefault<float>("prob_b")),
-      support_vectors_(info.GetAttrsOrDefault<float>("support_vectors")),
       post_transform_(MakeTransform(info.GetAttrOrDefault<std::string>("post_transform", "NONE"))) {
   ORT_ENFORCE(info.GetAttrs<float>("rho", rho_).IsOK());
   ORT_ENFORCE(info.GetAttrs<float>("coefficients", coefficients_).IsOK());
+  // only kept converted to kernel_vectors_
+  const std::vector<float> support_vectors = info.GetAttrsOrDefault<float>("support_vectors");
 
   // prob_a and prob_b are optional for Z output
   ORT_ENFORCE(proba_.size() == probb_.size());
@@ -56,7 +57,7 @@ SVMClassifier<T>::SVMClassifier(const OpKernelInfo& info)
     class_count_ = 1;
   }
   if (vector_count_ > 0) {
-    feature_count_ = support_vectors_.size() / vector_count_;  //length of each support vector
+    feature_count_ = support_vectors.size() / vector_count_;  //length of each support vector
     mode_ = SVM_TYPE::SVM_SVC;
   } else {
     feature_count_ = coefficients_.size() / class_count_;  //liblinear mode
@@ -73,6 +74,11 @@ SVMClassifier<T>::SVMClassifier(const OpKernelInfo& info)
       break;
     }
   }
+  if (mode_ == SVM_TYPE::SVM_SVC) {
+    prepare_vectors(support_vectors, vector_count_, feature_count_, kernel_vectors_, kernel_vector_norms_);
+  } else {
+    prepare_vectors(coefficients_, class_count_, feature_count_, kernel_vectors_, kernel_vector_norms_);
+  }
 }
 
 template <typename LabelType>
@@ -101,6 +107,112 @@ int _set_score_svm(Tensor* Y, float max_weight, const int64_t maxclass, const in
   return write_additional_scores;
 }
 
+template <typename T>
+void SVMClassifier<T>::ComputeRow(const double* kernels, int64_t n, int64_t nb_columns, Scratch& scratch, Tensor* Y,
+                                  Tensor* Z) const {
+  int64_t maxclass = -1;
+  std::vector<float>& scores = scratch.scores;
+  std::vector<int64_t>& votes = scratch.votes;
+  scores.clear();
+  votes.clear();
+
+  if (mode_ == SVM_TYPE::SVM_LINEAR) {
+    for (int64_t j = 0; j < class_count_; j++) {  //for each class
+      scores.push_back(static_cast<float>(kernels[j]) + rho_[0]);
+    }
+  } else {
+    int evals = 0;
+
+    votes.resize(class_count_, 0);
+    for (int64_t i = 0; i < class_count_; i++) {        // for each class
+      for (int64_t j = i + 1; j < class_count_; j++) {  // for each class
+        double sum = 0;
+        int64_t start_index_i = starting_vector_[i];  // *feature_count_;
+        int64_t start_index_j = starting_vector_[j];  // *feature_count_;
+
+        int64_t class_i_support_count = vectors_per_class_[i];
+        int64_t class_j_support_count = vectors_per_class_[j];
+
+        int64_t pos1 = (vector_count_) * (j - 1);
+        int64_t pos2 = (vector_count_) * (i);
+        const float* val1 = &(coefficients_[pos1 + start_index_i]);
+        const double* val2 = kernels + start_index_i;
+        for (int64_t m = 0; m < class_i_support_count; ++m, ++val1, ++val2)
+          sum += *val1 * *val2;
+
+        val1 = &(coefficients_[pos2 + start_index_j]);
+        val2 = kernels + start_index_j;
+        for (int64_t m = 0; m < class_j_support_count; ++m, ++val1, ++val2)
+          sum += *val1 * *val2;
+
+        sum += rho_[evals];
+        scores.push_back((float)sum);
+        ++(votes[sum > 0 ? i : j]);
+        ++evals;  //index into rho
+      }
+    }
+  }
+
+  if (proba_.size() > 0 && mode_ == SVM_TYPE::SVM_SVC) {
+    //compute probabilities from the scores
+    int64_t num = class_count_ * class_count_;
+    std::vector<float>& probsp2 = scratch.probsp2;
+    std::vector<float>& estimates = scratch.estimates;
+    probsp2.assign(num, 0.f);
+    estimates.assign(class_count_, 0.f);
+    int64_t index = 0;
+    for (int64_t i = 0; i < class_count_; ++i) {
+      int64_t p1 = i * class_count_ + i + 1;
+      int64_t p2 = (i + 1) * class_count_ + i;
+      for (int64_t j = i + 1; j < class_count_; ++j, ++index) {
+        float val1 = sigmoid_probability(scores[index], proba_[index], probb_[index]);
+        float val2 = std::max(val1, 1.0e-7f);
+        val2 = std::min(val2, 1 - 1.0e-7f);
+        probsp2[p1] = val2;
+        probsp2[p2] = 1 - val2;
+        ++p1;
+        p2 += class_count_;
+      }
+    }
+    multiclass_probability(class_count_, probsp2, estimates);
+    // copy probabilities back into scores
+    scores.assign(estimates.begin(), estimates.end());
+  }
+
+  float max_weight = 0;
+  if (votes.size() > 0) {
+    auto it_maxvotes = std::max_element(votes.begin(), votes.end());
+    maxclass = std::distance(votes.begin(), it_maxvotes);
+  } else {
+    auto it_max_weight = std::max_element(scores.begin(), scores.end());
+    maxclass = std::distance(scores.begin(), it_max_weight);
+    max_weight = *it_max_weight;
+  }
+
+  // write top class
+  // onnx specs expects one column per class.
+  int write_additional_scores = -1;
+  if (rho_.size() == 1) {
+    if (using_strings_) {
+      write_additional_scores = _set_score_svm<std::string>(
+          Y, max_weight, maxclass, n, post_transform_, proba_,
+          weights_are_all_positive_, classlabels_strings_, "1", "0");
+    } else {
+      write_additional_scores = _set_score_svm<int64_t>(
+          Y, max_weight, maxclass, n, post_transform_, proba_,
+          weights_are_all_positive_, classlabels_ints_, 1, 0);
+    }
+  } else {  //multiclass
+    if (using_strings_) {
+      Y->template MutableData<std::string>()[n] = classlabels_strings_[maxclass];
+    } else {
+      Y->template MutableData<int64_t>()[n] = classlabels_ints_[maxclass];
+    }
+  }
+
+  write_scores(scores, post_transform_, n * nb_columns, Z, write_additional_scores);
+}
+
 template <typename T>
 Status SVMClassifier<T>::Compute(OpKernelContext* ctx) const {
   const auto* X = ctx->Input<Tensor>(0);
@@ -121,124 +233,33 @@ Status SVMClassifier<T>::Compute(OpKernelContext* ctx) const {
   std::vector<int64_t> dims{N, nb_columns};
   Tensor* Z = ctx->Output(1, TensorShape(dims));
 
-  const T* x_data = X->template Data<T>();
-  int64_t zindex = 0;
-
-  for (int64_t n = 0; n < N; n++)  //for each example
-  {
-    int64_t current_weight_0 = n * stride;
-    int64_t maxclass = -1;
-    std::vector<float> decisions;
-    std::vector<float> scores;
-    std::vector<float> kernels;
-    std::vector<int64_t> votes;
-
-    if (vector_count_ == 0 && mode_ == SVM_TYPE::SVM_LINEAR) {
-      for (int64_t j = 0; j < class_count_; j++) {  //for each class
-        auto val = kernel_dot(x_data, current_weight_0, coefficients_, feature_count_ * j,
-                              feature_count_, get_kernel_type());
-        val += rho_[0];
-        scores.push_back(val);
-      }
-    } else {
-      if (vector_count_ == 0)
-        return Status(common::ONNXRUNTIME, common::FAIL, "No support vectors.");
-      int evals = 0;
-
-      for (int64_t j = 0; j < vector_count_; j++) {
-        auto val = kernel_dot(x_data, current_weight_0, support_vectors_, feature_count_ * j,
-                              feature_count_, get_kernel_type());
-        kernels.push_back(val);
-      }
-      votes.resize(class_count_, 0);
-      for (int64_t i = 0; i < class_count_; i++) {        // for each class
-        for (int64_t j = i + 1; j < class_count_; j++) {  // for each class
-          double sum = 0;
-          int64_t start_index_i = starting_vector_[i];  // *feature_count_;
-          int64_t start_index_j = starting_vector_[j];  // *feature_count_;
-
-          int64_t class_i_support_count = vectors_per_class_[i];
-          int64_t class_j_support_count = vectors_per_class_[j];
-
-          int64_t pos1 = (vector_count_) * (j - 1);
-          int64_t pos2 = (vector_count_) * (i);
-          const float* val1 = &(coefficients_[pos1 + start_index_i]);
-          const float* val2 = &(kernels[start_index_i]);
-          for (int64_t m = 0; m < class_i_support_count; ++m, ++val1, ++val2)
-            sum += *val1 * *val2;
-
-          val1 = &(coefficients_[pos2 + start_index_j]);
-          val2 = &(kernels[start_index_j]);
-          for (int64_t m = 0; m < class_j_support_count; ++m, ++val1, ++val2)
-            sum += *val1 * *val2;
-
-          sum += rho_[evals];
-          scores.push_back((float)sum);
-          ++(votes[sum > 0 ? i : j]);
-          ++evals;  //index into rho
-        }
-      }
-    }
+  if (mode_ == SVM_TYPE::SVM_SVC && vector_count_ == 0)
+    return Status(common::ONNXRUNTIME, common::FAIL, "No support vectors.");
+  if (stride < feature_count_)
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "The model has ", feature_count_,
+                           " features but the input only has ", stride, ".");
 
-    if (proba_.size() > 0 && mode_ == SVM_TYPE::SVM_SVC) {
-      //compute probabilities from the scores
-      int64_t num = class_count_ * class_count_;
-      std::vector<float> probsp2(num, 0.f);
-      std::vector<float> estimates(class_count_, 0.f);
-      int64_t index = 0;
-      for (int64_t i = 0; i < class_count_; ++i) {
-        int64_t p1 = i * class_count_ + i + 1;
-        int64_t p2 = (i + 1) * class_count_ + i;
-        for (int64_t j = i + 1; j < class_count_; ++j, ++index) {
-          float val1 = sigmoid_probability(scores[index], proba_[index], probb_[index]);
-          float val2 = std::max(val1, 1.0e-7f);
-          val2 = std::min(val2, 1 - 1.0e-7f);
-          probsp2[p1] = val2;
-          probsp2[p2] = 1 - val2;
-          ++p1;
-          p2 += class_count_;
-        }
-      }
-      multiclass_probability(class_count_, probsp2, estimates);
-      // copy probabilities back into scores
-      scores.resize(estimates.size());
-      std::copy(estimates.begin(), estimates.end(), scores.begin());
-    }
-
-    float max_weight = 0;
-    if (votes.size() > 0) {
-      auto it_maxvotes = std::max_element(votes.begin(), votes.end());
-      maxclass = std::distance(votes.begin(), it_maxvotes);
-    } else {
-      auto it_max_weight = std::max_element(scores.begin(), scores.end());
-      maxclass = std::distance(scores.begin(), it_max_weight);
-      max_weight = *it_max_weight;
-    }
+  // the kernels of the rows against the support vectors, or against the coefficients of each class for liblinear
+  const int64_t kernel_count = mode_ == SVM_TYPE::SVM_SVC ? vector_count_ : class_count_;
 
-    // write top class
-    // onnx specs expects one column per class.
-    int write_additional_scores = -1;
-    if (rho_.size() == 1) {
-      if (using_strings_) {
-        write_additional_scores = _set_score_svm<std::string>(
-            Y, max_weight, maxclass, n, post_transform_, proba_,
-            weights_are_all_positive_, classlabels_strings_, "1", "0");
-      } else {
-        write_additional_scores = _set_score_svm<int64_t>(
-            Y, max_weight, maxclass, n, post_transform_, proba_,
-            weights_are_all_positive_, classlabels_ints_, 1, 0);
-      }
-    } else {  //multiclass
-      if (using_strings_) {
-        Y->template MutableData<std::string>()[n] = classlabels_strings_[maxclass];
-      } else {
-        Y->template MutableData<int64_t>()[n] = classlabels_ints_[maxclass];
-      }
-    }
+  const T* x_data = X->template Data<T>();
+  const int64_t num_blocks = (N + kRowBlockSize - 1) / kRowBlockSize;
+  const double block_cost = static_cast<double>(kRowBlockSize * kernel_count * (feature_count_ + class_count_));
 
-    write_scores(scores, post_transform_, zindex, Z, write_additional_scores);
-    zindex += scores.size();
-  }
+  concurrency::ThreadPool::TryParallelFor(
+      ctx->GetOperatorThreadPool(), static_cast<std::ptrdiff_t>(num_blocks), block_cost,
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        Scratch scratch;
+        for (int64_t begin = first * kRowBlockSize, end = std::min(N, last * kRowBlockSize); begin < end;
+             begin += kRowBlockSize) {
+          const int64_t rows = std::min(kRowBlockSize, end - begin);
+          batched_kernel_dot(x_data + begin * stride, rows, stride, kernel_vectors_, kernel_vector_norms_, kernel_count,
+                             feature_count_, get_kernel_type(), scratch.x, scratch.kernels);
+          for (int64_t r = 0; r < rows; ++r) {
+            ComputeRow(scratch.kernels.data() + r * kernel_count, begin + r, nb_columns, scratch, Y, Z);
+          }
+        }
+      });
 
   return Status::OK();
 }
@@ -3,8 +3,13 @@
 
 #pragma once
 
+#include <algorithm>
+#include <type_traits>
+
 #include "core/common/common.h"
 #include "core/framework/op_kernel.h"
+#include "core/platform/threadpool.h"
+#include "core/util/math.h"
 #include "core/util/math_cpuonly.h"
 #include "ml_common.h"
 
@@ -29,31 +34,65 @@ class SVMCommon {
   void set_kernel_type(KERNEL new_kernel_type) { kernel_type_ = new_kernel_type; }
   KERNEL get_kernel_type() const { return kernel_type_; }
 
-  float kernel_dot(const T* A, int64_t a, const std::vector<float>& B, int64_t b, int64_t len, KERNEL k) const {
-    double sum = 0;
-    const T* pA = A + a;
-    const float* pB = B.data() + b;
+  // Rows evaluated together. The kernel values of a block of rows are computed with one GEMM against the vectors.
+  static constexpr int64_t kRowBlockSize = 64;
+
+  // Kernel operands of the vector_count vectors of length len: the vectors transposed to len rows of vector_count
+  // values, and their squared norms for the RBF kernel. The GEMM runs in double precision like the dot products did,
+  // as the polynomial kernel amplifies rounding errors.
+  static void prepare_vectors(const std::vector<float>& vectors, int64_t vector_count, int64_t len,
+                              std::vector<double>& vectors_t, std::vector<double>& norms) {
+    vectors_t.resize(static_cast<size_t>(vector_count * len));
+    norms.assign(static_cast<size_t>(vector_count), 0.);
+    for (int64_t j = 0; j < vector_count; ++j) {
+      for (int64_t i = 0; i < len; ++i) {
+        const double value = vectors[j * len + i];
+        vectors_t[i * vector_count + j] = value;
+        norms[j] += value * value;
+      }
+    }
+  }
+
+  // Computes the kernel of each of the M rows of x against the vectors prepared by prepare_vectors. kernels receives
+  // M rows of vector_count values. x_buffer holds the rows converted to contiguous doubles.
+  void batched_kernel_dot(const T* x, int64_t M, int64_t stride, const std::vector<double>& vectors_t,
+                          const std::vector<double>& norms, int64_t vector_count, int64_t len, KERNEL k,
+                          std::vector<double>& x_buffer, std::vector<double>& kernels) const {
+    const size_t count = static_cast<size_t>(M * vector_count);
+    kernels.resize(count);
+
+    const double* A;
+    if (std::is_same<T, double>::value && stride == len) {
+      A = reinterpret_cast<const double*>(x);
+    } else {
+      x_buffer.resize(static_cast<size_t>(M * len));
+      for (int64_t m = 0; m < M; ++m) {
+        for (int64_t i = 0; i < len; ++i)
+          x_buffer[m * len + i] = static_cast<double>(x[m * stride + i]);
+      }
+      A = x_buffer.data();
+    }
+
+    math::MatMul<double>(static_cast<int>(M), static_cast<int>(vector_count), static_cast<int>(len), A,
+                         vectors_t.data(), kernels.data(), nullptr);
+
+    const double gamma = gamma_;
+    const double coef0 = coef0_;
+    EigenVectorArrayMap<double> values(kernels.data(), count);
     if (k == KERNEL::POLY) {
-      for (int64_t i = len; i > 0; --i, ++pA, ++pB)
-        sum += *pA * *pB;
-      sum = gamma_ * sum + coef0_;
-      sum = std::pow(sum, degree_);
+      values = (values * gamma + coef0).pow(static_cast<double>(degree_));
     } else if (k == KERNEL::SIGMOID) {
-      for (int64_t i = len; i > 0; --i, ++pA, ++pB)
-        sum += *pA * *pB;
-      sum = gamma_ * sum + coef0_;
-      sum = std::tanh(sum);
+      values = (values * gamma + coef0).tanh();
     } else if (k == KERNEL::RBF) {
-      for (int64_t i = len; i > 0; --i, ++pA, ++pB) {
-        double val = *pA - *pB;
-        sum += val * val;
+      // |a - b|^2 = |a|^2 + |b|^2 - 2 a.b, clamped as rounding can make it slightly negative for a == b
+      for (int64_t m = 0; m < M; ++m) {
+        const double a_norm = ConstEigenVectorArrayMap<double>(A + m * len, len).square().sum();
+        double* row = kernels.data() + m * vector_count;
+        for (int64_t j = 0; j < vector_count; ++j)
+          row[j] = -gamma * std::max(a_norm + norms[j] - 2 * row[j], 0.);
       }
-      sum = std::exp(-gamma_ * sum);
-    } else if (k == KERNEL::LINEAR) {
-      for (int64_t i = len; i > 0; --i, ++pA, ++pB)
-        sum += *pA * *pB;
+      values = values.exp();
     }
-    return (float)sum;
   }
 
  private:
@@ -63,9 +102,14 @@ class SVMCommon {
   float degree_;
 };
 
+template <typename T>
+constexpr int64_t SVMCommon<T>::kRowBlockSize;
+
 template <typename T>
 class SVMClassifier final : public OpKernel, private SVMCommon<T> {
-  using SVMCommon<T>::kernel_dot;
+  using SVMCommon<T>::kRowBlockSize;
+  using SVMCommon<T>::prepare_vectors;
+  using SVMCommon<T>::batched_kernel_dot;
   using SVMCommon<T>::set_kernel_type;
   using SVMCommon<T>::get_kernel_type;
 
@@ -74,6 +118,19 @@ class SVMClassifier final : public OpKernel, private SVMCommon<T> {
   Status Compute(OpKernelContext* context) const override;
 
  private:
+  // buffers reused for the rows evaluated by a thread
+  struct Scratch {
+    std::vector<double> x;
+    std::vector<double> kernels;
+    std::vector<float> scores;
+    std::vector<float> probsp2;
+    std::vector<float> estimates;
+    std::vector<int64_t> votes;
+  };
+
+  // Computes the scores of row n from its kernel values, and writes its label and scores.
+  void ComputeRow(const double* kernels, int64_t n, int64_t nb_columns, Scratch& scratch, Tensor* Y, Tensor* Z) const;
+
   bool weights_are_all_positive_;
   int64_t feature_count_;
   int64_t class_count_;
@@ -85,7 +142,9 @@ class SVMClassifier final : public OpKernel, private SVMCommon<T> {
   std::vector<float> proba_;
   std::vector<float> probb_;
   std::vector<float> coefficients_;
-  std::vector<float> support_vectors_;
+  // kernel operands of the support vectors, or of the coefficients of each class for liblinear
+  std::vector<double> kernel_vectors_;
+  std::vector<double> kernel_vector_norms_;
   std::vector<int64_t> classlabels_ints_;
   std::vector<std::string> classlabels_strings_;
   POST_EVAL_TRANSFORM post_transform_;
@@ -17,23 +17,29 @@ SVMRegressor<T>::SVMRegressor(const OpKernelInfo& info)
     : OpKernel(info),
       SVMCommon<T>(info),
       vector_count_(info.GetAttrOrDefault<int64_t>("n_supports", 0)),
-      support_vectors_(info.GetAttrsOrDefault<float>("support_vectors")),
       post_transform_(MakeTransform(info.GetAttrOrDefault<std::string>("post_transform", "NONE"))) {
   ORT_ENFORCE(info.GetAttrs<float>("rho", rho_).IsOK());
   ORT_ENFORCE(info.GetAttrs<float>("coefficients", coefficients_).IsOK());
   ORT_ENFORCE(!coefficients_.empty());
+  // only kept converted to kernel_vectors_
+  const std::vector<float> support_vectors = info.GetAttrsOrDefault<float>("support_vectors");
 
   auto onec = info.GetAttrOrDefault<int64_t>("one_class", 0);
   one_class_ = (onec != 0);
 
   if (vector_count_ > 0) {
-    feature_count_ = support_vectors_.size() / vector_count_;  //length of each support vector
+    feature_count_ = support_vectors.size() / vector_count_;  //length of each support vector
     mode_ = SVM_TYPE::SVM_SVC;
   } else {
     feature_count_ = coefficients_.size();
     mode_ = SVM_TYPE::SVM_LINEAR;
     set_kernel_type(KERNEL::LINEAR);
   }
+  if (mode_ == SVM_TYPE::SVM_SVC) {
+    prepare_vectors(support_vectors, vector_count_, feature_count_, kernel_vectors_, kernel_vector_norms_);
+  } else {
+    prepare_vectors(coefficients_, 1, feature_count_, kernel_vectors_, kernel_vector_norms_);
+  }
 }
 
 template <typename T>
@@ -44,33 +50,50 @@ Status SVMRegressor<T>::Compute(OpKernelContext* ctx) const {
   int64_t N = X->Shape().NumDimensions() == 1 ? 1 : X->Shape()[0];
 
   Tensor* Y = ctx->Output(0, TensorShape({N, 1}));  // this op outputs for one target only
+  if (stride < feature_count_)
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "The model has ", feature_count_,
+                           " features but the input only has ", stride, ".");
+
+  // the kernels of the rows against the support vectors, or the dot product with the coefficients for liblinear
+  const bool svc = mode_ == SVM_TYPE::SVM_SVC;
+  const int64_t kernel_count = svc ? vector_count_ : 1;
+
   const auto* x_data = X->template Data<T>();
+  float* y_data = Y->template MutableData<float>();
+  const int64_t num_blocks = (N + kRowBlockSize - 1) / kRowBlockSize;
+  const double block_cost = static_cast<double>(kRowBlockSize * kernel_count * (feature_count_ + 1));
 
-  for (int64_t n = 0; n < N; n++) {  //for each example
-    int64_t current_weight_0 = n * stride;
-    std::vector<float> scores;
-
-    float sum = 0.f;
-    if (mode_ == SVM_TYPE::SVM_SVC) {
-      for (int64_t j = 0; j < vector_count_; j++) {
-        float val1 = kernel_dot(x_data, current_weight_0, support_vectors_, feature_count_ * j, feature_count_, get_kernel_type());
-        float val2 = coefficients_[j];
-        float val3 = val1 * val2;
-        sum += val3;
-      }
-      sum += rho_[0];
-    } else if (mode_ == SVM_TYPE::SVM_LINEAR) {  //liblinear
-      sum = kernel_dot(x_data, current_weight_0, coefficients_, 0, feature_count_, get_kernel_type());
-      sum += rho_[0];
-    }
-    if (one_class_ && sum > 0) {
-      Y->template MutableData<float>()[n] = 1.f;
-    } else if (one_class_) {
-      Y->template MutableData<float>()[n] = -1.f;
-    } else {
-      Y->template MutableData<float>()[n] = sum;
-    }
-  }
+  concurrency::ThreadPool::TryParallelFor(
+      ctx->GetOperatorThreadPool(), static_cast<std::ptrdiff_t>(num_blocks), block_cost,
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        std::vector<double> x_buffer;
+        std::vector<double> kernels;
+        for (int64_t begin = first * kRowBlockSize, end = std::min(N, last * kRowBlockSize); begin < end;
+             begin += kRowBlockSize) {
+          const int64_t rows = std::min(kRowBlockSize, end - begin);
+          batched_kernel_dot(x_data + begin * stride, rows, stride, kernel_vectors_, kernel_vector_norms_, kernel_count,
+                             feature_count_, get_kernel_type(), x_buffer, kernels);
+
+          for (int64_t r = 0; r < rows; ++r) {  //for each example
+            const double* row_kernels = kernels.data() + r * kernel_count;
+            float sum = 0.f;
+            if (svc) {
+              for (int64_t j = 0; j < vector_count_; j++) {
+                sum += static_cast<float>(row_kernels[j]) * coefficients_[j];
+              }
+            } else {  //liblinear
+              sum = static_cast<float>(row_kernels[0]);
+            }
+            sum += rho_[0];
+
+            if (one_class_) {
+              y_data[begin + r] = sum > 0 ? 1.f : -1.f;
+            } else {
+              y_data[begin + r] = sum;
+            }
+          }
+        }
+      });
 
   return Status::OK();
 }
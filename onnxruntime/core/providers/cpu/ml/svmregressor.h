@@ -14,7 +14,9 @@ namespace ml {
 
 template <typename T>
 class SVMRegressor final : public OpKernel, private SVMCommon<T> {
-  using SVMCommon<T>::kernel_dot;
+  using SVMCommon<T>::kRowBlockSize;
+  using SVMCommon<T>::prepare_vectors;
+  using SVMCommon<T>::batched_kernel_dot;
   using SVMCommon<T>::set_kernel_type;
   using SVMCommon<T>::get_kernel_type;
 
@@ -28,7 +30,9 @@ class SVMRegressor final : public OpKernel, private SVMCommon<T> {
   int64_t vector_count_;
   std::vector<float> rho_;
   std::vector<float> coefficients_;
-  std::vector<float> support_vectors_;
+  // kernel operands of the support vectors, or of the coefficients for liblinear
+  std::vector<double> kernel_vectors_;
+  std::vector<double> kernel_vector_norms_;
   POST_EVAL_TRANSFORM post_transform_;
   SVM_TYPE mode_;  //how are we computing SVM? 0=LibSVC, 1=LibLinear
 };
@@ -138,160 +138,28 @@ ADD_IN_TYPE_TREE_ENSEMBLE_CLASSIFIER_OP(int32_t);
 template <typename T>
 TreeEnsembleClassifier<T>::TreeEnsembleClassifier(const OpKernelInfo& info)
     : OpKernel(info),
-      nodes_treeids_(info.GetAttrsOrDefault<int64_t>("nodes_treeids")),
-      nodes_nodeids_(info.GetAttrsOrDefault<int64_t>("nodes_nodeids")),
-      nodes_featureids_(info.GetAttrsOrDefault<int64_t>("nodes_featureids")),
-      nodes_values_(info.GetAttrsOrDefault<float>("nodes_values")),
-      nodes_hitrates_(info.GetAttrsOrDefault<float>("nodes_hitrates")),
-      nodes_modes_names_(info.GetAttrsOrDefault<std::string>("nodes_modes")),
-      nodes_truenodeids_(info.GetAttrsOrDefault<int64_t>("nodes_truenodeids")),
-      nodes_falsenodeids_(info.GetAttrsOrDefault<int64_t>("nodes_falsenodeids")),
-      missing_tracks_true_(info.GetAttrsOrDefault<int64_t>("nodes_missing_value_tracks_true")),
-      class_nodeids_(info.GetAttrsOrDefault<int64_t>("class_nodeids")),
-      class_treeids_(info.GetAttrsOrDefault<int64_t>("class_treeids")),
-      class_ids_(info.GetAttrsOrDefault<int64_t>("class_ids")),
-      class_weights_(info.GetAttrsOrDefault<float>("class_weights")),
       base_values_(info.GetAttrsOrDefault<float>("base_values")),
       classlabels_strings_(info.GetAttrsOrDefault<std::string>("classlabels_strings")),
       classlabels_int64s_(info.GetAttrsOrDefault<int64_t>("classlabels_int64s")),
-      post_transform_(MakeTransform(info.GetAttrOrDefault<std::string>("post_transform", "NONE"))) {
-  ORT_ENFORCE(!nodes_treeids_.empty());
-  ORT_ENFORCE(class_nodeids_.size() == class_ids_.size());
-  ORT_ENFORCE(class_nodeids_.size() == class_weights_.size());
-  ORT_ENFORCE(nodes_nodeids_.size() == nodes_featureids_.size());
-  ORT_ENFORCE(nodes_nodeids_.size() == nodes_modes_names_.size());
-  ORT_ENFORCE(nodes_nodeids_.size() == nodes_values_.size());
-  ORT_ENFORCE(nodes_nodeids_.size() == nodes_truenodeids_.size());
-  ORT_ENFORCE(nodes_nodeids_.size() == nodes_falsenodeids_.size());
-  ORT_ENFORCE((nodes_nodeids_.size() == nodes_hitrates_.size()) || (nodes_hitrates_.empty()));
-
+      using_strings_(!classlabels_strings_.empty()),
+      class_count_(using_strings_ ? classlabels_strings_.size() : classlabels_int64s_.size()),
+      post_transform_(MakeTransform(info.GetAttrOrDefault<std::string>("post_transform", "NONE"))),
+      evaluator_(info, "class", std::max(class_count_, static_cast<int64_t>(base_values_.size()))) {
   ORT_ENFORCE(classlabels_strings_.empty() ^ classlabels_int64s_.empty(),
               "Must provide classlabels_strings or classlabels_int64s but not both.");
 
-  // in the absence of bool type supported by GetAttrs this ensure that we don't have any negative
-  // values so that we can check for the truth condition without worrying about negative values.
-  ORT_ENFORCE(std::all_of(
-      std::begin(missing_tracks_true_),
-      std::end(missing_tracks_true_), [](int64_t elem) { return elem >= 0; }));
-
-  Initialize();
-}
-
-template <typename T>
-void TreeEnsembleClassifier<T>::Initialize() {
-  int64_t current_tree_id = 1234567891L;
-  std::vector<int64_t> tree_offsets;
-  weights_are_all_positive_ = true;
-
-  for (int64_t i = 0, size_node_treeids = static_cast<int64_t>(nodes_treeids_.size());
-       i < size_node_treeids;
-       ++i) {
-    if (nodes_treeids_[i] != current_tree_id) {
-      tree_offsets.push_back(nodes_nodeids_[i]);
-      current_tree_id = nodes_treeids_[i];
-    }
-    int64_t offset = tree_offsets[tree_offsets.size() - 1];
-    nodes_nodeids_[i] = nodes_nodeids_[i] - offset;
-    if (nodes_falsenodeids_[i] >= 0) {
-      nodes_falsenodeids_[i] = nodes_falsenodeids_[i] - offset;
-    }
-    if (nodes_truenodeids_[i] >= 0) {
-      nodes_truenodeids_[i] = nodes_truenodeids_[i] - offset;
-    }
-  }
-  for (int64_t i = 0, size_class_nodeids = static_cast<int64_t>(class_nodeids_.size());
-       i < size_class_nodeids;
-       ++i) {
-    int64_t offset = tree_offsets[class_treeids_[i]];
-    class_nodeids_[i] = class_nodeids_[i] - offset;
-    if (class_weights_[i] < 0) {
-      weights_are_all_positive_ = false;
-    }
-  }
-
-  nodes_modes_.reserve(nodes_modes_names_.size());
-  for (size_t i = 0, end = nodes_modes_names_.size(); i < end; ++i) {
-    nodes_modes_.push_back(MakeTreeNodeMode(nodes_modes_names_[i]));
-  }
-
-  // leafnode data, these are the votes that leaves do
-  using LeafNodeData = std::tuple<int64_t, int64_t, int64_t, float>;
-  for (size_t i = 0, end = class_nodeids_.size(); i < end; ++i) {
-    leafnodedata_.push_back(std::make_tuple(class_treeids_[i], class_nodeids_[i], class_ids_[i], class_weights_[i]));
-    weights_classes_.insert(class_ids_[i]);
-  }
-  std::sort(std::begin(leafnodedata_), std::end(leafnodedata_), [](LeafNodeData const& t1, LeafNodeData const& t2) {
-    if (std::get<0>(t1) != std::get<0>(t2))
-      return std::get<0>(t1) < std::get<0>(t2);
-
-    return std::get<1>(t1) < std::get<1>(t2);
-  });
-  // make an index so we can find the leafnode data quickly when evaluating
-  int64_t field0 = -1;
-  int64_t field1 = -1;
-  for (size_t i = 0, end = leafnodedata_.size(); i < end; ++i) {
-    int64_t id0 = std::get<0>(leafnodedata_[i]);
-    int64_t id1 = std::get<1>(leafnodedata_[i]);
-    if (id0 != field0 || id1 != field1) {
-      int64_t id = id0 * kOffset_ + id1;
-      auto position = static_cast<int64_t>(i);
-      auto p3 = std::make_pair(id, position);
-      leafdata_map_.insert(p3);
-      field0 = id;
-      field1 = position;
-    }
-  }
+  const auto class_ids = info.GetAttrsOrDefault<int64_t>("class_ids");
+  const auto class_weights = info.GetAttrsOrDefault<float>("class_weights");
+  weights_classes_.insert(class_ids.cbegin(), class_ids.cend());
+  weights_are_all_positive_ = std::none_of(class_weights.cbegin(), class_weights.cend(),
+                                           [](float weight) { return weight < 0; });
 
-  // treenode ids, some are roots_, and roots_ have no parents
-  std::unordered_map<int64_t, int64_t> parents;  // holds count of all who point to you
-  std::unordered_map<int64_t, int64_t> indices;
-  // add all the nodes to a map, and the ones that have parents are not roots_
-  std::unordered_map<int64_t, int64_t>::iterator it;
-  for (size_t i = 0, end = nodes_treeids_.size(); i < end; ++i) {
-    // make an index to look up later
-    int64_t id = nodes_treeids_[i] * kOffset_ + nodes_nodeids_[i];
-    auto position = static_cast<int64_t>(i);
-    auto p3 = std::make_pair(id, position);
-    indices.insert(p3);
-    it = parents.find(id);
-    if (it == parents.end()) {
-      // start counter at 0
-      auto b = (int64_t)0L;
-      auto p1 = std::make_pair(id, b);
-      parents.insert(p1);
-    }
-  }
-  // all true nodes arent roots_
-  for (size_t i = 0, end = nodes_truenodeids_.size(); i < end; ++i) {
-    if (nodes_modes_[i] == NODE_MODE::LEAF) continue;
-    // they must be in the same tree
-    int64_t id = nodes_treeids_[i] * kOffset_ + nodes_truenodeids_[i];
-    it = parents.find(id);
-    ORT_ENFORCE(it != parents.end());
-    it->second++;
-  }
-  // all false nodes arent roots_
-  for (size_t i = 0, end = nodes_falsenodeids_.size(); i < end; ++i) {
-    if (nodes_modes_[i] == NODE_MODE::LEAF) continue;
-    // they must be in the same tree
-    int64_t id = nodes_treeids_[i] * kOffset_ + nodes_falsenodeids_[i];
-    it = parents.find(id);
-    ORT_ENFORCE(it != parents.end());
-    it->second++;
-  }
-  // find all the nodes that dont have other nodes pointing at them
-  for (auto& parent : parents) {
-    if (parent.second == 0) {
-      int64_t id = parent.first;
-      it = indices.find(id);
-      roots_.push_back(it->second);
-    }
-  }
-  class_count_ = !classlabels_strings_.empty() ? classlabels_strings_.size() : classlabels_int64s_.size();
-  using_strings_ = !classlabels_strings_.empty();
   ORT_ENFORCE(base_values_.empty() ||
               base_values_.size() == static_cast<size_t>(class_count_) ||
               base_values_.size() == weights_classes_.size());
+  // the top class is an index into the labels
+  ORT_ENFORCE(class_count_ <= 2 || evaluator_.NumTargets() <= class_count_,
+              "class_ids must be less than the number of class labels.");
 }
 
 template <typename T>
@@ -308,36 +176,44 @@ common::Status TreeEnsembleClassifier<T>::Compute(OpKernelContext* context) cons
   Tensor* Y = context->Output(0, TensorShape({N}));
   auto* Z = context->Output(1, TensorShape({N, class_count_}));
 
-  int64_t zindex = 0;
   const T* x_data = X.template Data<T>();
+  std::vector<TreeScore> tree_scores;
+  ORT_RETURN_IF_ERROR(evaluator_.ComputeScores(context->GetOperatorThreadPool(), x_data, N, stride, tree_scores));
+
+  const int64_t num_targets = evaluator_.NumTargets();
+  const int64_t num_base_values = static_cast<int64_t>(base_values_.size());
+  int64_t zindex = 0;
 
-  // for each class
+  // a class has a score if it has a base value or a leaf voted for it
+  std::vector<float> class_scores(num_targets);
+  std::vector<bool> has_class(num_targets);
   std::vector<float> scores;
   scores.reserve(class_count_);
   for (int64_t i = 0; i < N; ++i) {
     scores.clear();
-    int64_t current_weight_0 = i * stride;
-    std::map<int64_t, float> classes;
-    // fill in base values, this might be empty but that is ok
-    for (int64_t k = 0, end = static_cast<int64_t>(base_values_.size()); k < end; ++k) {
-      auto p1 = std::make_pair<int64_t&, const float&>(k, base_values_[k]);
-      classes.insert(p1);
-    }
-    // walk each tree from its root
-    for (size_t j = 0, end = roots_.size(); j < end; ++j) {
-      ORT_RETURN_IF_ERROR(ProcessTreeNode(classes, roots_[j], x_data, current_weight_0));
+    const TreeScore* row_scores = tree_scores.data() + i * num_targets;
+    bool has_classes = false;
+    for (int64_t k = 0; k < num_targets; ++k) {
+      class_scores[k] = (k < num_base_values ? base_values_[k] : 0.f) + row_scores[k].sum;
+      has_class[k] = k < num_base_values || row_scores[k].has_score;
+      has_classes = has_classes || has_class[k];
     }
+
     float maxweight = 0.f;
     int64_t maxclass = -1;
     // write top class
     int write_additional_scores = -1;
     if (class_count_ > 2) {
-      for (auto& classe : classes) {
-        if (maxclass == -1 || classe.second > maxweight) {
-          maxclass = classe.first;
-          maxweight = classe.second;
+      for (int64_t k = 0; k < num_targets; ++k) {
+        if (has_class[k] && (maxclass == -1 || class_scores[k] > maxweight)) {
+          maxclass = k;
+          maxweight = class_scores[k];
         }
       }
+      // no class has a score, which is only possible without base values
+      if (maxclass == -1) {
+        maxclass = 0;
+      }
       if (using_strings_) {
         Y->template MutableData<std::string>()[i] = classlabels_strings_[maxclass];
       } else {
@@ -345,7 +221,11 @@ common::Status TreeEnsembleClassifier<T>::Compute(OpKernelContext* context) cons
       }
     } else  // binary case
     {
-      maxweight = !classes.empty() ? classes[0] : 0.f;  // only 1 class
+      // only 1 class. once any class has a score, class 0 has one too.
+      if (has_classes) {
+        maxweight = class_scores[0];
+        has_class[0] = true;
+      }
       if (using_strings_) {
         auto* y_data = Y->template MutableData<std::string>();
         if (classlabels_strings_.size() == 2 &&
@@ -413,16 +293,13 @@ common::Status TreeEnsembleClassifier<T>::Compute(OpKernelContext* context) cons
     // for example a 10 class case where we only found 2 classes in the leaves
     if (weights_classes_.size() == static_cast<size_t>(class_count_)) {
       for (int64_t k = 0; k < class_count_; ++k) {
-        auto it_classes = classes.find(k);
-        if (it_classes != classes.end()) {
-          scores.push_back(it_classes->second);
-        } else {
-          scores.push_back(0.f);
-        }
+        scores.push_back(class_scores[k]);
       }
     } else {
-      for (auto& classe : classes) {
-        scores.push_back(classe.second);
+      for (int64_t k = 0; k < num_targets; ++k) {
+        if (has_class[k]) {
+          scores.push_back(class_scores[k]);
+        }
       }
     }
     write_scores(scores, post_transform_, zindex, Z, write_additional_scores);
@@ -431,84 +308,5 @@ common::Status TreeEnsembleClassifier<T>::Compute(OpKernelContext* context) cons
   return Status::OK();
 }
 
-template <typename T>
-common::Status TreeEnsembleClassifier<T>::ProcessTreeNode(std::map<int64_t, float>& classes,
-                                                          int64_t treeindex,
-                                                          const T* x_data,
-                                                          int64_t feature_base) const {
-  // walk down tree to the leaf
-  auto mode = static_cast<NODE_MODE>(nodes_modes_[treeindex]);
-  int64_t loopcount = 0;
-  int64_t root = treeindex;
-  while (mode != NODE_MODE::LEAF) {
-    T val = x_data[feature_base + nodes_featureids_[treeindex]];
-    bool tracktrue = true;
-    if (missing_tracks_true_.size() != nodes_truenodeids_.size()) {
-      tracktrue = false;
-    } else {
-      tracktrue = missing_tracks_true_[treeindex] && std::isnan(static_cast<float>(val));
-    }
-    float threshold = nodes_values_[treeindex];
-    switch (mode) {
-      case NODE_MODE::BRANCH_LEQ:
-        treeindex = val <= threshold || tracktrue ? nodes_truenodeids_[treeindex] : nodes_falsenodeids_[treeindex];
-        break;
-      case NODE_MODE::BRANCH_LT:
-        treeindex = val < threshold || tracktrue ? nodes_truenodeids_[treeindex] : nodes_falsenodeids_[treeindex];
-        break;
-      case NODE_MODE::BRANCH_GTE:
-        treeindex = val >= threshold || tracktrue ? nodes_truenodeids_[treeindex] : nodes_falsenodeids_[treeindex];
-        break;
-      case NODE_MODE::BRANCH_GT:
-        treeindex = val > threshold || tracktrue ? nodes_truenodeids_[treeindex] : nodes_falsenodeids_[treeindex];
-        break;
-      case NODE_MODE::BRANCH_EQ:
-        treeindex = val == threshold || tracktrue ? nodes_truenodeids_[treeindex] : nodes_falsenodeids_[treeindex];
-        break;
-      case NODE_MODE::BRANCH_NEQ:
-        treeindex = val != threshold || tracktrue ? nodes_truenodeids_[treeindex] : nodes_falsenodeids_[treeindex];
-        break;
-      default: {
-        std::ostringstream err_msg;
-        err_msg << "Invalid mode of value: " << static_cast<std::underlying_type<NODE_MODE>::type>(mode);
-        return Status(ONNXRUNTIME, INVALID_ARGUMENT, err_msg.str());
-      }
-    }
-    ORT_ENFORCE(treeindex >= 0);
-    treeindex = treeindex + root;
-    mode = static_cast<NODE_MODE>(nodes_modes_[treeindex]);
-    loopcount++;
-    if (loopcount > kMaxTreeDepth_) break;
-  }
-  // should be at leaf
-  int64_t id = nodes_treeids_[treeindex] * kOffset_ + nodes_nodeids_[treeindex];
-  auto it_lp = leafdata_map_.find(id);
-  if (it_lp == leafdata_map_.end()) {  // if not found, simply return
-    return Status::OK();
-  }
-  int64_t index = it_lp->second;
-  int64_t treeid = std::get<0>(leafnodedata_[index]);
-  int64_t nodeid = std::get<1>(leafnodedata_[index]);
-  while (treeid == nodes_treeids_[treeindex] && nodeid == nodes_nodeids_[treeindex]) {
-    int64_t classid = std::get<2>(leafnodedata_[index]);
-    float weight = std::get<3>(leafnodedata_[index]);
-    std::map<int64_t, float>::iterator it_classes;
-    it_classes = classes.find(classid);
-    if (it_classes != classes.end()) {
-      it_classes->second += weight;
-    } else {
-      auto p1 = std::make_pair(classid, weight);
-      classes.insert(p1);
-    }
-    ++index;
-    // some tree node will be last
-    if (index >= static_cast<int64_t>(leafnodedata_.size())) {
-      break;
-    }
-    treeid = std::get<0>(leafnodedata_[index]);
-    nodeid = std::get<1>(leafnodedata_[index]);
-  }
-  return Status::OK();
-}
 }  // namespace ml
 }  // namespace onnxruntime
@@ -0,0 +1,220 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/cpu/ml/tree_ensemble_evaluator.h"
+
+#include <limits>
+#include <map>
+
+namespace onnxruntime {
+namespace ml {
+
+constexpr int64_t TreeEnsembleEvaluator::kRowBlockSize;
+
+namespace {
+
+// rough number of cycles to visit a node, dominated by the load of the node and of the feature it tests
+constexpr double kCostPerNode = 10.0;
+
+using TreeNodeId = std::pair<int64_t, int64_t>;  // tree id, node id
+
+}  // namespace
+
+TreeEnsembleEvaluator::TreeEnsembleEvaluator(const OpKernelInfo& info, const std::string& weights_prefix,
+                                             int64_t num_targets)
+    : num_targets_(num_targets) {
+  const auto nodes_treeids = info.GetAttrsOrDefault<int64_t>("nodes_treeids");
+  const auto nodes_nodeids = info.GetAttrsOrDefault<int64_t>("nodes_nodeids");
+  const auto nodes_featureids = info.GetAttrsOrDefault<int64_t>("nodes_featureids");
+  const auto nodes_values = info.GetAttrsOrDefault<float>("nodes_values");
+  const auto nodes_hitrates = info.GetAttrsOrDefault<float>("nodes_hitrates");
+  const auto nodes_modes_names = info.GetAttrsOrDefault<std::string>("nodes_modes");
+  const auto nodes_truenodeids = info.GetAttrsOrDefault<int64_t>("nodes_truenodeids");
+  const auto nodes_falsenodeids = info.GetAttrsOrDefault<int64_t>("nodes_falsenodeids");
+  const auto missing_tracks_true = info.GetAttrsOrDefault<int64_t>("nodes_missing_value_tracks_true");
+  const auto weights_treeids = info.GetAttrsOrDefault<int64_t>(weights_prefix + "_treeids");
+  const auto weights_nodeids = info.GetAttrsOrDefault<int64_t>(weights_prefix + "_nodeids");
+  const auto weights_ids = info.GetAttrsOrDefault<int64_t>(weights_prefix + "_ids");
+  const auto weights_values = info.GetAttrsOrDefault<float>(weights_prefix + "_weights");
+
+  const size_t num_nodes = nodes_treeids.size();
+  ORT_ENFORCE(num_nodes > 0);
+  ORT_ENFORCE(num_nodes == nodes_nodeids.size());
+  ORT_ENFORCE(num_nodes == nodes_featureids.size());
+  ORT_ENFORCE(num_nodes == nodes_values.size());
+  ORT_ENFORCE(num_nodes == nodes_modes_names.size());
+  ORT_ENFORCE(num_nodes == nodes_truenodeids.size());
+  ORT_ENFORCE(num_nodes == nodes_falsenodeids.size());
+  ORT_ENFORCE((num_nodes == nodes_hitrates.size()) || (nodes_hitrates.empty()));
+  ORT_ENFORCE(weights_nodeids.size() == weights_treeids.size());
+  ORT_ENFORCE(weights_nodeids.size() == weights_ids.size());
+  ORT_ENFORCE(weights_nodeids.size() == weights_values.size());
+  ORT_ENFORCE(num_nodes < static_cast<size_t>(std::numeric_limits<int32_t>::max()) &&
+              weights_values.size() < static_cast<size_t>(std::numeric_limits<int32_t>::max()));
+
+  // missing values are only tracked if there is a flag for every node. in the absence of bool type supported by
+  // GetAttrs this ensure that we don't have any negative values so that we can check for the truth condition
+  // without worrying about negative values.
+  const bool use_missing_tracks = missing_tracks_true.size() == num_nodes;
+  ORT_ENFORCE(std::all_of(missing_tracks_true.cbegin(), missing_tracks_true.cend(),
+                          [](int64_t elem) { return elem >= 0; }));
+
+  std::vector<NODE_MODE> modes;
+  modes.reserve(num_nodes);
+  for (const auto& name : nodes_modes_names) {
+    modes.push_back(MakeTreeNodeMode(name));
+  }
+
+  // node ids are only unique within a tree. the first node with a given id is the one that is used.
+  std::map<TreeNodeId, size_t> indices;
+  for (size_t i = 0; i < num_nodes; ++i) {
+    indices.emplace(TreeNodeId{nodes_treeids[i], nodes_nodeids[i]}, i);
+  }
+
+  const auto find_child = [&](size_t i, int64_t child_id) {
+    auto it = indices.find(TreeNodeId{nodes_treeids[i], child_id});
+    ORT_ENFORCE(it != indices.end(), "Node ", nodes_nodeids[i], " of tree ", nodes_treeids[i],
+                " refers to the missing node ", child_id, ".");
+    return it->second;
+  };
+
+  // the roots are the nodes that no other node points to
+  std::vector<bool> has_parent(num_nodes, false);
+  for (size_t i = 0; i < num_nodes; ++i) {
+    if (modes[i] != NODE_MODE::LEAF) {
+      has_parent[find_child(i, nodes_truenodeids[i])] = true;
+      has_parent[find_child(i, nodes_falsenodeids[i])] = true;
+    }
+  }
+
+  // pack each tree in breadth first order
+  std::vector<int32_t> packed_index(num_nodes, -1);
+  std::vector<size_t> packed_source;
+  packed_source.reserve(num_nodes);
+  for (size_t i = 0; i < num_nodes; ++i) {
+    if (has_parent[i] || indices[TreeNodeId{nodes_treeids[i], nodes_nodeids[i]}] != i) {
+      continue;
+    }
+
+    roots_.push_back(static_cast<int32_t>(packed_source.size()));
+    packed_index[i] = static_cast<int32_t>(packed_source.size());
+    packed_source.push_back(i);
+
+    for (size_t next = roots_.back(); next < packed_source.size(); ++next) {
+      const size_t source = packed_source[next];
+      if (modes[source] == NODE_MODE::LEAF) {
+        continue;
+      }
+
+      for (int64_t child_id : {nodes_truenodeids[source], nodes_falsenodeids[source]}) {
+        const size_t child = find_child(source, child_id);
+        if (packed_index[child] < 0) {
+          packed_index[child] = static_cast<int32_t>(packed_source.size());
+          packed_source.push_back(child);
+        }
+      }
+    }
+  }
+
+  bool has_branch = false;
+  nodes_.reserve(packed_source.size());
+  for (size_t source : packed_source) {
+    TreeNodeElement node;
+    node.feature_id = 0;
+    node.value = nodes_values[source];
+    node.truenode = 0;
+    node.falsenode = 0;
+    node.mode = modes[source];
+    node.missing_tracks_true = use_missing_tracks && missing_tracks_true[source] != 0;
+
+    if (node.mode != NODE_MODE::LEAF) {
+      const int64_t feature_id = nodes_featureids[source];
+      ORT_ENFORCE(feature_id >= 0 && feature_id <= std::numeric_limits<int32_t>::max(),
+                  "Invalid feature id ", feature_id, " for node ", nodes_nodeids[source], " of tree ",
+                  nodes_treeids[source], ".");
+      node.feature_id = static_cast<int32_t>(feature_id);
+      node.truenode = packed_index[find_child(source, nodes_truenodeids[source])];
+      node.falsenode = packed_index[find_child(source, nodes_falsenodeids[source])];
+      max_feature_id_ = std::max(max_feature_id_, feature_id);
+
+      if (!has_branch) {
+        branch_mode_ = node.mode;
+        has_branch = true;
+      } else if (node.mode != branch_mode_) {
+        same_mode_ = false;
+      }
+
+      if (node.missing_tracks_true) {
+        same_mode_ = false;
+      }
+    }
+
+    nodes_.push_back(node);
+  }
+
+  ORT_ENFORCE(!roots_.empty(), "The trees have no root node.");
+
+  // check that the trees have no cycles, so walking them always ends at a leaf, and measure their depth
+  std::vector<int32_t> depths(nodes_.size(), 0);
+  std::vector<std::pair<int32_t, bool>> stack;  // node, whether its children were pushed
+  size_t total_depth = 0;
+  for (int32_t root : roots_) {
+    stack.emplace_back(root, false);
+    while (!stack.empty()) {
+      const int32_t index = stack.back().first;
+      const TreeNodeElement& node = nodes_[index];
+      if (!stack.back().second) {
+        if (depths[index] > 0) {
+          stack.pop_back();
+          continue;
+        }
+
+        // a node that is still being visited is an ancestor of itself
+        ORT_ENFORCE(depths[index] == 0, "Node ", nodes_nodeids[packed_source[index]], " of tree ",
+                    nodes_treeids[packed_source[index]], " is part of a cycle.");
+        depths[index] = -1;
+        stack.back().second = true;
+        if (node.mode != NODE_MODE::LEAF) {
+          stack.emplace_back(node.truenode, false);
+          stack.emplace_back(node.falsenode, false);
+        }
+      } else {
+        depths[index] = node.mode == NODE_MODE::LEAF
+                            ? 1
+                            : 1 + std::max(depths[node.truenode], depths[node.falsenode]);
+        stack.pop_back();
+      }
+    }
+
+    total_depth += static_cast<size_t>(depths[root]);
+  }
+
+  tree_cost_ = kCostPerNode * static_cast<double>(total_depth) / static_cast<double>(roots_.size());
+
+  // group the weights by leaf. weights of nodes that are not leaves are never used.
+  std::vector<std::vector<TreeLeafWeight>> leaf_weights(nodes_.size());
+  for (size_t i = 0, end = weights_nodeids.size(); i < end; ++i) {
+    ORT_ENFORCE(weights_ids[i] >= 0, "Invalid ", weights_prefix, " id ", weights_ids[i], ".");
+    num_targets_ = std::max(num_targets_, weights_ids[i] + 1);
+
+    auto it = indices.find(TreeNodeId{weights_treeids[i], weights_nodeids[i]});
+    if (it == indices.end() || packed_index[it->second] < 0 ||
+        nodes_[packed_index[it->second]].mode != NODE_MODE::LEAF) {
+      continue;
+    }
+
+    leaf_weights[packed_index[it->second]].push_back(TreeLeafWeight{weights_ids[i], weights_values[i]});
+  }
+
+  weights_.reserve(weights_values.size());
+  for (size_t i = 0, end = nodes_.size(); i < end; ++i) {
+    if (nodes_[i].mode == NODE_MODE::LEAF) {
+      nodes_[i].truenode = static_cast<int32_t>(weights_.size());
+      weights_.insert(weights_.end(), leaf_weights[i].cbegin(), leaf_weights[i].cend());
+      nodes_[i].falsenode = static_cast<int32_t>(weights_.size());
+    }
+  }
+}
+
+}  // namespace ml
+}  // namespace onnxruntime
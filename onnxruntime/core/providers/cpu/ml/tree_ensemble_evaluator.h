@@ -0,0 +1,251 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+
+#include "core/common/common.h"
+#include "core/framework/op_kernel.h"
+#include "core/platform/threadpool.h"
+#include "ml_common.h"
+
+namespace onnxruntime {
+namespace ml {
+
+// A node of a tree ensemble. The nodes of each tree are stored contiguously in breadth first order, so the
+// top levels of a tree, which are visited for every row, share a few cache lines.
+struct TreeNodeElement {
+  int32_t feature_id;
+  float value;
+  // indices of the children in the node array. for leaves, the [begin, end) range of the leaf's weights.
+  int32_t truenode;
+  int32_t falsenode;
+  NODE_MODE mode;
+  bool missing_tracks_true;
+};
+
+struct TreeLeafWeight {
+  int64_t target_id;
+  float weight;
+};
+
+// Accumulated leaf weights of one target (or class) for one row.
+struct TreeScore {
+  float sum;
+  float min;
+  float max;
+  bool has_score;
+};
+
+// Evaluates the trees of TreeEnsembleClassifier and TreeEnsembleRegressor.
+//
+// The node attributes are packed into an array of TreeNodeElement when the kernel is created. Rows are
+// evaluated in blocks against one tree at a time so the tree stays in cache, and the work is split across the
+// intra-op thread pool by rows, or by trees when there are too few rows to keep the threads busy.
+class TreeEnsembleEvaluator {
+ public:
+  // weights_prefix is "class" or "target", the prefix of the attributes holding the leaf weights.
+  // num_targets is the minimum number of targets. It is increased if the leaves have weights for larger ids.
+  TreeEnsembleEvaluator(const OpKernelInfo& info, const std::string& weights_prefix, int64_t num_targets);
+
+  size_t NumTrees() const { return roots_.size(); }
+  int64_t NumTargets() const { return num_targets_; }
+
+  // Evaluate all the trees for the N rows of x_data. scores is resized to N * NumTargets() and receives the
+  // aggregated leaf weights of each row.
+  template <typename T>
+  common::Status ComputeScores(concurrency::ThreadPool* tp, const T* x_data, int64_t N, int64_t stride,
+                               std::vector<TreeScore>& scores) const;
+
+ private:
+  // Number of rows evaluated against a tree before moving to the next one.
+  static constexpr int64_t kRowBlockSize = 64;
+
+  template <typename T>
+  const TreeNodeElement* ProcessTreeNodeLeave(const TreeNodeElement* root, const T* x_data) const;
+
+  template <typename T>
+  void ProcessRows(const T* x_data, int64_t stride, int64_t first_row, int64_t last_row,
+                   size_t first_tree, size_t last_tree, TreeScore* scores) const;
+
+  void AddLeafWeights(const TreeNodeElement& leaf, TreeScore* scores) const {
+    for (int32_t i = leaf.truenode; i < leaf.falsenode; ++i) {
+      const TreeLeafWeight& w = weights_[i];
+      TreeScore& score = scores[w.target_id];
+      if (score.has_score) {
+        score.sum += w.weight;
+        score.min = std::min(score.min, w.weight);
+        score.max = std::max(score.max, w.weight);
+      } else {
+        score = TreeScore{w.weight, w.weight, w.weight, true};
+      }
+    }
+  }
+
+  static void MergeScore(TreeScore& score, const TreeScore& other) {
+    if (!other.has_score) {
+      return;
+    }
+
+    if (score.has_score) {
+      score.sum += other.sum;
+      score.min = std::min(score.min, other.min);
+      score.max = std::max(score.max, other.max);
+    } else {
+      score = other;
+    }
+  }
+
+  std::vector<TreeNodeElement> nodes_;
+  std::vector<TreeLeafWeight> weights_;
+  std::vector<int32_t> roots_;
+  int64_t num_targets_;
+  int64_t max_feature_id_ = -1;
+  // cost estimate of evaluating one tree for one row, in cycles
+  double tree_cost_ = 0.0;
+  // set if every branch uses the same mode and no branch tracks missing values, which allows the mode to be
+  // dispatched once per tree instead of once per node.
+  bool same_mode_ = true;
+  NODE_MODE branch_mode_ = NODE_MODE::BRANCH_LEQ;
+};
+
+namespace detail {
+
+template <typename T, typename Compare>
+inline const TreeNodeElement* FindLeaf(const TreeNodeElement* nodes, const TreeNodeElement* node,
+                                       const T* x_data, Compare compare) {
+  while (node->mode != NODE_MODE::LEAF) {
+    node = nodes + (compare(x_data[node->feature_id], node->value) ? node->truenode : node->falsenode);
+  }
+  return node;
+}
+
+}  // namespace detail
+
+template <typename T>
+const TreeNodeElement* TreeEnsembleEvaluator::ProcessTreeNodeLeave(const TreeNodeElement* root,
+                                                                   const T* x_data) const {
+  const TreeNodeElement* nodes = nodes_.data();
+
+  if (same_mode_) {
+    switch (branch_mode_) {
+      case NODE_MODE::BRANCH_LEQ:
+        return detail::FindLeaf(nodes, root, x_data, [](T val, float threshold) { return val <= threshold; });
+      case NODE_MODE::BRANCH_LT:
+        return detail::FindLeaf(nodes, root, x_data, [](T val, float threshold) { return val < threshold; });
+      case NODE_MODE::BRANCH_GTE:
+        return detail::FindLeaf(nodes, root, x_data, [](T val, float threshold) { return val >= threshold; });
+      case NODE_MODE::BRANCH_GT:
+        return detail::FindLeaf(nodes, root, x_data, [](T val, float threshold) { return val > threshold; });
+      case NODE_MODE::BRANCH_EQ:
+        return detail::FindLeaf(nodes, root, x_data, [](T val, float threshold) { return val == threshold; });
+      case NODE_MODE::BRANCH_NEQ:
+        return detail::FindLeaf(nodes, root, x_data, [](T val, float threshold) { return val != threshold; });
+      default:
+        break;
+    }
+  }
+
+  const TreeNodeElement* node = root;
+  while (node->mode != NODE_MODE::LEAF) {
+    const T val = x_data[node->feature_id];
+    const float threshold = node->value;
+    bool take_true = node->missing_tracks_true && std::isnan(static_cast<float>(val));
+    switch (node->mode) {
+      case NODE_MODE::BRANCH_LEQ:
+        take_true = take_true || val <= threshold;
+        break;
+      case NODE_MODE::BRANCH_LT:
+        take_true = take_true || val < threshold;
+        break;
+      case NODE_MODE::BRANCH_GTE:
+        take_true = take_true || val >= threshold;
+        break;
+      case NODE_MODE::BRANCH_GT:
+        take_true = take_true || val > threshold;
+        break;
+      case NODE_MODE::BRANCH_EQ:
+        take_true = take_true || val == threshold;
+        break;
+      default:
+        take_true = take_true || val != threshold;
+        break;
+    }
+    node = nodes + (take_true ? node->truenode : node->falsenode);
+  }
+
+  return node;
+}
+
+template <typename T>
+void TreeEnsembleEvaluator::ProcessRows(const T* x_data, int64_t stride, int64_t first_row, int64_t last_row,
+                                        size_t first_tree, size_t last_tree, TreeScore* scores) const {
+  for (int64_t block_begin = first_row; block_begin < last_row; block_begin += kRowBlockSize) {
+    const int64_t block_end = std::min(last_row, block_begin + kRowBlockSize);
+    for (size_t j = first_tree; j < last_tree; ++j) {
+      const TreeNodeElement* root = nodes_.data() + roots_[j];
+      for (int64_t i = block_begin; i < block_end; ++i) {
+        AddLeafWeights(*ProcessTreeNodeLeave(root, x_data + i * stride), scores + i * num_targets_);
+      }
+    }
+  }
+}
+
+template <typename T>
+common::Status TreeEnsembleEvaluator::ComputeScores(concurrency::ThreadPool* tp, const T* x_data, int64_t N,
+                                                    int64_t stride, std::vector<TreeScore>& scores) const {
+  if (max_feature_id_ >= stride) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "The trees use feature ", max_feature_id_,
+                           " but the input only has ", stride, " features.");
+  }
+
+  scores.assign(static_cast<size_t>(N * num_targets_), TreeScore{0.f, 0.f, 0.f, false});
+  if (N == 0 || roots_.empty()) {
+    return Status::OK();
+  }
+
+  const size_t num_trees = roots_.size();
+  const double row_cost = tree_cost_ * static_cast<double>(num_trees);
+
+  // with fewer row blocks than threads, split the trees instead. each batch of trees accumulates into its own
+  // buffer, and the buffers are merged in a fixed order so the result does not depend on the scheduling.
+  if (tp != nullptr && N < kRowBlockSize * (tp->NumThreads() + 1)) {
+    // same threshold as the cost based ParallelFor uses to decide whether a block is worth a thread
+    constexpr double kMinCostPerBatch = 20000.0;
+    const double total_cost = row_cost * static_cast<double>(N);
+    const int32_t num_batches = static_cast<int32_t>(std::min<double>(
+        {static_cast<double>(tp->NumThreads() + 1), static_cast<double>(num_trees), total_cost / kMinCostPerBatch}));
+
+    if (num_batches > 1) {
+      std::vector<std::vector<TreeScore>> batch_scores(num_batches - 1);
+      tp->ParallelFor(num_batches, [&](int32_t batch) {
+        const size_t first_tree = batch * num_trees / num_batches;
+        const size_t last_tree = (batch + 1) * num_trees / num_batches;
+        TreeScore* batch_data = scores.data();
+        if (batch > 0) {
+          batch_scores[batch - 1].assign(scores.size(), TreeScore{0.f, 0.f, 0.f, false});
+          batch_data = batch_scores[batch - 1].data();
+        }
+        ProcessRows(x_data, stride, 0, N, first_tree, last_tree, batch_data);
+      });
+
+      for (const auto& batch : batch_scores) {
+        for (size_t i = 0, end = scores.size(); i < end; ++i) {
+          MergeScore(scores[i], batch[i]);
+        }
+      }
+      return Status::OK();
+    }
+  }
+
+  concurrency::ThreadPool::TryParallelFor(tp, static_cast<std::ptrdiff_t>(N), row_cost,
+                                          [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+                                            ProcessRows(x_data, stride, first, last, 0, num_trees, scores.data());
+                                          });
+  return Status::OK();
+}
+
+}  // namespace ml
+}  // namespace onnxruntime
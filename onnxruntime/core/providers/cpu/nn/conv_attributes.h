@@ -127,19 +127,23 @@ struct ConvAttributes {
   }
 
   Status ValidateInputShape(const Tensor* X, const Tensor* W) const {
-    const int64_t C = X->Shape()[1];
-    const int64_t M = W->Shape()[0];
+    return ValidateInputShape(X->Shape(), W->Shape());
+  }
+
+  Status ValidateInputShape(const TensorShape& X_shape, const TensorShape& W_shape) const {
+    const int64_t C = X_shape[1];
+    const int64_t M = W_shape[0];
 
-    if (X->Shape().NumDimensions() != W->Shape().NumDimensions()) {
+    if (X_shape.NumDimensions() != W_shape.NumDimensions()) {
       return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "X num_dims does not match W num_dims.",
-                             " X: ", X->Shape().ToString().c_str(),
-                             " W: ", W->Shape().ToString().c_str());
+                             " X: ", X_shape.ToString().c_str(),
+                             " W: ", W_shape.ToString().c_str());
     }
 
-    if (C != W->Shape()[1] * group) {
+    if (C != W_shape[1] * group) {
       return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Input channels C is not equal to kernel channels * group.",
                              " C: ", C,
-                             " kernel channels: ", W->Shape()[1],
+                             " kernel channels: ", W_shape[1],
                              " group: ", group);
     }
 
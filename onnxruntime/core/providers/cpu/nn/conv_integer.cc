@@ -2,10 +2,14 @@
 // Licensed under the MIT License.
 
 #include "core/providers/cpu/nn/conv_integer.h"
+
+#include <algorithm>
+
 #include "core/util/math.h"
 #include "core/util/math_cpuonly.h"
 #include "core/util/qmath.h"
 #include "core/providers/common.h"
+#include "core/mlas/inc/mlas.h"
 
 namespace onnxruntime {
 
@@ -16,34 +20,73 @@ ONNX_OPERATOR_KERNEL_EX(
     kCpuExecutionProvider,
     KernelDefBuilder()
         .TypeConstraint("T1", DataTypeImpl::GetTensorType<uint8_t>())
-        .TypeConstraint("T2", DataTypeImpl::GetTensorType<uint8_t>())
+        .TypeConstraint("T2", {DataTypeImpl::GetTensorType<uint8_t>(), DataTypeImpl::GetTensorType<int8_t>()})
         .TypeConstraint("T3", DataTypeImpl::GetTensorType<int32_t>()),
     ConvInteger);
 
+Status ConvInteger::PrePack(const Tensor& tensor, int input_idx, bool& is_packed) {
+  is_packed = false;
+
+  // only the filter is converted, and only if it is signed. an unsigned filter is used as is.
+  if (input_idx != 1 || !tensor.IsDataType<int8_t>() || tensor.Shape().Size() == 0) {
+    return Status::OK();
+  }
+
+  const auto W_size = static_cast<size_t>(tensor.Shape().Size());
+  auto alloc = Info().GetAllocator(0, OrtMemTypeDefault);
+  auto* packed_W_data = alloc->Alloc(sizeof(uint8_t) * W_size);
+  packed_W_ = BufferUniquePtr(packed_W_data, BufferDeleter(alloc));
+  QuantizedS8ToU8(tensor.Data<int8_t>(), static_cast<uint8_t*>(packed_W_data), W_size);
+
+  W_shape_ = tensor.Shape();
+  is_packed = true;
+  return Status::OK();
+}
+
 Status ConvInteger::Compute(OpKernelContext* context) const {
+  concurrency::ThreadPool* thread_pool = context->GetOperatorThreadPool();
+
   size_t num_inputs = OpKernel::Node().InputDefs().size();
   const auto* X = context->Input<Tensor>(0);
-  const auto* W = context->Input<Tensor>(1);
+  const auto* W = packed_W_ ? nullptr : context->Input<Tensor>(1);
+  const auto& W_shape = packed_W_ ? W_shape_ : W->Shape();
+  const int64_t N = X->Shape()[0];
+  const int64_t C = X->Shape()[1];
+  const int64_t M = W_shape[0];
+
+  // the filter is the lhs matrix of the GEMM, which is unsigned. a signed filter and its zero points are shifted to
+  // unsigned values.
+  const bool is_W_signed = packed_W_ || W->IsDataType<int8_t>();
   uint8_t input_offset = 0;
-  uint8_t filter_offset = 0;
+  std::vector<uint8_t> filter_offsets{is_W_signed ? static_cast<uint8_t>(0x80) : static_cast<uint8_t>(0)};
   if (num_inputs >= 3) {
     const auto* X_Zero_Point = context->Input<Tensor>(2);
-    ORT_ENFORCE(IsScalarOr1ElementVector(X_Zero_Point), "Must be a scalar or 1D tensor or size 1.");
+    ORT_ENFORCE(IsScalarOr1ElementVector(X_Zero_Point) && X_Zero_Point->Shape().Size() == 1,
+                "Must be a scalar or 1D tensor or size 1.");
     input_offset = *(X_Zero_Point->Data<uint8_t>());
   }
   if (num_inputs >= 4) {
     const auto* W_Zero_Point = context->Input<Tensor>(3);
-    ORT_ENFORCE(IsScalarOr1ElementVector(W_Zero_Point), "Non per-tensor quantization is not supported now.");
-    filter_offset = *(W_Zero_Point->Data<uint8_t>());
+    ORT_ENFORCE(IsScalarOr1ElementVector(W_Zero_Point) &&
+                    (W_Zero_Point->Shape().Size() == 1 || W_Zero_Point->Shape().Size() == M),
+                "Must be a scalar, a 1D tensor of size 1 or a 1D tensor with one element per output channel.");
+    filter_offsets.resize(static_cast<size_t>(W_Zero_Point->Shape().Size()));
+    if (is_W_signed) {
+      QuantizedS8ToU8(W_Zero_Point->Data<int8_t>(), filter_offsets.data(), filter_offsets.size());
+    } else {
+      std::copy_n(W_Zero_Point->Data<uint8_t>(), filter_offsets.size(), filter_offsets.begin());
+    }
+    if (std::all_of(filter_offsets.begin(), filter_offsets.end(),
+                    [&filter_offsets](uint8_t offset) { return offset == filter_offsets[0]; })) {
+      filter_offsets.resize(1);
+    }
   }
+  const bool filter_offset_per_channel = filter_offsets.size() > 1;
 
-  const int64_t N = X->Shape()[0];
-  const int64_t C = X->Shape()[1];
-  const int64_t M = W->Shape()[0];
-  ORT_RETURN_IF_ERROR(conv_attrs_.ValidateInputShape(X, W));
+  ORT_RETURN_IF_ERROR(conv_attrs_.ValidateInputShape(X->Shape(), W_shape));
 
   std::vector<int64_t> kernel_shape;
-  ORT_RETURN_IF_ERROR(conv_attrs_.ComputeKernelShape(W->Shape(), kernel_shape));
+  ORT_RETURN_IF_ERROR(conv_attrs_.ComputeKernelShape(W_shape, kernel_shape));
 
   std::vector<int64_t> pads(conv_attrs_.pads);
   if (pads.empty()) {
@@ -68,15 +111,67 @@ Status ConvInteger::Compute(OpKernelContext* context) const {
   AllocatorPtr alloc;
   ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&alloc));
 
+  const uint8_t* Wdata = nullptr;
+  BufferUniquePtr W_buffer;
+  if (packed_W_) {
+    Wdata = static_cast<const uint8_t*>(packed_W_.get());
+  } else if (is_W_signed) {
+    const auto W_size = static_cast<size_t>(W->Shape().Size());
+    W_buffer = BufferUniquePtr(alloc->Alloc(sizeof(uint8_t) * W_size), BufferDeleter(alloc));
+    QuantizedS8ToU8(W->template Data<int8_t>(), static_cast<uint8_t*>(W_buffer.get()), W_size);
+    Wdata = static_cast<const uint8_t*>(W_buffer.get());
+  } else {
+    Wdata = W->template Data<uint8_t>();
+  }
+
   const auto* Xdata = X->template Data<uint8_t>();
   auto* Ydata = Y->template MutableData<int32_t>();
 
   const int64_t input_image_size = input_shape.Size();
   const int64_t output_image_size = output_shape.Size();
+  const size_t kernel_rank = kernel_shape.size();
+
+#ifdef MLAS_SUPPORTS_GEMM_U8X8
+  if (kernel_rank <= 2) {
+    // convolve directly from the input images into Y.
+    MLAS_QCONV_PARAMETERS Parameters;
+    size_t WorkingBufferSize;
+    MlasQConvPrepare(&Parameters,
+                     kernel_rank,
+                     static_cast<size_t>(N),
+                     static_cast<size_t>(conv_attrs_.group),
+                     static_cast<size_t>(C / conv_attrs_.group),
+                     input_shape.GetDims().data(),
+                     kernel_shape.data(),
+                     dilations.data(),
+                     pads.data(),
+                     strides.data(),
+                     output_shape.GetDims().data(),
+                     static_cast<size_t>(M / conv_attrs_.group),
+                     input_offset,
+                     &WorkingBufferSize,
+                     thread_pool);
+
+    auto working_data = WorkingBufferSize > 0 ? alloc->Alloc(WorkingBufferSize) : nullptr;
+    BufferUniquePtr working_buffer(working_data, BufferDeleter(alloc));
+
+    MlasQConv(&Parameters,
+              Xdata,
+              Wdata,
+              filter_offsets.data(),
+              filter_offset_per_channel,
+              static_cast<uint8_t*>(working_buffer.get()),
+              Ydata,
+              thread_pool);
+
+    return Status::OK();
+  }
+#endif
+
   const int64_t kernel_size = TensorShape(kernel_shape).Size();
   const int64_t X_offset = C / conv_attrs_.group * input_image_size;
   const int64_t Y_offset = Y->Shape().Size() / Y->Shape()[0] / conv_attrs_.group;
-  const int64_t W_offset = W->Shape().Size() / conv_attrs_.group;
+  const int64_t W_offset = W_shape.Size() / conv_attrs_.group;
   const int64_t kernel_dim = C / conv_attrs_.group * kernel_size;
   const int64_t col_buffer_size = kernel_dim * output_image_size;
 
@@ -89,8 +184,6 @@ Status ConvInteger::Compute(OpKernelContext* context) const {
   col_buffer_shape.insert(col_buffer_shape.end(), output_shape.GetDims().begin(),
                           output_shape.GetDims().end());
 
-  const size_t kernel_rank = kernel_shape.size();
-
   for (int image_id = 0; image_id < N; ++image_id) {
     for (int group_id = 0; group_id < conv_attrs_.group; ++group_id) {
       if (kernel_rank == 2) {
@@ -131,15 +224,27 @@ Status ConvInteger::Compute(OpKernelContext* context) const {
       QGemmu8u8_s32(static_cast<int>(M / conv_attrs_.group),
                     static_cast<int>(output_image_size),
                     static_cast<int>(kernel_dim),
-                    W->template Data<uint8_t>() + group_id * W_offset,
+                    Wdata + group_id * W_offset,
                     static_cast<int>(kernel_dim),
-                    filter_offset,
+                    filter_offset_per_channel ? 0 : filter_offsets[0],
                     col_buffer_data,
                     static_cast<int>(output_image_size),
                     input_offset,
                     Ydata + group_id * Y_offset,
                     static_cast<int>(output_image_size),
-                    nullptr);
+                    thread_pool);
+
+      if (filter_offset_per_channel) {
+        QGemmApplyLhsRowOffsets(static_cast<int>(M / conv_attrs_.group),
+                                static_cast<int>(output_image_size),
+                                static_cast<int>(kernel_dim),
+                                filter_offsets.data() + group_id * (M / conv_attrs_.group),
+                                col_buffer_data,
+                                static_cast<int>(output_image_size),
+                                input_offset,
+                                Ydata + group_id * Y_offset,
+                                static_cast<int>(output_image_size));
+      }
     }
 
     Xdata += X_offset * conv_attrs_.group;
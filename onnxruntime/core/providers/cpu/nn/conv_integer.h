@@ -12,8 +12,15 @@ class ConvInteger : public OpKernel {
   explicit ConvInteger(const OpKernelInfo& info) : OpKernel(info), conv_attrs_(info) {
   }
 
+  // converts a constant signed filter to unsigned values once, instead of on every call
+  Status PrePack(const Tensor& tensor, int input_idx, bool& is_packed) override;
+
   Status Compute(OpKernelContext* context) const override;
 
   ConvAttributes conv_attrs_;
+
+ private:
+  TensorShape W_shape_;
+  BufferUniquePtr packed_W_;
 };
 }  // namespace onnxruntime
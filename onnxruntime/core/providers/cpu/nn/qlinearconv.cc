@@ -2,9 +2,14 @@
 // Licensed under the MIT License.
 
 #include "core/providers/cpu/nn/qlinearconv.h"
+
+#include <algorithm>
+
 #include "core/util/math.h"
 #include "core/util/math_cpuonly.h"
+#include "core/util/qmath.h"
 #include "core/providers/common.h"
+#include "core/mlas/inc/mlas.h"
 
 namespace onnxruntime {
 ONNX_OPERATOR_KERNEL_EX(
@@ -14,45 +19,115 @@ ONNX_OPERATOR_KERNEL_EX(
     kCpuExecutionProvider,
     KernelDefBuilder()
         .TypeConstraint("T1", DataTypeImpl::GetTensorType<uint8_t>())
-        .TypeConstraint("T2", DataTypeImpl::GetTensorType<uint8_t>())
+        .TypeConstraint("T2", {DataTypeImpl::GetTensorType<uint8_t>(), DataTypeImpl::GetTensorType<int8_t>()})
         .TypeConstraint("T3", DataTypeImpl::GetTensorType<uint8_t>())
         .TypeConstraint("T4", DataTypeImpl::GetTensorType<int32_t>()),
     QLinearConv);
 
+namespace {
+
+bool IsScalarOrChannelVector(const Tensor* input, int64_t channels) {
+  const auto& shape = input->Shape();
+  return shape.NumDimensions() == 0 ||
+         (shape.NumDimensions() == 1 && (shape[0] == 1 || shape[0] == channels));
+}
+
+}  // namespace
+
+Status QLinearConv::PrePack(const Tensor& tensor, int input_idx, bool& is_packed) {
+  is_packed = false;
+
+  // only the filter is converted, and only if it is signed. an unsigned filter is used as is.
+  if (input_idx != 3 || !tensor.IsDataType<int8_t>() || tensor.Shape().Size() == 0) {
+    return Status::OK();
+  }
+
+  const auto W_size = static_cast<size_t>(tensor.Shape().Size());
+  auto alloc = Info().GetAllocator(0, OrtMemTypeDefault);
+  auto* packed_W_data = alloc->Alloc(sizeof(uint8_t) * W_size);
+  packed_W_ = BufferUniquePtr(packed_W_data, BufferDeleter(alloc));
+  QuantizedS8ToU8(tensor.Data<int8_t>(), static_cast<uint8_t*>(packed_W_data), W_size);
+
+  W_shape_ = tensor.Shape();
+  is_packed = true;
+  return Status::OK();
+}
+
 Status QLinearConv::Compute(OpKernelContext* context) const {
+  concurrency::ThreadPool* thread_pool = context->GetOperatorThreadPool();
+
   const auto* X = context->Input<Tensor>(0);
-  const auto* W = context->Input<Tensor>(3);
+  const auto* W = packed_W_ ? nullptr : context->Input<Tensor>(3);
+  const auto& W_shape = packed_W_ ? W_shape_ : W->Shape();
+  const int64_t M = W_shape[0];
 
-  // validate offsets
+  // validate offsets. the filter may be quantized per output channel.
   auto input_offset = context->Input<Tensor>(2);
   auto filter_offset = context->Input<Tensor>(5);
   auto result_offset = context->Input<Tensor>(7);
-  ORT_ENFORCE(IsScalarOr1ElementVector(input_offset),
+  ORT_ENFORCE(IsScalarOr1ElementVector(input_offset) && input_offset->Shape().Size() == 1,
               "QLinearConv : input zero point must be a scalar or 1D tensor of size 1");
-  ORT_ENFORCE(IsScalarOr1ElementVector(filter_offset),
-              "QLinearConv : filter zero point must be a scalar or 1D tensor of size 1");
-  ORT_ENFORCE(IsScalarOr1ElementVector(result_offset),
+  ORT_ENFORCE(IsScalarOrChannelVector(filter_offset, M),
+              "QLinearConv : filter zero point must be a scalar, a 1D tensor of size 1 or a 1D tensor with one "
+              "element per output channel");
+  ORT_ENFORCE(IsScalarOr1ElementVector(result_offset) && result_offset->Shape().Size() == 1,
               "QLinearConv : result zero point must be a scalar or 1D tensor of size 1");
 
   // validate scale
   auto input_scale = context->Input<Tensor>(1);
   auto filter_scale = context->Input<Tensor>(4);
   auto result_scale = context->Input<Tensor>(6);
-  ORT_ENFORCE(IsScalarOr1ElementVector(input_scale),
+  ORT_ENFORCE(IsScalarOr1ElementVector(input_scale) && input_scale->Shape().Size() == 1,
               "QLinearConv : input scale must be a scalar or 1D tensor of size 1");
-  ORT_ENFORCE(IsScalarOr1ElementVector(filter_scale),
-              "QLinearConv : filter scale must be a scalar or 1D tensor of size 1");
-  ORT_ENFORCE(IsScalarOr1ElementVector(result_scale),
+  ORT_ENFORCE(IsScalarOrChannelVector(filter_scale, M),
+              "QLinearConv : filter scale must be a scalar, a 1D tensor of size 1 or a 1D tensor with one "
+              "element per output channel");
+  ORT_ENFORCE(IsScalarOr1ElementVector(result_scale) && result_scale->Shape().Size() == 1,
               "QLinearConv : result scale must be a scalar or 1D tensor of size 1");
 
+  const uint8_t input_offset_data = *(input_offset->template Data<uint8_t>());
+  const uint8_t result_offset_data = *(result_offset->template Data<uint8_t>());
+
+  // the scale that maps the integer convolution to Y, for all output channels or for each output channel
   auto input_scale_data = *(input_scale->template Data<float>());
-  auto filter_scale_data = *(filter_scale->template Data<float>());
+  auto filter_scale_data = filter_scale->template Data<float>();
   auto result_scale_data = *(result_scale->template Data<float>());
+  std::vector<float> output_scales(static_cast<size_t>(filter_scale->Shape().Size()));
+  for (size_t i = 0; i < output_scales.size(); i++) {
+    output_scales[i] = (input_scale_data * filter_scale_data[i]) / result_scale_data;
+  }
+  const bool scale_per_channel = output_scales.size() > 1;
 
-  const float real_multiplier = (input_scale_data * filter_scale_data) / result_scale_data;
-  int32_t integer_multiplier;
-  int right_shift;
-  QuantizeMultiplier(real_multiplier, &integer_multiplier, &right_shift);
+  AllocatorPtr alloc;
+  ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&alloc));
+
+  // the filter is the lhs matrix of the GEMM, which is unsigned. a signed filter and its zero points are shifted to
+  // unsigned values.
+  const bool is_W_signed = packed_W_ || W->IsDataType<int8_t>();
+  std::vector<uint8_t> filter_offsets(static_cast<size_t>(filter_offset->Shape().Size()));
+  if (is_W_signed) {
+    QuantizedS8ToU8(filter_offset->template Data<int8_t>(), filter_offsets.data(), filter_offsets.size());
+  } else {
+    std::copy_n(filter_offset->template Data<uint8_t>(), filter_offsets.size(), filter_offsets.begin());
+  }
+  if (std::all_of(filter_offsets.begin(), filter_offsets.end(),
+                  [&filter_offsets](uint8_t offset) { return offset == filter_offsets[0]; })) {
+    filter_offsets.resize(1);
+  }
+  const bool filter_offset_per_channel = filter_offsets.size() > 1;
+
+  const uint8_t* Wdata = nullptr;
+  BufferUniquePtr W_buffer;
+  if (packed_W_) {
+    Wdata = static_cast<const uint8_t*>(packed_W_.get());
+  } else if (is_W_signed) {
+    const auto W_size = static_cast<size_t>(W->Shape().Size());
+    W_buffer = BufferUniquePtr(alloc->Alloc(sizeof(uint8_t) * W_size), BufferDeleter(alloc));
+    QuantizedS8ToU8(W->template Data<int8_t>(), static_cast<uint8_t*>(W_buffer.get()), W_size);
+    Wdata = static_cast<const uint8_t*>(W_buffer.get());
+  } else {
+    Wdata = W->template Data<uint8_t>();
+  }
 
   size_t num_inputs = OpKernel::Node().InputDefs().size();
   const Tensor* bias = nullptr;
@@ -62,11 +137,10 @@ Status QLinearConv::Compute(OpKernelContext* context) const {
 
   const int64_t N = X->Shape()[0];
   const int64_t C = X->Shape()[1];
-  const int64_t M = W->Shape()[0];
-  ORT_RETURN_IF_ERROR(conv_attrs_.ValidateInputShape(X, W));
+  ORT_RETURN_IF_ERROR(conv_attrs_.ValidateInputShape(X->Shape(), W_shape));
 
   std::vector<int64_t> kernel_shape;
-  ORT_RETURN_IF_ERROR(conv_attrs_.ComputeKernelShape(W->Shape(), kernel_shape));
+  ORT_RETURN_IF_ERROR(conv_attrs_.ComputeKernelShape(W_shape, kernel_shape));
 
   std::vector<int64_t> pads(conv_attrs_.pads);
   if (pads.empty()) {
@@ -88,18 +162,73 @@ Status QLinearConv::Compute(OpKernelContext* context) const {
   Tensor* Y = context->Output(0, TensorShape(Y_dims));
   TensorShape output_shape = Y->Shape().Slice(2);
 
-  AllocatorPtr alloc;
-  ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&alloc));
-
   const auto* Xdata = X->template Data<uint8_t>();
   auto* Ydata = Y->template MutableData<uint8_t>();
 
   const int64_t input_image_size = input_shape.Size();
   const int64_t output_image_size = output_shape.Size();
+  const size_t kernel_rank = kernel_shape.size();
+
+#ifdef MLAS_SUPPORTS_GEMM_U8X8
+  if (kernel_rank <= 2) {
+    // convolve the whole batch directly from the input images. the 32-bit result of each image is then
+    // requantized to Y.
+    MLAS_QCONV_PARAMETERS Parameters;
+    size_t WorkingBufferSize;
+    MlasQConvPrepare(&Parameters,
+                     kernel_rank,
+                     static_cast<size_t>(N),
+                     static_cast<size_t>(conv_attrs_.group),
+                     static_cast<size_t>(C / conv_attrs_.group),
+                     input_shape.GetDims().data(),
+                     kernel_shape.data(),
+                     dilations.data(),
+                     pads.data(),
+                     strides.data(),
+                     output_shape.GetDims().data(),
+                     static_cast<size_t>(M / conv_attrs_.group),
+                     input_offset_data,
+                     &WorkingBufferSize,
+                     thread_pool);
+
+    auto working_data = WorkingBufferSize > 0 ? alloc->Alloc(WorkingBufferSize) : nullptr;
+    BufferUniquePtr working_buffer(working_data, BufferDeleter(alloc));
+
+    auto conv_output_data = alloc->Alloc(sizeof(int32_t) * N * M * output_image_size);
+    BufferUniquePtr conv_output_buffer(conv_output_data, BufferDeleter(alloc));
+    auto* conv_output = static_cast<int32_t*>(conv_output_buffer.get());
+
+    MlasQConv(&Parameters,
+              Xdata,
+              Wdata,
+              filter_offsets.data(),
+              filter_offset_per_channel,
+              static_cast<uint8_t*>(working_buffer.get()),
+              conv_output,
+              thread_pool);
+
+    for (int image_id = 0; image_id < N; ++image_id) {
+      MlasRequantizeOutput(conv_output,
+                           Ydata,
+                           bias == nullptr ? nullptr : bias->template Data<int32_t>(),
+                           static_cast<size_t>(M),
+                           static_cast<size_t>(output_image_size),
+                           output_scales.data(),
+                           scale_per_channel ? MlasPerRow : MlasPerMatrix,
+                           result_offset_data);
+
+      conv_output += M * output_image_size;
+      Ydata += M * output_image_size;
+    }
+
+    return Status::OK();
+  }
+#endif
+
   const int64_t kernel_size = TensorShape(kernel_shape).Size();
   const int64_t X_offset = C / conv_attrs_.group * input_image_size;
   const int64_t Y_offset = Y->Shape().Size() / Y->Shape()[0] / conv_attrs_.group;
-  const int64_t W_offset = W->Shape().Size() / conv_attrs_.group;
+  const int64_t W_offset = W_shape.Size() / conv_attrs_.group;
   const int64_t kernel_dim = C / conv_attrs_.group * kernel_size;
   const int64_t col_buffer_size = kernel_dim * output_image_size;
   const int bias_offset = static_cast<int>(M / conv_attrs_.group);
@@ -108,13 +237,16 @@ Status QLinearConv::Compute(OpKernelContext* context) const {
   BufferUniquePtr col_buffer(col_data, BufferDeleter(alloc));
   auto* col_buffer_data = static_cast<uint8_t*>(col_buffer.get());
 
+  // the integer convolution of one group, which is requantized to Y
+  auto gemm_output_data = alloc->Alloc(sizeof(int32_t) * Y_offset);
+  BufferUniquePtr gemm_output_buffer(gemm_output_data, BufferDeleter(alloc));
+  auto* gemm_output = static_cast<int32_t*>(gemm_output_buffer.get());
+
   TensorShape image_shape = X->Shape().Slice(1);
   std::vector<int64_t> col_buffer_shape{kernel_dim};
   col_buffer_shape.insert(col_buffer_shape.end(), output_shape.GetDims().begin(),
                           output_shape.GetDims().end());
 
-  const size_t kernel_rank = kernel_shape.size();
-
   for (int image_id = 0; image_id < N; ++image_id) {
     for (int group_id = 0; group_id < conv_attrs_.group; ++group_id) {
       if (kernel_rank == 2) {
@@ -134,7 +266,7 @@ Status QLinearConv::Compute(OpKernelContext* context) const {
             strides[0],
             strides[1],
             col_buffer_data,
-            *input_offset->template Data<uint8_t>());
+            input_offset_data);
       } else {
         math::Im2colNd<uint8_t, StorageOrder::NCHW>()(
             Xdata + group_id * X_offset,
@@ -149,21 +281,42 @@ Status QLinearConv::Compute(OpKernelContext* context) const {
             static_cast<int>(kernel_shape.size()),
             col_buffer_data,
             false,
-            *input_offset->template Data<uint8_t>());
+            input_offset_data);
+      }
+
+      QGemmu8u8_s32(static_cast<int>(M / conv_attrs_.group),
+                    static_cast<int>(output_image_size),
+                    static_cast<int>(kernel_dim),
+                    Wdata + group_id * W_offset,
+                    static_cast<int>(kernel_dim),
+                    filter_offset_per_channel ? 0 : filter_offsets[0],
+                    col_buffer_data,
+                    static_cast<int>(output_image_size),
+                    input_offset_data,
+                    gemm_output,
+                    static_cast<int>(output_image_size),
+                    thread_pool);
+
+      if (filter_offset_per_channel) {
+        QGemmApplyLhsRowOffsets(static_cast<int>(M / conv_attrs_.group),
+                                static_cast<int>(output_image_size),
+                                static_cast<int>(kernel_dim),
+                                filter_offsets.data() + group_id * bias_offset,
+                                col_buffer_data,
+                                static_cast<int>(output_image_size),
+                                input_offset_data,
+                                gemm_output,
+                                static_cast<int>(output_image_size));
       }
 
-      GemmlowpMultiplyu8u8_u8(W->template Data<uint8_t>() + group_id * W_offset,
-                              col_buffer_data,
-                              Ydata + group_id * Y_offset,
-                              *filter_offset->template Data<uint8_t>(),
-                              *input_offset->template Data<uint8_t>(),
-                              *result_offset->template Data<uint8_t>(),
-                              static_cast<int>(M / conv_attrs_.group),
-                              static_cast<int>(output_image_size),
-                              static_cast<int>(kernel_dim),
-                              integer_multiplier,
-                              right_shift,
-                              bias == nullptr ? nullptr : bias->template Data<int32_t>() + group_id * bias_offset);
+      MlasRequantizeOutput(gemm_output,
+                           Ydata + group_id * Y_offset,
+                           bias == nullptr ? nullptr : bias->template Data<int32_t>() + group_id * bias_offset,
+                           static_cast<size_t>(M / conv_attrs_.group),
+                           static_cast<size_t>(output_image_size),
+                           output_scales.data() + (scale_per_channel ? group_id * bias_offset : 0),
+                           scale_per_channel ? MlasPerRow : MlasPerMatrix,
+                           result_offset_data);
     }
 
     Xdata += X_offset * conv_attrs_.group;
@@ -5,7 +5,6 @@
 
 #include "core/framework/op_kernel.h"
 #include "core/providers/cpu/nn/conv_attributes.h"
-#include "core/util/gemmlowp_common.h"
 
 namespace onnxruntime {
 class QLinearConv : public OpKernel {
@@ -13,8 +12,15 @@ class QLinearConv : public OpKernel {
   explicit QLinearConv(const OpKernelInfo& info) : OpKernel(info), conv_attrs_(info) {
   }
 
+  // converts a constant signed filter to unsigned values once, instead of on every call
+  Status PrePack(const Tensor& tensor, int input_idx, bool& is_packed) override;
+
   Status Compute(OpKernelContext* context) const override;
 
   ConvAttributes conv_attrs_;
+
+ private:
+  TensorShape W_shape_;
+  BufferUniquePtr packed_W_;
 };
 }  // namespace onnxruntime
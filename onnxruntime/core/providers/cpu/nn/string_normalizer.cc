@@ -4,20 +4,19 @@
 #include "string_normalizer.h"
 #include "onnx/defs/schema.h"
 #include "core/common/common.h"
+#include "core/framework/string_buffer.h"
 #include "core/framework/tensor.h"
+#include "core/platform/threadpool.h"
 
 #ifdef _MSC_VER
 #include <codecvt>
 #include <locale.h>
 #elif defined (__APPLE__) or defined (__ANDROID__)
 #include <codecvt>
-#else
-#include <limits>
-#include <iconv.h>
 #endif  // _MSC_VER
 
+#include <algorithm>
 #include <locale>
-#include <functional>
 #include <unordered_set>
 
 namespace onnxruntime {
@@ -81,7 +80,8 @@ const std::string default_locale("en-US");
 
 class Locale {
  public:
-  explicit Locale(const std::string& name) try : loc_(name.c_str()) {
+  explicit Locale(const std::string& name) try : loc_(name.c_str()),
+                                                 ctype_(&std::use_facet<std::ctype<wchar_t>>(loc_)) {
   } catch (const std::runtime_error& e) {
     ORT_THROW("Failed to construct locale with name:",
               name, ":", e.what(), ":Please, install necessary language-pack-XX and configure locales");
@@ -92,17 +92,20 @@ class Locale {
   void ChangeCase(StringNormalizer::CaseAction caseaction,
                   std::wstring& wstr) const {
     assert(caseaction != StringNormalizer::NONE);
+    if (wstr.empty()) {
+      return;
+    }
+    // Same as std::tolower(ch, loc_) for every character, without looking up the facet for each of them
     if (caseaction == StringNormalizer::LOWER) {
-      std::transform(wstr.begin(), wstr.end(), wstr.begin(),
-                     [this](wchar_t ch) { return std::tolower(ch, loc_); });
+      ctype_->tolower(&wstr[0], &wstr[0] + wstr.size());
     } else {
-      std::transform(wstr.begin(), wstr.end(), wstr.begin(),
-                     [this](wchar_t ch) { return std::toupper(ch, loc_); });
+      ctype_->toupper(&wstr[0], &wstr[0] + wstr.size());
     }
   }
 
  private:
   std::locale loc_;
+  const std::ctype<wchar_t>* ctype_;
 };
 
 #if defined(__APPLE__) or defined(__ANDROID__)
@@ -110,75 +113,89 @@ using Utf8Converter = std::wstring_convert<std::codecvt_utf8<wchar_t>>;
 #else
 
 // All others (Linux)
+// Converts between UTF-8 and the UTF-32 of wchar_t directly into the buffers of the caller, rather than opening an
+// iconv descriptor for every string. Malformed and overlong sequences, surrogates and code points past U+10FFFF are
+// rejected.
 class Utf8Converter {
  public:
+  static_assert(sizeof(wchar_t) == 4, "wchar_t is expected to hold UTF-32");
 
   Utf8Converter(const std::string&, const std::wstring&) {}
 
-  std::wstring from_bytes(const std::string& s) const {
-    std::wstring result;
-    if (s.empty()) {
-      return result;
-    }
-    // Order of arguments is to, from
-    auto icvt = iconv_open("WCHAR_T", "UTF-8");
-    // CentOS is not happy with -1
-    if (std::numeric_limits<iconv_t>::max() == icvt) {
-      return wconv_error;
-    }
-
-    char* iconv_in = const_cast<char*>(s.c_str());
-    size_t iconv_in_bytes = s.length();
-    // Temporary buffer assumes 1 byte to 1 wchar_t
-    // to make sure it is enough.
-    const size_t buffer_len = iconv_in_bytes * sizeof(wchar_t);
-    auto buffer = onnxruntime::make_unique<char[]>(buffer_len);
-    char* iconv_out = buffer.get();
-    size_t iconv_out_bytes = buffer_len;
-    auto ret = iconv(icvt, &iconv_in, &iconv_in_bytes, &iconv_out, &iconv_out_bytes);
-    if (static_cast<size_t>(-1) == ret) {
-      result = wconv_error;
-    } else {
-      size_t converted_bytes = buffer_len - iconv_out_bytes;
-      assert((converted_bytes % sizeof(wchar_t)) == 0);
-      result.assign(reinterpret_cast<const wchar_t*>(buffer.get()), converted_bytes / sizeof(wchar_t));
+  bool from_bytes(const std::string& s, std::wstring& wstr) const {
+    wstr.clear();
+    auto p = reinterpret_cast<const unsigned char*>(s.data());
+    auto const end = p + s.size();
+    while (p != end) {
+      char32_t cp = *p++;
+      if (cp >= 0x80) {
+        size_t trailing = 0;
+        char32_t min_cp = 0;
+        if ((cp & 0xE0) == 0xC0) {
+          trailing = 1;
+          min_cp = 0x80;
+          cp &= 0x1F;
+        } else if ((cp & 0xF0) == 0xE0) {
+          trailing = 2;
+          min_cp = 0x800;
+          cp &= 0x0F;
+        } else if ((cp & 0xF8) == 0xF0) {
+          trailing = 3;
+          min_cp = 0x10000;
+          cp &= 0x07;
+        } else {
+          return false;
+        }
+        if (static_cast<size_t>(end - p) < trailing) {
+          return false;
+        }
+        for (; trailing > 0; --trailing, ++p) {
+          if ((*p & 0xC0) != 0x80) {
+            return false;
+          }
+          cp = (cp << 6) | (*p & 0x3F);
+        }
+        if (cp < min_cp || !IsValid(cp)) {
+          return false;
+        }
+      }
+      wstr.push_back(static_cast<wchar_t>(cp));
     }
-    iconv_close(icvt);
-    return result;
+    return true;
   }
 
-  std::string to_bytes(const std::wstring& wstr) const {
-    std::string result;
-    if (wstr.empty()) {
-      return result;
-    }
-    // Order of arguments is to, from
-    auto icvt = iconv_open("UTF-8", "WCHAR_T");
-    // CentOS is not happy with -1
-    if (std::numeric_limits<iconv_t>::max() == icvt) {
-      return conv_error;
+  bool to_bytes(const std::wstring& wstr, std::string& s) const {
+    s.clear();
+    for (wchar_t ch : wstr) {
+      const auto cp = static_cast<char32_t>(ch);
+      if (cp < 0x80) {
+        s.push_back(static_cast<char>(cp));
+      } else if (cp < 0x800) {
+        s.push_back(static_cast<char>(0xC0 | (cp >> 6)));
+        s.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+      } else if (cp < 0x10000) {
+        if (!IsValid(cp)) {
+          return false;
+        }
+        s.push_back(static_cast<char>(0xE0 | (cp >> 12)));
+        s.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+        s.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+      } else {
+        if (!IsValid(cp)) {
+          return false;
+        }
+        s.push_back(static_cast<char>(0xF0 | (cp >> 18)));
+        s.push_back(static_cast<char>(0x80 | ((cp >> 12) & 0x3F)));
+        s.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+        s.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+      }
     }
+    return true;
+  }
 
-    // I hope this does not modify the incoming buffer
-    wchar_t* non_const_in = const_cast<wchar_t*>(wstr.c_str());
-    char* iconv_in = reinterpret_cast<char*>(non_const_in);
-    size_t iconv_in_bytes = wstr.length() * sizeof(wchar_t);
-    // Temp buffer, assume every code point converts into 3 bytes, this should be enough
-    // We do not convert terminating zeros
-    const size_t buffer_len = wstr.length() * 3;
-    auto buffer = onnxruntime::make_unique<char[]>(buffer_len);
-
-    char* iconv_out = buffer.get();
-    size_t iconv_out_bytes = buffer_len;
-    auto ret = iconv(icvt, &iconv_in, &iconv_in_bytes, &iconv_out, &iconv_out_bytes);
-    if (static_cast<size_t>(-1) == ret) {
-      result = conv_error;
-    } else {
-      size_t converted_len = buffer_len - iconv_out_bytes;
-      result.assign(buffer.get(), converted_len);
-    }
-    iconv_close(icvt);
-    return result;
+ private:
+  static bool IsValid(char32_t cp) {
+    return cp <= 0x10FFFF && (cp < 0xD800 || cp > 0xDFFF);
   }
 };
 
@@ -188,12 +205,70 @@ const std::string default_locale("en_US.UTF-8"); // All non-MS
 
 #endif // MS_VER
 
-template <class ForwardIter>
-Status CopyCaseAction(ForwardIter first, ForwardIter end, OpKernelContext* ctx,
-                      const Locale& loc,
-                      Utf8Converter& converter,
-                      size_t N, size_t C,
-                      StringNormalizer::CaseAction caseaction) {
+// Converts the strings into buffers that are reused from string to string.
+// std::wstring_convert returns the error strings it is constructed with when a conversion fails.
+#if defined(_MSC_VER) || defined(__APPLE__) || defined(__ANDROID__)
+bool FromUtf8(Utf8Converter& converter, const std::string& s, std::wstring& wstr) {
+  wstr = converter.from_bytes(s);
+  return wstr != wconv_error;
+}
+
+void ToUtf8(Utf8Converter& converter, const std::wstring& wstr, std::string& s) {
+  s = converter.to_bytes(wstr);
+}
+#else
+bool FromUtf8(Utf8Converter& converter, const std::string& s, std::wstring& wstr) {
+  return converter.from_bytes(s, wstr);
+}
+
+void ToUtf8(Utf8Converter& converter, const std::wstring& wstr, std::string& s) {
+  if (!converter.to_bytes(wstr, s)) {
+    s = conv_error;
+  }
+}
+#endif
+
+// The strings are filtered and converted in blocks of strings, in parallel on the intra-op thread pool.
+// Each block has its own converter and buffers, and stops at its first invalid string.
+constexpr size_t kStringBlockSize = 64;
+
+template <typename ProcessString>
+Status ForEachStringBlock(concurrency::ThreadPool* tp, const std::string* const* strings, size_t count,
+                          const ProcessString& process_string) {
+  const size_t num_blocks = (count + kStringBlockSize - 1) / kStringBlockSize;
+  std::vector<Status> statuses(num_blocks);
+
+  size_t bytes = 0;
+  for (size_t i = 0; i < count; ++i) {
+    bytes += strings[i]->size();
+  }
+  // the cost of a block grows with the length of its strings
+  const double block_cost = static_cast<double>(bytes + count) / std::max<size_t>(count, 1) * kStringBlockSize * 8;
+
+  concurrency::ThreadPool::TryParallelFor(
+      tp, static_cast<std::ptrdiff_t>(num_blocks), block_cost, [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        Utf8Converter converter(conv_error, wconv_error);
+        std::wstring wstr;
+        for (auto b = static_cast<size_t>(first); b < static_cast<size_t>(last); ++b) {
+          for (size_t i = b * kStringBlockSize, end = std::min(count, i + kStringBlockSize); i < end; ++i) {
+            if (!process_string(i, converter, wstr)) {
+              statuses[b] = Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
+                                   "Input contains invalid utf8 chars at: " + *strings[i]);
+              break;
+            }
+          }
+        }
+      });
+
+  // the error of the first invalid string, as when the strings are processed one by one
+  for (const auto& status : statuses) {
+    ORT_RETURN_IF_ERROR(status);
+  }
+  return Status::OK();
+}
+
+// Creates the output for C strings. nullptr if there are none, in which case the output is a single empty string.
+Tensor* CreateOutput(OpKernelContext* ctx, size_t N, size_t C) {
   std::vector<int64_t> output_dims;
   if (N == 1) {
     output_dims.push_back(1);
@@ -205,41 +280,93 @@ Status CopyCaseAction(ForwardIter first, ForwardIter end, OpKernelContext* ctx,
     TensorShape output_shape(output_dims);
     // This will create one empty string
     ctx->Output(0, output_shape);
-    return Status::OK();
+    return nullptr;
   }
 
   output_dims.push_back(C);
-
   TensorShape output_shape(output_dims);
-  auto output_tensor = ctx->Output(0, output_shape);
+  return ctx->Output(0, output_shape);
+}
+
+Status CopyCaseAction(const std::vector<const std::string*>& strings, OpKernelContext* ctx,
+                      const Locale& loc,
+                      size_t N,
+                      StringNormalizer::CaseAction caseaction) {
+  const size_t C = strings.size();
+  auto output_tensor = CreateOutput(ctx, N, C);
+  if (output_tensor == nullptr) {
+    return Status::OK();
+  }
+
   auto const output_data = output_tensor->template MutableData<std::string>();
 
-  size_t output_idx = 0;
-  while (first != end) {
-    auto& s = *first;
-    if (caseaction == StringNormalizer::LOWER || caseaction == StringNormalizer::UPPER) {
-      std::wstring wstr = converter.from_bytes(s);
-      if (wstr == wconv_error) {
-        return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
-                      "Input contains invalid utf8 chars at: " + static_cast<const std::string&>(s));
-      }
-      // In place transform
-      loc.ChangeCase(caseaction, wstr);
-      *(output_data + output_idx) = converter.to_bytes(wstr);
-    } else {
-      assert(caseaction == StringNormalizer::NONE);
-      // Simple copy or move if the iterator points to a non-const string
-      *(output_data + output_idx) = std::move(s);
+  return ForEachStringBlock(
+      ctx->GetOperatorThreadPool(), strings.data(), C,
+      [&](size_t i, Utf8Converter& converter, std::wstring& wstr) {
+        const std::string& s = *strings[i];
+        if (caseaction == StringNormalizer::LOWER || caseaction == StringNormalizer::UPPER) {
+          if (!FromUtf8(converter, s, wstr)) {
+            return false;
+          }
+          // In place transform
+          loc.ChangeCase(caseaction, wstr);
+          ToUtf8(converter, wstr, output_data[i]);
+        } else {
+          assert(caseaction == StringNormalizer::NONE);
+          output_data[i] = s;
+        }
+        return true;
+      });
+}
+
+// The strings of a block converted while the stopwords are marked, an empty string for each stopword.
+struct ConvertedBlock {
+  StringBuffer strings;
+  // buffer of the conversion of a string back to UTF-8, reused from string to string
+  std::string utf8;
+};
+
+// Copies the converted strings that aren't stopwords to the output, in parallel over the blocks.
+Status CopyConverted(const std::vector<ConvertedBlock>& converted, const std::vector<char>& is_stopword,
+                     OpKernelContext* ctx, size_t N) {
+  // the position in the output of the first string kept from each block
+  const size_t num_blocks = converted.size();
+  std::vector<size_t> block_starts(num_blocks + 1, 0);
+  for (size_t b = 0; b < num_blocks; ++b) {
+    size_t kept = 0;
+    for (size_t i = b * kStringBlockSize, end = std::min(is_stopword.size(), i + kStringBlockSize); i < end; ++i) {
+      kept += is_stopword[i] ? 0 : 1;
     }
-    ++output_idx;
-    ++first;
+    block_starts[b + 1] = block_starts[b] + kept;
   }
+
+  auto output_tensor = CreateOutput(ctx, N, block_starts[num_blocks]);
+  if (output_tensor == nullptr) {
+    return Status::OK();
+  }
+
+  auto const output_data = output_tensor->template MutableData<std::string>();
+  concurrency::ThreadPool::TryParallelFor(
+      ctx->GetOperatorThreadPool(), static_cast<std::ptrdiff_t>(num_blocks), static_cast<double>(kStringBlockSize) * 8,
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        for (auto b = static_cast<size_t>(first); b < static_cast<size_t>(last); ++b) {
+          const StringBuffer& strings = converted[b].strings;
+          std::string* output = output_data + block_starts[b];
+          for (size_t j = 0; j < strings.Size(); ++j) {
+            if (!is_stopword[b * kStringBlockSize + j]) {
+              (output++)->assign(strings.Data(j), strings.Length(j));
+            }
+          }
+        }
+      });
   return Status::OK();
 }
 }  // namespace string_normalizer
 
 using namespace string_normalizer;
 
+StringNormalizer::~StringNormalizer() = default;
+
 StringNormalizer::StringNormalizer(const OpKernelInfo& info) : OpKernel(info),
                                                                is_case_sensitive_(true),
                                                                case_change_action_(NONE),
@@ -267,9 +394,10 @@ StringNormalizer::StringNormalizer(const OpKernelInfo& info) : OpKernel(info),
     compare_caseaction_ = (case_change_action_ == UPPER) ? UPPER : LOWER;
   }
 
-  locale_name_ = info.GetAttrOrDefault("locale", default_locale);
-  Locale locale(locale_name_);
+  const std::string locale_name = info.GetAttrOrDefault("locale", default_locale);
+  locale_ = onnxruntime::make_unique<Locale>(locale_name);
   Utf8Converter converter(conv_error, wconv_error);
+  std::wstring wstr;
 
   std::vector<std::string> swords = info.GetAttrsOrDefault<std::string>("stopwords");
   for (const auto& sw : swords) {
@@ -278,9 +406,8 @@ StringNormalizer::StringNormalizer(const OpKernelInfo& info) : OpKernel(info),
       auto p = stopwords_.insert(sw);
       ORT_ENFORCE(p.second, "Duplicate stopwords not allowed");
     } else {
-      std::wstring wstr = converter.from_bytes(sw);
-      ORT_ENFORCE(wstr != wconv_error, "Stopword contains invalid utf8 chars");
-      locale.ChangeCase(compare_caseaction_, wstr);
+      ORT_ENFORCE(FromUtf8(converter, sw, wstr), "Stopword contains invalid utf8 chars");
+      locale_->ChangeCase(compare_caseaction_, wstr);
       auto p = wstopwords_.insert(wstr);
       ORT_ENFORCE(p.second, "Duplicate stopwords not allowed");
     }
@@ -314,70 +441,59 @@ Status StringNormalizer::Compute(OpKernelContext* ctx) const {
                   "Input dimensions are either[C > 0] or [1][C > 0] allowed");
   }
 
-  Status status;
-  Locale locale(locale_name_);
-  Utf8Converter converter(conv_error, wconv_error);
   auto const input_data = X->template Data<std::string>();
-  using StrRef = std::reference_wrapper<const std::string>;
-  if (is_case_sensitive_) {
-    if (!stopwords_.empty()) {
-      std::vector<StrRef> filtered_strings;
-      filtered_strings.reserve(C);
-      auto first = input_data;
-      auto const last = input_data + C;
-      while (first != last) {
-        const std::string& s = *first;
-        if (0 == stopwords_.count(s)) {
-          filtered_strings.push_back(std::cref(s));
-        }
-        ++first;
-      }
-      status = CopyCaseAction(filtered_strings.cbegin(), filtered_strings.cend(), ctx, locale, converter,
-                              N, filtered_strings.size(), case_change_action_);
-    } else {
-      // Nothing to filter. Copy input to output and change case if needed
-      status = CopyCaseAction(input_data, input_data + C, ctx, locale, converter, N, C, case_change_action_);
-    }
-  } else {
-    if (!wstopwords_.empty()) {
-      // Filter input. When no case action is required
-      // we simply store original string references.
-      // Otherwise, we store converted strings.
-      std::vector<StrRef> filtered_orignal_strings;
-      std::vector<std::string> filtered_cased_strings;
-      filtered_orignal_strings.reserve(C);
-      filtered_cased_strings.reserve(C);
-      auto first = input_data;
-      auto const last = input_data + C;
-      while (first != last) {
-        const std::string& s = *first;
-        std::wstring wstr = converter.from_bytes(s);
-        if (wstr == wconv_error) {
-          return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
-                        "Input contains invalid utf8 chars at: " + s);
-        }
-        locale.ChangeCase(compare_caseaction_, wstr);
-        if (0 == wstopwords_.count(wstr)) {
-          if (case_change_action_ == NONE) {
-            filtered_orignal_strings.push_back(std::cref(s));
-          } else {
-            filtered_cased_strings.push_back(converter.to_bytes(wstr));
+  std::vector<const std::string*> strings(C);
+  for (size_t i = 0; i < C; ++i) {
+    strings[i] = input_data + i;
+  }
+
+  if (!stopwords_.empty() || !wstopwords_.empty()) {
+    // The stopwords are compared in the case of the case action if there is one, so the strings are converted to
+    // the output while they're marked, rather than converted again once the stopwords are removed
+    const bool convert_while_marking = !is_case_sensitive_ && case_change_action_ != NONE;
+    std::vector<ConvertedBlock> converted(convert_while_marking ? (C + kStringBlockSize - 1) / kStringBlockSize : 0);
+
+    // Mark the stopwords in parallel, then keep the other strings in their order
+    std::vector<char> is_stopword(C, 0);
+    ORT_RETURN_IF_ERROR(ForEachStringBlock(
+        ctx->GetOperatorThreadPool(), strings.data(), C,
+        [&](size_t i, Utf8Converter& converter, std::wstring& wstr) {
+          if (is_case_sensitive_) {
+            is_stopword[i] = stopwords_.count(*strings[i]) != 0;
+            return true;
           }
-        }
-        ++first;
-      }
-      if (case_change_action_ == NONE) {
-        status = CopyCaseAction(filtered_orignal_strings.cbegin(), filtered_orignal_strings.cend(), ctx, locale, converter,
-                                N, filtered_orignal_strings.size(), NONE);
-      } else {
-        status = CopyCaseAction(filtered_cased_strings.begin(), filtered_cased_strings.end(), ctx, locale, converter,
-                                N, filtered_cased_strings.size(), NONE);
+          if (!FromUtf8(converter, *strings[i], wstr)) {
+            return false;
+          }
+          locale_->ChangeCase(compare_caseaction_, wstr);
+          is_stopword[i] = wstopwords_.count(wstr) != 0;
+          if (convert_while_marking) {
+            assert(compare_caseaction_ == case_change_action_);
+            ConvertedBlock& block = converted[i / kStringBlockSize];
+            if (is_stopword[i]) {
+              block.strings.Append(nullptr, 0);
+            } else {
+              ToUtf8(converter, wstr, block.utf8);
+              block.strings.Append(block.utf8);
+            }
+          }
+          return true;
+        }));
+
+    if (convert_while_marking) {
+      return CopyConverted(converted, is_stopword, ctx, N);
+    }
+
+    size_t kept = 0;
+    for (size_t i = 0; i < C; ++i) {
+      if (!is_stopword[i]) {
+        strings[kept++] = strings[i];
       }
-    } else {
-      // Nothing to filter. Copy input to output and change case if needed
-      status = CopyCaseAction(input_data, input_data + C, ctx, locale, converter, N, C, case_change_action_);
     }
+    strings.resize(kept);
   }
-  return status;
+
+  // Copy the strings to the output and change case if needed
+  return CopyCaseAction(strings, ctx, *locale_, N, case_change_action_);
 }
 }  // namespace onnxruntime
@@ -6,11 +6,16 @@
 #include "core/framework/op_kernel.h"
 
 #include <locale>
+#include <memory>
 #include <string>
 #include <unordered_set>
 
 namespace onnxruntime {
 
+namespace string_normalizer {
+class Locale;
+}  // namespace string_normalizer
+
 class StringNormalizer : public OpKernel {
  public:
   enum CaseAction {
@@ -20,7 +25,7 @@ class StringNormalizer : public OpKernel {
   };
 
   explicit StringNormalizer(const OpKernelInfo& info);
-  ~StringNormalizer() override = default;
+  ~StringNormalizer() override;
 
   Status Compute(OpKernelContext* ctx) const override;
 
@@ -28,7 +33,8 @@ class StringNormalizer : public OpKernel {
   bool is_case_sensitive_;
   CaseAction case_change_action_;
   CaseAction compare_caseaction_;  // used for case-insensitive compare
-  std::string locale_name_;
+  // constructed once, as constructing a locale is expensive, and used by the concurrent runs
+  std::unique_ptr<string_normalizer::Locale> locale_;
   // Either if these are populated but not both
   std::unordered_set<std::string> stopwords_;
   std::unordered_set<std::wstring> wstopwords_;
@@ -2,6 +2,12 @@
 // Licensed under the MIT License.
 
 #include "core/providers/cpu/reduction/reduction_ops.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "core/platform/threadpool.h"
 #include "core/providers/common.h"
 #include "core/util/math_cpuonly.h"
 using namespace std;
@@ -118,441 +124,567 @@ REGISTER_UNARY_ELEMENTWISE_KERNEL(ArgMax, 11);
 REGISTER_UNARY_ELEMENTWISE_VERSIONED_KERNEL(ArgMin, 1, 10);
 REGISTER_UNARY_ELEMENTWISE_KERNEL(ArgMin, 11);
 
-// When all reduce axises located at the tail of the dims, quite general cases, transpose and extra
-// copy could be skipped to improve performance, if required by check_no_transpose = true;
-// return value: true means transposedInputData is not created/copied, input tensor data could
-//               be direct use as row major matrix [block_size, blocks], where blocks is the
-//               size of each reduce.
-template <typename T>
-bool PrepareForReduce(OpKernelContext* ctx,
-                      std::vector<T>& transposedInputData,
-                      Tensor** reducedTensor,
-                      int64_t& block_size,
-                      int64_t& blocks,
-                      const std::vector<int64_t>& axes_,
-                      bool keepdims_,
-                      bool check_no_transpose = false) {
-  const auto* input_tensor_ptr = ctx->Input<Tensor>(0);
-  ORT_ENFORCE(input_tensor_ptr != nullptr);
-  const Tensor& input = *input_tensor_ptr;
-
-  size_t ndim = input.Shape().GetDims().size();
-  std::vector<int64_t> axes;
-  axes.reserve(axes_.size());
-  for (int64_t axis : axes_) {
-    axes.push_back(HandleNegativeAxis(axis, static_cast<int64_t>(ndim)));
-  }
-
-  if (axes.empty()) {
+namespace {
+
+// The input of a reduction with its dims collapsed into alternating runs of kept and reduced dims. Dims with a
+// value of 1 are dropped and adjacent dims of the same kind are merged, e.g. reducing an input of shape
+// {2, 3, 4, 1, 5} on axes {1, 2} gives the runs {2, 12, 5} where the second run is reduced.
+// The input is reduced in place by walking these runs, without transposing the reduced dims to the front.
+struct ReduceShape {
+  std::vector<int64_t> runs;
+  bool first_run_reduced = false;
+  int64_t output_size = 1;
+  int64_t reduce_size = 1;
+
+  bool IsReduced(size_t run) const { return first_run_reduced == (run % 2 == 0); }
+};
+
+// Computes the output shape and the collapsed input shape of a reduction on axes_ of input.
+Status PrepareForReduce(const Tensor& input,
+                        const std::vector<int64_t>& axes_,
+                        bool keepdims_,
+                        std::vector<int64_t>& reduced_dims,
+                        ReduceShape& reduce_shape) {
+  const auto& in_dims = input.Shape().GetDims();
+  const size_t ndim = in_dims.size();
+
+  std::vector<bool> keep_axis(ndim, true);
+  if (axes_.empty()) {
     // This is the default case for non-arg kind reductions. Reduce on all dimensions.
-    for (size_t i = 0; i < ndim; i++) {
-      axes.push_back(i);
-    }
-  }
-
-  std::sort(axes.begin(), axes.end());
-
-  // If all reduced axes are located at the tail of the input shape, then copy could be skipped is required
-  bool need_copy = true;
-  if (axes.size() <= ndim &&
-      axes.front() == static_cast<int64_t>(ndim - axes.size()) &&
-      axes.back() == static_cast<int64_t>(ndim) - 1) {
-    need_copy = false;
-  }
-
-  vector<bool> keep_axis(ndim, true);
-  for (auto i : axes) {
-    keep_axis[i] = false;
-  }
-
-  //transpose the input so that all to-be-reduced axes are at the head
-  vector<int64_t> transposed_axes(axes.begin(), axes.end());
-  for (size_t i = 0; i < ndim; ++i) {
-    if (keep_axis[i]) {
-      transposed_axes.push_back(i);
-    }
-  }
-
-  vector<int64_t> new_dims_(transposed_axes.size());
-  for (size_t i = 0; i < transposed_axes.size(); ++i) {
-    new_dims_[i] = input.Shape().GetDims().at(transposed_axes[i]);
-  }
-
-  int num_axes = static_cast<int>(transposed_axes.size());
-  auto in_dims = input.Shape().GetDims();
-
-  // Measure amount of contiguous data we can copy at once
-  int64_t blocksize = 1;
-  int n_shared_idxs = 0;
-  for (int i = num_axes - 1; i >= 0; --i) {
-    if (transposed_axes[i] == i) {
-      blocksize *= new_dims_[i];
-      ++n_shared_idxs;
-    } else {
-      break;
+    std::fill(keep_axis.begin(), keep_axis.end(), false);
+  } else {
+    for (int64_t axis : axes_) {
+      keep_axis[HandleNegativeAxis(axis, static_cast<int64_t>(ndim))] = false;
     }
   }
 
-  const T* from_data = input.template Data<T>();
-  size_t count = input.Shape().Size();
-
   //set to-be-reduced axes to one. squeeze is keepdims_ is false
-  int64_t first_dim = 1;
-  std::vector<int64_t> reduced_dims;
-  reduced_dims.reserve(in_dims.size());
+  reduced_dims.clear();
+  reduced_dims.reserve(ndim);
+  reduce_shape = ReduceShape();
 
-  for (size_t i = 0; i < in_dims.size(); i++) {
+  for (size_t i = 0; i < ndim; i++) {
     const auto in_dim = in_dims[i];
     if (keep_axis[i]) {
       reduced_dims.push_back(in_dim);
+      reduce_shape.output_size *= in_dim;
     } else {
-      first_dim *= in_dim;
+      reduce_shape.reduce_size *= in_dim;
       if (keepdims_) {
         reduced_dims.push_back(in_dim == 0 ? 0 : 1);
-      } else {
+      } else if (in_dim == 0) {
         // as we are reducing on this axis and not keeping a dim for it, we can't drop a dim value of 0.
         // e.g. if input was {3, 0, 2} and we reduced on axis 1 without keeping it, the output shape would be
         // {3, 2} which is invalid given the input was empty.
         // note that if we do keep the dim the output shape will have a 0 in it,
         // which is still valid for an empty tensor, so allow that.
-        ORT_ENFORCE(in_dim != 0,
-                    "Can't reduce on dim with value of 0 if 'keepdims' is false. "
-                    "Invalid output shape would be produced. input_shape:",
-                    input.Shape());
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                               "Can't reduce on dim with value of 0 if 'keepdims' is false. "
+                               "Invalid output shape would be produced. input_shape:",
+                               input.Shape());
       }
     }
+
+    if (in_dim == 1) {
+      continue;
+    }
+
+    const bool reduced = !keep_axis[i];
+    auto& runs = reduce_shape.runs;
+    if (runs.empty()) {
+      runs.push_back(in_dim);
+      reduce_shape.first_run_reduced = reduced;
+    } else if (reduce_shape.IsReduced(runs.size() - 1) == reduced) {
+      runs.back() *= in_dim;
+    } else {
+      runs.push_back(in_dim);
+    }
   }
 
-  *reducedTensor = ctx->Output(0, std::move(reduced_dims));
-  auto num_elements = input.Shape().Size();
+  return Status::OK();
+}
+
+// The aggregators define how the values reduced to one output are combined, in an accumulator of type AccType:
+//   Init() is the accumulator of no values.
+//   Aggregate(data, size, first_index) accumulates a contiguous range of values.
+//   UpdateBlock(acc, row, size, index) accumulates row[i] into acc[i] for a block of outputs.
+//   Merge(acc, other) combines two accumulators, where the values of other follow those of acc.
+//   Finalize(acc, reduce_size) computes the output from the accumulator of all reduce_size values.
+// index is the position of a value within the values reduced to an output, which is only used by ArgMax/ArgMin.
+template <typename T>
+struct ReduceAggregatorSum {
+  using AccType = T;
+  using OutputType = T;
 
-  // edge case. one or more input dims with value of 0.
-  if (num_elements == 0) {
-    block_size = blocks = 0;
-    return true;
+  static AccType Init() { return 0; }
+  static AccType Aggregate(const T* data, int64_t size, int64_t /*first_index*/) {
+    return ConstEigenVectorMap<T>(data, size).sum();
   }
+  static void UpdateBlock(AccType* acc, const T* row, int64_t size, int64_t /*index*/) {
+    EigenVectorArrayMap<T>(acc, size) += ConstEigenVectorArrayMap<T>(row, size);
+  }
+  static void Merge(AccType& acc, const AccType& other) { acc += other; }
+  static OutputType Finalize(const AccType& acc, int64_t /*reduce_size*/) { return acc; }
+};
 
-  block_size = num_elements / first_dim;
-  blocks = first_dim;
+template <typename T>
+struct ReduceAggregatorMean : ReduceAggregatorSum<T> {
+  static T Finalize(const T& acc, int64_t reduce_size) { return acc / static_cast<T>(reduce_size); }
+};
 
-  if (!need_copy && check_no_transpose) {
-    return true;
+template <typename T>
+struct ReduceAggregatorLogSum : ReduceAggregatorSum<T> {
+  static T Finalize(const T& acc, int64_t /*reduce_size*/) { return static_cast<T>(std::log(acc)); }
+};
+
+template <typename T>
+struct ReduceAggregatorL1 : ReduceAggregatorSum<T> {
+  static T Aggregate(const T* data, int64_t size, int64_t /*first_index*/) {
+    return ConstEigenVectorArrayMap<T>(data, size).abs().sum();
   }
+  static void UpdateBlock(T* acc, const T* row, int64_t size, int64_t /*index*/) {
+    EigenVectorArrayMap<T>(acc, size) += ConstEigenVectorArrayMap<T>(row, size).abs();
+  }
+};
 
-  transposedInputData.resize(input.Shape().Size(), 0);
-  T* to_data = &transposedInputData[0];
-  if (num_axes < 2 || n_shared_idxs == num_axes) {
-    memcpy(to_data, from_data, count * sizeof(T));
-    return false;
+template <typename T>
+struct ReduceAggregatorSumSquare : ReduceAggregatorSum<T> {
+  static T Aggregate(const T* data, int64_t size, int64_t /*first_index*/) {
+    return ConstEigenVectorMap<T>(data, size).squaredNorm();
+  }
+  static void UpdateBlock(T* acc, const T* row, int64_t size, int64_t /*index*/) {
+    EigenVectorArrayMap<T>(acc, size) += ConstEigenVectorArrayMap<T>(row, size).square();
   }
+};
 
-  int itr_axes = num_axes - n_shared_idxs;
+template <typename T>
+struct ReduceAggregatorL2 : ReduceAggregatorSumSquare<T> {
+  static T Finalize(const T& acc, int64_t /*reduce_size*/) { return static_cast<T>(std::sqrt(acc)); }
+};
 
-  // Calculate strides
-  std::vector<int64_t> stride_x(itr_axes, 0);
-  for (size_t i = 0; static_cast<int>(i) < itr_axes; i++) {
-    stride_x[i] = 1;
-    for (size_t j = transposed_axes[i] + 1; static_cast<int>(j) < itr_axes; j++) {
-      stride_x[i] *= in_dims[j];
-    }
+template <typename T>
+struct ReduceAggregatorProd : ReduceAggregatorSum<T> {
+  static T Init() { return 1; }
+  static T Aggregate(const T* data, int64_t size, int64_t /*first_index*/) {
+    return ConstEigenVectorMap<T>(data, size).prod();
   }
+  static void UpdateBlock(T* acc, const T* row, int64_t size, int64_t /*index*/) {
+    EigenVectorArrayMap<T>(acc, size) *= ConstEigenVectorArrayMap<T>(row, size);
+  }
+  static void Merge(T& acc, const T& other) { acc *= other; }
+};
 
-  std::vector<int64_t> itr_idxs(itr_axes, 0);
+// the lowest value of T, which is -infinity for floating point types so that it is the maximum of only -infinity
+template <typename T>
+constexpr T LowestValue() {
+  return std::numeric_limits<T>::has_infinity ? -std::numeric_limits<T>::infinity()
+                                              : std::numeric_limits<T>::lowest();
+}
 
-  // Branch here to avoid branching within the loop
-  if (blocksize > 1) {
-    for (size_t index = 0; index < (count / blocksize); index++) {
-      int64_t from_index = 0;
-      for (int i = 0; i < itr_axes; ++i) {
-        from_index += stride_x[i] * itr_idxs[i];
-      }
+template <typename T>
+constexpr T HighestValue() {
+  return std::numeric_limits<T>::has_infinity ? std::numeric_limits<T>::infinity()
+                                              : std::numeric_limits<T>::max();
+}
 
-      memcpy(
-          to_data + blocksize * index,
-          from_data + blocksize * from_index,
-          blocksize * sizeof(T));
+template <typename T>
+struct ReduceAggregatorMax : ReduceAggregatorSum<T> {
+  static T Init() { return LowestValue<T>(); }
+  static T Aggregate(const T* data, int64_t size, int64_t /*first_index*/) {
+    return ConstEigenVectorMap<T>(data, size).maxCoeff();
+  }
+  static void UpdateBlock(T* acc, const T* row, int64_t size, int64_t /*index*/) {
+    EigenVectorArrayMap<T> acc_block(acc, size);
+    acc_block = acc_block.max(ConstEigenVectorArrayMap<T>(row, size));
+  }
+  static void Merge(T& acc, const T& other) { acc = std::max(acc, other); }
+};
 
-      ++itr_idxs[itr_axes - 1];
-      for (int i = itr_axes - 1; i >= 1; --i) {
-        auto expected_dim = new_dims_[i];
-        if (itr_idxs[i] < expected_dim) {
-          break;
-        }
-        itr_idxs[i] %= expected_dim;
-        ++itr_idxs[i - 1];
-      }
+template <typename T>
+struct ReduceAggregatorMin : ReduceAggregatorSum<T> {
+  static T Init() { return HighestValue<T>(); }
+  static T Aggregate(const T* data, int64_t size, int64_t /*first_index*/) {
+    return ConstEigenVectorMap<T>(data, size).minCoeff();
+  }
+  static void UpdateBlock(T* acc, const T* row, int64_t size, int64_t /*index*/) {
+    EigenVectorArrayMap<T> acc_block(acc, size);
+    acc_block = acc_block.min(ConstEigenVectorArrayMap<T>(row, size));
+  }
+  static void Merge(T& acc, const T& other) { acc = std::min(acc, other); }
+};
+
+// keeps the maximum seen so far and the sum of the exponentials of the values minus that maximum, so that the
+// values are only read once
+template <typename T>
+struct ReduceAggregatorLogSumExp {
+  struct AccType {
+    T max;
+    T sum;
+  };
+  using OutputType = T;
+
+  static AccType Init() { return {std::numeric_limits<T>::lowest(), 0}; }
+  static AccType Aggregate(const T* data, int64_t size, int64_t /*first_index*/) {
+    AccType acc{std::numeric_limits<T>::lowest(), 0};
+    for (int64_t i = 0; i < size; ++i) {
+      acc.max = std::max(acc.max, data[i]);
     }
-  } else {
-    for (size_t index = 0; index < count; index++) {
-      int64_t from_index = 0;
-      for (int i = 0; i < itr_axes; ++i) {
-        from_index += stride_x[i] * itr_idxs[i];
+    for (int64_t i = 0; i < size; ++i) {
+      acc.sum += static_cast<T>(std::exp(data[i] - acc.max));
+    }
+    return acc;
+  }
+  static void UpdateBlock(AccType* acc, const T* row, int64_t size, int64_t /*index*/) {
+    for (int64_t i = 0; i < size; ++i) {
+      Merge(acc[i], {row[i], 1});
+    }
+  }
+  static void Merge(AccType& acc, const AccType& other) {
+    if (other.max > acc.max) {
+      acc.sum = static_cast<T>(acc.sum * std::exp(acc.max - other.max)) + other.sum;
+      acc.max = other.max;
+    } else {
+      acc.sum += static_cast<T>(other.sum * std::exp(other.max - acc.max));
+    }
+  }
+  static OutputType Finalize(const AccType& acc, int64_t /*reduce_size*/) {
+    return static_cast<T>(std::log(acc.sum) + acc.max);
+  }
+};
+
+// ArgMax and ArgMin return the index of the first occurrence of the maximum or minimum
+template <typename T, bool is_max>
+struct ReduceAggregatorArgMinMax {
+  struct AccType {
+    T value;
+    int64_t index;
+  };
+  using OutputType = int64_t;
+
+  static bool IsBetter(T value, T current) { return is_max ? value > current : value < current; }
+
+  static AccType Init() { return {is_max ? LowestValue<T>() : HighestValue<T>(), 0}; }
+  static AccType Aggregate(const T* data, int64_t size, int64_t first_index) {
+    AccType acc = Init();
+    acc.index = first_index;
+    for (int64_t i = 0; i < size; ++i) {
+      if (IsBetter(data[i], acc.value)) {
+        acc = {data[i], first_index + i};
       }
-
-      *(to_data + index) = *(from_data + from_index);
-
-      ++itr_idxs[itr_axes - 1];
-      for (int i = itr_axes - 1; i >= 1; --i) {
-        auto expected_dim = new_dims_[i];
-        if (itr_idxs[i] < expected_dim) {
-          break;
-        }
-        itr_idxs[i] %= expected_dim;
-        ++itr_idxs[i - 1];
+    }
+    return acc;
+  }
+  static void UpdateBlock(AccType* acc, const T* row, int64_t size, int64_t index) {
+    for (int64_t i = 0; i < size; ++i) {
+      if (IsBetter(row[i], acc[i].value)) {
+        acc[i] = {row[i], index};
       }
     }
   }
-  return false;
-}
+  static void Merge(AccType& acc, const AccType& other) {
+    if (IsBetter(other.value, acc.value)) {
+      acc = other;
+    }
+  }
+  static OutputType Finalize(const AccType& acc, int64_t /*reduce_size*/) { return acc.index; }
+};
 
 template <typename T>
-Status ReduceL1<T>::Compute(OpKernelContext* ctx) const {
-  std::vector<T> transposedInputData;
-  int64_t block_size;
-  int64_t blocks;
-  Tensor* reduced;
-  PrepareForReduce<T>(ctx, transposedInputData, &reduced, block_size, blocks, axes_, keepdims_);
+using ReduceAggregatorArgMax = ReduceAggregatorArgMinMax<T, true>;
 
-  T* output_data = reduced->template MutableData<T>();
+template <typename T>
+using ReduceAggregatorArgMin = ReduceAggregatorArgMinMax<T, false>;
 
-  EigenVectorMap<T> out_vec(output_data, block_size);
-  out_vec = ConstEigenMatrixMap<T>(&transposedInputData[0], block_size, blocks).cwiseAbs().rowwise().sum();
+// rough number of cycles to accumulate one value
+constexpr double kReduceCostPerValue = 1.0;
 
-  return Status::OK();
-}
+// The values reduced to an output are split into parts reduced in parallel if there are fewer outputs than
+// threads, so that e.g. the sum of a whole tensor still uses the thread pool. Parts are at least this long.
+constexpr int64_t kMinReducePartSize = 16384;
 
-template <typename T>
-Status ReduceL2<T>::Compute(OpKernelContext* ctx) const {
-  std::vector<T> transposedInputData;
-  int64_t block_size;
-  int64_t blocks;
-  Tensor* reduced;
-  PrepareForReduce<T>(ctx, transposedInputData, &reduced, block_size, blocks, axes_, keepdims_);
+// number of columns of a block of outputs accumulated together when reducing rows
+constexpr int64_t kReduceColumnBlock = 256;
 
-  T* output_data = reduced->template MutableData<T>();
+int64_t NumReduceParts(concurrency::ThreadPool* tp, int64_t num_tasks, int64_t reduce_size) {
+  if (tp == nullptr) {
+    return 1;
+  }
 
-  EigenVectorMap<T> out_vec(output_data, block_size);
-  out_vec = ConstEigenMatrixMap<T>(&transposedInputData[0], block_size, blocks).rowwise().norm();
+  const int64_t num_threads = static_cast<int64_t>(tp->NumThreads()) + 1;
+  if (num_tasks >= num_threads) {
+    return 1;
+  }
 
-  return Status::OK();
+  const int64_t num_parts = (num_threads + num_tasks - 1) / num_tasks;
+  return std::max<int64_t>(1, std::min(num_parts, reduce_size / kMinReducePartSize));
 }
 
-template <typename T>
-Status ReduceLogSum<T>::Compute(OpKernelContext* ctx) const {
-  std::vector<T> transposedInputData;
-  int64_t block_size;
-  int64_t blocks;
-  Tensor* reduced;
-  PrepareForReduce<T>(ctx, transposedInputData, &reduced, block_size, blocks, axes_, keepdims_);
-
-  T* output_data = reduced->template MutableData<T>();
-
-  EigenVectorMap<T> out_vec(output_data, block_size);
-  out_vec = ConstEigenMatrixMap<T>(&transposedInputData[0], block_size, blocks).rowwise().sum();
-  for (int j = 0; j < block_size; ++j) {
-    *(output_data) = static_cast<T>(std::log(*(output_data)));
-    ++output_data;
+// Reduces the input viewed as a [K, R] matrix over its rows, i.e. the reduced axes are the trailing ones.
+template <typename T, typename Aggregator>
+void ReduceKR(const T* input, int64_t K, int64_t R,
+              typename Aggregator::OutputType* output, concurrency::ThreadPool* tp) {
+  using AccType = typename Aggregator::AccType;
+
+  const int64_t num_parts = NumReduceParts(tp, K, R);
+  if (num_parts == 1) {
+    concurrency::ThreadPool::TryParallelFor(
+        tp, static_cast<std::ptrdiff_t>(K), kReduceCostPerValue * static_cast<double>(R),
+        [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+          for (std::ptrdiff_t k = first; k < last; ++k) {
+            output[k] = Aggregator::Finalize(Aggregator::Aggregate(input + k * R, R, 0), R);
+          }
+        });
+    return;
   }
 
-  return Status::OK();
-}
+  const int64_t part_size = (R + num_parts - 1) / num_parts;
+  std::vector<AccType> partials(static_cast<size_t>(K * num_parts));
+  concurrency::ThreadPool::TryParallelFor(
+      tp, static_cast<std::ptrdiff_t>(K * num_parts), kReduceCostPerValue * static_cast<double>(part_size),
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        for (std::ptrdiff_t task = first; task < last; ++task) {
+          const int64_t k = task / num_parts;
+          const int64_t start = (task % num_parts) * part_size;
+          const int64_t size = std::min(part_size, R - start);
+          partials[task] = size > 0 ? Aggregator::Aggregate(input + k * R + start, size, start)
+                                    : Aggregator::Init();
+        }
+      });
 
-template <typename T>
-Status ReduceLogSumExp<T>::Compute(OpKernelContext* ctx) const {
-  std::vector<T> transposedInputData;
-  int64_t block_size;
-  int64_t blocks;
-  Tensor* reduced;
-  PrepareForReduce<T>(ctx, transposedInputData, &reduced, block_size, blocks, axes_, keepdims_);
-
-  T* output_data = reduced->template MutableData<T>();
-
-  for (int j = 0; j < block_size; ++j) {
-    T max_value = std::numeric_limits<T>::lowest();
-    for (int i = 0; i < blocks; ++i) {
-      max_value = std::max(max_value, transposedInputData[i * block_size + j]);
-    }
-    T scaled_exp_sum = 0;
-    for (int i = 0; i < blocks; ++i) {
-      scaled_exp_sum += static_cast<T>(std::exp(transposedInputData[i * block_size + j] - max_value));
+  for (int64_t k = 0; k < K; ++k) {
+    AccType acc = partials[k * num_parts];
+    for (int64_t part = 1; part < num_parts; ++part) {
+      Aggregator::Merge(acc, partials[k * num_parts + part]);
     }
-    *(output_data++) = static_cast<T>(std::log(scaled_exp_sum) + max_value);
+    output[k] = Aggregator::Finalize(acc, R);
   }
-  return Status::OK();
 }
 
-template <typename T>
-Status ReduceMax<T>::Compute(OpKernelContext* ctx) const {
-  std::vector<T> transposedInputData;
-  int64_t block_size;
-  int64_t blocks;
-  Tensor* reduced;
-  bool no_transpose = PrepareForReduce<T>(ctx, transposedInputData, &reduced, block_size, blocks, axes_, keepdims_, true);
-
-  T* output_data = reduced->template MutableData<T>();
+// Reduces the input viewed as a [K0, R, K1] tensor over its middle dim, which covers the leading (K0 == 1) and
+// interleaved reduced axes. The rows of K1 values are accumulated a block of columns at a time.
+template <typename T, typename Aggregator>
+void ReduceKRK(const T* input, int64_t K0, int64_t R, int64_t K1,
+               typename Aggregator::OutputType* output, concurrency::ThreadPool* tp) {
+  using AccType = typename Aggregator::AccType;
+
+  const int64_t num_column_blocks = (K1 + kReduceColumnBlock - 1) / kReduceColumnBlock;
+  const int64_t num_blocks = K0 * num_column_blocks;
+  const int64_t num_parts = NumReduceParts(tp, num_blocks, R);
+  const int64_t part_size = (R + num_parts - 1) / num_parts;
+
+  // each output has num_parts accumulators if the rows are split into parts
+  std::vector<AccType> partials;
+  if (num_parts > 1) {
+    partials.resize(static_cast<size_t>(K0 * K1 * num_parts));
+  }
 
-  if (no_transpose) {
-    const T* input_data = ctx->Input<Tensor>(0)->template Data<T>();
+  concurrency::ThreadPool::TryParallelFor(
+      tp, static_cast<std::ptrdiff_t>(num_blocks * num_parts),
+      kReduceCostPerValue * static_cast<double>(part_size * std::min(K1, kReduceColumnBlock)),
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        AccType acc[kReduceColumnBlock];
+        for (std::ptrdiff_t task = first; task < last; ++task) {
+          const int64_t part = task % num_parts;
+          const int64_t block = task / num_parts;
+          const int64_t k0 = block / num_column_blocks;
+          const int64_t column = (block % num_column_blocks) * kReduceColumnBlock;
+          const int64_t columns = std::min(kReduceColumnBlock, K1 - column);
+          const int64_t start = part * part_size;
+          const int64_t end = std::min(R, start + part_size);
+
+          std::fill_n(acc, columns, Aggregator::Init());
+          const T* row = input + (k0 * R + start) * K1 + column;
+          for (int64_t r = start; r < end; ++r) {
+            Aggregator::UpdateBlock(acc, row, columns, r);
+            row += K1;
+          }
+
+          const int64_t output_index = k0 * K1 + column;
+          if (num_parts == 1) {
+            for (int64_t i = 0; i < columns; ++i) {
+              output[output_index + i] = Aggregator::Finalize(acc[i], R);
+            }
+          } else {
+            for (int64_t i = 0; i < columns; ++i) {
+              partials[(output_index + i) * num_parts + part] = acc[i];
+            }
+          }
+        }
+      });
 
-    for (int64_t i = 0; i < block_size; ++i) {
-      output_data[i] = ConstEigenVectorMap<T>(input_data + (i * blocks), blocks).maxCoeff();
+  if (num_parts > 1) {
+    for (int64_t i = 0, end = K0 * K1; i < end; ++i) {
+      AccType acc = partials[i * num_parts];
+      for (int64_t part = 1; part < num_parts; ++part) {
+        Aggregator::Merge(acc, partials[i * num_parts + part]);
+      }
+      output[i] = Aggregator::Finalize(acc, R);
     }
-  } else {
-    EigenVectorMap<T> out_vec(output_data, block_size);
-    out_vec = ConstEigenMatrixMap<T>(&transposedInputData[0], block_size, blocks).rowwise().maxCoeff();
   }
-
-  return Status::OK();
 }
 
-template <typename T>
-Status ReduceMean<T>::Compute(OpKernelContext* ctx) const {
-  std::vector<T> transposedInputData;
-  int64_t block_size;
-  int64_t blocks;
-  Tensor* reduced;
-  bool no_transpose = PrepareForReduce<T>(ctx, transposedInputData, &reduced, block_size, blocks, axes_, keepdims_, true);
-
-  T* output_data = reduced->template MutableData<T>();
-
-  if (no_transpose) {
-    const T* input_data = ctx->Input<Tensor>(0)->template Data<T>();
-
-#ifdef USE_OPENMP
-#pragma omp parallel for
-#endif
-    for (int64_t i = 0; i < block_size; ++i) {
-      output_data[i] = ConstEigenVectorMap<T>(input_data + (i * blocks), blocks).mean();
+// Reduces any other pattern of kept and reduced runs, e.g. [R, K, R]. The offsets of the values reduced to an
+// output are the same for every output, relative to the offset of its first value, and are computed once. A trailing
+// reduced run is contiguous and is aggregated as a whole.
+template <typename T, typename Aggregator>
+void ReduceGeneric(const T* input, const ReduceShape& shape,
+                   typename Aggregator::OutputType* output, concurrency::ThreadPool* tp) {
+  using AccType = typename Aggregator::AccType;
+
+  const size_t num_runs = shape.runs.size();
+  std::vector<int64_t> strides(num_runs);
+  int64_t stride = 1;
+  for (size_t i = num_runs; i-- > 0;) {
+    strides[i] = stride;
+    stride *= shape.runs[i];
+  }
+
+  const bool last_run_reduced = shape.IsReduced(num_runs - 1);
+  const int64_t inner_size = last_run_reduced ? shape.runs.back() : 1;
+  const size_t num_outer_runs = last_run_reduced ? num_runs - 1 : num_runs;
+
+  std::vector<int64_t> reduce_offsets{0};
+  reduce_offsets.reserve(static_cast<size_t>(shape.reduce_size / inner_size));
+  for (size_t i = 0; i < num_outer_runs; ++i) {
+    if (!shape.IsReduced(i)) {
+      continue;
+    }
+
+    const size_t count = reduce_offsets.size();
+    for (int64_t j = 1; j < shape.runs[i]; ++j) {
+      for (size_t offset = 0; offset < count; ++offset) {
+        reduce_offsets.push_back(reduce_offsets[offset] + j * strides[i]);
+      }
     }
-  } else {
-    EigenVectorMap<T> out_vec(output_data, block_size);
-    out_vec = ConstEigenMatrixMap<T>(&transposedInputData[0], block_size, blocks).rowwise().mean();
   }
 
-  return Status::OK();
+  // keep the offsets in increasing order, which is the order of the indices of the values
+  std::sort(reduce_offsets.begin(), reduce_offsets.end());
+
+  concurrency::ThreadPool::TryParallelFor(
+      tp, static_cast<std::ptrdiff_t>(shape.output_size),
+      kReduceCostPerValue * static_cast<double>(shape.reduce_size),
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        for (std::ptrdiff_t out = first; out < last; ++out) {
+          // offset of the first value of the output, from its index in each kept run
+          int64_t base = 0;
+          int64_t remaining = out;
+          for (size_t i = num_runs; i-- > 0;) {
+            if (!shape.IsReduced(i)) {
+              base += (remaining % shape.runs[i]) * strides[i];
+              remaining /= shape.runs[i];
+            }
+          }
+
+          AccType acc = Aggregator::Init();
+          int64_t index = 0;
+          for (int64_t offset : reduce_offsets) {
+            Aggregator::Merge(acc, Aggregator::Aggregate(input + base + offset, inner_size, index));
+            index += inner_size;
+          }
+
+          output[out] = Aggregator::Finalize(acc, shape.reduce_size);
+        }
+      });
 }
 
-template <typename T>
-Status ReduceMin<T>::Compute(OpKernelContext* ctx) const {
-  std::vector<T> transposedInputData;
-  int64_t block_size;
-  int64_t blocks;
-  Tensor* reduced;
-  bool no_transpose = PrepareForReduce<T>(ctx, transposedInputData, &reduced, block_size, blocks, axes_, keepdims_, true);
+template <typename T, typename Aggregator>
+Status Reduce(OpKernelContext* ctx, const std::vector<int64_t>& axes, bool keepdims) {
+  const auto* input_tensor_ptr = ctx->Input<Tensor>(0);
+  ORT_ENFORCE(input_tensor_ptr != nullptr);
+  const Tensor& input = *input_tensor_ptr;
 
-  T* output_data = reduced->template MutableData<T>();
+  std::vector<int64_t> reduced_dims;
+  ReduceShape shape;
+  ORT_RETURN_IF_ERROR(PrepareForReduce(input, axes, keepdims, reduced_dims, shape));
 
-  if (no_transpose) {
-    const T* input_data = ctx->Input<Tensor>(0)->template Data<T>();
+  Tensor* reduced = ctx->Output(0, reduced_dims);
 
-    for (int64_t i = 0; i < block_size; ++i) {
-      output_data[i] = ConstEigenVectorMap<T>(input_data + (i * blocks), blocks).minCoeff();
-    }
+  // edge case. one or more input dims with value of 0, so the output is empty as well.
+  if (input.Shape().Size() == 0) {
+    return Status::OK();
+  }
+
+  const T* input_data = input.template Data<T>();
+  auto* output_data = reduced->template MutableData<typename Aggregator::OutputType>();
+  concurrency::ThreadPool* tp = ctx->GetOperatorThreadPool();
+
+  const auto& runs = shape.runs;
+  if (runs.size() <= 1 || (runs.size() == 2 && !shape.first_run_reduced)) {
+    // the reduced axes are the trailing ones, or all of them, or only have a dim value of 1
+    ReduceKR<T, Aggregator>(input_data, shape.output_size, shape.reduce_size, output_data, tp);
+  } else if (runs.size() == 2) {
+    // the reduced axes are the leading ones
+    ReduceKRK<T, Aggregator>(input_data, 1, runs[0], runs[1], output_data, tp);
+  } else if (runs.size() == 3 && !shape.first_run_reduced) {
+    ReduceKRK<T, Aggregator>(input_data, runs[0], runs[1], runs[2], output_data, tp);
   } else {
-    EigenVectorMap<T> out_vec(output_data, block_size);
-    out_vec = ConstEigenMatrixMap<T>(&transposedInputData[0], block_size, blocks).rowwise().minCoeff();
+    ReduceGeneric<T, Aggregator>(input_data, shape, output_data, tp);
   }
 
   return Status::OK();
 }
 
+}  // namespace
+
 template <typename T>
-Status ReduceProd<T>::Compute(OpKernelContext* ctx) const {
-  std::vector<T> transposedInputData;
-  int64_t block_size;
-  int64_t blocks;
-  Tensor* reduced;
-  PrepareForReduce<T>(ctx, transposedInputData, &reduced, block_size, blocks, axes_, keepdims_);
+Status ReduceL1<T>::Compute(OpKernelContext* ctx) const {
+  return Reduce<T, ReduceAggregatorL1<T>>(ctx, axes_, keepdims_);
+}
 
-  T* output_data = reduced->template MutableData<T>();
+template <typename T>
+Status ReduceL2<T>::Compute(OpKernelContext* ctx) const {
+  return Reduce<T, ReduceAggregatorL2<T>>(ctx, axes_, keepdims_);
+}
 
-  EigenVectorMap<T> out_vec(output_data, block_size);
-  out_vec = ConstEigenMatrixMap<T>(&transposedInputData[0], block_size, blocks).rowwise().prod();
+template <typename T>
+Status ReduceLogSum<T>::Compute(OpKernelContext* ctx) const {
+  return Reduce<T, ReduceAggregatorLogSum<T>>(ctx, axes_, keepdims_);
+}
 
-  return Status::OK();
+template <typename T>
+Status ReduceLogSumExp<T>::Compute(OpKernelContext* ctx) const {
+  return Reduce<T, ReduceAggregatorLogSumExp<T>>(ctx, axes_, keepdims_);
 }
 
 template <typename T>
-Status ReduceSum<T>::Compute(OpKernelContext* ctx) const {
-  std::vector<T> transposedInputData;
-  int64_t block_size;
-  int64_t blocks;
-  Tensor* reduced;
-  bool no_transpose = PrepareForReduce<T>(ctx, transposedInputData, &reduced, block_size, blocks, axes_, keepdims_, true);
-
-  T* output_data = reduced->template MutableData<T>();
-
-  if (no_transpose) {
-    const T* input_data = ctx->Input<Tensor>(0)->template Data<T>();
-
-#ifdef USE_OPENMP
-#pragma omp parallel for
-#endif
-    for (int64_t i = 0; i < block_size; ++i) {
-      output_data[i] = ConstEigenVectorMap<T>(input_data + (i * blocks), blocks).sum();
-    }
-  } else {
-    EigenVectorMap<T> out_vec(output_data, block_size);
-    out_vec = ConstEigenMatrixMap<T>(&transposedInputData[0], block_size, blocks).rowwise().sum();
-  }
+Status ReduceMax<T>::Compute(OpKernelContext* ctx) const {
+  return Reduce<T, ReduceAggregatorMax<T>>(ctx, axes_, keepdims_);
+}
 
-  return Status::OK();
+template <typename T>
+Status ReduceMean<T>::Compute(OpKernelContext* ctx) const {
+  return Reduce<T, ReduceAggregatorMean<T>>(ctx, axes_, keepdims_);
 }
 
 template <typename T>
-Status ReduceSumSquare<T>::Compute(OpKernelContext* ctx) const {
-  std::vector<T> transposedInputData;
-  int64_t block_size;
-  int64_t blocks;
-  Tensor* reduced;
-  PrepareForReduce<T>(ctx, transposedInputData, &reduced, block_size, blocks, axes_, keepdims_);
+Status ReduceMin<T>::Compute(OpKernelContext* ctx) const {
+  return Reduce<T, ReduceAggregatorMin<T>>(ctx, axes_, keepdims_);
+}
 
-  T* output_data = reduced->template MutableData<T>();
+template <typename T>
+Status ReduceProd<T>::Compute(OpKernelContext* ctx) const {
+  return Reduce<T, ReduceAggregatorProd<T>>(ctx, axes_, keepdims_);
+}
 
-  EigenVectorMap<T> out_vec(output_data, block_size);
-  out_vec = ConstEigenMatrixMap<T>(&transposedInputData[0], block_size, blocks).rowwise().squaredNorm();
+template <typename T>
+Status ReduceSum<T>::Compute(OpKernelContext* ctx) const {
+  return Reduce<T, ReduceAggregatorSum<T>>(ctx, axes_, keepdims_);
+}
 
-  return Status::OK();
+template <typename T>
+Status ReduceSumSquare<T>::Compute(OpKernelContext* ctx) const {
+  return Reduce<T, ReduceAggregatorSumSquare<T>>(ctx, axes_, keepdims_);
 }
 
 template <typename T>
 Status ArgMax<T>::Compute(OpKernelContext* ctx) const {
-  std::vector<T> transposedInputData;
-  int64_t block_size;
-  int64_t blocks;
-  Tensor* reduced;
-  PrepareForReduce<T>(ctx, transposedInputData, &reduced, block_size, blocks, axes_, keepdims_);
-
-  auto* output_data = reduced->template MutableData<int64_t>();
-
-  Eigen::MatrixXf::Index maxIndex;
-  auto matrixData = ConstEigenMatrixMap<T>(&transposedInputData[0], block_size, blocks);
-  for (int i = 0; i < block_size; ++i) {
-    matrixData.row(i).maxCoeff(&maxIndex);
-    *(output_data++) = maxIndex;
-  }
-
-  return Status::OK();
+  return Reduce<T, ReduceAggregatorArgMax<T>>(ctx, axes_, keepdims_);
 }
 
 template <typename T>
 Status ArgMin<T>::Compute(OpKernelContext* ctx) const {
-  std::vector<T> transposedInputData;
-  int64_t block_size;
-  int64_t blocks;
-  Tensor* reduced;
-  PrepareForReduce<T>(ctx, transposedInputData, &reduced, block_size, blocks, axes_, keepdims_);
-
-  auto* output_data = reduced->template MutableData<int64_t>();
-
-  Eigen::MatrixXf::Index minIndex;
-  auto matrixData = ConstEigenMatrixMap<T>(&transposedInputData[0], block_size, blocks);
-  for (int i = 0; i < block_size; ++i) {
-    matrixData.row(i).minCoeff(&minIndex);
-    *(output_data++) = minIndex;
-  }
-
-  return Status::OK();
+  return Reduce<T, ReduceAggregatorArgMin<T>>(ctx, axes_, keepdims_);
 }
 
 }  // namespace onnxruntime
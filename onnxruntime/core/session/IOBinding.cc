@@ -28,6 +28,7 @@ common::Status IOBinding::BindInput(const std::string& name, const OrtValue& ml_
     } else {
       feed_names_.push_back(name);
       feeds_.push_back(value);
+      prepared_run_.reset();
     }
   };
 
@@ -77,11 +78,79 @@ common::Status IOBinding::BindOutput(const std::string& name, const OrtValue& ml
   auto rc = Contains(output_names_, name);
   if (rc.first) {
     outputs_[rc.second] = ml_value;
+    output_allocators_[rc.second] = nullptr;
     return Status::OK();
   }
 
   output_names_.push_back(name);
   outputs_.push_back(ml_value);
+  output_allocators_.push_back(nullptr);
+  prepared_run_.reset();
+  return Status::OK();
+}
+
+common::Status IOBinding::BindOutput(const std::string& name, const OrtMemoryInfo& memory_info) {
+  auto allocator = session_state_.GetExecutionProviders().GetAllocator(memory_info);
+  if (allocator == nullptr) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "The session has no allocator for output '", name,
+                           "' bound to ", memory_info.ToString());
+  }
+
+  auto rc = Contains(output_names_, name);
+  if (rc.first) {
+    outputs_[rc.second] = OrtValue();
+    output_allocators_[rc.second] = allocator;
+    return Status::OK();
+  }
+
+  output_names_.push_back(name);
+  outputs_.emplace_back();
+  output_allocators_.push_back(allocator);
+  prepared_run_.reset();
+  return Status::OK();
+}
+
+void IOBinding::ClearInputs() {
+  feed_names_.clear();
+  feeds_.clear();
+  prepared_run_.reset();
+}
+
+void IOBinding::ClearOutputs() {
+  output_names_.clear();
+  outputs_.clear();
+  output_allocators_.clear();
+  prepared_run_.reset();
+}
+
+void IOBinding::ResetDeviceOutputs() {
+  // the previous values aren't reused as the shapes of the outputs may change between runs
+  for (size_t i = 0; i < outputs_.size(); ++i) {
+    if (output_allocators_[i] != nullptr) {
+      outputs_[i] = OrtValue();
+    }
+  }
+}
+
+common::Status IOBinding::CopyOutputsToDevices() {
+  for (size_t i = 0; i < outputs_.size(); ++i) {
+    const auto& allocator = output_allocators_[i];
+    if (allocator == nullptr || !outputs_[i].IsTensor()) {
+      continue;
+    }
+
+    const auto& fetched_tensor = outputs_[i].Get<Tensor>();
+    if (fetched_tensor.Location().device == allocator->Info().device) {
+      continue;
+    }
+
+    auto p_tensor = onnxruntime::make_unique<Tensor>(fetched_tensor.DataType(), fetched_tensor.Shape(), allocator);
+    ORT_RETURN_IF_ERROR(session_state_.GetDataTransferMgr().CopyTensor(fetched_tensor, *p_tensor));
+
+    auto ml_tensor = DataTypeImpl::GetType<Tensor>();
+    outputs_[i].Init(p_tensor.release(), ml_tensor, ml_tensor->GetDeleteFunc());
+  }
+
   return Status::OK();
 }
 
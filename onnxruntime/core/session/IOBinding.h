@@ -63,6 +63,18 @@ class IOBinding {
     */
   common::Status BindOutput(const std::string& name, const OrtValue& ml_value);
 
+  /**
+    * Binds an output that each Run allocates on the device of memory_info. If the run produces the output on
+    * another device it is copied to that device. The session must have an allocator for the device.
+    */
+  common::Status BindOutput(const std::string& name, const OrtMemoryInfo& memory_info);
+
+  /**
+    * Removes all the bound inputs or outputs so that the binding can be used with other names.
+    */
+  void ClearInputs();
+  void ClearOutputs();
+
   /**
     * This simply collects the outputs obtained after calling Run() inside the @param outputs.
     */
@@ -83,11 +95,21 @@ class IOBinding {
   friend InferenceSession;
 
   IOBinding(const SessionState& session_state);
+
+  // called by InferenceSession::Run before and after the execution for the outputs bound to a device
+  void ResetDeviceOutputs();
+  common::Status CopyOutputsToDevices();
+
   const SessionState& session_state_;
   std::vector<std::string> feed_names_;
   std::vector<OrtValue> feeds_;
   std::vector<std::string> output_names_;
   std::vector<OrtValue> outputs_;
+  std::vector<AllocatorPtr> output_allocators_;  // allocator of the device an output is bound to, else nullptr
+
+  // the bound names resolved by the first run with them, so that the next runs skip the name lookups.
+  // reset when a name is bound or removed, not when the value of a bound name is replaced.
+  std::unique_ptr<InferenceSession::PreparedRun> prepared_run_;
 
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(IOBinding);
 };
@@ -149,6 +149,75 @@ ORT_API_STATUS_IMPL(OrtApis::SetInterOpNumThreads, _In_ OrtSessionOptions* optio
   return nullptr;
 }
 
+ORT_API_STATUS_IMPL(OrtApis::SetIntraOpSpinDuration, _In_ OrtSessionOptions* options, int spin_duration_us) {
+  if (spin_duration_us < 0) {
+    return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "spin_duration_us must be >= 0");
+  }
+  options->value.intra_op_spin_duration_us = spin_duration_us;
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtApis::SetIntraOpThreadAffinity, _In_ OrtSessionOptions* options,
+                    _In_ const size_t* logical_processors, size_t num_logical_processors) {
+  if (logical_processors == nullptr && num_logical_processors > 0) {
+    return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "logical_processors is null");
+  }
+  options->value.intra_op_thread_affinity.assign(logical_processors, logical_processors + num_logical_processors);
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtApis::SetIntraOpNumaNode, _In_ OrtSessionOptions* options, int numa_node) {
+  if (numa_node < -1) {
+    return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "numa_node must be >= -1");
+  }
+  options->value.intra_op_numa_node = numa_node;
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtApis::DisablePerSessionThreads, _In_ OrtSessionOptions* options) {
+  options->value.use_per_session_threads = false;
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtApis::SetCpuMemArenaThreadCacheSize, _In_ OrtSessionOptions* options,
+                    size_t max_bytes_per_thread) {
+  options->value.cpu_mem_arena_thread_cache_max_bytes = max_bytes_per_thread;
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtApis::SetCpuMemArenaConfig, _In_ OrtSessionOptions* options, size_t max_mem,
+                    OrtArenaExtendStrategy extend_strategy, size_t initial_chunk_size_bytes) {
+  if (extend_strategy != ORT_ARENA_EXTEND_NEXT_POWER_OF_TWO && extend_strategy != ORT_ARENA_EXTEND_SAME_AS_REQUESTED) {
+    return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "unknown arena extend strategy");
+  }
+  if (initial_chunk_size_bytes == 0) {
+    return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "initial_chunk_size_bytes must be positive");
+  }
+
+  auto& config = options->value.cpu_mem_arena_config;
+  config.max_mem = max_mem;
+  config.extend_strategy = extend_strategy == ORT_ARENA_EXTEND_SAME_AS_REQUESTED
+                               ? onnxruntime::ArenaExtendStrategy::kSameAsRequested
+                               : onnxruntime::ArenaExtendStrategy::kNextPowerOfTwo;
+  config.initial_chunk_size_bytes = initial_chunk_size_bytes;
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtApis::SetSparseWeightThreshold, _In_ OrtSessionOptions* options, float threshold) {
+  if (!(threshold >= 0.0f && threshold <= 1.0f)) {
+    return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "sparse weight threshold must be in [0, 1]");
+  }
+
+  options->value.sparse_weight_threshold = threshold;
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtApis::SetGraphCacheFilePath, _Inout_ OrtSessionOptions* options,
+                    _In_ const ORTCHAR_T* graph_cache_filepath) {
+  options->value.graph_cache_filepath = graph_cache_filepath;
+  return nullptr;
+}
+
 ORT_API_STATUS_IMPL(OrtApis::AddFreeDimensionOverride, _Inout_ OrtSessionOptions* options,
                     _In_ const char* symbolic_dim, _In_ int64_t dim_override) {
   options->value.free_dimension_overrides.push_back(onnxruntime::FreeDimensionOverride{symbolic_dim, dim_override});
@@ -18,6 +18,7 @@
 #endif
 
 #include "core/platform/env.h"
+#include "core/util/thread_utils.h"
 
 #ifdef ONNXRUNTIME_ENABLE_INSTRUMENT
 #include "core/platform/tracing.h"
@@ -30,6 +31,9 @@ using namespace ONNX_NAMESPACE;
 std::once_flag schemaRegistrationOnceFlag;
 
 std::atomic<bool> Environment::is_initialized_{false};
+std::atomic<bool> Environment::has_global_thread_pools_{false};
+concurrency::ThreadPool* Environment::global_intra_op_thread_pool_ = nullptr;
+concurrency::ThreadPool* Environment::global_inter_op_thread_pool_ = nullptr;
 
 Status Environment::Create(std::unique_ptr<Environment>& environment) {
   environment = std::unique_ptr<Environment>(new Environment());
@@ -37,6 +41,25 @@ Status Environment::Create(std::unique_ptr<Environment>& environment) {
   return status;
 }
 
+Status Environment::Create(std::unique_ptr<Environment>& environment, const ThreadingOptions& tp_options) {
+  ORT_RETURN_IF_NOT(!HasGlobalThreadPools(), "Global thread pools have already been created by another environment");
+  ORT_RETURN_IF_ERROR(Create(environment));
+  environment->CreateGlobalThreadPools(tp_options);
+  return Status::OK();
+}
+
+void Environment::CreateGlobalThreadPools(const ThreadingOptions& tp_options) {
+  intra_op_thread_pool_ = concurrency::CreateThreadPool("env_global_intra_op_thread_pool",
+                                                        tp_options.intra_op_num_threads,
+                                                        tp_options.intra_op_thread_options);
+  inter_op_thread_pool_ = concurrency::CreateThreadPool("env_global_inter_op_thread_pool",
+                                                        tp_options.inter_op_num_threads);
+  global_intra_op_thread_pool_ = intra_op_thread_pool_.get();
+  global_inter_op_thread_pool_ = inter_op_thread_pool_.get();
+  created_global_thread_pools_ = true;
+  has_global_thread_pools_ = true;
+}
+
 Status Environment::Initialize() {
   auto status = Status::OK();
 
@@ -106,6 +129,11 @@ Internal copy node
 }
 
 Environment::~Environment() {
+  if (created_global_thread_pools_) {
+    has_global_thread_pools_ = false;
+    global_intra_op_thread_pool_ = nullptr;
+    global_inter_op_thread_pool_ = nullptr;
+  }
   ::google::protobuf::ShutdownProtobufLibrary();
 }
 
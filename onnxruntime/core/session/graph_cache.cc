@@ -0,0 +1,385 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/session/graph_cache.h"
+
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <sstream>
+
+#ifdef _WIN32
+#include <Windows.h>
+#endif
+
+#include "google/protobuf/io/zero_copy_stream_impl.h"
+#include "core/framework/arena.h"
+#include "core/graph/graph_viewer.h"
+#include "core/platform/env.h"
+#include "onnxruntime_config.h"
+
+namespace onnxruntime {
+
+namespace {
+
+constexpr const char* kKeyMetadataKey = "onnxruntime.graph_cache.key";
+constexpr const char* kNodeProvidersMetadataKey = "onnxruntime.graph_cache.node_providers";
+
+// the subgraphs of a node, in a fixed order
+std::map<std::string, Graph*> GetSubgraphs(Node& node) {
+  std::map<std::string, Graph*> subgraphs;
+  for (auto& entry : node.GetAttributeNameToMutableSubgraphMap()) {
+    subgraphs.emplace(entry.first, entry.second);
+  }
+  return subgraphs;
+}
+
+// 64 bit FNV-1a over a stream of values, applied to 8 bytes at a time. Strings and arrays are prefixed with their
+// length, so that the boundaries between the values are part of the hash.
+class KeyHasher {
+ public:
+  void Add(const void* data, size_t size) {
+    const auto* bytes = static_cast<const unsigned char*>(data);
+    size_t i = 0;
+    for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+      uint64_t word;
+      memcpy(&word, bytes + i, sizeof(uint64_t));
+      hash_ = (hash_ ^ word) * 1099511628211ULL;
+    }
+    for (; i < size; ++i) {
+      hash_ = (hash_ ^ bytes[i]) * 1099511628211ULL;
+    }
+    size_ += size;
+  }
+
+  void Add(int64_t value) { Add(&value, sizeof(value)); }
+
+  void Add(const std::string& value) {
+    Add(static_cast<int64_t>(value.size()));
+    Add(value.data(), value.size());
+  }
+
+  template <typename T>
+  void Add(const google::protobuf::RepeatedField<T>& values) {
+    Add(static_cast<int64_t>(values.size()));
+    Add(values.data(), values.size() * sizeof(T));
+  }
+
+  void Add(const google::protobuf::RepeatedPtrField<std::string>& values) {
+    Add(static_cast<int64_t>(values.size()));
+    for (const auto& value : values) {
+      Add(value);
+    }
+  }
+
+  // Adds a small message by serializing it. Tensors and graphs, which may be large, are added field by field.
+  void Add(const google::protobuf::MessageLite& message) {
+    std::string bytes;
+    message.SerializeToString(&bytes);
+    Add(bytes);
+  }
+
+  uint64_t Hash() const { return hash_; }
+  uint64_t Size() const { return size_; }
+
+ private:
+  uint64_t hash_ = 14695981039346656037ULL;
+  uint64_t size_ = 0;
+};
+
+void HashTensor(const ONNX_NAMESPACE::TensorProto& tensor, KeyHasher& hasher) {
+  hasher.Add(tensor.name());
+  hasher.Add(static_cast<int64_t>(tensor.data_type()));
+  hasher.Add(tensor.dims());
+  hasher.Add(static_cast<int64_t>(tensor.data_location()));
+  hasher.Add(static_cast<int64_t>(tensor.external_data_size()));
+  for (const auto& entry : tensor.external_data()) {
+    hasher.Add(entry.key());
+    hasher.Add(entry.value());
+  }
+
+  hasher.Add(tensor.raw_data());
+  hasher.Add(tensor.float_data());
+  hasher.Add(tensor.int32_data());
+  hasher.Add(tensor.string_data());
+  hasher.Add(tensor.int64_data());
+  hasher.Add(tensor.double_data());
+  hasher.Add(tensor.uint64_data());
+}
+
+void HashNodeArgs(ConstPointerContainer<std::vector<NodeArg*>> node_args, KeyHasher& hasher) {
+  hasher.Add(static_cast<int64_t>(node_args.size()));
+  for (const auto* node_arg : node_args) {
+    hasher.Add(node_arg->Name());
+  }
+}
+
+void HashGraph(Graph& graph, KeyHasher& hasher);
+
+// Hashes a node, its attributes in the order of their names, and its subgraphs.
+void HashNode(Node& node, KeyHasher& hasher) {
+  hasher.Add(node.OpType());
+  hasher.Add(node.Domain());
+  hasher.Add(node.Name());
+  HashNodeArgs(node.InputDefs(), hasher);
+  HashNodeArgs(node.OutputDefs(), hasher);
+
+  const auto& attributes = node.GetAttributes();
+  std::map<std::string, const ONNX_NAMESPACE::AttributeProto*> sorted_attributes;
+  for (const auto& entry : attributes) {
+    sorted_attributes.emplace(entry.first, &entry.second);
+  }
+
+  hasher.Add(static_cast<int64_t>(sorted_attributes.size()));
+  for (const auto& entry : sorted_attributes) {
+    const auto& attribute = *entry.second;
+    if (attribute.has_t()) {
+      hasher.Add(attribute.name());
+      HashTensor(attribute.t(), hasher);
+    } else if (!attribute.has_g()) {
+      hasher.Add(attribute);
+    }
+  }
+
+  for (auto& subgraph : GetSubgraphs(node)) {
+    hasher.Add(subgraph.first);
+    HashGraph(*subgraph.second, hasher);
+  }
+}
+
+// Hashes the inputs and outputs of a graph, its initializers in the order of their names and its nodes. The data of
+// the initializers is hashed in place rather than serializing the graph, which would copy the whole model and fail
+// for models over the 2GB limit of protobuf.
+void HashGraph(Graph& graph, KeyHasher& hasher) {
+  for (const auto* node_args : {&graph.GetInputsIncludingInitializers(), &graph.GetOutputs()}) {
+    hasher.Add(static_cast<int64_t>(node_args->size()));
+    for (const auto* node_arg : *node_args) {
+      hasher.Add(node_arg->Name());
+      const auto* type = node_arg->TypeAsProto();
+      if (type != nullptr) {
+        hasher.Add(*type);
+      }
+    }
+  }
+
+  std::map<std::string, const ONNX_NAMESPACE::TensorProto*> initializers(graph.GetAllInitializedTensors().begin(),
+                                                                          graph.GetAllInitializedTensors().end());
+  hasher.Add(static_cast<int64_t>(initializers.size()));
+  for (const auto& entry : initializers) {
+    HashTensor(*entry.second, hasher);
+  }
+
+  hasher.Add(static_cast<int64_t>(graph.NumberOfNodes()));
+  for (auto& node : graph.Nodes()) {
+    HashNode(node, hasher);
+  }
+}
+
+// Writes the op type and the execution provider of each node, in the order of the nodes in the serialized graph,
+// which is the topological order.
+Status WriteNodeProviders(Graph& graph, std::ostream& out) {
+  GraphViewer graph_viewer(graph);
+  for (auto node_index : graph_viewer.GetNodesInTopologicalOrder()) {
+    Node& node = *graph.GetNode(node_index);
+    if (node.NodeType() == Node::Type::Fused) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED, "Node ", node.Name(), " is compiled by the ",
+                             node.GetExecutionProviderType(), " execution provider and can't be cached.");
+    }
+
+    out << node.OpType() << ' ' << node.GetExecutionProviderType() << '\n';
+    for (auto& subgraph : GetSubgraphs(node)) {
+      ORT_RETURN_IF_ERROR(WriteNodeProviders(*subgraph.second, out));
+    }
+  }
+
+  return Status::OK();
+}
+
+// Assigns the execution providers written by WriteNodeProviders. A graph loaded from a GraphProto has its nodes
+// in the order of the GraphProto. Returns false if the nodes don't match.
+bool ReadNodeProviders(Graph& graph, std::istream& in) {
+  for (auto& node : graph.Nodes()) {
+    std::string op_type;
+    std::string provider;
+    if (!(in >> op_type >> provider) || op_type != node.OpType()) {
+      return false;
+    }
+
+    node.SetExecutionProviderType(provider);
+    for (auto& subgraph : GetSubgraphs(node)) {
+      if (!ReadNodeProviders(*subgraph.second, in)) {
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
+Status WriteModelProto(const ONNX_NAMESPACE::ModelProto& model_proto, const std::basic_string<ORTCHAR_T>& file_path) {
+  int fd;
+  ORT_RETURN_IF_ERROR(Env::Default().FileOpenWr(file_path, fd));
+
+  bool result;
+  {
+    google::protobuf::io::FileOutputStream output(fd);
+    result = model_proto.SerializeToZeroCopyStream(&output) && output.Flush();
+  }
+
+  ORT_RETURN_IF_ERROR(Env::Default().FileClose(fd));
+  if (!result) {
+    return Status(common::ONNXRUNTIME, common::FAIL, "Protobuf serialization failed.");
+  }
+
+  return Status::OK();
+}
+
+}  // namespace
+
+std::string GraphCache::ComputeKey(Model& model, const SessionOptions& session_options,
+                                   const ExecutionProviders& execution_providers,
+                                   const std::vector<std::string>& transformers_to_enable) {
+  Graph& graph = model.MainGraph();
+  KeyHasher hasher;
+  hasher.Add(static_cast<int64_t>(model.IrVersion()));
+  std::map<std::string, int> domain_to_version(graph.DomainToVersionMap().begin(), graph.DomainToVersionMap().end());
+  for (const auto& entry : domain_to_version) {
+    hasher.Add(entry.first);
+    hasher.Add(static_cast<int64_t>(entry.second));
+  }
+
+  HashGraph(graph, hasher);
+
+  std::ostringstream key;
+  key << "onnxruntime " << ORT_VERSION << "\n"
+      << "model " << std::hex << hasher.Hash() << std::dec << " " << hasher.Size() << "\n"
+      << "graph_optimization_level " << static_cast<int>(session_options.graph_optimization_level) << "\n"
+      << "sparse_weight_threshold " << session_options.sparse_weight_threshold << "\n";
+
+  // the device and the arena settings of each provider affect the memory planning and the placement of the nodes
+  for (const auto& provider : execution_providers) {
+    key << "provider " << provider->Type();
+    for (const auto* allocator : provider->GetAllocators()) {
+      const OrtMemoryInfo& info = allocator->Info();
+      key << " [" << info.name << " id=" << info.id << " mem_type=" << static_cast<int>(info.mem_type)
+          << " alloc_type=" << static_cast<int>(info.alloc_type);
+      const auto* arena = dynamic_cast<const IArenaAllocator*>(allocator);
+      if (arena != nullptr) {
+        const ArenaConfig config = arena->GetConfig();
+        key << " max_mem=" << config.max_mem << " extend_strategy=" << static_cast<int>(config.extend_strategy)
+            << " initial_chunk_size=" << config.initial_chunk_size_bytes;
+      }
+      key << "]";
+    }
+    key << "\n";
+  }
+
+  key << "transformers";
+  for (const auto& transformer : transformers_to_enable) {
+    key << " " << transformer;
+  }
+
+  key << "\nfree_dimension_overrides";
+  for (const auto& dim_override : session_options.free_dimension_overrides) {
+    key << " " << dim_override.dimension_denotation << "=" << dim_override.dimension_override;
+  }
+
+  return key.str();
+}
+
+Status GraphCache::Load(const std::basic_string<ORTCHAR_T>& file_path, const std::string& key,
+                        const IOnnxRuntimeOpSchemaRegistryList* local_registries,
+                        const logging::Logger& logger,
+                        std::shared_ptr<Model>& model, bool& hit) {
+  hit = false;
+
+  int fd;
+  if (!Env::Default().FileOpenRd(file_path, fd).IsOK()) {
+    // nothing has been cached yet
+    return Status::OK();
+  }
+
+  auto model_proto = onnxruntime::make_unique<ONNX_NAMESPACE::ModelProto>();
+  Status status = Model::Load(fd, *model_proto);
+  ORT_RETURN_IF_ERROR(Env::Default().FileClose(fd));
+  ORT_RETURN_IF_ERROR(status);
+
+  // remove the cache metadata so that it isn't reported as metadata of the model
+  std::string cached_key;
+  std::string node_providers;
+  auto* metadata_props = model_proto->mutable_metadata_props();
+  for (int i = metadata_props->size() - 1; i >= 0; --i) {
+    const auto& prop = metadata_props->Get(i);
+    if (prop.key() == kKeyMetadataKey) {
+      cached_key = prop.value();
+    } else if (prop.key() == kNodeProvidersMetadataKey) {
+      node_providers = prop.value();
+    } else {
+      continue;
+    }
+
+    metadata_props->DeleteSubrange(i, 1);
+  }
+
+  if (cached_key != key) {
+    // the cache was created for another model or configuration, and is replaced once the session is initialized
+    return Status::OK();
+  }
+
+  std::shared_ptr<Model> cached_model;
+  ORT_RETURN_IF_ERROR(Model::Load(std::move(model_proto), cached_model, local_registries, logger));
+
+  std::istringstream node_providers_stream(node_providers);
+  std::string remaining;
+  if (!ReadNodeProviders(cached_model->MainGraph(), node_providers_stream) || (node_providers_stream >> remaining)) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "The execution providers recorded in the graph cache don't match ",
+                           "its graph.");
+  }
+
+  model = std::move(cached_model);
+  hit = true;
+  return Status::OK();
+}
+
+Status GraphCache::Save(Model& model, const std::basic_string<ORTCHAR_T>& file_path, const std::string& key) {
+  std::ostringstream node_providers;
+  ORT_RETURN_IF_ERROR(WriteNodeProviders(model.MainGraph(), node_providers));
+
+  ONNX_NAMESPACE::ModelProto model_proto = model.ToProto();
+  auto* prop = model_proto.add_metadata_props();
+  prop->set_key(kKeyMetadataKey);
+  prop->set_value(key);
+  prop = model_proto.add_metadata_props();
+  prop->set_key(kNodeProvidersMetadataKey);
+  prop->set_value(node_providers.str());
+
+  // write to a file of this save only and move it in place, so that a session loading the cache concurrently never
+  // reads a partially written file. The file is named after the process and a counter of the saves in the process, as
+  // the sessions of a process can save the same cache concurrently.
+  static std::atomic<uint64_t> save_count{0};
+  std::basic_string<ORTCHAR_T> temp_path = file_path;
+  for (char c : "." + std::to_string(Env::Default().GetSelfPid()) + "." + std::to_string(save_count++) + ".tmp") {
+    temp_path.push_back(static_cast<ORTCHAR_T>(c));
+  }
+
+  ORT_RETURN_IF_ERROR(WriteModelProto(model_proto, temp_path));
+
+#ifdef _WIN32
+  const bool moved = MoveFileExW(temp_path.c_str(), file_path.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+  const bool moved = std::rename(temp_path.c_str(), file_path.c_str()) == 0;
+#endif
+  if (!moved) {
+#ifdef _WIN32
+    DeleteFileW(temp_path.c_str());
+#else
+    std::remove(temp_path.c_str());
+#endif
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Failed to move the graph cache in place.");
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
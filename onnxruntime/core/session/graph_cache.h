@@ -0,0 +1,50 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/common/logging/logging.h"
+#include "core/framework/execution_providers.h"
+#include "core/framework/session_options.h"
+#include "core/graph/model.h"
+
+namespace onnxruntime {
+
+/**
+  The graph cache stores the graph of an initialized session, after the graph transformations and the
+  partitioning, so that another session created for the same model and options can skip both.
+
+  The cache is an ONNX model holding the transformed graph. Its metadata records the key the graph was created for
+  and the execution provider assigned to each node. The copy nodes between devices are not cached, as they have no
+  schema, and are inserted again when the cache is loaded.
+
+  Only the graph is cached. A session loading it still creates the execution plan and the kernels, and the kernels
+  pre-pack their weights again.
+*/
+class GraphCache {
+ public:
+  // Computes the key identifying the model, the version of onnxruntime and everything in the session
+  // configuration that affects the transformed graph, including the devices and arena settings of the execution
+  // providers. Must be called before the graph is transformed.
+  static std::string ComputeKey(Model& model, const SessionOptions& session_options,
+                                const ExecutionProviders& execution_providers,
+                                const std::vector<std::string>& transformers_to_enable);
+
+  // Loads the cached graph from file_path. model is only set, and hit only true, if the file exists and was
+  // created for key. Returns an error if the file exists but can't be read.
+  static common::Status Load(const std::basic_string<ORTCHAR_T>& file_path, const std::string& key,
+                             const IOnnxRuntimeOpSchemaRegistryList* local_registries,
+                             const logging::Logger& logger,
+                             /*out*/ std::shared_ptr<Model>& model, /*out*/ bool& hit);
+
+  // Saves the transformed graph of model to file_path. The graph must be resolved and every node must be
+  // assigned to an execution provider. Graphs with nodes compiled by an execution provider can't be cached.
+  static common::Status Save(Model& model, const std::basic_string<ORTCHAR_T>& file_path, const std::string& key);
+};
+
+}  // namespace onnxruntime
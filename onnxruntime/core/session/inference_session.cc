@@ -7,6 +7,7 @@
 
 #include "core/session/inference_session.h"
 
+#include <algorithm>
 #include <memory>
 #include <sstream>
 #include <unordered_set>
@@ -56,6 +57,7 @@
 #include "core/optimizer/graph_transformer_utils.h"
 #include "core/util/thread_utils.h"
 #include "core/session/inference_session_utils.h"
+#include "core/session/graph_cache.h"
 
 using namespace ONNX_NAMESPACE;
 
@@ -94,6 +96,16 @@ inline std::basic_string<T> GetCurrentTimeString() {
   return std::basic_string<T>(time_str);
 }
 
+// Creates a view of a pool shared by all sessions that limits the number of its threads this session uses.
+// Follows CreateThreadPool in returning nullptr when only the calling thread should be used.
+std::unique_ptr<concurrency::ThreadPool> CreateSharedThreadPoolView(concurrency::ThreadPool* shared_pool,
+                                                                    int num_threads) {
+  if (shared_pool == nullptr || num_threads == 1) {
+    return nullptr;
+  }
+  return onnxruntime::make_unique<concurrency::ThreadPool>(*shared_pool, num_threads);
+}
+
 }  // namespace
 
 std::atomic<uint32_t> InferenceSession::global_session_id_{1};
@@ -174,19 +186,48 @@ void InferenceSession::ConstructorCommon(const SessionOptions& session_options,
       session_options_.max_num_graph_transformation_steps);
   logging_manager_ = logging_manager;
 
-  thread_pool_ = concurrency::CreateThreadPool("intra_op_thread_pool",
-                                               session_options_.intra_op_num_threads);
+  if (session_options_.use_per_session_threads) {
+    concurrency::ThreadOptions intra_op_thread_options;
+    intra_op_thread_options.spin_duration_us = session_options_.intra_op_spin_duration_us;
+    if (!session_options_.intra_op_thread_affinity.empty()) {
+      for (size_t processor : session_options_.intra_op_thread_affinity) {
+        intra_op_thread_options.affinities.push_back({processor});
+      }
+    } else if (session_options_.intra_op_numa_node >= 0) {
+      std::vector<size_t> numa_node_processors;
+      status = Env::Default().GetNumaNodeProcessors(session_options_.intra_op_numa_node, numa_node_processors);
+      ORT_ENFORCE(status.IsOK(), "Could not get the processors of NUMA node ", session_options_.intra_op_numa_node,
+                  ". Error Message: ", status.ErrorMessage());
+      intra_op_thread_options.affinities.push_back(std::move(numa_node_processors));
+    }
 
-  inter_op_thread_pool_ = session_options_.execution_mode == ExecutionMode::ORT_PARALLEL
-                              ? concurrency::CreateThreadPool("inter_op_thread_pool",
-                                                              session_options_.inter_op_num_threads)
-                              : nullptr;
+    thread_pool_ = concurrency::CreateThreadPool("intra_op_thread_pool",
+                                                 session_options_.intra_op_num_threads,
+                                                 intra_op_thread_options);
+
+    inter_op_thread_pool_ = session_options_.execution_mode == ExecutionMode::ORT_PARALLEL
+                                ? concurrency::CreateThreadPool("inter_op_thread_pool",
+                                                                session_options_.inter_op_num_threads)
+                                : nullptr;
+  } else {
+    ORT_ENFORCE(Environment::HasGlobalThreadPools(),
+                "Per-session threads are disabled but the environment was created without global thread pools.");
+
+    // the session only gets a view of the shared pools so that it can't use more threads than configured
+    thread_pool_ = CreateSharedThreadPoolView(Environment::GetIntraOpThreadPool(),
+                                              session_options_.intra_op_num_threads);
+    inter_op_thread_pool_ = session_options_.execution_mode == ExecutionMode::ORT_PARALLEL
+                                ? CreateSharedThreadPoolView(Environment::GetInterOpThreadPool(),
+                                                             session_options_.inter_op_num_threads)
+                                : nullptr;
+  }
 
   session_state_ = onnxruntime::make_unique<SessionState>(execution_providers_,
                                                           session_options_.enable_mem_pattern &&
                                                               session_options_.execution_mode == ExecutionMode::ORT_SEQUENTIAL,
                                                           thread_pool_.get(),
-                                                          inter_op_thread_pool_.get());
+                                                          inter_op_thread_pool_.get(),
+                                                          session_options_.mem_pattern_cache_capacity);
 
   InitLogger(logging_manager);
 
@@ -265,6 +306,14 @@ InferenceSession::InferenceSession(const SessionOptions& session_options,
 }
 
 InferenceSession::~InferenceSession() {
+  // wait for the queued asynchronous runs and their callbacks while the state they use is still alive. the workers
+  // only stop once the queue is empty.
+  {
+    std::unique_lock<onnxruntime::OrtMutex> lock(async_run_mutex_);
+    async_run_workers_done_.wait(lock, [this]() { return num_async_run_workers_ == 0; });
+  }
+  async_run_thread_pool_.reset();
+
   if (session_options_.enable_profiling) {
     try {
       EndProfiling();
@@ -319,6 +368,7 @@ common::Status InferenceSession::RegisterGraphTransformer(
   if (p_graph_transformer == nullptr) {
     return Status(common::ONNXRUNTIME, common::FAIL, "Received nullptr for graph transformer");
   }
+  has_custom_graph_transformers_ = true;
   return graph_transformation_mgr_->Register(std::move(p_graph_transformer), level);
 }
 
@@ -649,18 +699,54 @@ common::Status InferenceSession::TransformGraph(onnxruntime::Graph& graph,
     }
   }
 
+  return common::Status::OK();
+}
+
+// The copy nodes are inserted separately from the other transformations as they aren't saved in the graph cache.
+common::Status InferenceSession::InsertCopyNodes(onnxruntime::Graph& graph,
+                                                 const ExecutionProviders& providers,
+                                                 KernelRegistryManager& kernel_registry_manager) {
   std::vector<std::string> provider_types;
   for (auto& provider_ptr : providers) {
     provider_types.push_back(provider_ptr->Type());
   }
 
-  // Insert copy node/s.
+  bool modified = false;
   MemcpyTransformer copy_transformer{provider_types, kernel_registry_manager};
   ORT_RETURN_IF_ERROR_SESSIONID_(copy_transformer.Apply(graph, modified, *session_logger_));
 
   return common::Status::OK();
 }
 
+common::Status InferenceSession::LoadGraphCache(const std::string& key, bool& loaded) {
+  std::shared_ptr<Model> cached_model;
+  auto status = GraphCache::Load(session_options_.graph_cache_filepath, key,
+                                 HasLocalSchema() ? &custom_schema_registries_ : nullptr, *session_logger_,
+                                 cached_model, loaded);
+  if (!status.IsOK()) {
+    // the session is initialized from the model instead, and the cache is replaced
+    LOGS(*session_logger_, WARNING) << "Ignoring the graph cache: " << status.ErrorMessage();
+    loaded = false;
+    return common::Status::OK();
+  }
+
+  if (!loaded) {
+    LOGS(*session_logger_, INFO) << "No graph cache for this model and configuration.";
+    return common::Status::OK();
+  }
+
+  model_ = std::move(cached_model);
+
+  // the saved inputs and outputs refer to the NodeArgs of the replaced graph
+  required_inputs_.clear();
+  input_def_map_.clear();
+  model_output_names_.clear();
+  ORT_RETURN_IF_ERROR_SESSIONID_(SaveModelMetadata(*model_));
+
+  LOGS(*session_logger_, INFO) << "Loaded the transformed graph from the graph cache.";
+  return common::Status::OK();
+}
+
 /// Create SessionState instance for each subgraph as we need that for the GraphPartitioner
 /// This will be initialized by InitializeSubgraphSessions.
 common::Status InferenceSession::CreateSubgraphSessionState(Graph& graph, SessionState& session_state) {
@@ -673,7 +759,8 @@ common::Status InferenceSession::CreateSubgraphSessionState(Graph& graph, Sessio
       auto subgraph_session_state = onnxruntime::make_unique<SessionState>(execution_providers_,
                                                                            session_state.GetEnableMemoryPattern(),
                                                                            session_state.GetThreadPool(),
-                                                                           session_state.GetInterOpThreadPool());
+                                                                           session_state.GetInterOpThreadPool(),
+                                                                           session_state.GetMemoryPatternCacheCapacity());
       subgraph_session_state->SetProfiler(session_profiler_);
       subgraph_session_state->SetLogger(*session_logger_);
       // Pass data transfer manager to subgraph.
@@ -769,6 +856,8 @@ common::Status InferenceSession::Initialize() {
     if (!execution_providers_.Get(onnxruntime::kCpuExecutionProvider)) {
       LOGS(*session_logger_, INFO) << "Adding default CPU execution provider.";
       CPUExecutionProviderInfo epi{session_options_.enable_cpu_mem_arena};
+      epi.arena_thread_cache_max_bytes = session_options_.cpu_mem_arena_thread_cache_max_bytes;
+      epi.arena_config = session_options_.cpu_mem_arena_config;
       auto p_cpu_exec_provider = onnxruntime::make_unique<CPUExecutionProvider>(epi);
       ORT_RETURN_IF_ERROR_SESSIONID_(RegisterExecutionProvider(std::move(p_cpu_exec_provider)));
     }
@@ -782,6 +871,20 @@ common::Status InferenceSession::Initialize() {
                             "for the registered CUDA Execution Provider.");
     }
 
+    // the graph cache replaces the model with its transformed graph, so it is checked before anything refers
+    // to the graph
+    std::string graph_cache_key;
+    bool loaded_from_cache = false;
+    if (!session_options_.graph_cache_filepath.empty()) {
+      if (has_custom_graph_transformers_) {
+        LOGS(*session_logger_, WARNING) << "The graph cache is not used as custom graph transformers are registered.";
+      } else {
+        graph_cache_key = GraphCache::ComputeKey(*model_, session_options_, execution_providers_,
+                                                 transformers_to_enable_);
+        ORT_RETURN_IF_ERROR_SESSIONID_(LoadGraphCache(graph_cache_key, loaded_from_cache));
+      }
+    }
+
     // add predefined transformers
     AddPredefinedTransformers(*graph_transformation_mgr_, session_options_.graph_optimization_level,
                               transformers_to_enable_);
@@ -804,11 +907,24 @@ common::Status InferenceSession::Initialize() {
     // create SessionState for subgraphs as it's needed by the transformers
     ORT_RETURN_IF_ERROR_SESSIONID_(CreateSubgraphSessionState(graph, *session_state_));
 
-    // apply any transformations to the main graph and any subgraphs
-    ORT_RETURN_IF_ERROR_SESSIONID_(TransformGraph(graph, *graph_transformation_mgr_,
-                                                  execution_providers_, kernel_registry_manager_,
-                                                  insert_cast_transformer_,
-                                                  *session_state_));
+    if (!loaded_from_cache) {
+      // apply any transformations to the main graph and any subgraphs
+      ORT_RETURN_IF_ERROR_SESSIONID_(TransformGraph(graph, *graph_transformation_mgr_,
+                                                    execution_providers_, kernel_registry_manager_,
+                                                    insert_cast_transformer_,
+                                                    *session_state_));
+
+      if (!graph_cache_key.empty()) {
+        ORT_RETURN_IF_ERROR_SESSIONID_(graph.Resolve());
+        auto cache_status = GraphCache::Save(*model_, session_options_.graph_cache_filepath, graph_cache_key);
+        if (!cache_status.IsOK()) {
+          LOGS(*session_logger_, WARNING) << "Failed to save the graph cache: " << cache_status.ErrorMessage();
+        }
+      }
+    }
+
+    // Insert copy node/s.
+    ORT_RETURN_IF_ERROR_SESSIONID_(InsertCopyNodes(graph, execution_providers_, kernel_registry_manager_));
 
     // now that all the transforms are done, call Resolve on the main graph. this will recurse into the subgraphs.
     ORT_RETURN_IF_ERROR_SESSIONID_(graph.Resolve());
@@ -913,6 +1029,34 @@ static common::Status CheckTypes(MLDataType actual, MLDataType expected) {
                 "Unexpected input data type. Actual: (" + actual_name + ") , expected: (" + expected_name + ")");
 }
 
+common::Status InferenceSession::ValidateInput(const std::string& feed_name, const InputDefMetaData& input_def,
+                                               const OrtValue& input_ml_value) const {
+  auto expected_type = input_def.ml_data_type;
+  if (input_ml_value.IsTensor()) {
+    // check for type
+    if (!expected_type->IsTensorType()) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Input with name: ", feed_name,
+                             " is not expected to be of type tensor.");
+    }
+
+    auto expected_element_type = expected_type->AsTensorType()->GetElementType();
+    auto input_element_type = input_ml_value.Get<Tensor>().DataType();
+    ORT_RETURN_IF_ERROR_SESSIONID_(CheckTypes(input_element_type, expected_element_type));
+
+    // check for shape
+    const auto& expected_shape = input_def.tensor_shape;
+    if (expected_shape.NumDimensions() > 0) {
+      const auto& input_shape = input_ml_value.Get<Tensor>().Shape();
+      ORT_RETURN_IF_ERROR_SESSIONID_(CheckShapes(feed_name, input_shape, expected_shape));
+    }
+  } else {
+    auto input_type = input_ml_value.Type();
+    ORT_RETURN_IF_ERROR_SESSIONID_(CheckTypes(input_type, expected_type));
+  }
+
+  return Status::OK();
+}
+
 common::Status InferenceSession::ValidateInputs(const std::vector<std::string>& feed_names,
                                                 const std::vector<OrtValue>& feeds) const {
   if (feed_names.size() != feeds.size()) {
@@ -928,65 +1072,135 @@ common::Status InferenceSession::ValidateInputs(const std::vector<std::string>&
       return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Invalid Feed Input Name:", feed_name);
     }
 
-    auto expected_type = iter->second.ml_data_type;
-    auto& input_ml_value = feeds.at(i);
-    if (input_ml_value.IsTensor()) {
-      // check for type
-      if (!expected_type->IsTensorType()) {
-        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Input with name: ", feed_name,
-                               " is not expected to be of type tensor.");
-      }
-
-      auto expected_element_type = expected_type->AsTensorType()->GetElementType();
-      auto input_element_type = input_ml_value.Get<Tensor>().DataType();
-      ORT_RETURN_IF_ERROR_SESSIONID_(CheckTypes(input_element_type, expected_element_type));
-
-      // check for shape
-      const auto& expected_shape = iter->second.tensor_shape;
-      if (expected_shape.NumDimensions() > 0) {
-        const auto& input_shape = input_ml_value.Get<Tensor>().Shape();
-        ORT_RETURN_IF_ERROR_SESSIONID_(CheckShapes(feed_name, input_shape, expected_shape));
-      }
-    } else {
-      auto input_type = input_ml_value.Type();
-      ORT_RETURN_IF_ERROR_SESSIONID_(CheckTypes(input_type, expected_type));
-    }
+    ORT_RETURN_IF_ERROR_SESSIONID_(ValidateInput(feed_name, iter->second, feeds[i]));
   }
 
   return Status::OK();
 }
 
-common::Status InferenceSession::ValidateOutputs(const std::vector<std::string>& output_names,
-                                                 const std::vector<OrtValue>* p_fetches) const {
+common::Status InferenceSession::ValidateFetches(size_t num_outputs, const std::vector<OrtValue>* p_fetches) const {
   if (p_fetches == nullptr) {
     return common::Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT, "Output vector pointer is NULL");
   }
 
-  if (output_names.empty()) {
+  if (num_outputs == 0) {
     return common::Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT, "At least one output should be requested.");
   }
 
-  if (!p_fetches->empty() && (output_names.size() != p_fetches->size())) {
+  if (!p_fetches->empty() && (num_outputs != p_fetches->size())) {
     std::ostringstream ostr;
-    ostr << "Output vector incorrectly sized: output_names.size(): " << output_names.size()
+    ostr << "Output vector incorrectly sized: output_names.size(): " << num_outputs
          << "p_fetches->size(): " << p_fetches->size();
     return common::Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT, ostr.str());
   }
 
+  // TODO add more validation here like checking shape of the allocated buffers
+
+  return common::Status::OK();
+}
+
+common::Status InferenceSession::ValidateOutputs(const std::vector<std::string>& output_names,
+                                                 const std::vector<OrtValue>* p_fetches) const {
+  ORT_RETURN_IF_ERROR_SESSIONID_(ValidateFetches(output_names.size(), p_fetches));
+
   for (const auto& name : output_names) {
     if (model_output_names_.find(name) == model_output_names_.end()) {
       return common::Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT, "Invalid Output Name:" + name);
     }
   }
 
-  // TODO add more validation here like checking shape of the allocated buffers
-
   return common::Status::OK();
 }
 
 Status InferenceSession::Run(const RunOptions& run_options, const std::vector<std::string>& feed_names,
                              const std::vector<OrtValue>& feeds, const std::vector<std::string>& output_names,
                              std::vector<OrtValue>* p_fetches) {
+  return ExecuteRun(run_options, [&](const logging::Logger& run_logger) {
+    ORT_RETURN_IF_ERROR_SESSIONID_(ValidateInputs(feed_names, feeds));
+    ORT_RETURN_IF_ERROR_SESSIONID_(ValidateOutputs(output_names, p_fetches));
+
+    FeedsFetchesInfo info(feed_names, output_names, session_state_->GetOrtValueNameIdxMap());
+    FeedsFetchesManager feeds_fetches_manager{std::move(info)};
+
+    return utils::ExecuteGraph(*session_state_, feeds_fetches_manager, feeds, *p_fetches,
+                               session_options_.execution_mode, run_options.terminate, run_logger);
+  });
+}
+
+common::Status InferenceSession::PrepareRun(const std::vector<std::string>& feed_names,
+                                            const std::vector<std::string>& output_names,
+                                            std::unique_ptr<PreparedRun>* prepared_run) {
+  {
+    std::lock_guard<onnxruntime::OrtMutex> l(session_mutex_);
+    if (!is_inited_) {
+      LOGS(*session_logger_, ERROR) << "Session was not initialized";
+      return common::Status(common::ONNXRUNTIME, common::FAIL, "Session not initialized.");
+    }
+  }
+
+  std::vector<const InputDefMetaData*> input_defs;
+  input_defs.reserve(feed_names.size());
+  for (const auto& feed_name : feed_names) {
+    auto iter = input_def_map_.find(feed_name);
+    if (input_def_map_.end() == iter) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Invalid Feed Input Name:", feed_name);
+    }
+
+    input_defs.push_back(&iter->second);
+  }
+
+  std::vector<OrtValue> no_fetches;
+  ORT_RETURN_IF_ERROR_SESSIONID_(ValidateOutputs(output_names, &no_fetches));
+
+  FeedsFetchesInfo info;
+  info.feed_names = feed_names;
+  info.output_names = output_names;
+  ORT_RETURN_IF_ERROR_SESSIONID_(info.SetMLValueIdxs(session_state_->GetOrtValueNameIdxMap()));
+
+  // private constructor, can't use make_unique
+  std::unique_ptr<PreparedRun> result(new PreparedRun(*this, std::move(info), std::move(input_defs)));
+  ORT_RETURN_IF_ERROR_SESSIONID_(utils::InitializeFeedFetchCopyInfo(*session_state_, result->feeds_fetches_manager_));
+
+  *prepared_run = std::move(result);
+  return Status::OK();
+}
+
+common::Status InferenceSession::Run(const RunOptions& run_options, const PreparedRun& prepared_run,
+                                     const std::vector<OrtValue>& feeds, std::vector<OrtValue>* p_fetches) {
+  if (&prepared_run.session_ != this) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "The run was prepared by another session.");
+  }
+
+  return ExecuteRun(run_options, [&](const logging::Logger& run_logger) {
+    const auto& input_defs = prepared_run.input_defs_;
+    if (input_defs.size() != feeds.size()) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Size mismatch: the run was prepared for ",
+                             input_defs.size(), " feeds, but feeds has ", feeds.size(), " elements.");
+    }
+
+    const auto& feeds_fetches_manager = prepared_run.feeds_fetches_manager_;
+    const auto& info = feeds_fetches_manager.GetFeedsFetchesInfo();
+    for (size_t i = 0; i < feeds.size(); ++i) {
+      ORT_RETURN_IF_ERROR_SESSIONID_(ValidateInput(info.feed_names[i], *input_defs[i], feeds[i]));
+    }
+
+    ORT_RETURN_IF_ERROR_SESSIONID_(ValidateFetches(info.output_names.size(), p_fetches));
+
+    if (feeds_fetches_manager.GetDeviceCopyChecks().status == DeviceCopyCheck::NoCopy) {
+      p_fetches->resize(info.output_names.size());
+      return utils::ExecuteSubgraph(*session_state_, feeds_fetches_manager, feeds, *p_fetches, {},
+                                    session_options_.execution_mode, run_options.terminate, run_logger);
+    }
+
+    FeedsFetchesManager run_feeds_fetches_manager{FeedsFetchesInfo(info)};
+    return utils::ExecuteGraph(*session_state_, run_feeds_fetches_manager, feeds, *p_fetches,
+                               session_options_.execution_mode, run_options.terminate, run_logger);
+  });
+}
+
+common::Status InferenceSession::ExecuteRun(
+    const RunOptions& run_options,
+    const std::function<common::Status(const logging::Logger& run_logger)>& execute) {
   TimePoint tp;
   if (session_profiler_.IsEnabled()) {
     tp = session_profiler_.StartTime();
@@ -1005,12 +1219,6 @@ Status InferenceSession::Run(const RunOptions& run_options, const std::vector<st
       return Status(common::ONNXRUNTIME, common::FAIL, "Session not initialized.");
     }
 
-    ORT_RETURN_IF_ERROR_SESSIONID_(ValidateInputs(feed_names, feeds));
-    ORT_RETURN_IF_ERROR_SESSIONID_(ValidateOutputs(output_names, p_fetches));
-
-    FeedsFetchesInfo info(feed_names, output_names, session_state_->GetOrtValueNameIdxMap());
-    FeedsFetchesManager feeds_fetches_manager{std::move(info)};
-
     if (!run_options.run_tag.empty()) {
       LOGS(*session_logger_, INFO) << "Running with tag: " << run_options.run_tag;
     }
@@ -1031,10 +1239,7 @@ Status InferenceSession::Run(const RunOptions& run_options, const std::vector<st
     }
 
     // execute the graph
-    ORT_CHECK_AND_SET_RETVAL(
-        utils::ExecuteGraph(*session_state_, feeds_fetches_manager, feeds, *p_fetches,
-                            session_options_.execution_mode,
-                            run_options.terminate, run_logger));
+    ORT_CHECK_AND_SET_RETVAL(execute(run_logger));
 
   } catch (const std::exception& e) {
     retval = Status(common::ONNXRUNTIME, common::FAIL, e.what());
@@ -1047,6 +1252,10 @@ Status InferenceSession::Run(const RunOptions& run_options, const std::vector<st
     ORT_CHECK_AND_SET_RETVAL(xp->OnRunEnd());
   }
 
+  if (run_options.shrink_memory_arenas) {
+    ORT_CHECK_AND_SET_RETVAL(ShrinkMemoryArenas());
+  }
+
   --current_num_runs_;
 
   // keep track of telemetry
@@ -1074,6 +1283,24 @@ Status InferenceSession::Run(const RunOptions& run_options, const std::vector<st
   return retval;
 }
 
+common::Status InferenceSession::ShrinkMemoryArenas() {
+  std::unordered_set<IArenaAllocator*> shrunk_arenas;
+  for (auto& xp : execution_providers_) {
+    // the allocators of every device and memory type of the provider
+    for (const auto* registered : xp->GetAllocators()) {
+      const auto& info = registered->Info();
+      auto allocator = xp->GetAllocator(info.id, info.mem_type);
+      auto* arena = dynamic_cast<IArenaAllocator*>(allocator.get());
+      // memory types may share an arena
+      if (arena != nullptr && shrunk_arenas.insert(arena).second) {
+        ORT_RETURN_IF_ERROR(arena->Shrink());
+      }
+    }
+  }
+
+  return Status::OK();
+}
+
 common::Status InferenceSession::Run(const NameMLValMap& feeds, const std::vector<std::string>& output_names,
                                      std::vector<OrtValue>* p_fetches) {
   return Run(RunOptions(), feeds, output_names, p_fetches);
@@ -1164,8 +1391,14 @@ common::Status InferenceSession::NewIOBinding(std::unique_ptr<IOBinding>* io_bin
 common::Status InferenceSession::Run(const RunOptions& run_options, IOBinding& io_binding) {
   // TODO should Run() call io_binding.SynchronizeInputs() or should it let the callers do it?
   // io_binding.SynchronizeInputs();
-  return Run(run_options, io_binding.GetInputNames(), io_binding.GetInputs(),
-             io_binding.GetOutputNames(), &io_binding.GetOutputs());
+  // the names are resolved by the first run with them only
+  if (io_binding.prepared_run_ == nullptr) {
+    ORT_RETURN_IF_ERROR(PrepareRun(io_binding.GetInputNames(), io_binding.GetOutputNames(), &io_binding.prepared_run_));
+  }
+
+  io_binding.ResetDeviceOutputs();
+  ORT_RETURN_IF_ERROR(Run(run_options, *io_binding.prepared_run_, io_binding.GetInputs(), &io_binding.GetOutputs()));
+  return io_binding.CopyOutputsToDevices();
 }
 
 common::Status InferenceSession::Run(IOBinding& io_binding) {
@@ -1173,6 +1406,89 @@ common::Status InferenceSession::Run(IOBinding& io_binding) {
   return Run(run_options, io_binding);
 }
 
+common::Status InferenceSession::RunAsync(const RunOptions* run_options, std::vector<std::string> feed_names,
+                                          std::vector<OrtValue> feeds, std::vector<std::string> output_names,
+                                          std::vector<OrtValue> fetches, RunAsyncCallback callback) {
+  if (!callback) {
+    return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT, "RunAsync requires a callback.");
+  }
+
+  {
+    std::lock_guard<onnxruntime::OrtMutex> l(session_mutex_);
+    if (!is_inited_) {
+      LOGS(*session_logger_, ERROR) << "Session was not initialized";
+      return Status(common::ONNXRUNTIME, common::FAIL, "Session not initialized.");
+    }
+  }
+
+  std::function<void()> run =
+      [this, run_options, feed_names = std::move(feed_names), feeds = std::move(feeds),
+       output_names = std::move(output_names), fetches = std::move(fetches), callback = std::move(callback)]() mutable {
+        Status status;
+        if (run_options == nullptr) {
+          RunOptions default_run_options;
+          status = Run(default_run_options, feed_names, feeds, output_names, &fetches);
+        } else {
+          status = Run(*run_options, feed_names, feeds, output_names, &fetches);
+        }
+
+        callback(status, fetches);
+      };
+
+  concurrency::ThreadPool* async_run_thread_pool = nullptr;
+  {
+    std::lock_guard<onnxruntime::OrtMutex> l(async_run_mutex_);
+    if (async_run_thread_pool_ == nullptr) {
+      concurrency::ThreadPool* env_thread_pool = Environment::GetInterOpThreadPool();
+      if (!session_options_.use_per_session_threads && env_thread_pool != nullptr) {
+        async_run_thread_pool_ = onnxruntime::make_unique<concurrency::ThreadPool>(
+            *env_thread_pool, session_options_.inter_op_num_threads);
+        max_async_run_workers_ = async_run_thread_pool_->NumThreads();
+        if (session_options_.execution_mode == ExecutionMode::ORT_PARALLEL) {
+          // the nodes of a parallel run execute on the same pool while the run waits for them, so leave them a thread
+          max_async_run_workers_ = std::max(1, std::min(max_async_run_workers_, env_thread_pool->NumThreads() - 1));
+        }
+      } else {
+        int num_threads = session_options_.inter_op_num_threads;
+        if (num_threads <= 0) {
+          num_threads = std::max<int>(1, std::thread::hardware_concurrency() / 2);
+        }
+        async_run_thread_pool_ = onnxruntime::make_unique<concurrency::ThreadPool>("async_run_thread_pool",
+                                                                                   num_threads);
+        max_async_run_workers_ = async_run_thread_pool_->NumThreads();
+      }
+    }
+
+    async_run_queue_.push_back(std::move(run));
+    if (num_async_run_workers_ < max_async_run_workers_) {
+      ++num_async_run_workers_;
+      async_run_thread_pool = async_run_thread_pool_.get();
+    }
+  }
+
+  // schedule outside of the lock, as a pool with a full queue runs the task on this thread
+  if (async_run_thread_pool != nullptr) {
+    async_run_thread_pool->Schedule([this]() { ExecuteAsyncRuns(); });
+  }
+
+  return Status::OK();
+}
+
+void InferenceSession::ExecuteAsyncRuns() {
+  std::unique_lock<onnxruntime::OrtMutex> lock(async_run_mutex_);
+  while (!async_run_queue_.empty()) {
+    std::function<void()> run = std::move(async_run_queue_.front());
+    async_run_queue_.pop_front();
+    lock.unlock();
+    run();
+    lock.lock();
+  }
+
+  // notify while holding the lock, as the session may be destroyed as soon as it is released
+  --num_async_run_workers_;
+  async_run_workers_done_.notify_all();
+}
+
 template <typename T>
 void InferenceSession::StartProfiling(const std::basic_string<T>& file_prefix) {
   std::basic_ostringstream<T> ss;
@@ -1338,7 +1654,8 @@ void InferenceSession::AddPredefinedTransformers(GraphTransformerManager& transf
                                                  const std::vector<std::string>& custom_list) {
   auto add_transformers = [&](TransformerLevel level) {
     // Generate and register transformers for level
-    auto transformers_to_register = optimizer_utils::GenerateTransformers(level, session_options_.free_dimension_overrides, custom_list);
+    auto transformers_to_register = optimizer_utils::GenerateTransformers(level, session_options_.free_dimension_overrides, custom_list,
+                                                                          session_options_.sparse_weight_threshold);
     for (auto& entry : transformers_to_register) {
       transformer_manager.Register(std::move(entry), level);
     }
@@ -3,6 +3,8 @@
 
 #pragma once
 
+#include <deque>
+#include <functional>
 #include <string>
 #include <unordered_map>
 
@@ -11,6 +13,7 @@
 #include "core/common/profiler.h"
 #include "core/common/status.h"
 #include "core/framework/execution_providers.h"
+#include "core/framework/feeds_fetches_manager.h"
 #include "core/framework/framework_common.h"
 #include "core/framework/iexecutor.h"
 #include "core/framework/kernel_registry_manager.h"
@@ -276,6 +279,49 @@ class InferenceSession {
   common::Status Run(const RunOptions& run_options, IOBinding& io_binding);
   common::Status Run(IOBinding& io_binding);
 
+  class PreparedRun;
+
+  /**
+    * Resolve the feed and output names of a Run once, for repeated runs with the same names.
+    * Running the returned object skips the name lookups of Run; only the types and shapes of the feeds are checked.
+    * A prepared run may be used by concurrent Run calls and must not outlive the session.
+    * @return OK if success.
+    */
+  common::Status PrepareRun(const std::vector<std::string>& feed_names, const std::vector<std::string>& output_names,
+                            std::unique_ptr<PreparedRun>* prepared_run);
+
+  /**
+    * Run with the names resolved by PrepareRun.
+    * @param feeds in the order of the feed names of the prepared run.
+    * @param p_fetches output values in the order of the output names of the prepared run.
+    * @return OK if success.
+    */
+  common::Status Run(const RunOptions& run_options, const PreparedRun& prepared_run,
+                     const std::vector<OrtValue>& feeds, std::vector<OrtValue>* p_fetches);
+
+  using RunAsyncCallback = std::function<void(const common::Status& status, std::vector<OrtValue>& fetches)>;
+
+  /**
+    * Queue a Run and return without waiting for it. The queue has no limit. Up to
+    * SessionOptions::inter_op_num_threads runs execute at once, on the inter-op pool of the environment if
+    * SessionOptions::use_per_session_threads is off, or else on a pool of the session created by the first call.
+    * Destroying the session waits for the queued runs and their callbacks.
+    * @param run_options optional; must stay valid until the callback is invoked.
+    * @param fetches pre-allocated outputs, or empty values for the outputs the run allocates.
+    * @param callback invoked on the thread of the run with its status and the fetches.
+    * @return OK if the run was queued.
+    */
+  common::Status RunAsync(const RunOptions* run_options, std::vector<std::string> feed_names,
+                          std::vector<OrtValue> feeds, std::vector<std::string> output_names,
+                          std::vector<OrtValue> fetches, RunAsyncCallback callback);
+
+  /**
+    * Return the memory held but not used by the arenas of the registered execution providers to the devices.
+    * Safe to call while other threads are running the session; memory in use is not affected.
+    * Also done at the end of a Run when RunOptions::shrink_memory_arenas is set.
+    */
+  common::Status ShrinkMemoryArenas();
+
   /**
     * @return pair.first = OK; FAIL otherwise. pair.second is non-NULL when pair.first = OK.
     * @note lifetime of the returned pointer is valid as long as the Session object is live.
@@ -410,6 +456,13 @@ class InferenceSession {
                                 const InsertCastTransformer& insert_cast_transformer,
                                 SessionState& session_state);
 
+  common::Status InsertCopyNodes(onnxruntime::Graph& graph,
+                                 const ExecutionProviders& providers,
+                                 KernelRegistryManager& kernel_registry_manager);
+
+  // Replaces the model with the cached transformed graph if there is a graph cache for key.
+  common::Status LoadGraphCache(const std::string& key, bool& loaded);
+
   common::Status CreateSubgraphSessionState(Graph& graph, SessionState& session_state);
 
   common::Status InitializeSubgraphSessions(Graph& graph, SessionState& session_state);
@@ -420,6 +473,9 @@ class InferenceSession {
 
   void InitLogger(logging::LoggingManager* logging_manager);
 
+  // Executes the runs queued by RunAsync until the queue is empty. Runs on a thread of async_run_thread_pool_.
+  void ExecuteAsyncRuns();
+
   common::Status CheckShapes(const std::string& input_name,
                              const TensorShape& input_shape,
                              const TensorShape& expected_shape) const;
@@ -428,6 +484,13 @@ class InferenceSession {
 
   common::Status ValidateOutputs(const std::vector<std::string>& output_names, const std::vector<OrtValue>* p_fetches) const;
 
+  common::Status ValidateFetches(size_t num_outputs, const std::vector<OrtValue>* p_fetches) const;
+
+  // Runs execute with the feeds and fetches set up by the caller, inside the error handling, logging and
+  // profiling shared by all the Run overloads.
+  common::Status ExecuteRun(const RunOptions& run_options,
+                            const std::function<common::Status(const logging::Logger& run_logger)>& execute);
+
   common::Status WaitForNotification(Notification* p_executor_done, int64_t timeout_in_ms);
 
   template <typename T>
@@ -445,6 +508,10 @@ class InferenceSession {
   // .i.e This list overrides both SessionOptions.graph_optimization_level and predefined transformers.
   std::vector<std::string> transformers_to_enable_;
 
+  // Set if graph transformers were registered with RegisterGraphTransformer. They aren't part of the key of the
+  // graph cache, so the cache is not used.
+  bool has_custom_graph_transformers_ = false;
+
   /// Logging manager if provided.
   logging::LoggingManager* logging_manager_ = nullptr;
 
@@ -461,6 +528,15 @@ class InferenceSession {
   std::unique_ptr<onnxruntime::concurrency::ThreadPool> thread_pool_;
   std::unique_ptr<onnxruntime::concurrency::ThreadPool> inter_op_thread_pool_;
 
+  // Runs queued by RunAsync. Up to max_async_run_workers_ tasks on async_run_thread_pool_ take the runs from the
+  // queue until it is empty, so the queue of the pool never holds more tasks of the session than it has threads.
+  std::deque<std::function<void()>> async_run_queue_;                            // GUARDED_BY(async_run_mutex_)
+  std::unique_ptr<onnxruntime::concurrency::ThreadPool> async_run_thread_pool_;  // GUARDED_BY(async_run_mutex_)
+  int max_async_run_workers_ = 0;                                                // GUARDED_BY(async_run_mutex_)
+  int num_async_run_workers_ = 0;                                                // GUARDED_BY(async_run_mutex_)
+  onnxruntime::OrtMutex async_run_mutex_;
+  onnxruntime::OrtCondVar async_run_workers_done_;
+
   KernelRegistryManager kernel_registry_manager_;
   std::list<std::shared_ptr<onnxruntime::IOnnxRuntimeOpSchemaCollection>> custom_schema_registries_;
 
@@ -479,6 +555,10 @@ class InferenceSession {
     TensorShape tensor_shape;  // not applicable if the input is non-tensor type
   };
   std::unordered_map<std::string, InputDefMetaData> input_def_map_;
+
+  common::Status ValidateInput(const std::string& feed_name, const InputDefMetaData& input_def,
+                               const OrtValue& input_ml_value) const;
+
   OutputDefList output_def_list_;
 
   // Data transfer manager.
@@ -518,4 +598,35 @@ class InferenceSession {
   // used to hold the ModelProto parsed in an applicable ctor to be used while calling parameter-less Load()
   std::unique_ptr<ONNX_NAMESPACE::ModelProto> model_proto_;
 };
+
+/**
+  * The feed and output names of a Run resolved to the indices of their values and the definitions of the inputs.
+  * Created by InferenceSession::PrepareRun.
+  */
+class InferenceSession::PreparedRun {
+ public:
+  const std::vector<std::string>& GetFeedNames() const {
+    return feeds_fetches_manager_.GetFeedsFetchesInfo().feed_names;
+  }
+  const std::vector<std::string>& GetOutputNames() const {
+    return feeds_fetches_manager_.GetFeedsFetchesInfo().output_names;
+  }
+
+ private:
+  friend class InferenceSession;
+
+  PreparedRun(const InferenceSession& session, FeedsFetchesInfo&& info,
+              std::vector<const InputDefMetaData*>&& input_defs)
+      : session_(session), feeds_fetches_manager_(std::move(info)), input_defs_(std::move(input_defs)) {}
+
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(PreparedRun);
+
+  const InferenceSession& session_;
+
+  // Finalized once if the feeds and fetches never need a copy, and then shared by the runs. Otherwise each run
+  // copies the info to a manager of its own, as the copies depend on the locations of the feeds and fetches.
+  FeedsFetchesManager feeds_fetches_manager_;
+
+  std::vector<const InputDefMetaData*> input_defs_;
+};
 }  // namespace onnxruntime
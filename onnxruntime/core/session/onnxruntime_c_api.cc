@@ -23,6 +23,7 @@
 #include "core/framework/tensorprotoutils.h"
 #include "core/framework/onnxruntime_typeinfo.h"
 #include "core/session/inference_session.h"
+#include "core/session/IOBinding.h"
 #include "core/session/ort_apis.h"
 #include "core/framework/data_types.h"
 #include "abi_session_options_impl.h"
@@ -67,6 +68,18 @@ class LoggingWrapper : public ISink {
   void* logger_param_;
 };
 
+struct OrtThreadingOptions {
+  onnxruntime::ThreadingOptions value;
+};
+
+struct OrtIoBinding {
+  std::unique_ptr<onnxruntime::IOBinding> binding_;
+};
+
+struct OrtPreparedRun {
+  std::unique_ptr<onnxruntime::InferenceSession::PreparedRun> prepared_run_;
+};
+
 struct OrtEnv {
  public:
   struct LoggingManagerConstructionInfo {
@@ -84,11 +97,14 @@ struct OrtEnv {
     const char* logid{};
   };
 
-  static OrtEnv* GetInstance(const LoggingManagerConstructionInfo& lm_info, Status& status) {
+  // tp_options is only used when the instance is created. Requesting global thread pools from an existing
+  // instance that was created without them is an error.
+  static OrtEnv* GetInstance(const LoggingManagerConstructionInfo& lm_info, Status& status,
+                             const ThreadingOptions* tp_options = nullptr) {
     std::lock_guard<OrtMutex> lock(m_);
     if (!p_instance_) {
       std::unique_ptr<Environment> env;
-      status = Environment::Create(env);
+      status = tp_options != nullptr ? Environment::Create(env, *tp_options) : Environment::Create(env);
       if (!status.IsOK()) {
         return nullptr;
       }
@@ -112,6 +128,10 @@ struct OrtEnv {
       }
 
       p_instance_ = new OrtEnv(std::move(env), std::move(lmgr));
+    } else if (tp_options != nullptr && !Environment::HasGlobalThreadPools()) {
+      status = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL,
+                               "The environment already exists and was created without global thread pools");
+      return nullptr;
     }
     ++ref_count_;
     return p_instance_;
@@ -186,6 +206,45 @@ ORT_API_STATUS_IMPL(OrtApis::CreateEnv, OrtLoggingLevel default_warning_level,
   API_IMPL_END
 }
 
+ORT_API_STATUS_IMPL(OrtApis::CreateEnvWithGlobalThreadPools, OrtLoggingLevel default_warning_level,
+                    _In_ const char* logid, _In_ const OrtThreadingOptions* tp_options, _Outptr_ OrtEnv** out) {
+  API_IMPL_BEGIN
+  OrtEnv::LoggingManagerConstructionInfo lm_info{nullptr, nullptr, default_warning_level, logid};
+  Status status;
+  *out = OrtEnv::GetInstance(lm_info, status, &tp_options->value);
+  return ToOrtStatus(status);
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtApis::CreateThreadingOptions, _Outptr_ OrtThreadingOptions** out) {
+  API_IMPL_BEGIN
+  *out = new OrtThreadingOptions();
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtApis::SetGlobalIntraOpNumThreads, _Inout_ OrtThreadingOptions* tp_options,
+                    int intra_op_num_threads) {
+  if (intra_op_num_threads < 0) {
+    return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "intra_op_num_threads must be >= 0");
+  }
+  tp_options->value.intra_op_num_threads = intra_op_num_threads;
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtApis::SetGlobalInterOpNumThreads, _Inout_ OrtThreadingOptions* tp_options,
+                    int inter_op_num_threads) {
+  if (inter_op_num_threads < 0) {
+    return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "inter_op_num_threads must be >= 0");
+  }
+  tp_options->value.inter_op_num_threads = inter_op_num_threads;
+  return nullptr;
+}
+
+ORT_API(void, OrtApis::ReleaseThreadingOptions, _Frees_ptr_opt_ OrtThreadingOptions* value) {
+  delete value;
+}
+
 // enable platform telemetry
 ORT_API_STATUS_IMPL(OrtApis::EnableTelemetryEvents, _In_ const OrtEnv* ort_env) {
   API_IMPL_BEGIN
@@ -526,16 +585,16 @@ ORT_API_STATUS_IMPL(OrtApis::CreateSessionFromArray, _In_ const OrtEnv* env, _In
   API_IMPL_END
 }
 
-ORT_API_STATUS_IMPL(OrtApis::Run, _Inout_ OrtSession* sess,
-                    _In_opt_ const OrtRunOptions* run_options,
-                    _In_ const char* const* input_names, _In_ const OrtValue* const* input, size_t input_len,
-                    _In_ const char* const* output_names1, size_t output_names_len, _Outptr_ OrtValue** output) {
-  API_IMPL_BEGIN
-  auto session = reinterpret_cast<::onnxruntime::InferenceSession*>(sess);
+// Copies the names and values passed to a run into the form InferenceSession::Run takes.
+static OrtStatus* GetFeedsAndFetches(_In_ const char* const* input_names, _In_ const OrtValue* const* input,
+                                     size_t input_len, _In_ const char* const* output_names1,
+                                     size_t output_names_len, _In_ OrtValue** output,
+                                     std::vector<std::string>& feed_names, std::vector<OrtValue>& feeds,
+                                     std::vector<std::string>& output_names, std::vector<OrtValue>& fetches) {
   const int queue_id = 0;
 
-  std::vector<std::string> feed_names(input_len);
-  std::vector<OrtValue> feeds(input_len);
+  feed_names.resize(input_len);
+  feeds.resize(input_len);
 
   for (size_t i = 0; i != input_len; ++i) {
     if (input_names[i] == nullptr || input_names[i][0] == '\0') {
@@ -549,7 +608,7 @@ ORT_API_STATUS_IMPL(OrtApis::Run, _Inout_ OrtSession* sess,
   }
 
   // Create output feed
-  std::vector<std::string> output_names(output_names_len);
+  output_names.resize(output_names_len);
   for (size_t i = 0; i != output_names_len; ++i) {
     if (output_names1[i] == nullptr || output_names1[i][0] == '\0') {
       return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "output name cannot be empty");
@@ -557,7 +616,7 @@ ORT_API_STATUS_IMPL(OrtApis::Run, _Inout_ OrtSession* sess,
     output_names[i] = output_names1[i];
   }
 
-  std::vector<OrtValue> fetches(output_names_len);
+  fetches.resize(output_names_len);
   for (size_t i = 0; i != output_names_len; ++i) {
     if (output[i] != nullptr) {
       ::OrtValue& value = *(output[i]);
@@ -566,24 +625,236 @@ ORT_API_STATUS_IMPL(OrtApis::Run, _Inout_ OrtSession* sess,
       fetches[i] = value;
     }
   }
-  Status status;
+
+  return nullptr;
+}
+
+// Returns the fetches of a successful run in the output array of the caller.
+static void SetRunOutputs(std::vector<OrtValue>& fetches, _Inout_ OrtValue** output) {
+  const int queue_id = 0;
+
+  for (size_t i = 0; i != fetches.size(); ++i) {
+    ::OrtValue& value = fetches[i];
+    if (value.Fence())
+      value.Fence()->BeforeUsingAsInput(onnxruntime::kCpuExecutionProvider, queue_id);
+    if (output[i] == nullptr) {
+      output[i] = new OrtValue(value);
+    }
+  }
+}
+
+ORT_API_STATUS_IMPL(OrtApis::Run, _Inout_ OrtSession* sess,
+                    _In_opt_ const OrtRunOptions* run_options,
+                    _In_ const char* const* input_names, _In_ const OrtValue* const* input, size_t input_len,
+                    _In_ const char* const* output_names1, size_t output_names_len, _Outptr_ OrtValue** output) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<::onnxruntime::InferenceSession*>(sess);
+
+  std::vector<std::string> feed_names;
+  std::vector<OrtValue> feeds;
+  std::vector<std::string> output_names;
+  std::vector<OrtValue> fetches;
+  OrtStatus* status = GetFeedsAndFetches(input_names, input, input_len, output_names1, output_names_len, output,
+                                         feed_names, feeds, output_names, fetches);
+  if (status != nullptr)
+    return status;
+
+  Status run_status;
   if (run_options == nullptr) {
     OrtRunOptions op;
-    status = session->Run(op, feed_names, feeds, output_names, &fetches);
+    run_status = session->Run(op, feed_names, feeds, output_names, &fetches);
   } else {
-    status = session->Run(*run_options, feed_names, feeds, output_names, &fetches);
+    run_status = session->Run(*run_options, feed_names, feeds, output_names, &fetches);
   }
 
+  if (!run_status.IsOK())
+    return ToOrtStatus(run_status);
+  SetRunOutputs(fetches, output);
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtApis::RunAsync, _Inout_ OrtSession* sess, _In_opt_ const OrtRunOptions* run_options,
+                    _In_ const char* const* input_names, _In_ const OrtValue* const* input, size_t input_len,
+                    _In_ const char* const* output_names1, size_t output_names_len, _Inout_ OrtValue** output,
+                    _In_ OrtRunAsyncCallbackFn callback, _In_opt_ void* user_data) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<::onnxruntime::InferenceSession*>(sess);
+
+  if (callback == nullptr) {
+    return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "callback cannot be null");
+  }
+
+  std::vector<std::string> feed_names;
+  std::vector<OrtValue> feeds;
+  std::vector<std::string> output_names;
+  std::vector<OrtValue> fetches;
+  OrtStatus* status = GetFeedsAndFetches(input_names, input, input_len, output_names1, output_names_len, output,
+                                         feed_names, feeds, output_names, fetches);
+  if (status != nullptr)
+    return status;
+
+  return ToOrtStatus(session->RunAsync(
+      run_options, std::move(feed_names), std::move(feeds), std::move(output_names), std::move(fetches),
+      [output, output_names_len, callback, user_data](const Status& run_status, std::vector<OrtValue>& run_fetches) {
+        if (!run_status.IsOK()) {
+          callback(user_data, output, output_names_len, ToOrtStatus(run_status));
+          return;
+        }
+        SetRunOutputs(run_fetches, output);
+        callback(user_data, output, output_names_len, nullptr);
+      }));
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtApis::CreateIoBinding, _Inout_ OrtSession* sess, _Outptr_ OrtIoBinding** out) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<::onnxruntime::InferenceSession*>(sess);
+  std::unique_ptr<::onnxruntime::IOBinding> binding;
+  auto status = session->NewIOBinding(&binding);
   if (!status.IsOK())
     return ToOrtStatus(status);
+  *out = new OrtIoBinding{std::move(binding)};
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API(void, OrtApis::ReleaseIoBinding, _Frees_ptr_opt_ OrtIoBinding* binding_ptr) {
+  delete binding_ptr;
+}
+
+ORT_API_STATUS_IMPL(OrtApis::BindInput, _Inout_ OrtIoBinding* binding_ptr, _In_ const char* name,
+                    _In_ const OrtValue* val_ptr) {
+  API_IMPL_BEGIN
+  return ToOrtStatus(binding_ptr->binding_->BindInput(name, *val_ptr));
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtApis::BindOutput, _Inout_ OrtIoBinding* binding_ptr, _In_ const char* name,
+                    _In_ const OrtValue* val_ptr) {
+  API_IMPL_BEGIN
+  return ToOrtStatus(binding_ptr->binding_->BindOutput(name, *val_ptr));
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtApis::BindOutputToDevice, _Inout_ OrtIoBinding* binding_ptr, _In_ const char* name,
+                    _In_ const OrtMemoryInfo* mem_info_ptr) {
+  API_IMPL_BEGIN
+  return ToOrtStatus(binding_ptr->binding_->BindOutput(name, *mem_info_ptr));
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtApis::GetBoundOutputValues, _In_ const OrtIoBinding* binding_ptr, _Inout_ OrtAllocator* allocator,
+                    _Outptr_ OrtValue*** output, _Out_ size_t* output_count) {
+  API_IMPL_BEGIN
+  const auto& outputs = binding_ptr->binding_->GetOutputs();
+  *output = nullptr;
+  *output_count = outputs.size();
+  if (outputs.empty()) {
+    return nullptr;
+  }
+
+  auto values = reinterpret_cast<OrtValue**>(allocator->Alloc(allocator, outputs.size() * sizeof(OrtValue*)));
+  for (size_t i = 0; i != outputs.size(); ++i) {
+    values[i] = new OrtValue(outputs[i]);
+  }
+  *output = values;
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API(void, OrtApis::ClearBoundInputs, _Inout_ OrtIoBinding* binding_ptr) {
+  binding_ptr->binding_->ClearInputs();
+}
+
+ORT_API(void, OrtApis::ClearBoundOutputs, _Inout_ OrtIoBinding* binding_ptr) {
+  binding_ptr->binding_->ClearOutputs();
+}
+
+ORT_API_STATUS_IMPL(OrtApis::RunWithBinding, _Inout_ OrtSession* sess, _In_opt_ const OrtRunOptions* run_options,
+                    _Inout_ OrtIoBinding* binding_ptr) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<::onnxruntime::InferenceSession*>(sess);
+  Status status;
+  if (run_options == nullptr) {
+    OrtRunOptions op;
+    status = session->Run(op, *binding_ptr->binding_);
+  } else {
+    status = session->Run(*run_options, *binding_ptr->binding_);
+  }
+  return ToOrtStatus(status);
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtApis::CreatePreparedRun, _Inout_ OrtSession* sess, _In_ const char* const* input_names,
+                    size_t input_len, _In_ const char* const* output_names1, size_t output_names_len,
+                    _Outptr_ OrtPreparedRun** out) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<::onnxruntime::InferenceSession*>(sess);
+
+  std::vector<std::string> feed_names(input_len);
+  for (size_t i = 0; i != input_len; ++i) {
+    if (input_names[i] == nullptr || input_names[i][0] == '\0') {
+      return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "input name cannot be empty");
+    }
+    feed_names[i] = input_names[i];
+  }
+
+  std::vector<std::string> output_names(output_names_len);
   for (size_t i = 0; i != output_names_len; ++i) {
-    ::OrtValue& value = fetches[i];
-    if (value.Fence())
-      value.Fence()->BeforeUsingAsInput(onnxruntime::kCpuExecutionProvider, queue_id);
-    if (output[i] == nullptr) {
-      output[i] = new OrtValue(value);
+    if (output_names1[i] == nullptr || output_names1[i][0] == '\0') {
+      return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "output name cannot be empty");
     }
+    output_names[i] = output_names1[i];
   }
+
+  std::unique_ptr<::onnxruntime::InferenceSession::PreparedRun> prepared_run;
+  auto status = session->PrepareRun(feed_names, output_names, &prepared_run);
+  if (!status.IsOK())
+    return ToOrtStatus(status);
+  *out = new OrtPreparedRun{std::move(prepared_run)};
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API(void, OrtApis::ReleasePreparedRun, _Frees_ptr_opt_ OrtPreparedRun* prepared_run) {
+  delete prepared_run;
+}
+
+ORT_API_STATUS_IMPL(OrtApis::RunPrepared, _Inout_ OrtSession* sess, _In_opt_ const OrtRunOptions* run_options,
+                    _In_ const OrtPreparedRun* prepared_run, _In_ const OrtValue* const* input, size_t input_len,
+                    _Inout_ OrtValue** output, size_t output_len) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<::onnxruntime::InferenceSession*>(sess);
+  const int queue_id = 0;
+
+  std::vector<OrtValue> feeds(input_len);
+  for (size_t i = 0; i != input_len; ++i) {
+    auto& ort_value = feeds[i] = *reinterpret_cast<const ::OrtValue*>(input[i]);
+    if (ort_value.Fence()) ort_value.Fence()->BeforeUsingAsInput(onnxruntime::kCpuExecutionProvider, queue_id);
+  }
+
+  std::vector<OrtValue> fetches(output_len);
+  for (size_t i = 0; i != output_len; ++i) {
+    if (output[i] != nullptr) {
+      ::OrtValue& value = *(output[i]);
+      if (value.Fence())
+        value.Fence()->BeforeUsingAsOutput(onnxruntime::kCpuExecutionProvider, queue_id);
+      fetches[i] = value;
+    }
+  }
+
+  Status run_status;
+  if (run_options == nullptr) {
+    OrtRunOptions op;
+    run_status = session->Run(op, *prepared_run->prepared_run_, feeds, &fetches);
+  } else {
+    run_status = session->Run(*run_options, *prepared_run->prepared_run_, feeds, &fetches);
+  }
+
+  if (!run_status.IsOK())
+    return ToOrtStatus(run_status);
+  SetRunOutputs(fetches, output);
   return nullptr;
   API_IMPL_END
 }
@@ -702,6 +973,13 @@ ORT_API_STATUS_IMPL(OrtApis::SessionGetOverridableInitializerCount, _In_ const O
   return GetNodeDefListCountHelper(sess, get_overridable_initializers_fn, out);
 }
 
+ORT_API_STATUS_IMPL(OrtApis::SessionShrinkMemoryArenas, _Inout_ OrtSession* sess) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<::onnxruntime::InferenceSession*>(sess);
+  return ToOrtStatus(session->ShrinkMemoryArenas());
+  API_IMPL_END
+}
+
 static OrtStatus* GetNodeDefTypeInfoHelper(const OrtSession* sess, GetDefListFn get_fn, size_t index, _Outptr_ struct OrtTypeInfo** out) {
   API_IMPL_BEGIN
   auto session = reinterpret_cast<const ::onnxruntime::InferenceSession*>(sess);
@@ -1322,7 +1600,11 @@ static constexpr OrtApiBase ort_api_base = {
     &OrtApis::GetVersionString,
 };
 
-static constexpr OrtApi ort_api_1 = {
+static constexpr OrtApi ort_api_1_to_2 = {
+    // NOTE: The ordering of these fields MUST not change after that version has shipped since existing binaries
+    // depend on this ordering.
+
+    // Shipped as version 1 - DO NOT MODIFY
     &OrtApis::CreateStatus,
     &OrtApis::GetErrorCode,
     &OrtApis::GetErrorMessage,
@@ -1437,13 +1719,44 @@ static constexpr OrtApi ort_api_1 = {
     &OrtApis::ReleaseTensorTypeAndShapeInfo,
     &OrtApis::ReleaseSessionOptions,
     &OrtApis::ReleaseCustomOpDomain,
+    // End of Version 1 - DO NOT MODIFY ABOVE
+
+    // Version 2 - In development, feel free to add/remove/rearrange here
+    &OrtApis::SetIntraOpSpinDuration,
+    &OrtApis::SetIntraOpThreadAffinity,
+    &OrtApis::SetIntraOpNumaNode,
+    &OrtApis::CreateEnvWithGlobalThreadPools,
+    &OrtApis::DisablePerSessionThreads,
+    &OrtApis::CreateThreadingOptions,
+    &OrtApis::SetGlobalIntraOpNumThreads,
+    &OrtApis::SetGlobalInterOpNumThreads,
+    &OrtApis::ReleaseThreadingOptions,
+    &OrtApis::SetCpuMemArenaThreadCacheSize,
+    &OrtApis::SetCpuMemArenaConfig,
+    &OrtApis::RunOptionsSetShrinkMemoryArenas,
+    &OrtApis::SessionShrinkMemoryArenas,
+    &OrtApis::SetSparseWeightThreshold,
+    &OrtApis::SetGraphCacheFilePath,
+    &OrtApis::RunAsync,
+    &OrtApis::CreateIoBinding,
+    &OrtApis::ReleaseIoBinding,
+    &OrtApis::BindInput,
+    &OrtApis::BindOutput,
+    &OrtApis::BindOutputToDevice,
+    &OrtApis::GetBoundOutputValues,
+    &OrtApis::ClearBoundInputs,
+    &OrtApis::ClearBoundOutputs,
+    &OrtApis::RunWithBinding,
+    &OrtApis::CreatePreparedRun,
+    &OrtApis::ReleasePreparedRun,
+    &OrtApis::RunPrepared,
 };
 
 ORT_API(const OrtApi*, OrtApis::GetApi, uint32_t version) {
-  if (version > 1)
-    return nullptr;
+  if (version >= 1 && version <= ORT_API_VERSION)
+    return &ort_api_1_to_2;
 
-  return &ort_api_1;
+  return nullptr;
 }
 
 ORT_API(const char*, OrtApis::GetVersionString) {
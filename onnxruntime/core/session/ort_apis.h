@@ -16,6 +16,9 @@ ORT_API(void, ReleaseTypeInfo, OrtTypeInfo*);
 ORT_API(void, ReleaseTensorTypeAndShapeInfo, OrtTensorTypeAndShapeInfo*);
 ORT_API(void, ReleaseSessionOptions, OrtSessionOptions*);
 ORT_API(void, ReleaseCustomOpDomain, OrtCustomOpDomain*);
+ORT_API(void, ReleaseThreadingOptions, OrtThreadingOptions*);
+ORT_API(void, ReleaseIoBinding, OrtIoBinding*);
+ORT_API(void, ReleasePreparedRun, OrtPreparedRun*);
 
 ORT_API_STATUS_IMPL(CreateStatus, OrtErrorCode code, _In_ const char* msg);
 OrtErrorCode ORT_API_CALL GetErrorCode(_In_ const OrtStatus* status) NO_EXCEPTION ORT_ALL_ARGS_NONNULL;
@@ -55,6 +58,23 @@ ORT_API_STATUS_IMPL(SetSessionGraphOptimizationLevel, _In_ OrtSessionOptions* op
                     GraphOptimizationLevel graph_optimization_level);
 ORT_API_STATUS_IMPL(SetIntraOpNumThreads, _Inout_ OrtSessionOptions* options, int intra_op_num_threads);
 ORT_API_STATUS_IMPL(SetInterOpNumThreads, _Inout_ OrtSessionOptions* options, int inter_op_num_threads);
+ORT_API_STATUS_IMPL(SetIntraOpSpinDuration, _Inout_ OrtSessionOptions* options, int spin_duration_us);
+ORT_API_STATUS_IMPL(SetIntraOpThreadAffinity, _Inout_ OrtSessionOptions* options,
+                    _In_ const size_t* logical_processors, size_t num_logical_processors);
+ORT_API_STATUS_IMPL(SetIntraOpNumaNode, _Inout_ OrtSessionOptions* options, int numa_node);
+ORT_API_STATUS_IMPL(DisablePerSessionThreads, _Inout_ OrtSessionOptions* options);
+ORT_API_STATUS_IMPL(SetCpuMemArenaThreadCacheSize, _Inout_ OrtSessionOptions* options, size_t max_bytes_per_thread);
+ORT_API_STATUS_IMPL(SetCpuMemArenaConfig, _Inout_ OrtSessionOptions* options, size_t max_mem,
+                    OrtArenaExtendStrategy extend_strategy, size_t initial_chunk_size_bytes);
+ORT_API_STATUS_IMPL(SetSparseWeightThreshold, _Inout_ OrtSessionOptions* options, float threshold);
+ORT_API_STATUS_IMPL(SetGraphCacheFilePath, _Inout_ OrtSessionOptions* options,
+                    _In_ const ORTCHAR_T* graph_cache_filepath);
+
+ORT_API_STATUS_IMPL(CreateEnvWithGlobalThreadPools, OrtLoggingLevel default_logging_level, _In_ const char* logid,
+                    _In_ const OrtThreadingOptions* tp_options, _Outptr_ OrtEnv** out);
+ORT_API_STATUS_IMPL(CreateThreadingOptions, _Outptr_ OrtThreadingOptions** out);
+ORT_API_STATUS_IMPL(SetGlobalIntraOpNumThreads, _Inout_ OrtThreadingOptions* tp_options, int intra_op_num_threads);
+ORT_API_STATUS_IMPL(SetGlobalInterOpNumThreads, _Inout_ OrtThreadingOptions* tp_options, int inter_op_num_threads);
 
 ORT_API_STATUS_IMPL(CreateCustomOpDomain, _In_ const char* domain, _Outptr_ OrtCustomOpDomain** out);
 ORT_API_STATUS_IMPL(CustomOpDomain_Add, _Inout_ OrtCustomOpDomain* custom_op_domain, _In_ OrtCustomOp* op);
@@ -84,6 +104,30 @@ ORT_API_STATUS_IMPL(RunOptionsGetRunTag, _In_ const OrtRunOptions*, _Out_ const
 
 ORT_API_STATUS_IMPL(RunOptionsSetTerminate, _Inout_ OrtRunOptions* options);
 ORT_API_STATUS_IMPL(RunOptionsUnsetTerminate, _Inout_ OrtRunOptions* options);
+ORT_API_STATUS_IMPL(RunOptionsSetShrinkMemoryArenas, _Inout_ OrtRunOptions* options, int value);
+ORT_API_STATUS_IMPL(SessionShrinkMemoryArenas, _Inout_ OrtSession* sess);
+ORT_API_STATUS_IMPL(RunAsync, _Inout_ OrtSession* sess, _In_opt_ const OrtRunOptions* run_options,
+                    _In_ const char* const* input_names, _In_ const OrtValue* const* input, size_t input_len,
+                    _In_ const char* const* output_names, size_t output_names_len, _Inout_ OrtValue** output,
+                    _In_ OrtRunAsyncCallbackFn callback, _In_opt_ void* user_data);
+
+ORT_API_STATUS_IMPL(CreateIoBinding, _Inout_ OrtSession* sess, _Outptr_ OrtIoBinding** out);
+ORT_API_STATUS_IMPL(BindInput, _Inout_ OrtIoBinding* binding_ptr, _In_ const char* name, _In_ const OrtValue* val_ptr);
+ORT_API_STATUS_IMPL(BindOutput, _Inout_ OrtIoBinding* binding_ptr, _In_ const char* name, _In_ const OrtValue* val_ptr);
+ORT_API_STATUS_IMPL(BindOutputToDevice, _Inout_ OrtIoBinding* binding_ptr, _In_ const char* name,
+                    _In_ const OrtMemoryInfo* mem_info_ptr);
+ORT_API_STATUS_IMPL(GetBoundOutputValues, _In_ const OrtIoBinding* binding_ptr, _Inout_ OrtAllocator* allocator,
+                    _Outptr_ OrtValue*** output, _Out_ size_t* output_count);
+ORT_API(void, ClearBoundInputs, _Inout_ OrtIoBinding* binding_ptr);
+ORT_API(void, ClearBoundOutputs, _Inout_ OrtIoBinding* binding_ptr);
+ORT_API_STATUS_IMPL(RunWithBinding, _Inout_ OrtSession* sess, _In_opt_ const OrtRunOptions* run_options,
+                    _Inout_ OrtIoBinding* binding_ptr);
+
+ORT_API_STATUS_IMPL(CreatePreparedRun, _Inout_ OrtSession* sess, _In_ const char* const* input_names, size_t input_len,
+                    _In_ const char* const* output_names, size_t output_names_len, _Outptr_ OrtPreparedRun** out);
+ORT_API_STATUS_IMPL(RunPrepared, _Inout_ OrtSession* sess, _In_opt_ const OrtRunOptions* run_options,
+                    _In_ const OrtPreparedRun* prepared_run, _In_ const OrtValue* const* input, size_t input_len,
+                    _Inout_ OrtValue** output, size_t output_len);
 
 ORT_API_STATUS_IMPL(CreateTensorAsOrtValue, _Inout_ OrtAllocator* allocator,
                     _In_ const int64_t* shape, size_t shape_len, ONNXTensorElementDataType type,
@@ -2,19 +2,13 @@
 // Licensed under the MIT License.
 
 #include "core/util/qmath.h"
+
+#include <vector>
+
 #include "core/common/common.h"
 #include "core/util/math_cpuonly.h"
 #include "core/mlas/inc/mlas.h"
 
-#if defined(_M_AMD64) || defined(__x86_64__) || defined(_M_IX86) || defined(__i386__)
-#define MLAS_SUPPORTS_GEMM_U8X8
-#else
-// default to gemmlowp when building for arm devices
-#ifndef USE_GEMMLOWP
-#define USE_GEMMLOWP
-#endif
-#endif
-
 #ifdef USE_GEMMLOWP
 #include "core/util/gemmlowp_common.h"
 #endif
@@ -41,10 +35,15 @@ void QGemmu8s8_s32(
 #else
   ORT_UNUSED_PARAMETER(thread_pool);
 
-  ORT_ENFORCE(lhs_offset == 0 && rhs_offset == 0, "For Eigen, zero point must be zero");
   ORT_ENFORCE(lda == K && ldb == N && ldc == N, "For Eigen only RowMajor*RowMajor=RowMajor format is supported");
 
-  EigenCastGEMM<uint8_t, int8_t, int32_t>(lhs_data, rhs_data, result_data, M, N, K);
+  if (lhs_offset == 0 && rhs_offset == 0) {
+    EigenCastGEMM<uint8_t, int8_t, int32_t>(lhs_data, rhs_data, result_data, M, N, K);
+  } else {
+    auto lhs = ConstEigenMatrixMap<uint8_t>(lhs_data, K, M).cast<int32_t>().array() - static_cast<int32_t>(lhs_offset);
+    auto rhs = ConstEigenMatrixMap<int8_t>(rhs_data, N, K).cast<int32_t>().array() - static_cast<int32_t>(rhs_offset);
+    EigenMatrixMap<int32_t>(result_data, N, M) = rhs.matrix() * lhs.matrix();
+  }
 
 #endif
 }
@@ -73,4 +72,87 @@ void QGemmu8u8_s32(
 
 #endif
 }
+
+namespace {
+
+template <typename TOffset>
+void ApplyRhsColumnOffsets(int M, int N, int K, const uint8_t* lhs_data, int lda, const uint8_t lhs_offset,
+                           const TOffset* rhs_offsets, int32_t* result_data, int ldc) {
+  for (int m = 0; m < M; m++) {
+    int32_t row_sum = 0;
+    for (int k = 0; k < K; k++) {
+      row_sum += lhs_data[k];
+    }
+    row_sum -= K * static_cast<int32_t>(lhs_offset);
+
+    for (int n = 0; n < N; n++) {
+      result_data[n] -= static_cast<int32_t>(rhs_offsets[n]) * row_sum;
+    }
+
+    lhs_data += lda;
+    result_data += ldc;
+  }
+}
+
+}  // namespace
+
+void QGemmApplyLhsRowOffsets(
+    int M,
+    int N,
+    int K,
+    const uint8_t* lhs_offsets,
+    const uint8_t* rhs_data,
+    int ldb,
+    const uint8_t rhs_offset,
+    int32_t* result_data,
+    int ldc) {
+  std::vector<int32_t> column_sums(N, -K * static_cast<int32_t>(rhs_offset));
+  for (int k = 0; k < K; k++) {
+    for (int n = 0; n < N; n++) {
+      column_sums[n] += rhs_data[n];
+    }
+    rhs_data += ldb;
+  }
+
+  for (int m = 0; m < M; m++) {
+    const int32_t lhs_offset = lhs_offsets[m];
+    for (int n = 0; n < N; n++) {
+      result_data[n] -= lhs_offset * column_sums[n];
+    }
+    result_data += ldc;
+  }
+}
+
+void QGemmApplyRhsColumnOffsets(
+    int M,
+    int N,
+    int K,
+    const uint8_t* lhs_data,
+    int lda,
+    const uint8_t lhs_offset,
+    const uint8_t* rhs_offsets,
+    int32_t* result_data,
+    int ldc) {
+  ApplyRhsColumnOffsets(M, N, K, lhs_data, lda, lhs_offset, rhs_offsets, result_data, ldc);
+}
+
+void QGemmApplyRhsColumnOffsets(
+    int M,
+    int N,
+    int K,
+    const uint8_t* lhs_data,
+    int lda,
+    const uint8_t lhs_offset,
+    const int8_t* rhs_offsets,
+    int32_t* result_data,
+    int ldc) {
+  ApplyRhsColumnOffsets(M, N, K, lhs_data, lda, lhs_offset, rhs_offsets, result_data, ldc);
+}
+
+void QuantizedS8ToU8(const int8_t* input, uint8_t* output, size_t count) {
+  for (size_t i = 0; i < count; i++) {
+    output[i] = static_cast<uint8_t>(input[i]) ^ 0x80;
+  }
+}
+
 }  // namespace onnxruntime
@@ -5,6 +5,15 @@
 
 #include "core/platform/threadpool.h"
 
+#if defined(_M_AMD64) || defined(__x86_64__) || defined(_M_IX86) || defined(__i386__)
+#define MLAS_SUPPORTS_GEMM_U8X8
+#else
+// default to gemmlowp when building for arm devices
+#ifndef USE_GEMMLOWP
+#define USE_GEMMLOWP
+#endif
+#endif
+
 namespace onnxruntime {
 
 void QGemmu8s8_s32(
@@ -35,4 +44,48 @@ void QGemmu8u8_s32(
     int ldc,
     concurrency::ThreadPool* thread_pool);
 
+// The GEMMs above apply one zero point to each matrix. A zero point per row of the lhs matrix or per column of the
+// rhs matrix is applied by running the GEMM with a zero offset for that matrix, then correcting the result with
+// the routines below.
+
+// result[m][n] -= lhs_offsets[m] * (sum over k of (rhs[k][n] - rhs_offset))
+void QGemmApplyLhsRowOffsets(
+    int M,
+    int N,
+    int K,
+    const uint8_t* lhs_offsets,
+    const uint8_t* rhs_data,
+    int ldb,
+    const uint8_t rhs_offset,
+    int32_t* result_data,
+    int ldc);
+
+// result[m][n] -= rhs_offsets[n] * (sum over k of (lhs[m][k] - lhs_offset))
+void QGemmApplyRhsColumnOffsets(
+    int M,
+    int N,
+    int K,
+    const uint8_t* lhs_data,
+    int lda,
+    const uint8_t lhs_offset,
+    const uint8_t* rhs_offsets,
+    int32_t* result_data,
+    int ldc);
+
+void QGemmApplyRhsColumnOffsets(
+    int M,
+    int N,
+    int K,
+    const uint8_t* lhs_data,
+    int lda,
+    const uint8_t lhs_offset,
+    const int8_t* rhs_offsets,
+    int32_t* result_data,
+    int ldc);
+
+// Converts signed 8-bit quantized values to unsigned 8-bit values by adding 128. Converting the zero point the same
+// way leaves the difference of each value and its zero point unchanged, so signed weights can be multiplied as the
+// lhs matrix of the GEMMs above, which is always unsigned.
+void QuantizedS8ToU8(const int8_t* input, uint8_t* output, size_t count);
+
 }  // namespace onnxruntime
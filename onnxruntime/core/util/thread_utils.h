@@ -5,6 +5,7 @@
 namespace onnxruntime {
 namespace concurrency {
 
-std::unique_ptr<ThreadPool> CreateThreadPool(const std::string& name, int thread_pool_size);
+std::unique_ptr<ThreadPool> CreateThreadPool(const std::string& name, int thread_pool_size,
+                                             const ThreadOptions& thread_options = ThreadOptions());
 }  // namespace concurrency
 }  // namespace onnxruntime
\ No newline at end of file
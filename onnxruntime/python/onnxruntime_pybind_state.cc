@@ -109,6 +109,9 @@ std::string nuphar_settings;
 
 namespace onnxruntime {
 std::shared_ptr<IExecutionProviderFactory> CreateExecutionProviderFactory_CPU(int use_arena);
+std::shared_ptr<IExecutionProviderFactory> CreateExecutionProviderFactory_CPU(int use_arena,
+                                                                              size_t arena_thread_cache_max_bytes,
+                                                                              const ArenaConfig& arena_config);
 std::shared_ptr<IExecutionProviderFactory> CreateExecutionProviderFactory_CUDA(int device_id);
 std::shared_ptr<IExecutionProviderFactory> CreateExecutionProviderFactory_Tensorrt(int device_id);
 std::shared_ptr<IExecutionProviderFactory> CreateExecutionProviderFactory_Dnnl(int use_arena);
@@ -295,7 +298,11 @@ const std::vector<std::string>& GetAvailableProviders() {
 void RegisterExecutionProviders(InferenceSession* sess, const std::vector<std::string>& provider_types) {
   for (const std::string& type : provider_types) {
     if (type == kCpuExecutionProvider) {
-      RegisterExecutionProvider(sess, *onnxruntime::CreateExecutionProviderFactory_CPU(sess->GetSessionOptions().enable_cpu_mem_arena));
+      const auto& session_options = sess->GetSessionOptions();
+      RegisterExecutionProvider(sess, *onnxruntime::CreateExecutionProviderFactory_CPU(
+                                          session_options.enable_cpu_mem_arena,
+                                          session_options.cpu_mem_arena_thread_cache_max_bytes,
+                                          session_options.cpu_mem_arena_config));
     } else if (type == kTensorrtExecutionProvider) {
 #ifdef USE_TENSORRT
       RegisterExecutionProvider(sess, *onnxruntime::CreateExecutionProviderFactory_Tensorrt(0));
@@ -557,10 +564,14 @@ void addObjectMethods(py::module& m) {
       .def_readwrite("enable_cpu_mem_arena", &SessionOptions::enable_cpu_mem_arena,
                      R"pbdoc(Enables the memory arena on CPU. Arena may pre-allocate memory for future usage.
 Set this option to false if you don't want it. Default is True.)pbdoc")
+      .def_readwrite("cpu_mem_arena_thread_cache_max_bytes", &SessionOptions::cpu_mem_arena_thread_cache_max_bytes,
+                     R"pbdoc(Maximum number of bytes of freed blocks each thread caches in front of the CPU memory arena. Reduces contention on the arena when running a session from multiple threads. Default is 0 which disables the cache.)pbdoc")
       .def_readwrite("enable_profiling", &SessionOptions::enable_profiling,
                      R"pbdoc(Enable profiling for this session. Default is false.)pbdoc")
       .def_readwrite("optimized_model_filepath", &SessionOptions::optimized_model_filepath,
                      R"pbdoc(File path to serialize optimized model. By default, optimized model is not serialized if optimized_model_filepath is not provided.)pbdoc")
+      .def_readwrite("graph_cache_filepath", &SessionOptions::graph_cache_filepath,
+                     R"pbdoc(File path of the graph cache. The optimized graph is saved there and loaded by later sessions for the same model and options, which skips the graph optimizations. The execution plan and the kernels are still created. Default is empty which disables the cache.)pbdoc")
       .def_readwrite("enable_mem_pattern", &SessionOptions::enable_mem_pattern,
                      R"pbdoc(Enable the memory pattern optimization. Default is true.)pbdoc")
       .def_readwrite("logid", &SessionOptions::session_logid,
@@ -573,10 +584,18 @@ Set this option to false if you don't want it. Default is True.)pbdoc")
 Applies to session load, initialization, etc. Default is 0.)pbdoc")
       .def_readwrite("intra_op_num_threads", &SessionOptions::intra_op_num_threads,
                      R"pbdoc(Sets the number of threads used to parallelize the execution within nodes. Default is 0 to let onnxruntime choose.)pbdoc")
+      .def_readwrite("intra_op_spin_duration_us", &SessionOptions::intra_op_spin_duration_us,
+                     R"pbdoc(Sets the time in microseconds the threads used within nodes keep spinning for new work before they block. Default is 0 which disables spinning.)pbdoc")
+      .def_readwrite("intra_op_thread_affinity", &SessionOptions::intra_op_thread_affinity,
+                     R"pbdoc(Sets the logical processors the threads used within nodes are pinned to, one per thread. Default is empty which leaves the threads unpinned.)pbdoc")
+      .def_readwrite("intra_op_numa_node", &SessionOptions::intra_op_numa_node,
+                     R"pbdoc(Sets the NUMA node the threads used within nodes are restricted to. Default is -1 which leaves the threads unrestricted.)pbdoc")
       .def_readwrite("inter_op_num_threads", &SessionOptions::inter_op_num_threads,
                      R"pbdoc(Sets the number of threads used to parallelize the execution of the graph (across nodes). Default is 0 to let onnxruntime choose.)pbdoc")
       .def_readwrite("execution_mode", &SessionOptions::execution_mode,
                      R"pbdoc(Sets the execution mode. Default is sequential.)pbdoc")
+      .def_readwrite("sparse_weight_threshold", &SessionOptions::sparse_weight_threshold,
+                     R"pbdoc(MatMul and Gemm weights with at least this fraction of zeros are converted to a sparse format when extended graph optimizations are enabled. Default is 0 which disables the conversion.)pbdoc")
       .def_property(
           "graph_optimization_level",
           [](const SessionOptions* options) -> GraphOptimizationLevel {
@@ -631,7 +650,10 @@ Applies to a particular Run() invocation. Default is 0.)pbdoc")
                      "To identify logs generated by a particular Run() invocation.")
       .def_readwrite("terminate", &RunOptions::terminate,
                      R"pbdoc(Set to True to terminate any currently executing calls that are using this
-RunOptions instance. The individual calls will exit gracefully and return an error status.)pbdoc");
+RunOptions instance. The individual calls will exit gracefully and return an error status.)pbdoc")
+      .def_readwrite("shrink_memory_arenas", &RunOptions::shrink_memory_arenas,
+                     R"pbdoc(Set to True to release the memory held but not used by the arenas of the session at the end of
+the Run. Default is False.)pbdoc");
 
   py::class_<ModelMetadata>(m, "ModelMetadata", R"pbdoc(Pre-defined and custom metadata about the model.
 It is usually used to identify the model used to run the prediction and
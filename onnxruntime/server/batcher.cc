@@ -0,0 +1,342 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+
+#include "batcher.h"
+
+namespace onnxruntime {
+namespace server {
+
+// Size of an element of the tensor types whose data can be copied as bytes, 0 for the others.
+static size_t ElementSize(ONNXTensorElementDataType type) {
+  switch (type) {
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT8:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT8:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_BOOL:
+      return 1;
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT16:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT16:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT16:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_BFLOAT16:
+      return 2;
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT32:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT32:
+      return 4;
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_DOUBLE:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT64:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT64:
+      return 8;
+    default:
+      return 0;
+  }
+}
+
+static std::vector<const char*> ToCStrings(const std::vector<std::string>& names) {
+  std::vector<const char*> result;
+  result.reserve(names.size());
+  for (const auto& name : names) {
+    result.push_back(name.c_str());
+  }
+  return result;
+}
+
+Batcher::Batcher(Ort::Session& session, const BatchingOptions& options, std::shared_ptr<spdlog::logger> logger)
+    : session_(session), options_(options), logger_(std::move(logger)) {
+  for (size_t i = 0; i < std::max<size_t>(options_.max_concurrent_batches, 1); ++i) {
+    threads_.emplace_back(&Batcher::ThreadMain, this);
+  }
+}
+
+Batcher::~Batcher() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    shutdown_ = true;
+  }
+  cv_.notify_all();
+  for (auto& thread : threads_) {
+    thread.join();
+  }
+}
+
+bool Batcher::SupportsBatching(const Ort::Session& session) {
+  for (size_t i = 0, count = session.GetInputCount(); i < count; ++i) {
+    auto type_info = session.GetInputTypeInfo(i);
+    if (type_info.GetONNXType() != ONNX_TYPE_TENSOR) {
+      return false;
+    }
+
+    auto shape = type_info.GetTensorTypeAndShapeInfo().GetShape();
+    if (shape.empty() || shape[0] != -1) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+bool Batcher::CanBatch(const std::vector<Ort::Value>& input_values) const {
+  if (input_values.empty()) {
+    return false;
+  }
+
+  int64_t rows = -1;
+  for (const auto& value : input_values) {
+    if (!value.IsTensor()) {
+      return false;
+    }
+
+    auto info = value.GetTensorTypeAndShapeInfo();
+    auto shape = info.GetShape();
+    if (ElementSize(info.GetElementType()) == 0 || shape.empty() || (rows != -1 && shape[0] != rows)) {
+      return false;
+    }
+    rows = shape[0];
+  }
+
+  return rows > 0 && static_cast<size_t>(rows) <= options_.max_batch_size;
+}
+
+std::vector<Ort::Value> Batcher::Run(const Ort::RunOptions& run_options, const std::vector<std::string>& input_names,
+                                     const std::vector<Ort::Value>& input_values,
+                                     const std::vector<std::string>& output_names) {
+  std::unique_ptr<Request> request(new Request());
+  request->run_options = &run_options;
+  request->input_names = &input_names;
+  request->input_values = &input_values;
+  request->output_names = &output_names;
+
+  request->input_order.resize(input_names.size());
+  std::iota(request->input_order.begin(), request->input_order.end(), size_t{0});
+  std::sort(request->input_order.begin(), request->input_order.end(),
+            [&input_names](size_t a, size_t b) { return input_names[a] < input_names[b]; });
+
+  for (auto i : request->input_order) {
+    auto info = input_values[i].GetTensorTypeAndShapeInfo();
+    auto shape = info.GetShape();
+    request->rows = shape[0];
+    request->signature += input_names[i] + ":" + std::to_string(info.GetElementType());
+    for (size_t d = 1; d < shape.size(); ++d) {
+      request->signature += "," + std::to_string(shape[d]);
+    }
+    request->signature += ";";
+  }
+  for (const auto& name : output_names) {
+    request->signature += "|" + name;
+  }
+
+  auto outputs = request->outputs.get_future();
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    request->enqueue_time = std::chrono::steady_clock::now();
+    queue_.push_back(std::move(request));
+  }
+  cv_.notify_one();
+
+  return outputs.get();
+}
+
+BatcherMetrics Batcher::GetMetrics() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  BatcherMetrics metrics = metrics_;
+  metrics.queue_depth = queue_.size();
+  return metrics;
+}
+
+void Batcher::ThreadMain() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    cv_.wait(lock, [this] { return shutdown_ || !queue_.empty(); });
+    if (queue_.empty()) {
+      return;
+    }
+
+    // wait for more requests until the batch is full or its oldest request has waited for the timeout. another
+    // thread may take the batch meanwhile, so check the queue again after waiting.
+    const auto deadline = queue_.front()->enqueue_time + options_.batch_timeout;
+    if (!shutdown_ && CompatibleRows() < options_.max_batch_size && std::chrono::steady_clock::now() < deadline) {
+      cv_.wait_until(lock, deadline);
+      continue;
+    }
+
+    auto batch = TakeBatch();
+    if (!queue_.empty()) {
+      // let an idle thread form the next batch from the remaining requests
+      cv_.notify_one();
+    }
+
+    size_t rows = 0;
+    for (const auto& request : batch) {
+      rows += static_cast<size_t>(request->rows);
+    }
+
+    ++metrics_.batch_count;
+    metrics_.request_count += batch.size();
+    metrics_.row_count += rows;
+    metrics_.max_batch_size_seen = std::max(metrics_.max_batch_size_seen, rows);
+    logger_->debug("Running a batch of {} requests with {} rows, {} requests queued. Requests: {}", batch.size(), rows,
+                   queue_.size(), BatchRunTag(batch));
+
+    lock.unlock();
+    RunBatch(batch);
+    lock.lock();
+  }
+}
+
+// Rows of the queued requests that can join the batch of the oldest one, up to the maximum batch size.
+size_t Batcher::CompatibleRows() const {
+  const auto& signature = queue_.front()->signature;
+  size_t rows = 0;
+  for (const auto& request : queue_) {
+    if (request->signature == signature) {
+      rows += static_cast<size_t>(request->rows);
+      if (rows >= options_.max_batch_size) {
+        break;
+      }
+    }
+  }
+  return rows;
+}
+
+// Removes the oldest request from the queue with the compatible requests that fit in its batch.
+std::vector<std::unique_ptr<Batcher::Request>> Batcher::TakeBatch() {
+  std::vector<std::unique_ptr<Request>> batch;
+  const std::string signature = queue_.front()->signature;
+  size_t rows = 0;
+  for (auto it = queue_.begin(); it != queue_.end();) {
+    const auto request_rows = static_cast<size_t>((*it)->rows);
+    if ((*it)->signature == signature && rows + request_rows <= options_.max_batch_size) {
+      rows += request_rows;
+      batch.push_back(std::move(*it));
+      it = queue_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  return batch;
+}
+
+void Batcher::RunBatch(std::vector<std::unique_ptr<Request>>& batch) {
+  int64_t rows = 0;
+  for (const auto& request : batch) {
+    rows += request->rows;
+  }
+
+  if (batch.size() > 1 && RunConcatenated(batch, rows)) {
+    return;
+  }
+
+  // run the requests one by one, so that a request that fails doesn't fail the others of its batch
+  for (auto& request : batch) {
+    try {
+      request->outputs.set_value(RunOne(*request));
+    } catch (...) {
+      request->outputs.set_exception(std::current_exception());
+    }
+  }
+}
+
+std::vector<Ort::Value> Batcher::RunOne(const Request& request) {
+  auto input_names = ToCStrings(*request.input_names);
+  auto output_names = ToCStrings(*request.output_names);
+  return session_.Run(*request.run_options, input_names.data(), request.input_values->data(), input_names.size(),
+                      output_names.data(), output_names.size());
+}
+
+// Run tags of the requests of the batch, separated by commas.
+std::string Batcher::BatchRunTag(const std::vector<std::unique_ptr<Request>>& batch) {
+  std::string run_tag;
+  for (const auto& request : batch) {
+    if (!run_tag.empty()) {
+      run_tag += ",";
+    }
+    run_tag += request->run_options->GetRunTag();
+  }
+  return run_tag;
+}
+
+// Runs the batch as one request. Returns false if the run fails or its outputs can't be split by the rows of the
+// requests, leaving the requests to be run separately.
+bool Batcher::RunConcatenated(std::vector<std::unique_ptr<Request>>& batch, int64_t rows) {
+  const Request& first = *batch.front();
+  std::vector<std::vector<Ort::Value>> outputs(batch.size());
+
+  try {
+    Ort::AllocatorWithDefaultOptions allocator;
+
+    std::vector<const char*> input_names;
+    std::vector<Ort::Value> inputs;
+    for (size_t i = 0; i < first.input_order.size(); ++i) {
+      const auto& first_input = (*first.input_values)[first.input_order[i]];
+      auto info = first_input.GetTensorTypeAndShapeInfo();
+      auto shape = info.GetShape();
+      const auto type = info.GetElementType();
+      const size_t row_bytes = ElementSize(type) * (info.GetElementCount() / static_cast<size_t>(shape[0]));
+
+      shape[0] = rows;
+      auto input = Ort::Value::CreateTensor(allocator, shape.data(), shape.size(), type);
+      auto* data = input.GetTensorMutableData<uint8_t>();
+      for (const auto& request : batch) {
+        auto& value = const_cast<Ort::Value&>((*request->input_values)[request->input_order[i]]);
+        const size_t bytes = row_bytes * static_cast<size_t>(request->rows);
+        memcpy(data, value.GetTensorMutableData<uint8_t>(), bytes);
+        data += bytes;
+      }
+
+      input_names.push_back((*first.input_names)[first.input_order[i]].c_str());
+      inputs.push_back(std::move(input));
+    }
+
+    // the logs of the run name every request of the batch
+    const std::string run_tag = BatchRunTag(batch);
+    Ort::RunOptions run_options;
+    run_options.SetRunLogVerbosityLevel(first.run_options->GetRunLogVerbosityLevel());
+    run_options.SetRunLogSeverityLevel(first.run_options->GetRunLogSeverityLevel());
+    run_options.SetRunTag(run_tag.c_str());
+
+    auto output_names = ToCStrings(*first.output_names);
+    auto batch_outputs = session_.Run(run_options, input_names.data(), inputs.data(), inputs.size(),
+                                      output_names.data(), output_names.size());
+
+    for (size_t o = 0; o < batch_outputs.size(); ++o) {
+      auto& batch_output = batch_outputs[o];
+      if (!batch_output.IsTensor()) {
+        logger_->warn("Output {} of the batch is not a tensor", output_names[o]);
+        return false;
+      }
+
+      auto info = batch_output.GetTensorTypeAndShapeInfo();
+      auto shape = info.GetShape();
+      const auto type = info.GetElementType();
+      if (ElementSize(type) == 0 || shape.empty() || shape[0] != rows) {
+        logger_->warn("Output {} of the batch can't be split by the rows of the requests", output_names[o]);
+        return false;
+      }
+
+      const size_t row_bytes = ElementSize(type) * (info.GetElementCount() / static_cast<size_t>(rows));
+      const auto* data = batch_output.GetTensorMutableData<uint8_t>();
+      for (size_t r = 0; r < batch.size(); ++r) {
+        shape[0] = batch[r]->rows;
+        auto output = Ort::Value::CreateTensor(allocator, shape.data(), shape.size(), type);
+        const size_t bytes = row_bytes * static_cast<size_t>(batch[r]->rows);
+        memcpy(output.GetTensorMutableData<uint8_t>(), data, bytes);
+        data += bytes;
+        outputs[r].push_back(std::move(output));
+      }
+    }
+  } catch (const std::exception& e) {
+    logger_->warn("Running a batch of {} requests failed: {}. Requests: {}", batch.size(), e.what(), BatchRunTag(batch));
+    return false;
+  }
+
+  for (size_t r = 0; r < batch.size(); ++r) {
+    batch[r]->outputs.set_value(std::move(outputs[r]));
+  }
+  return true;
+}
+
+}  // namespace server
+}  // namespace onnxruntime
@@ -0,0 +1,102 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "core/session/onnxruntime_cxx_api.h"
+#include <spdlog/spdlog.h>
+
+namespace onnxruntime {
+namespace server {
+
+struct BatchingOptions {
+  // Largest number of rows in a batch. 1 disables batching.
+  size_t max_batch_size = 1;
+  // Longest time a request waits for other requests to join its batch.
+  std::chrono::microseconds batch_timeout{1000};
+  // Number of batches of a model that can run at the same time.
+  size_t max_concurrent_batches = 1;
+};
+
+struct BatcherMetrics {
+  size_t queue_depth = 0;          // requests waiting for a batch
+  uint64_t batch_count = 0;        // batches run
+  uint64_t request_count = 0;      // requests run in the batches
+  uint64_t row_count = 0;          // rows run in the batches
+  size_t max_batch_size_seen = 0;  // most rows in one batch
+};
+
+// Runs the requests for a session in batches. Requests with the same inputs and outputs, whose input tensors
+// differ only in their first dimension, wait up to the batch timeout for each other. They are concatenated along the
+// first dimension, run once, and the outputs are split back by the rows of each request.
+// Up to max_concurrent_batches threads run the batches, so the requests arriving while they are all busy form the
+// next ones.
+class Batcher {
+ public:
+  Batcher(Ort::Session& session, const BatchingOptions& options, std::shared_ptr<spdlog::logger> logger);
+  ~Batcher();
+  Batcher(const Batcher&) = delete;
+  Batcher& operator=(const Batcher&) = delete;
+
+  // True if every input of the model has a symbolic first dimension, so that the model accepts batches.
+  static bool SupportsBatching(const Ort::Session& session);
+
+  // True if the inputs can join a batch: non-string tensors of rank 1 or more, with at most max_batch_size rows.
+  bool CanBatch(const std::vector<Ort::Value>& input_values) const;
+
+  // Runs the request as part of a batch and waits for its outputs. Throws Ort::Exception if the run fails.
+  // A batch runs with the options of its first request, and its run tag lists the run tags of all its requests.
+  std::vector<Ort::Value> Run(const Ort::RunOptions& run_options, const std::vector<std::string>& input_names,
+                              const std::vector<Ort::Value>& input_values,
+                              const std::vector<std::string>& output_names);
+
+  BatcherMetrics GetMetrics() const;
+
+ private:
+  struct Request {
+    const Ort::RunOptions* run_options;
+    const std::vector<std::string>* input_names;
+    const std::vector<Ort::Value>* input_values;
+    const std::vector<std::string>* output_names;
+    // indices of the inputs sorted by name, so that the inputs of compatible requests line up
+    std::vector<size_t> input_order;
+    // input and output names, element types and dimensions after the first one; equal for compatible requests
+    std::string signature;
+    int64_t rows;
+    std::chrono::steady_clock::time_point enqueue_time;
+    std::promise<std::vector<Ort::Value>> outputs;
+  };
+
+  void ThreadMain();
+  size_t CompatibleRows() const;
+  std::vector<std::unique_ptr<Request>> TakeBatch();
+  void RunBatch(std::vector<std::unique_ptr<Request>>& batch);
+  std::vector<Ort::Value> RunOne(const Request& request);
+  bool RunConcatenated(std::vector<std::unique_ptr<Request>>& batch, int64_t rows);
+  static std::string BatchRunTag(const std::vector<std::unique_ptr<Request>>& batch);
+
+  Ort::Session& session_;
+  const BatchingOptions options_;
+  const std::shared_ptr<spdlog::logger> logger_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable cv_;
+  std::deque<std::unique_ptr<Request>> queue_;  // GUARDED_BY(mutex_)
+  BatcherMetrics metrics_;                      // GUARDED_BY(mutex_)
+  bool shutdown_ = false;                       // GUARDED_BY(mutex_)
+
+  std::vector<std::thread> threads_;
+};
+
+}  // namespace server
+}  // namespace onnxruntime
@@ -1,6 +1,7 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <algorithm>
 #include <memory>
 #include "environment.h"
 #include "core/session/onnxruntime_cxx_api.h"
@@ -86,47 +87,116 @@ void ServerEnvironment::RegisterExecutionProviders(){
 
 }
 
-void ServerEnvironment::InitializeModel(const std::string& model_path, const std::string& model_name, const std::string& model_version) {
-  RegisterExecutionProviders();
-  auto result = sessions_.emplace(std::piecewise_construct, std::forward_as_tuple(model_name, model_version), std::forward_as_tuple(runtime_environment_, model_path.c_str(), options_));
+std::shared_ptr<const Model> ServerEnvironment::LoadModel(const std::string& model_path, const std::string& model_name,
+                                                         const std::string& model_version) {
+  std::call_once(providers_registered_, [this]() { RegisterExecutionProviders(); });
+  auto model = std::make_shared<Model>(runtime_environment_, model_path, options_);
 
-  if (!result.second) {
-    throw Ort::Exception("Model of that name already loaded.", ORT_INVALID_ARGUMENT);
-  }
-
-  auto iterator = result.first;
-  auto output_count = (iterator->second).session.GetOutputCount();
+  auto output_count = model->session.GetOutputCount();
 
   Ort::AllocatorWithDefaultOptions allocator;
   for (size_t i = 0; i < output_count; i++) {
-    auto name = (iterator->second).session.GetOutputName(i, allocator);
-    (iterator->second).output_names.push_back(name);
+    auto name = model->session.GetOutputName(i, allocator);
+    model->output_names.push_back(name);
     allocator.Free(name);
   }
+
+  if (batching_options_.max_batch_size > 1) {
+    if (Batcher::SupportsBatching(model->session)) {
+      model->batcher = std::unique_ptr<Batcher>(new Batcher(model->session, batching_options_, default_logger_));
+    } else {
+      default_logger_->info("Requests for model {} version {} are not batched: not every input has a symbolic first dimension",
+                            model_name, model_version);
+    }
+  }
+
+  return model;
 }
 
-const std::vector<std::string>& ServerEnvironment::GetModelOutputNames(const std::string& model_name, const std::string& model_version) const {
+void ServerEnvironment::InitializeModel(const std::string& model_path, const std::string& model_name, const std::string& model_version) {
   auto identifier = std::make_pair(model_name, model_version);
-  auto it = sessions_.find(identifier);
-  if (it == sessions_.end()) {
-    throw Ort::Exception("No model loaded of that name.", ORT_NO_MODEL);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (models_.find(identifier) != models_.end()) {
+      throw Ort::Exception("Model of that name already loaded.", ORT_INVALID_ARGUMENT);
+    }
   }
 
-  return it->second.output_names;
+  auto model = LoadModel(model_path, model_name, model_version);
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!models_.emplace(identifier, std::move(model)).second) {
+    throw Ort::Exception("Model of that name already loaded.", ORT_INVALID_ARGUMENT);
+  }
 }
 
-OrtLoggingLevel ServerEnvironment::GetLogSeverity() const {
-  return severity_;
+void ServerEnvironment::ReplaceModel(const std::string& model_path, const std::string& model_name, const std::string& model_version) {
+  auto model = LoadModel(model_path, model_name, model_version);
+
+  // the replaced model is released outside the lock, when the requests running on it complete
+  std::shared_ptr<const Model> replaced;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& loaded = models_[std::make_pair(model_name, model_version)];
+    replaced = std::move(loaded);
+    loaded = std::move(model);
+  }
 }
 
-const Ort::Session& ServerEnvironment::GetSession(const std::string& model_name, const std::string& model_version) const {
-  auto identifier = std::make_pair(model_name, model_version);
-  auto it = sessions_.find(identifier);
-  if (it == sessions_.end()) {
+void ServerEnvironment::SetBatchingOptions(const BatchingOptions& options) {
+  batching_options_ = options;
+}
+
+// Orders the versions numerically when both are numbers, and by name otherwise.
+static bool VersionLess(const std::string& a, const std::string& b) {
+  const bool a_numeric = !a.empty() && a.find_first_not_of("0123456789") == std::string::npos;
+  const bool b_numeric = !b.empty() && b.find_first_not_of("0123456789") == std::string::npos;
+  if (a_numeric && b_numeric) {
+    const auto a_digits = a.substr(std::min(a.find_first_not_of('0'), a.size() - 1));
+    const auto b_digits = b.substr(std::min(b.find_first_not_of('0'), b.size() - 1));
+    return a_digits.size() != b_digits.size() ? a_digits.size() < b_digits.size() : a_digits < b_digits;
+  }
+  return a_numeric != b_numeric ? a_numeric < b_numeric : a < b;
+}
+
+std::shared_ptr<const Model> ServerEnvironment::GetModel(const std::string& model_name, const std::string& model_version) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!model_version.empty()) {
+    auto it = models_.find(std::make_pair(model_name, model_version));
+    if (it == models_.end()) {
+      throw Ort::Exception("No model loaded of that name.", ORT_NO_MODEL);
+    }
+    return it->second;
+  }
+
+  auto latest = models_.end();
+  for (auto it = models_.begin(); it != models_.end(); ++it) {
+    if (it->first.first == model_name && (latest == models_.end() || VersionLess(latest->first.second, it->first.second))) {
+      latest = it;
+    }
+  }
+  if (latest == models_.end()) {
     throw Ort::Exception("No model loaded of that name.", ORT_NO_MODEL);
   }
+  return latest->second;
+}
 
-  return it->second.session;
+std::vector<std::string> ServerEnvironment::GetModelVersions(const std::string& model_name) const {
+  std::vector<std::string> versions;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& entry : models_) {
+      if (entry.first.first == model_name) {
+        versions.push_back(entry.first.second);
+      }
+    }
+  }
+  std::sort(versions.begin(), versions.end(), VersionLess);
+  return versions;
+}
+
+OrtLoggingLevel ServerEnvironment::GetLogSeverity() const {
+  return severity_;
 }
 
 std::shared_ptr<spdlog::logger> ServerEnvironment::GetLogger(const std::string& request_id) const {
@@ -140,13 +210,18 @@ std::shared_ptr<spdlog::logger> ServerEnvironment::GetAppLogger() const {
 }
 
 void ServerEnvironment::UnloadModel(const std::string& model_name, const std::string& model_version) {
-  auto identifier = std::make_pair(model_name, model_version);
-  auto it = sessions_.find(identifier);
-  if (it == sessions_.end()) {
-    throw Ort::Exception("No model loaded of that name.", ORT_NO_MODEL);
+  // the model is released outside the lock, when the requests running on it complete
+  std::shared_ptr<const Model> unloaded;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = models_.find(std::make_pair(model_name, model_version));
+    if (it == models_.end()) {
+      throw Ort::Exception("No model loaded of that name.", ORT_NO_MODEL);
+    }
+
+    unloaded = std::move(it->second);
+    models_.erase(it);
   }
-
-  sessions_.erase(it);
 }
 
 }  // namespace server
@@ -4,9 +4,12 @@
 #pragma once
 
 #include <memory>
+#include <mutex>
+#include <string>
 #include <vector>
 
 #include "core/session/onnxruntime_cxx_api.h"
+#include "batcher.h"
 #include <spdlog/spdlog.h>
 #include <unordered_map>
 #include <boost/functional/hash.hpp>
@@ -14,6 +17,23 @@
 namespace onnxruntime {
 namespace server {
 
+// A version of a model loaded in a session. Requests hold on to it until they complete, so that replacing or
+// unloading the version doesn't release the session under them.
+struct Model {
+  Ort::Session session;
+  std::vector<std::string> output_names;
+  // destroyed before the session, running the requests it queued
+  std::unique_ptr<Batcher> batcher;
+  explicit Model(Ort::Env& env, const std::string& path, const Ort::SessionOptions& options) : session(nullptr) {
+    session = Ort::Session(env, path.c_str(), options);
+  };
+  ~Model() = default;
+  Model(const Model&) = delete;
+  Model(const Model&&) = delete;
+  Model& operator=(const Model&) = delete;
+};
+
+// Hosts the models loaded by the server. The models may be loaded, replaced and unloaded while requests run.
 class ServerEnvironment {
  public:
   explicit ServerEnvironment(OrtLoggingLevel severity, spdlog::sinks_init_list sink);
@@ -22,15 +42,27 @@ class ServerEnvironment {
 
   OrtLoggingLevel GetLogSeverity() const;
 
-  const Ort::Session& GetSession(const std::string& model_name, const std::string& model_version) const;
+  // The model of that name and version. An empty version selects the latest one: the highest numeric version.
+  // Throws Ort::Exception with ORT_NO_MODEL if there's no such model.
+  std::shared_ptr<const Model> GetModel(const std::string& model_name, const std::string& model_version) const;
+  // The versions of the model loaded, empty if there's no model of that name
+  std::vector<std::string> GetModelVersions(const std::string& model_name) const;
+  // Loads the model. Throws if a model of that name and version is already loaded.
   void InitializeModel(const std::string& model_path, const std::string& model_name, const std::string& model_version);
-  const std::vector<std::string>& GetModelOutputNames(const std::string& model_name, const std::string& model_version) const;
+  // Loads the model and swaps it in for the model of that name and version, if one is loaded. The session is
+  // initialized before the swap, and the requests running on the replaced model complete on it.
+  void ReplaceModel(const std::string& model_path, const std::string& model_name, const std::string& model_version);
+  // Batch the requests of the models initialized afterwards that accept batches
+  void SetBatchingOptions(const BatchingOptions& options);
   std::shared_ptr<spdlog::logger> GetLogger(const std::string& request_id) const;
   std::shared_ptr<spdlog::logger> GetAppLogger() const;
   void UnloadModel(const std::string& model_name, const std::string& model_version);
   void RegisterExecutionProviders();
 
  private:
+  std::shared_ptr<const Model> LoadModel(const std::string& model_path, const std::string& model_name,
+                                         const std::string& model_version);
+
   const OrtLoggingLevel severity_;
   const std::string logger_id_;
   const std::vector<spdlog::sink_ptr> sink_;
@@ -38,20 +70,13 @@ class ServerEnvironment {
 
   Ort::Env runtime_environment_;
   Ort::SessionOptions options_;
+  std::once_flag providers_registered_;
+  BatchingOptions batching_options_;
 
-  struct SessionHolder {
-    Ort::Session session;
-    std::vector<std::string> output_names;
-    explicit SessionHolder(Ort::Env& env, std::string path, const Ort::SessionOptions& options) : session(nullptr) {
-      session = Ort::Session(env, path.c_str(), options);
-    };
-    ~SessionHolder() = default;
-    SessionHolder(const SessionHolder&) = delete;
-    SessionHolder(const SessionHolder&&) = delete;
-    SessionHolder& operator=(const SessionHolder&) = delete;
-  };
-
-  std::unordered_map<std::pair<std::string, std::string>, ServerEnvironment::SessionHolder, boost::hash<std::pair<std::string, std::string>>> sessions_;
+  mutable std::mutex mutex_;
+  std::unordered_map<std::pair<std::string, std::string>, std::shared_ptr<const Model>,
+                     boost::hash<std::pair<std::string, std::string>>>
+      models_;  // GUARDED_BY(mutex_)
 };
 
 }  // namespace server
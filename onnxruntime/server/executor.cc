@@ -122,6 +122,14 @@ protobufutil::Status Executor::Predict(const std::string& model_name,
   run_options.SetRunLogVerbosityLevel(static_cast<int>(env_->GetLogSeverity()));
   run_options.SetRunTag(request_id_.c_str());
 
+  // Hold on to the model until the request completes, so that it survives being replaced or unloaded meanwhile
+  std::shared_ptr<const Model> model;
+  try {
+    model = env_->GetModel(model_name, model_version);
+  } catch (const Ort::Exception& e) {
+    return GenerateProtobufStatus(e.GetOrtErrorCode(), e.what());
+  }
+
   // Prepare the output names
   std::vector<std::string> output_names;
 
@@ -131,12 +139,16 @@ protobufutil::Status Executor::Predict(const std::string& model_name,
       output_names.push_back(name);
     }
   } else {
-    output_names = env_->GetModelOutputNames(model_name, model_version);
+    output_names = model->output_names;
   }
 
   std::vector<Ort::Value> outputs;
   try {
-    outputs = Run(env_->GetSession(model_name, model_version), run_options, input_names, input_values, output_names);
+    if (model->batcher != nullptr && model->batcher->CanBatch(input_values)) {
+      outputs = model->batcher->Run(run_options, input_names, input_values, output_names);
+    } else {
+      outputs = Run(model->session, run_options, input_names, input_values, output_names);
+    }
   } catch (const Ort::Exception& e) {
     return GenerateProtobufStatus(e.GetOrtErrorCode(), e.what());
   }
@@ -11,7 +11,7 @@ PredictionServiceImpl::PredictionServiceImpl(const std::shared_ptr<onnxruntime::
   auto request_id = SetRequestContext(context);
   onnxruntime::server::Executor executor(environment_.get(), request_id);
   //TODO: (csteegz) Add modelspec for both paths.
-  auto status = executor.Predict("default", "1", *request, *response);  // Currently only support one model so hard coded.
+  auto status = executor.Predict("default", "", *request, *response);  // Currently only the latest version of the default model.
   if (!status.ok()) {
     return ::grpc::Status(::grpc::StatusCode(status.error_code()), status.error_message());
   }
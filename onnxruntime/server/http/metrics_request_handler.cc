@@ -0,0 +1,52 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <sstream>
+
+#include "json_handling.h"
+#include "metrics_request_handler.h"
+#include "util.h"
+
+namespace onnxruntime {
+namespace server {
+
+void GetMetrics(const std::string& name,
+                const std::string& version,
+                /* in, out */ HttpContext& context,
+                const std::shared_ptr<ServerEnvironment>& env) {
+  context.response.insert(util::MS_REQUEST_ID_HEADER, context.request_id);
+  if (!context.client_request_id.empty()) {
+    context.response.insert(util::MS_CLIENT_REQUEST_ID_HEADER, context.client_request_id);
+  }
+  context.response.set(http::field::content_type, "application/json");
+
+  std::shared_ptr<const Model> model;
+  try {
+    model = env->GetModel(name, version);
+  } catch (const Ort::Exception& e) {
+    context.response.result(http::status::not_found);
+    context.response.body() = CreateJsonError(http::status::not_found, e.what());
+    return;
+  }
+
+  const Batcher* batcher = model->batcher.get();
+  BatcherMetrics metrics{};
+  if (batcher != nullptr) {
+    metrics = batcher->GetMetrics();
+  }
+
+  std::ostringstream body;
+  body << R"({"batching": )" << (batcher != nullptr ? "true" : "false")
+       << R"(, "queueDepth": )" << metrics.queue_depth
+       << R"(, "batchCount": )" << metrics.batch_count
+       << R"(, "requestCount": )" << metrics.request_count
+       << R"(, "rowCount": )" << metrics.row_count
+       << R"(, "maxBatchSize": )" << metrics.max_batch_size_seen
+       << "}\n";
+
+  context.response.body() = body.str();
+  context.response.result(http::status::ok);
+}
+
+}  // namespace server
+}  // namespace onnxruntime
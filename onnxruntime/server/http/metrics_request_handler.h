@@ -0,0 +1,19 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "http_server.h"
+#include "environment.h"
+
+namespace onnxruntime {
+namespace server {
+
+// Responds with the batching metrics of the model as JSON
+void GetMetrics(const std::string& name,
+                const std::string& version,
+                /* in, out */ HttpContext& context,
+                const std::shared_ptr<ServerEnvironment>& env);
+
+}  // namespace server
+}  // namespace onnxruntime
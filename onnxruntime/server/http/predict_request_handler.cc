@@ -40,7 +40,6 @@ void Predict(const std::string& name,
   logger->info("Model Name: {}, Version: {}, Action: {}", name, version, action);
 
   auto effective_name = name.empty() ? "default" : name;
-  auto effective_version = version.empty() ? "1" : version;
 
   if (!context.client_request_id.empty()) {
     logger->info("{}: [{}]", util::MS_CLIENT_REQUEST_ID_HEADER, context.client_request_id);
@@ -67,7 +66,8 @@ void Predict(const std::string& name,
   // Run Prediction
   Executor executor(env.get(), context.request_id);
   PredictResponse predict_response{};
-  auto status = executor.Predict(effective_name, effective_version, predict_request, predict_response);
+  // an empty version selects the latest version of the model
+  auto status = executor.Predict(effective_name, version, predict_request, predict_response);
   if (!status.ok()) {
     GenerateErrorResponse(logger, GetHttpStatusCode((status)), status.error_message(), context);
     return;
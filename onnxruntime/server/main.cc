@@ -4,6 +4,8 @@
 #include "environment.h"
 #include "http_server.h"
 #include "predict_request_handler.h"
+#include "metrics_request_handler.h"
+#include "model_repository.h"
 #include "server_configuration.h"
 #include "grpc/grpc_app.h"
 #include <spdlog/spdlog.h>
@@ -60,14 +62,33 @@ int main(int argc, char* argv[]) {
 
   const auto env = std::make_shared<server::ServerEnvironment>(config.logging_level, spdlog::sinks_init_list{std::make_shared<spdlog::sinks::stdout_sink_mt>(), std::make_shared<spdlog::sinks::syslog_sink_mt>()});
   auto logger = env->GetAppLogger();
-  logger->info("Model path: {}", config.model_path);
+  if (config.max_batch_size > 1) {
+    logger->info("Batching up to {} rows, waiting up to {} microseconds, running up to {} batches per model at once",
+                 config.max_batch_size, config.batch_timeout_micros, config.max_concurrent_batches);
+    server::BatchingOptions batching_options;
+    batching_options.max_batch_size = static_cast<size_t>(config.max_batch_size);
+    batching_options.batch_timeout = std::chrono::microseconds(config.batch_timeout_micros);
+    batching_options.max_concurrent_batches = static_cast<size_t>(config.max_concurrent_batches);
+    env->SetBatchingOptions(batching_options);
+  }
 
-  try {
-    env->InitializeModel(config.model_path, "default", "1");
-    logger->debug("Initialize Model Successfully!");
-  } catch (const Ort::Exception& ex) {
-    logger->critical("Initialize Model Failed: {} ---- Error: [{}]", ex.GetOrtErrorCode(), ex.what());
-    exit(EXIT_FAILURE);
+  std::unique_ptr<server::ModelRepository> repository;
+  if (!config.repository_path.empty()) {
+    logger->info("Model repository: {}", config.repository_path);
+    repository = std::unique_ptr<server::ModelRepository>(new server::ModelRepository(env, config.repository_path));
+    repository->Poll();
+    if (config.repository_poll_seconds > 0) {
+      repository->StartPolling(std::chrono::seconds(config.repository_poll_seconds));
+    }
+  } else {
+    logger->info("Model path: {}", config.model_path);
+    try {
+      env->InitializeModel(config.model_path, "default", "1");
+      logger->debug("Initialize Model Successfully!");
+    } catch (const Ort::Exception& ex) {
+      logger->critical("Initialize Model Failed: {} ---- Error: [{}]", ex.GetOrtErrorCode(), ex.what());
+      exit(EXIT_FAILURE);
+    }
   }
 
   //Setup GRPC Server
@@ -116,6 +137,12 @@ int main(int argc, char* argv[]) {
       }
   );
 
+  app.RegisterGet(
+      R"(/v1/models/([^/:]+)/versions/(\d+)/(metrics))",
+      [&env](const auto& name, const auto& version, const auto& /*action*/, auto& context) -> void {
+        server::GetMetrics(name, version, context, env);
+      });
+
   app.Bind(boost_address, config.http_port)
       .NumThreads(config.num_http_threads)
       .Run();
@@ -0,0 +1,130 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <boost/filesystem.hpp>
+
+#include "model_repository.h"
+
+namespace onnxruntime {
+namespace server {
+
+namespace fs = boost::filesystem;
+
+static const char* const kModelFileName = "model.onnx";
+
+static bool IsVersion(const std::string& name) {
+  return !name.empty() && name.find_first_not_of("0123456789") == std::string::npos;
+}
+
+ModelRepository::ModelRepository(std::shared_ptr<ServerEnvironment> env, std::string path)
+    : env_(std::move(env)), path_(std::move(path)), logger_(env_->GetAppLogger()) {
+}
+
+ModelRepository::~ModelRepository() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    shutdown_ = true;
+  }
+  cv_.notify_all();
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+}
+
+void ModelRepository::StartPolling(std::chrono::milliseconds interval) {
+  thread_ = std::thread(&ModelRepository::ThreadMain, this, interval);
+}
+
+void ModelRepository::ThreadMain(std::chrono::milliseconds interval) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (!cv_.wait_for(lock, interval, [this] { return shutdown_; })) {
+    lock.unlock();
+    Poll();
+    lock.lock();
+  }
+}
+
+void ModelRepository::Poll() {
+  std::lock_guard<std::mutex> lock(poll_mutex_);
+
+  struct ModelFile {
+    fs::path path;
+    std::time_t modified;
+    std::uintmax_t size;
+  };
+
+  // the model files in the repository, by model name and version
+  std::map<std::pair<std::string, std::string>, ModelFile> found;
+  boost::system::error_code ec;
+  for (fs::directory_iterator model_it(path_, ec), end; !ec && model_it != end; model_it.increment(ec)) {
+    if (!fs::is_directory(model_it->status())) {
+      continue;
+    }
+
+    boost::system::error_code version_ec;
+    for (fs::directory_iterator version_it(model_it->path(), version_ec); !version_ec && version_it != end;
+         version_it.increment(version_ec)) {
+      const auto version = version_it->path().filename().string();
+      const auto model_file = version_it->path() / kModelFileName;
+      boost::system::error_code modified_ec;
+      boost::system::error_code size_ec;
+      const auto modified = fs::last_write_time(model_file, modified_ec);
+      const auto size = fs::file_size(model_file, size_ec);
+      if (IsVersion(version) && !modified_ec && !size_ec) {
+        found.emplace(std::make_pair(model_it->path().filename().string(), version),
+                      ModelFile{model_file, modified, size});
+      }
+    }
+  }
+
+  if (ec) {
+    // keep serving the models loaded when the repository can't be read, rather than unloading them
+    logger_->error("Reading the model repository {} failed: {}", path_, ec.message());
+    return;
+  }
+
+  for (auto it = versions_.begin(); it != versions_.end();) {
+    if (found.find(it->first) != found.end()) {
+      ++it;
+      continue;
+    }
+
+    if (it->second.loaded) {
+      logger_->info("Unloading model {} version {}", it->first.first, it->first.second);
+      try {
+        env_->UnloadModel(it->first.first, it->first.second);
+      } catch (const Ort::Exception& e) {
+        logger_->warn("Unloading model {} version {} failed: {}", it->first.first, it->first.second, e.what());
+      }
+    }
+    it = versions_.erase(it);
+  }
+
+  for (const auto& entry : found) {
+    const auto& name = entry.first.first;
+    const auto& version = entry.first.second;
+    const auto& model_file = entry.second;
+
+    auto known = versions_.find(entry.first);
+    if (known != versions_.end() && !known->second.failed && known->second.modified == model_file.modified &&
+        known->second.size == model_file.size) {
+      continue;
+    }
+
+    logger_->info("Loading model {} version {} from {}", name, version, model_file.path.string());
+    bool loaded = known != versions_.end() && known->second.loaded;
+    bool failed = false;
+    try {
+      env_->ReplaceModel(model_file.path.string(), name, version);
+      loaded = true;
+    } catch (const Ort::Exception& e) {
+      // a version that was loaded keeps serving requests from its previous model file
+      logger_->error("Loading model {} version {} failed: {} ---- Error: [{}]", name, version, e.GetOrtErrorCode(), e.what());
+      failed = true;
+    }
+    versions_[entry.first] = Version{model_file.modified, model_file.size, loaded, failed};
+  }
+}
+
+}  // namespace server
+}  // namespace onnxruntime
@@ -0,0 +1,66 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <ctime>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "environment.h"
+#include <spdlog/spdlog.h>
+
+namespace onnxruntime {
+namespace server {
+
+// Loads the models of a repository directory laid out as <repository>/<model name>/<version>/model.onnx, where the
+// versions are numbers. Polling the repository loads the versions added and the ones whose model file changed, and
+// unloads the versions removed. A version is loaded before it replaces the one serving requests, so that requests
+// don't wait for the session initialization and the running ones complete on the replaced version.
+class ModelRepository {
+ public:
+  ModelRepository(std::shared_ptr<ServerEnvironment> env, std::string path);
+  ~ModelRepository();
+  ModelRepository(const ModelRepository&) = delete;
+  ModelRepository& operator=(const ModelRepository&) = delete;
+
+  // Brings the models loaded up to date with the repository. A version that fails to load is logged, and retried
+  // at the next poll, as its model file may have been partly written when it was read.
+  void Poll();
+
+  // Polls the repository on a background thread at the interval, until the repository is destroyed.
+  void StartPolling(std::chrono::milliseconds interval);
+
+ private:
+  struct Version {
+    // the model file is reloaded when either changes. the modification time alone has a resolution of a second.
+    std::time_t modified;
+    std::uintmax_t size;
+    // whether a model of the version serves requests, and whether the last load of the model file failed
+    bool loaded;
+    bool failed;
+  };
+
+  void ThreadMain(std::chrono::milliseconds interval);
+
+  const std::shared_ptr<ServerEnvironment> env_;
+  const std::string path_;
+  const std::shared_ptr<spdlog::logger> logger_;
+
+  std::mutex poll_mutex_;
+  std::map<std::pair<std::string, std::string>, Version> versions_;  // GUARDED_BY(poll_mutex_)
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  bool shutdown_ = false;  // GUARDED_BY(mutex_)
+  std::thread thread_;
+};
+
+}  // namespace server
+}  // namespace onnxruntime
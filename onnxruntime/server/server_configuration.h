@@ -7,6 +7,7 @@
 #include <fstream>
 #include <unordered_map>
 
+#include "boost/filesystem.hpp"
 #include "boost/program_options.hpp"
 #include "core/session/onnxruntime_cxx_api.h"
 
@@ -37,22 +38,32 @@ static std::unordered_map<std::string, OrtLoggingLevel> supported_log_levels{
 // Provides sane default values
 class ServerConfiguration {
  public:
-  const std::string full_desc = "ONNX Server: host an ONNX model with ONNX Runtime";
+  const std::string full_desc = "ONNX Server: host ONNX models with ONNX Runtime";
   std::string model_path;
+  std::string repository_path;
+  int repository_poll_seconds = 30;
   std::string address = "0.0.0.0";
   unsigned short http_port = 8001;
   unsigned short grpc_port = 50051;
   int num_http_threads = std::thread::hardware_concurrency();
+  int max_batch_size = 1;
+  int batch_timeout_micros = 1000;
+  int max_concurrent_batches = 1;
   OrtLoggingLevel logging_level{};
 
   ServerConfiguration() {
     desc.add_options()("help,h", "Shows a help message and exits");
     desc.add_options()("log_level", po::value(&log_level_str)->default_value(log_level_str), "Logging level. Allowed options (case sensitive): verbose, info, warning, error, fatal");
-    desc.add_options()("model_path", po::value(&model_path)->required(), "Path to ONNX model");
+    desc.add_options()("model_path", po::value(&model_path), "Path to ONNX model, served as the model named default, version 1");
+    desc.add_options()("repository_path", po::value(&repository_path), "Path to a model repository of <model name>/<version>/model.onnx files to serve instead of model_path");
+    desc.add_options()("repository_poll_seconds", po::value(&repository_poll_seconds)->default_value(repository_poll_seconds), "Interval in seconds at which the model repository is checked for models added, changed or removed. 0 disables the checks");
     desc.add_options()("address", po::value(&address)->default_value(address), "The base HTTP address");
     desc.add_options()("http_port", po::value(&http_port)->default_value(http_port), "HTTP port to listen to requests");
     desc.add_options()("num_http_threads", po::value(&num_http_threads)->default_value(num_http_threads), "Number of http threads");
     desc.add_options()("grpc_port", po::value(&grpc_port)->default_value(grpc_port), "GRPC port to listen to requests");
+    desc.add_options()("max_batch_size", po::value(&max_batch_size)->default_value(max_batch_size), "Largest number of rows the requests batched into one run can have. 1 disables batching");
+    desc.add_options()("batch_timeout_micros", po::value(&batch_timeout_micros)->default_value(batch_timeout_micros), "Longest time in microseconds a request waits for other requests to join its batch");
+    desc.add_options()("max_concurrent_batches", po::value(&max_concurrent_batches)->default_value(max_concurrent_batches), "Number of batches of a model that can run at the same time");
   }
 
   // Parses argc and argv and sets the values for the class
@@ -99,9 +110,27 @@ class ServerConfiguration {
     } else if (num_http_threads <= 0) {
       PrintHelp(std::cerr, "num_http_threads must be greater than 0");
       return Result::ExitFailure;
-    } else if (!file_exists(model_path)) {
+    } else if (max_batch_size <= 0) {
+      PrintHelp(std::cerr, "max_batch_size must be greater than 0");
+      return Result::ExitFailure;
+    } else if (batch_timeout_micros < 0) {
+      PrintHelp(std::cerr, "batch_timeout_micros must not be negative");
+      return Result::ExitFailure;
+    } else if (max_concurrent_batches <= 0) {
+      PrintHelp(std::cerr, "max_concurrent_batches must be greater than 0");
+      return Result::ExitFailure;
+    } else if (repository_poll_seconds < 0) {
+      PrintHelp(std::cerr, "repository_poll_seconds must not be negative");
+      return Result::ExitFailure;
+    } else if (model_path.empty() == repository_path.empty()) {
+      PrintHelp(std::cerr, "Exactly one of model_path and repository_path must be given");
+      return Result::ExitFailure;
+    } else if (!model_path.empty() && !file_exists(model_path)) {
       PrintHelp(std::cerr, "model_path must be the location of a valid file");
       return Result::ExitFailure;
+    } else if (!repository_path.empty() && !directory_exists(repository_path)) {
+      PrintHelp(std::cerr, "repository_path must be the location of a directory");
+      return Result::ExitFailure;
     } else {
       return Result::ContinueSuccess;
     }
@@ -124,6 +153,11 @@ class ServerConfiguration {
     std::ifstream infile(fileName.c_str());
     return infile.good();
   }
+
+  inline bool directory_exists(const std::string& path) {
+    boost::system::error_code ec;
+    return boost::filesystem::is_directory(path, ec);
+  }
 };
 
 }  // namespace server
@@ -1,6 +1,10 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
 #include "gtest/gtest.h"
 #include "test/common/tensor_op_test_utils.h"
 #include "test/common/cuda_op_test_utils.h"
@@ -19,10 +23,11 @@ static void RunAttentionTest(
     int sequence_length,
     int hidden_size,
     int number_of_heads,
-    bool use_float16 = false) {
+    bool use_float16 = false,
+    bool cpu_only = false) {
   int min_cuda_architecture = use_float16 ? 530 : 0;
 
-  bool enable_cuda = HasCudaEnvironment(min_cuda_architecture);
+  bool enable_cuda = !cpu_only && HasCudaEnvironment(min_cuda_architecture);
   bool enable_cpu = !use_float16;
 
   if (enable_cpu || enable_cuda) {
@@ -49,7 +54,11 @@ static void RunAttentionTest(
       tester.AddOutput<float>("output", output_dims, output_data);
     }
 
-    tester.Run();
+    if (cpu_only) {
+      tester.Run(OpTester::ExpectResult::kExpectSuccess, "", {kCudaExecutionProvider});
+    } else {
+      tester.Run();
+    }
   }
 }
 
@@ -204,5 +213,128 @@ TEST(AttentionTest, AttentionMaskExceedSequence) {
                    batch_size, sequence_length, hidden_size, number_of_heads);
 }
 
+// Reference implementation, with the mask applied as in the original BERT model. When every key of a batch is
+// masked, the exponentials of the scores all underflow and the keys get the same weight.
+static std::vector<float> ComputeAttentionReference(
+    const std::vector<float>& input_data, const std::vector<float>& weights_data, const std::vector<float>& bias_data,
+    const std::vector<int32_t>& mask_index_data, int batch_size, int sequence_length, int hidden_size,
+    int number_of_heads) {
+  const int head_size = hidden_size / number_of_heads;
+
+  // qkv(B, S, 3NH) = input x weights + bias
+  std::vector<float> qkv(batch_size * sequence_length * 3 * hidden_size);
+  for (int i = 0; i < batch_size * sequence_length; i++) {
+    for (int j = 0; j < 3 * hidden_size; j++) {
+      float sum = bias_data[j];
+      for (int k = 0; k < hidden_size; k++) {
+        sum += input_data[i * hidden_size + k] * weights_data[k * 3 * hidden_size + j];
+      }
+      qkv[i * 3 * hidden_size + j] = sum;
+    }
+  }
+
+  std::vector<float> output_data(batch_size * sequence_length * hidden_size);
+  std::vector<float> scores(sequence_length);
+  for (int b = 0; b < batch_size; b++) {
+    for (int n = 0; n < number_of_heads; n++) {
+      for (int s = 0; s < sequence_length; s++) {
+        const float* q = qkv.data() + (b * sequence_length + s) * 3 * hidden_size + n * head_size;
+        float max_score = std::numeric_limits<float>::lowest();
+        for (int t = 0; t < sequence_length; t++) {
+          const float* k = qkv.data() + (b * sequence_length + t) * 3 * hidden_size + hidden_size + n * head_size;
+          float dot = 0.0f;
+          for (int h = 0; h < head_size; h++) {
+            dot += q[h] * k[h];
+          }
+          scores[t] = dot / std::sqrt(static_cast<float>(head_size)) + (t >= mask_index_data[b] ? -10000.0f : 0.0f);
+          max_score = std::max(max_score, scores[t]);
+        }
+
+        float sum = 0.0f;
+        for (int t = 0; t < sequence_length; t++) {
+          scores[t] = mask_index_data[b] <= 0 ? 1.0f : std::exp(scores[t] - max_score);
+          sum += scores[t];
+        }
+
+        for (int h = 0; h < head_size; h++) {
+          float value = 0.0f;
+          for (int t = 0; t < sequence_length; t++) {
+            value += scores[t] * qkv[(b * sequence_length + t) * 3 * hidden_size + 2 * hidden_size + n * head_size + h];
+          }
+          output_data[(b * sequence_length + s) * hidden_size + n * head_size + h] = value / sum;
+        }
+      }
+    }
+  }
+
+  return output_data;
+}
+
+TEST(AttentionTest, AttentionLongSequence) {
+  // long enough for the queries and the keys to be processed in several blocks
+  int batch_size = 2;
+  int sequence_length = 150;
+  int hidden_size = 8;
+  int number_of_heads = 2;
+
+  std::vector<float> input_data(batch_size * sequence_length * hidden_size);
+  for (size_t i = 0; i < input_data.size(); i++) {
+    input_data[i] = 0.5f * std::sin(0.37f * static_cast<float>(i));
+  }
+
+  std::vector<float> weight_data(hidden_size * 3 * hidden_size);
+  for (size_t i = 0; i < weight_data.size(); i++) {
+    weight_data[i] = 0.3f * std::cos(0.61f * static_cast<float>(i));
+  }
+
+  std::vector<float> bias_data(3 * hidden_size);
+  for (size_t i = 0; i < bias_data.size(); i++) {
+    bias_data[i] = 0.1f * static_cast<float>(i % 5) - 0.2f;
+  }
+
+  // the second batch masks part of the last block of keys
+  std::vector<int32_t> mask_index_data = {150L, 140L};
+
+  std::vector<float> output_data = ComputeAttentionReference(input_data, weight_data, bias_data, mask_index_data,
+                                                             batch_size, sequence_length, hidden_size,
+                                                             number_of_heads);
+
+  RunAttentionTest(input_data, weight_data, bias_data, mask_index_data, output_data,
+                   batch_size, sequence_length, hidden_size, number_of_heads);
+}
+
+TEST(AttentionTest, AttentionMaskAllKeys) {
+  // the first batch masks every key, which gives every key the same weight. 70 queries take two blocks.
+  int batch_size = 2;
+  int sequence_length = 70;
+  int hidden_size = 8;
+  int number_of_heads = 2;
+
+  std::vector<float> input_data(batch_size * sequence_length * hidden_size);
+  for (size_t i = 0; i < input_data.size(); i++) {
+    input_data[i] = 0.5f * std::sin(0.29f * static_cast<float>(i));
+  }
+
+  std::vector<float> weight_data(hidden_size * 3 * hidden_size);
+  for (size_t i = 0; i < weight_data.size(); i++) {
+    weight_data[i] = 0.3f * std::cos(0.43f * static_cast<float>(i));
+  }
+
+  std::vector<float> bias_data(3 * hidden_size);
+  for (size_t i = 0; i < bias_data.size(); i++) {
+    bias_data[i] = 0.1f * static_cast<float>(i % 3) - 0.1f;
+  }
+
+  std::vector<int32_t> mask_index_data = {0L, 30L};
+
+  std::vector<float> output_data = ComputeAttentionReference(input_data, weight_data, bias_data, mask_index_data,
+                                                             batch_size, sequence_length, hidden_size,
+                                                             number_of_heads);
+
+  // the CUDA kernel doesn't handle a batch without any key
+  RunAttentionTest(input_data, weight_data, bias_data, mask_index_data, output_data,
+                   batch_size, sequence_length, hidden_size, number_of_heads, false, true);
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -0,0 +1,121 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "gtest/gtest.h"
+#include "test/providers/provider_test_utils.h"
+
+namespace onnxruntime {
+namespace test {
+
+// B = [[1, 0, 0],
+//      [0, 0, 2],
+//      [0, 0, 0],
+//      [3, 0, 4]]
+// which is supplied transposed in CSR format. The second column of B is empty.
+static void AddSparseB(OpTester& test, bool is_initializer = false) {
+  test.AddInput<float>("B_values", {4}, {1.0f, 3.0f, 2.0f, 4.0f}, is_initializer);
+  test.AddInput<int32_t>("B_row_offsets", {4}, {0, 2, 2, 4}, is_initializer);
+  test.AddInput<int32_t>("B_column_indices", {4}, {0, 3, 1, 3}, is_initializer);
+}
+
+TEST(SparseMatMulOpTest, MatMul) {
+  OpTester test("SparseMatMul", 1, onnxruntime::kMSDomain);
+  test.AddAttribute<int64_t>("K", 4);
+  test.AddInput<float>("A", {2, 4}, {1.0f, 2.0f, 3.0f, 4.0f,
+                                     -1.0f, 0.5f, 8.0f, 2.0f});
+  AddSparseB(test);
+  test.AddOutput<float>("Y", {2, 3}, {13.0f, 0.0f, 20.0f,
+                                      5.0f, 0.0f, 9.0f});
+  test.Run();
+}
+
+TEST(SparseMatMulOpTest, MatMulConstantB) {
+  OpTester test("SparseMatMul", 1, onnxruntime::kMSDomain);
+  test.AddAttribute<int64_t>("K", 4);
+  test.AddInput<float>("A", {2, 4}, {1.0f, 2.0f, 3.0f, 4.0f,
+                                     -1.0f, 0.5f, 8.0f, 2.0f});
+  AddSparseB(test, true);
+  test.AddOutput<float>("Y", {2, 3}, {13.0f, 0.0f, 20.0f,
+                                      5.0f, 0.0f, 9.0f});
+  test.Run();
+}
+
+TEST(SparseMatMulOpTest, MatMulBatched) {
+  OpTester test("SparseMatMul", 1, onnxruntime::kMSDomain);
+  test.AddAttribute<int64_t>("K", 4);
+  test.AddInput<float>("A", {2, 1, 4}, {1.0f, 2.0f, 3.0f, 4.0f,
+                                        -1.0f, 0.5f, 8.0f, 2.0f});
+  AddSparseB(test);
+  test.AddOutput<float>("Y", {2, 1, 3}, {13.0f, 0.0f, 20.0f,
+                                         5.0f, 0.0f, 9.0f});
+  test.Run();
+}
+
+TEST(SparseMatMulOpTest, MatMulVector) {
+  OpTester test("SparseMatMul", 1, onnxruntime::kMSDomain);
+  test.AddAttribute<int64_t>("K", 4);
+  test.AddInput<float>("A", {4}, {1.0f, 2.0f, 3.0f, 4.0f});
+  AddSparseB(test);
+  test.AddOutput<float>("Y", {3}, {13.0f, 0.0f, 20.0f});
+  test.Run();
+}
+
+TEST(SparseMatMulOpTest, GemmWithBias) {
+  OpTester test("SparseMatMul", 1, onnxruntime::kMSDomain);
+  test.AddAttribute<int64_t>("K", 4);
+  test.AddAttribute("alpha", 2.0f);
+  test.AddAttribute("beta", 0.5f);
+  test.AddInput<float>("A", {2, 4}, {1.0f, 2.0f, 3.0f, 4.0f,
+                                     -1.0f, 0.5f, 8.0f, 2.0f});
+  AddSparseB(test);
+  test.AddInput<float>("C", {3}, {2.0f, 4.0f, 6.0f});
+  test.AddOutput<float>("Y", {2, 3}, {27.0f, 2.0f, 43.0f,
+                                      11.0f, 2.0f, 21.0f});
+  test.Run();
+}
+
+TEST(SparseMatMulOpTest, GemmWithColumnBias) {
+  OpTester test("SparseMatMul", 1, onnxruntime::kMSDomain);
+  test.AddAttribute<int64_t>("K", 4);
+  test.AddInput<float>("A", {2, 4}, {1.0f, 2.0f, 3.0f, 4.0f,
+                                     -1.0f, 0.5f, 8.0f, 2.0f});
+  AddSparseB(test);
+  test.AddInput<float>("C", {2, 1}, {1.0f, -1.0f});
+  test.AddOutput<float>("Y", {2, 3}, {14.0f, 1.0f, 21.0f,
+                                      4.0f, -1.0f, 8.0f});
+  test.Run();
+}
+
+TEST(SparseMatMulOpTest, InvalidColumnIndex) {
+  OpTester test("SparseMatMul", 1, onnxruntime::kMSDomain);
+  test.AddAttribute<int64_t>("K", 4);
+  test.AddInput<float>("A", {1, 4}, {1.0f, 2.0f, 3.0f, 4.0f});
+  test.AddInput<float>("B_values", {1}, {1.0f});
+  test.AddInput<int32_t>("B_row_offsets", {2}, {0, 1});
+  test.AddInput<int32_t>("B_column_indices", {1}, {4});
+  test.AddOutput<float>("Y", {1, 1}, {0.0f});
+  test.Run(OpTester::ExpectResult::kExpectFailure, "column index 4 is out of range");
+}
+
+TEST(SparseMatMulOpTest, InvalidConstantColumnIndex) {
+  OpTester test("SparseMatMul", 1, onnxruntime::kMSDomain);
+  test.AddAttribute<int64_t>("K", 4);
+  test.AddInput<float>("A", {1, 4}, {1.0f, 2.0f, 3.0f, 4.0f});
+  test.AddInput<float>("B_values", {1}, {1.0f}, true);
+  test.AddInput<int32_t>("B_row_offsets", {2}, {0, 1}, true);
+  test.AddInput<int32_t>("B_column_indices", {1}, {4}, true);
+  test.AddOutput<float>("Y", {1, 1}, {0.0f});
+  test.Run(OpTester::ExpectResult::kExpectFailure, "column index 4 is out of range");
+}
+
+TEST(SparseMatMulOpTest, InvalidK) {
+  OpTester test("SparseMatMul", 1, onnxruntime::kMSDomain);
+  test.AddAttribute<int64_t>("K", 3);
+  test.AddInput<float>("A", {1, 4}, {1.0f, 2.0f, 3.0f, 4.0f});
+  AddSparseB(test);
+  test.AddOutput<float>("Y", {1, 3}, {0.0f, 0.0f, 0.0f});
+  test.Run(OpTester::ExpectResult::kExpectFailure, "dimension of A does not match K");
+}
+
+}  // namespace test
+}  // namespace onnxruntime
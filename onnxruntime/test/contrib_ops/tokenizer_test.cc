@@ -864,5 +864,37 @@ TEST(ContribOpTest, Tokenizer_EmptyInput) {
     test.Run(OpTester::ExpectResult::kExpectSuccess);
   }
 }
+
+TEST(ContribOpTest, TokenizerWithSeparators_LiteralAndRegexSeparatorsManyRowsNC) {
+  // Enough rows to be tokenized in several blocks, with a different number of
+  // tokens in each row. ";" is searched as a plain string, " +" as a regex.
+  std::vector<std::string> separators = {u8";", u8" +"};
+
+  OpTester test("Tokenizer", opset_ver, domain);
+  InitTestAttr(test, true, separators, 1);
+
+  const int64_t N = 3;
+  const int64_t C = 70;
+  const int64_t max_row_tokens = 4;
+  std::vector<std::string> input;
+  std::vector<std::string> output;
+  for (int64_t row = 0; row < N * C; ++row) {
+    const int64_t tokens = row % (max_row_tokens + 1);
+    std::string s;
+    output.push_back(start_mark);
+    for (int64_t t = 0; t < tokens; ++t) {
+      const std::string token = u8"т" + std::to_string(row) + "_" + std::to_string(t);
+      s += token + (t % 2 == 0 ? ";" : "  ");
+      output.push_back(token);
+    }
+    input.push_back(s);
+    output.push_back(end_mark);
+    output.insert(output.end(), max_row_tokens - tokens, padval);
+  }
+
+  test.AddInput<std::string>("T", {N, C}, input);
+  test.AddOutput<std::string>("Y", {N, C, max_row_tokens + 2}, output);
+  test.Run(OpTester::ExpectResult::kExpectSuccess);
+}
 }  // namespace test
 }  // namespace onnxruntime
@@ -2,8 +2,10 @@
 // Licensed under the MIT License.
 
 #include "core/framework/bfc_arena.h"
+#include "core/framework/thread_caching_arena.h"
 #include "gtest/gtest.h"
 #include <cstdlib>
+#include <thread>
 
 namespace onnxruntime {
 namespace test {
@@ -234,5 +236,196 @@ TEST(BFCArenaTest, TestReserve) {
   a.GetStats(&stats);
   EXPECT_EQ(stats.total_allocated_bytes, 1048576);
 }
+
+TEST(BFCArenaTest, InitialChunkSize) {
+  BFCArena a(std::unique_ptr<IDeviceAllocator>(new CPUAllocator()), 1 << 30,
+             ArenaExtendStrategy::kNextPowerOfTwo, 4096);
+
+  void* p = a.Alloc(256);
+  AllocatorStats stats;
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.total_allocated_bytes, 4096);
+  a.Free(p);
+}
+
+TEST(BFCArenaTest, ExtendSameAsRequested) {
+  BFCArena a(std::unique_ptr<IDeviceAllocator>(new CPUAllocator()), 1 << 30,
+             ArenaExtendStrategy::kSameAsRequested, 1 << 20);
+
+  // fits in the initial region
+  void* p1 = a.Alloc(1 << 19);
+  // the new region is exactly the size requested instead of the next power of two
+  void* p2 = a.Alloc(3 << 20);
+  AllocatorStats stats;
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.total_allocated_bytes, (1 << 20) + (3 << 20));
+
+  a.Free(p1);
+  a.Free(p2);
+}
+
+TEST(BFCArenaTest, Shrink) {
+  BFCArena a(std::unique_ptr<IDeviceAllocator>(new CPUAllocator()), 1 << 30);
+
+  void* small = a.Alloc(1024);
+  void* large = a.Alloc(16 << 20);
+  AllocatorStats stats;
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.total_allocated_bytes, (1 << 20) + (16 << 20));
+
+  // regions with chunks in use are kept
+  ASSERT_TRUE(a.Shrink().IsOK());
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.total_allocated_bytes, (1 << 20) + (16 << 20));
+
+  a.Free(large);
+  ASSERT_TRUE(a.Shrink().IsOK());
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.total_allocated_bytes, 1 << 20);
+  EXPECT_EQ(stats.bytes_in_use, 1024);
+
+  // the arena grows again from the initial chunk size
+  void* p = a.Alloc(2 << 20);
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.total_allocated_bytes, (1 << 20) + (2 << 20));
+
+  a.Free(p);
+  a.Free(small);
+  ASSERT_TRUE(a.Shrink().IsOK());
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.total_allocated_bytes, 0);
+
+  // still usable after releasing everything
+  p = a.Alloc(100);
+  EXPECT_NE(p, nullptr);
+  a.Free(p);
+}
+
+TEST(ThreadCachingArenaTest, ReusesFreedBlocks) {
+  auto* bfc = new BFCArena(std::unique_ptr<IDeviceAllocator>(new CPUAllocator()), 1 << 30);
+  ThreadCachingArena a(std::unique_ptr<IArenaAllocator>(bfc), 1 << 20);
+
+  void* p1 = a.Alloc(1000);
+  ASSERT_NE(p1, nullptr);
+  EXPECT_EQ(reinterpret_cast<std::uintptr_t>(p1) % ThreadCachingArena::kHeaderSize, 0U);
+  a.Free(p1);
+  EXPECT_GT(a.ThreadCachedBytes(), 0U);
+
+  // a request in the same size class is served from the thread cache without going to the arena
+  void* p2 = a.Alloc(1010);
+  EXPECT_EQ(p1, p2);
+  EXPECT_EQ(a.ThreadCachedBytes(), 0U);
+
+  AllocatorStats stats;
+  bfc->GetStats(&stats);
+  EXPECT_EQ(stats.num_allocs, 1);
+
+  // large requests bypass the cache
+  void* large = a.Alloc(ThreadCachingArena::kMaxCachedBlockSize);
+  a.Free(large);
+  EXPECT_EQ(a.ThreadCachedBytes(), 0U);
+
+  a.Free(p2);
+  a.FlushThreadCache();
+  EXPECT_EQ(a.ThreadCachedBytes(), 0U);
+  bfc->GetStats(&stats);
+  EXPECT_EQ(stats.bytes_in_use, 0);
+}
+
+TEST(ThreadCachingArenaTest, RespectsMaxCachedBytes) {
+  auto* bfc = new BFCArena(std::unique_ptr<IDeviceAllocator>(new CPUAllocator()), 1 << 30);
+  ThreadCachingArena a(std::unique_ptr<IArenaAllocator>(bfc), 4096);
+
+  std::vector<void*> ptrs;
+  for (int i = 0; i < 16; ++i) {
+    ptrs.push_back(a.Alloc(1000));
+  }
+
+  for (void* p : ptrs) {
+    a.Free(p);
+  }
+
+  EXPECT_LE(a.ThreadCachedBytes(), 4096U);
+
+  AllocatorStats stats;
+  bfc->GetStats(&stats);
+  EXPECT_EQ(static_cast<size_t>(stats.bytes_in_use), a.ThreadCachedBytes());
+}
+
+TEST(ThreadCachingArenaTest, FreeOnAnotherThread) {
+  auto* bfc = new BFCArena(std::unique_ptr<IDeviceAllocator>(new CPUAllocator()), 1 << 30);
+  ThreadCachingArena a(std::unique_ptr<IArenaAllocator>(bfc), 1 << 20);
+
+  std::vector<void*> ptrs;
+  for (size_t size = 1; size < 8192; size += 97) {
+    ptrs.push_back(a.Alloc(size));
+  }
+
+  void* reserved = a.Reserve(1 << 20);
+
+  std::thread t([&a, &ptrs, reserved]() {
+    for (void* p : ptrs) {
+      a.Free(p);
+    }
+    a.Free(reserved);
+    // the blocks cached by this thread are returned to the arena when it exits
+  });
+  t.join();
+
+  EXPECT_EQ(a.ThreadCachedBytes(), 0U);
+  AllocatorStats stats;
+  bfc->GetStats(&stats);
+  EXPECT_EQ(stats.bytes_in_use, 0);
+}
+
+TEST(ThreadCachingArenaTest, Shrink) {
+  auto* bfc = new BFCArena(std::unique_ptr<IDeviceAllocator>(new CPUAllocator()), 1 << 30);
+  ThreadCachingArena a(std::unique_ptr<IArenaAllocator>(bfc), 1 << 20);
+
+  void* p = a.Alloc(1000);
+  a.Free(p);
+  EXPECT_GT(a.ThreadCachedBytes(), 0U);
+
+  // the cached block is flushed so its region can be released
+  ASSERT_TRUE(a.Shrink().IsOK());
+  EXPECT_EQ(a.ThreadCachedBytes(), 0U);
+  AllocatorStats stats;
+  bfc->GetStats(&stats);
+  EXPECT_EQ(stats.total_allocated_bytes, 0);
+}
+
+TEST(ThreadCachingArenaTest, ConcurrentAllocAndFree) {
+  auto* bfc = new BFCArena(std::unique_ptr<IDeviceAllocator>(new CPUAllocator()), 1 << 30);
+  ThreadCachingArena a(std::unique_ptr<IArenaAllocator>(bfc), 1 << 16);
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&a, t]() {
+      std::vector<void*> ptrs;
+      for (int i = 0; i < 10000; ++i) {
+        const size_t size = 1 + (static_cast<size_t>(i * 31 + t * 17) % 20000);
+        void* p = a.Alloc(size);
+        // touch the whole block to catch overlapping blocks with the sanitizers
+        memset(p, t, size);
+        ptrs.push_back(p);
+        if (ptrs.size() > 8) {
+          a.Free(ptrs.front());
+          ptrs.erase(ptrs.begin());
+        }
+      }
+      for (void* p : ptrs) {
+        a.Free(p);
+      }
+    });
+  }
+
+  for (auto& t : threads) {
+    t.join();
+  }
+
+  AllocatorStats stats;
+  bfc->GetStats(&stats);
+  EXPECT_EQ(stats.bytes_in_use, 0);
+}
 }  // namespace test
 }  // namespace onnxruntime
@@ -4,8 +4,10 @@
 #include "core/session/inference_session.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cfloat>
 #include <functional>
+#include <future>
 #include <iterator>
 #include <thread>
 #include <fstream>
@@ -29,6 +31,7 @@
 #ifdef USE_CUDA
 #include "core/providers/cuda/gpu_data_transfer.h"
 #endif
+#include "core/session/environment.h"
 #include "core/session/IOBinding.h"
 #include "dummy_provider.h"
 #include "test_utils.h"
@@ -423,6 +426,104 @@ TEST(InferenceSessionTests, TestModelSerialization) {
   ASSERT_TRUE(session_object_emptyValidation.Initialize().IsOK());
 }
 
+TEST(InferenceSessionTests, TestGraphCache) {
+  const string test_model = "testdata/transform/abs-id-max.onnx";
+  const string cache_file = test_model + "-graph-cache";
+  std::remove(cache_file.c_str());
+
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.TestGraphCache";
+  so.graph_optimization_level = TransformerLevel::Level1;
+  so.graph_cache_filepath = ToWideString(cache_file);
+
+  // the first session transforms the graph and creates the cache
+  {
+    InferenceSessionGetGraphWrapper session_object{so, &DefaultLoggingManager()};
+    ASSERT_TRUE(session_object.Load(test_model).IsOK());
+    ASSERT_TRUE(session_object.Initialize().IsOK());
+    ASSERT_EQ(CountOpsInGraph(session_object.GetGraph())["Identity"], 0);
+  }
+
+  // rename the cached graph, which shows whether the next sessions use the cache
+  ONNX_NAMESPACE::ModelProto cache_proto;
+  ASSERT_TRUE(Model::Load(so.graph_cache_filepath, cache_proto).IsOK());
+  ASSERT_EQ(cache_proto.metadata_props_size(), 2);
+  cache_proto.mutable_graph()->set_name("cached_graph");
+  {
+    std::ofstream cache_fs(cache_file, ios::out | ios::binary | ios::trunc);
+    ASSERT_TRUE(cache_proto.SerializeToOstream(&cache_fs));
+  }
+
+  {
+    InferenceSessionGetGraphWrapper session_object{so, &DefaultLoggingManager()};
+    ASSERT_TRUE(session_object.Load(test_model).IsOK());
+    ASSERT_TRUE(session_object.Initialize().IsOK());
+    ASSERT_EQ(CountOpsInGraph(session_object.GetGraph())["Identity"], 0);
+
+    // the metadata of the cache is not reported as metadata of the model
+    auto metadata = session_object.GetModelMetadata();
+    ASSERT_TRUE(metadata.first.IsOK());
+    ASSERT_EQ(metadata.second->graph_name, "cached_graph");
+    ASSERT_TRUE(metadata.second->custom_metadata_map.empty());
+  }
+
+  // a different optimization level doesn't use the cache and replaces it
+  {
+    SessionOptions so_noopt = so;
+    so_noopt.graph_optimization_level = TransformerLevel::Default;
+    InferenceSessionGetGraphWrapper session_object{so_noopt, &DefaultLoggingManager()};
+    ASSERT_TRUE(session_object.Load(test_model).IsOK());
+    ASSERT_TRUE(session_object.Initialize().IsOK());
+    ASSERT_GT(CountOpsInGraph(session_object.GetGraph())["Identity"], 0);
+    ASSERT_NE(session_object.GetModelMetadata().second->graph_name, "cached_graph");
+  }
+
+  {
+    InferenceSessionGetGraphWrapper session_object{so, &DefaultLoggingManager()};
+    ASSERT_TRUE(session_object.Load(test_model).IsOK());
+    ASSERT_TRUE(session_object.Initialize().IsOK());
+    ASSERT_EQ(CountOpsInGraph(session_object.GetGraph())["Identity"], 0);
+    ASSERT_NE(session_object.GetModelMetadata().second->graph_name, "cached_graph");
+  }
+
+  std::remove(cache_file.c_str());
+}
+
+TEST(InferenceSessionTests, TestGraphCacheConcurrentSaves) {
+  const string test_model = "testdata/transform/abs-id-max.onnx";
+  const string cache_file = test_model + "-concurrent-graph-cache";
+  std::remove(cache_file.c_str());
+
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.TestGraphCacheConcurrentSaves";
+  so.graph_optimization_level = TransformerLevel::Level1;
+  so.graph_cache_filepath = ToWideString(cache_file);
+
+  // the sessions of one process that miss the cache at the same time each save it, to a file of their own that is
+  // moved in place
+  std::vector<std::future<bool>> sessions;
+  for (int i = 0; i < 4; ++i) {
+    sessions.push_back(std::async(std::launch::async, [&so, &test_model]() {
+      InferenceSession session_object{so, &DefaultLoggingManager()};
+      return session_object.Load(test_model).IsOK() && session_object.Initialize().IsOK();
+    }));
+  }
+  for (auto& session : sessions) {
+    ASSERT_TRUE(session.get());
+  }
+
+  ONNX_NAMESPACE::ModelProto cache_proto;
+  ASSERT_TRUE(Model::Load(so.graph_cache_filepath, cache_proto).IsOK());
+  ASSERT_EQ(cache_proto.metadata_props_size(), 2);
+
+  InferenceSessionGetGraphWrapper session_object{so, &DefaultLoggingManager()};
+  ASSERT_TRUE(session_object.Load(test_model).IsOK());
+  ASSERT_TRUE(session_object.Initialize().IsOK());
+  ASSERT_EQ(CountOpsInGraph(session_object.GetGraph())["Identity"], 0);
+
+  std::remove(cache_file.c_str());
+}
+
 #ifdef ORT_RUN_EXTERNAL_ONNX_TESTS
 static bool Compare(const InputDefList& f_arg, const InputDefList& s_arg) {
   if (f_arg.size() != s_arg.size()) {
@@ -651,6 +752,16 @@ TEST(InferenceSessionTests, MultipleSessionsNoTimeout) {
   thread2.join();
 }
 
+TEST(InferenceSessionTests, DisablePerSessionThreadsRequiresGlobalThreadPools) {
+  // the test environment is created without global thread pools
+  ASSERT_FALSE(Environment::HasGlobalThreadPools());
+
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.DisablePerSessionThreadsRequiresGlobalThreadPools";
+  so.use_per_session_threads = false;
+  ASSERT_THROW(InferenceSession(so, &DefaultLoggingManager()), OnnxRuntimeException);
+}
+
 TEST(InferenceSessionTests, PreAllocateOutputVector) {
   SessionOptions so;
 
@@ -666,6 +777,144 @@ TEST(InferenceSessionTests, PreAllocateOutputVector) {
   RunModel(session_object, run_options, is_preallocate_output_vec);
 }
 
+TEST(InferenceSessionTests, RunAsync) {
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.RunAsync";
+  so.inter_op_num_threads = 2;
+
+  InferenceSession session_object{so, &DefaultLoggingManager()};
+  ASSERT_TRUE(session_object.Load(MODEL_URI).IsOK());
+  ASSERT_TRUE(session_object.Initialize().IsOK());
+
+  std::vector<int64_t> dims_mul_x = {3, 2};
+  std::vector<float> values_mul_x = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+  std::vector<int64_t> expected_dims_mul_y = {3, 2};
+  std::vector<float> expected_values_mul_y = {1.0f, 4.0f, 9.0f, 16.0f, 25.0f, 36.0f};
+
+  // queue more runs than there are threads, half of them with a pre-allocated output.
+  constexpr int num_runs = 6;
+  std::vector<std::promise<std::vector<OrtValue>>> results(num_runs);
+  for (int i = 0; i < num_runs; ++i) {
+    OrtValue ml_value;
+    CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), dims_mul_x, values_mul_x,
+                         &ml_value);
+    std::vector<OrtValue> fetches(1);
+    if (i % 2 == 1) {
+      CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), dims_mul_x, values_mul_x,
+                           &fetches[0]);
+    }
+
+    auto& result = results[i];
+    ASSERT_STATUS_OK(session_object.RunAsync(nullptr, {"X"}, {ml_value}, {"Y"}, std::move(fetches),
+                                             [&result](const Status& status, std::vector<OrtValue>& run_fetches) {
+                                               EXPECT_TRUE(status.IsOK()) << status.ErrorMessage();
+                                               result.set_value(std::move(run_fetches));
+                                             }));
+  }
+
+  for (auto& result : results) {
+    VerifyOutputs(result.get_future().get(), expected_dims_mul_y, expected_values_mul_y);
+  }
+
+  // errors of the run are reported to the callback
+  std::promise<Status> failed;
+  ASSERT_STATUS_OK(session_object.RunAsync(nullptr, {"X"}, {}, {"Y"}, std::vector<OrtValue>(1),
+                                           [&failed](const Status& status, std::vector<OrtValue>&) {
+                                             failed.set_value(status);
+                                           }));
+  ASSERT_FALSE(failed.get_future().get().IsOK());
+}
+
+TEST(InferenceSessionTests, RunAsyncDestroySessionWithPendingRuns) {
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.RunAsyncDestroySessionWithPendingRuns";
+  so.inter_op_num_threads = 2;
+
+  std::vector<int64_t> dims_mul_x = {3, 2};
+  std::vector<float> values_mul_x = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+
+  // queue more runs than fit in the queue of a thread pool, and destroy the session before they complete.
+  // the destructor waits for all of them, and none runs on the thread that queued it.
+  constexpr int num_runs = 2000;
+  std::atomic<int> num_completed{0};
+  std::atomic<int> num_failed{0};
+  std::atomic<int> num_inline{0};
+  const auto queue_thread_id = std::this_thread::get_id();
+  {
+    InferenceSession session_object{so, &DefaultLoggingManager()};
+    ASSERT_TRUE(session_object.Load(MODEL_URI).IsOK());
+    ASSERT_TRUE(session_object.Initialize().IsOK());
+
+    for (int i = 0; i < num_runs; ++i) {
+      OrtValue ml_value;
+      CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), dims_mul_x, values_mul_x,
+                           &ml_value);
+      ASSERT_STATUS_OK(session_object.RunAsync(nullptr, {"X"}, {ml_value}, {"Y"}, std::vector<OrtValue>(1),
+                                               [&](const Status& status, std::vector<OrtValue>&) {
+                                                 if (!status.IsOK()) {
+                                                   ++num_failed;
+                                                 }
+                                                 if (std::this_thread::get_id() == queue_thread_id) {
+                                                   ++num_inline;
+                                                 }
+                                                 ++num_completed;
+                                               }));
+    }
+  }
+
+  ASSERT_EQ(num_completed, num_runs);
+  ASSERT_EQ(num_failed, 0);
+  ASSERT_EQ(num_inline, 0);
+}
+
+TEST(InferenceSessionTests, PrepareRun) {
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.PrepareRun";
+
+  InferenceSession session_object{so, &DefaultLoggingManager()};
+  ASSERT_TRUE(session_object.Load(MODEL_URI).IsOK());
+
+  std::unique_ptr<InferenceSession::PreparedRun> prepared_run;
+  ASSERT_FALSE(session_object.PrepareRun({"X"}, {"Y"}, &prepared_run).IsOK());
+
+  ASSERT_TRUE(session_object.Initialize().IsOK());
+  ASSERT_FALSE(session_object.PrepareRun({"X"}, {"Z"}, &prepared_run).IsOK());
+  ASSERT_FALSE(session_object.PrepareRun({"Z"}, {"Y"}, &prepared_run).IsOK());
+  ASSERT_STATUS_OK(session_object.PrepareRun({"X"}, {"Y"}, &prepared_run));
+  ASSERT_EQ(prepared_run->GetFeedNames(), std::vector<std::string>{"X"});
+  ASSERT_EQ(prepared_run->GetOutputNames(), std::vector<std::string>{"Y"});
+
+  std::vector<int64_t> dims_mul_x = {3, 2};
+  std::vector<float> values_mul_x = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+  std::vector<int64_t> expected_dims_mul_y = {3, 2};
+  std::vector<float> expected_values_mul_y = {1.0f, 4.0f, 9.0f, 16.0f, 25.0f, 36.0f};
+
+  OrtValue ml_value;
+  CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), dims_mul_x, values_mul_x,
+                       &ml_value);
+
+  RunOptions run_options;
+  for (int i = 0; i < 2; ++i) {
+    std::vector<OrtValue> fetches;
+    ASSERT_STATUS_OK(session_object.Run(run_options, *prepared_run, {ml_value}, &fetches));
+    VerifyOutputs(fetches, expected_dims_mul_y, expected_values_mul_y);
+  }
+
+  // the feeds are still checked against the definitions of the inputs
+  OrtValue int_value;
+  CreateMLValue<int32_t>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), dims_mul_x,
+                         {1, 2, 3, 4, 5, 6}, &int_value);
+  std::vector<OrtValue> fetches;
+  ASSERT_FALSE(session_object.Run(run_options, *prepared_run, {int_value}, &fetches).IsOK());
+  ASSERT_FALSE(session_object.Run(run_options, *prepared_run, {}, &fetches).IsOK());
+
+  // a run prepared by another session is rejected
+  InferenceSession other_session{so, &DefaultLoggingManager()};
+  ASSERT_TRUE(other_session.Load(MODEL_URI).IsOK());
+  ASSERT_TRUE(other_session.Initialize().IsOK());
+  ASSERT_FALSE(other_session.Run(run_options, *prepared_run, {ml_value}, &fetches).IsOK());
+}
+
 TEST(InferenceSessionTests, ConfigureVerbosityLevel) {
   SessionOptions so;
 
@@ -833,6 +1082,49 @@ TEST(InferenceSessionTests, TestIOBindingReuse) {
   }
 }
 
+TEST(InferenceSessionTests, TestIOBindingRepeatedRuns) {
+  SessionOptions so;
+  InferenceSession session_object(so);
+  std::unique_ptr<Model> p_model;
+  CreateMatMulModel(p_model, kCpuExecutionProvider);
+
+  std::string s1;
+  p_model->ToProto().SerializeToString(&s1);
+  std::stringstream sstr(s1);
+  ASSERT_TRUE(session_object.Load(sstr).IsOK());
+  ASSERT_TRUE(session_object.Initialize().IsOK());
+  unique_ptr<IOBinding> io_binding;
+  ASSERT_TRUE(session_object.NewIOBinding(&io_binding).IsOK());
+
+  auto allocator = TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault);
+  OrtValue a, b, identity;
+  CreateMLValue<float>(allocator, {2, 2}, {1.f, 2.f, 3.f, 4.f}, &a);
+  CreateMLValue<float>(allocator, {2, 2}, {1.f, 0.f, 0.f, 1.f}, &identity);
+  CreateMLValue<float>(allocator, {2, 2}, {0.f, 1.f, 1.f, 0.f}, &b);
+  ASSERT_TRUE(io_binding->BindInput("A", a).IsOK());
+  ASSERT_TRUE(io_binding->BindInput("B", identity).IsOK());
+  ASSERT_TRUE(io_binding->BindOutput("Y", OrtValue()).IsOK());
+
+  // the names are resolved by the first run and reused by the next ones, with the values bound in between
+  ASSERT_TRUE(session_object.Run(*io_binding).IsOK());
+  VerifyOutputs(io_binding->GetOutputs(), {2, 2}, {1.f, 2.f, 3.f, 4.f});
+  ASSERT_TRUE(io_binding->BindInput("B", b).IsOK());
+  ASSERT_TRUE(session_object.Run(*io_binding).IsOK());
+  VerifyOutputs(io_binding->GetOutputs(), {2, 2}, {2.f, 1.f, 4.f, 3.f});
+
+  // binding other names resolves them again
+  io_binding->ClearOutputs();
+  ASSERT_TRUE(io_binding->BindOutput("Z", OrtValue()).IsOK());
+  auto st = session_object.Run(*io_binding);
+  ASSERT_FALSE(st.IsOK());
+  EXPECT_THAT(st.ErrorMessage(), testing::HasSubstr("Invalid Output Name:Z"));
+
+  io_binding->ClearOutputs();
+  ASSERT_TRUE(io_binding->BindOutput("Y", OrtValue()).IsOK());
+  ASSERT_TRUE(session_object.Run(*io_binding).IsOK());
+  VerifyOutputs(io_binding->GetOutputs(), {2, 2}, {2.f, 1.f, 4.f, 3.f});
+}
+
 TEST(InferenceSessionTests, InvalidInputTypeOfTensorElement) {
   SessionOptions so;
 
@@ -2,6 +2,8 @@
 // Licensed under the MIT License.
 
 #include "core/framework/mem_pattern_planner.h"
+#include "core/framework/mem_pattern_cache.h"
+#include "core/platform/threadpool.h"
 #include "gtest/gtest.h"
 
 namespace onnxruntime {
@@ -34,5 +36,108 @@ TEST(MemPatternPlannerTest, TraceAllocaitonTest) {
   EXPECT_EQ(pattern.GetBlock(5)->offset_, 1024 + 256 + 512);
   EXPECT_EQ(pattern.GetBlock(6)->offset_, 1024);
 }
+
+static std::unique_ptr<MemoryPatternGroup> CreatePatterns(size_t peak_size) {
+  MemPatternPlanner planner;
+  planner.TraceAllocation(0, peak_size);
+  auto patterns = onnxruntime::make_unique<MemoryPatternGroup>();
+  patterns->patterns.push_back(planner.GenerateMemPattern());
+  return patterns;
+}
+
+TEST(MemoryPatternCacheTest, FindAndInsert) {
+  MemoryPatternCache cache(4);
+  TensorShape a{2, 3};
+  TensorShape b{3, 2};
+  TensorShape c{2};
+  TensorShape d{3};
+
+  EXPECT_EQ(cache.Find({a}), nullptr);
+  cache.Insert({a}, CreatePatterns(6));
+  cache.Insert({b}, CreatePatterns(7));
+
+  auto found = cache.Find({a});
+  ASSERT_NE(found, nullptr);
+  EXPECT_EQ(found->patterns[0].PeakSize(), 6U);
+  found = cache.Find({b});
+  ASSERT_NE(found, nullptr);
+  EXPECT_EQ(found->patterns[0].PeakSize(), 7U);
+
+  // same dims split across a different number of inputs is a different key
+  EXPECT_EQ(cache.Find({c, d}), nullptr);
+
+  // the first entry for a set of shapes wins
+  cache.Insert({a}, CreatePatterns(100));
+  EXPECT_EQ(cache.Find({a})->patterns[0].PeakSize(), 6U);
+
+  auto stats = cache.GetStats();
+  EXPECT_EQ(stats.hits, 3U);
+  EXPECT_EQ(stats.misses, 2U);
+  EXPECT_EQ(stats.evictions, 0U);
+  EXPECT_EQ(stats.size, 2U);
+  // without concurrent readers the replaced tables are freed by the inserts
+  EXPECT_EQ(stats.retired_tables, 0U);
+}
+
+TEST(MemoryPatternCacheTest, EvictsLeastRecentlyUsed) {
+  MemoryPatternCache cache(2);
+  TensorShape a{1};
+  TensorShape b{2};
+  TensorShape c{3};
+
+  // recency is tracked between inserts: 'a' is used before 'b' is inserted, and 'b' after, so 'a' becomes the
+  // least recently used entry. keep a reference to check it outlives eviction.
+  cache.Insert({a}, CreatePatterns(1));
+  auto evicted = cache.Find({a});
+  ASSERT_NE(evicted, nullptr);
+  cache.Insert({b}, CreatePatterns(2));
+  ASSERT_NE(cache.Find({b}), nullptr);
+
+  cache.Insert({c}, CreatePatterns(3));
+
+  EXPECT_EQ(cache.Find({a}), nullptr);
+  EXPECT_NE(cache.Find({b}), nullptr);
+  EXPECT_NE(cache.Find({c}), nullptr);
+  EXPECT_EQ(evicted->patterns[0].PeakSize(), 1U);
+
+  auto stats = cache.GetStats();
+  EXPECT_EQ(stats.evictions, 1U);
+  EXPECT_EQ(stats.size, 2U);
+}
+
+TEST(MemoryPatternCacheTest, ZeroCapacityDisablesCache) {
+  MemoryPatternCache cache(0);
+  TensorShape a{1};
+  cache.Insert({a}, CreatePatterns(1));
+  EXPECT_EQ(cache.Find({a}), nullptr);
+  EXPECT_EQ(cache.GetStats().size, 0U);
+}
+
+TEST(MemoryPatternCacheTest, ConcurrentFindAndInsert) {
+  MemoryPatternCache cache(8);
+  concurrency::ThreadPool tp{"test", 4};
+  std::vector<TensorShape> shapes;
+  for (int64_t i = 1; i <= 16; ++i) {
+    shapes.push_back(TensorShape{i, 2});
+  }
+
+  tp.ParallelFor(1000, [&](int32_t i) {
+    const TensorShape& shape = shapes[i % shapes.size()];
+    auto found = cache.Find({shape});
+    if (found) {
+      EXPECT_EQ(found->patterns[0].PeakSize(), static_cast<size_t>(shape.Size()));
+    } else {
+      cache.Insert({shape}, CreatePatterns(static_cast<size_t>(shape.Size())));
+    }
+  });
+
+  auto stats = cache.GetStats();
+  EXPECT_EQ(stats.hits + stats.misses, 1000U);
+  EXPECT_LE(stats.size, 8U);
+
+  // the tables replaced while other readers were active are freed by a later reader
+  cache.Find({shapes[0]});
+  EXPECT_EQ(cache.GetStats().retired_tables, 0U);
+}
 }  // namespace test
 }  // namespace onnxruntime
@@ -152,5 +152,88 @@ TEST_P(SessionStateTestP, TestInitializerProcessing) {
 }
 
 INSTANTIATE_TEST_CASE_P(SessionStateTests, SessionStateTestP, testing::ValuesIn(param_list));
+
+class SessionStatePrePackTest : public testing::TestWithParam<bool> {};
+// Test that a constant initializer packed by all of its consumers is released, with and without the memory pattern,
+// and that the other initializers keep their values
+TEST_P(SessionStatePrePackTest, ReleasesPackedInitializers) {
+  const bool enable_mem_pattern = GetParam();
+  concurrency::ThreadPool tp{"test", 1};
+
+  onnxruntime::Model model("graph_1", false, DefaultLoggingManager().DefaultLogger());
+  auto& graph = model.MainGraph();
+
+  TypeProto float_type;
+  float_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  auto& a = graph.GetOrCreateNodeArg("A", &float_type);
+  auto& b = graph.GetOrCreateNodeArg("B", &float_type);
+  auto& c = graph.GetOrCreateNodeArg("C", &float_type);
+  auto& y = graph.GetOrCreateNodeArg("Y", &float_type);
+  auto& z = graph.GetOrCreateNodeArg("Z", &float_type);
+  graph.AddNode("matmul", "MatMul", "", {&a, &b}, {&y});
+  graph.AddNode("add", "Add", "", {&y, &c}, {&z});
+
+  TensorProto b_proto;
+  b_proto.set_name("B");
+  b_proto.set_data_type(TensorProto_DataType_FLOAT);
+  b_proto.add_dims(4);
+  b_proto.add_dims(3);
+  for (int i = 0; i < 12; ++i) {
+    b_proto.add_float_data(static_cast<float>(i));
+  }
+  graph.AddInitializedTensor(b_proto);
+
+  TensorProto c_proto;
+  c_proto.set_name("C");
+  c_proto.set_data_type(TensorProto_DataType_FLOAT);
+  c_proto.add_dims(3);
+  for (int i = 0; i < 3; ++i) {
+    c_proto.add_float_data(static_cast<float>(i + 1));
+  }
+  graph.AddInitializedTensor(c_proto);
+
+  Status status = graph.Resolve();
+  ASSERT_TRUE(status.IsOK()) << status;
+
+  ExecutionProviders execution_providers;
+  CPUExecutionProviderInfo epi{false};
+  status = execution_providers.Add(onnxruntime::kCpuExecutionProvider,
+                                   onnxruntime::make_unique<CPUExecutionProvider>(epi));
+  ASSERT_TRUE(status.IsOK()) << status;
+
+  KernelRegistryManager krm;
+  status = krm.RegisterKernels(execution_providers);
+  ASSERT_TRUE(status.IsOK()) << status;
+
+  SessionState session_state(execution_providers, enable_mem_pattern, &tp, nullptr);
+  SessionStateInitializer session_initializer(enable_mem_pattern, ORT_TSTR(""), graph, session_state,
+                                              execution_providers, krm);
+
+  GraphPartitioner partitioner(krm, execution_providers);
+  status = partitioner.Partition(graph, session_state.ExportDll(), session_state.GetMutableFuncMgr());
+  ASSERT_TRUE(status.IsOK()) << status;
+
+  status = session_initializer.CreatePlan(nullptr, nullptr, ExecutionMode::ORT_SEQUENTIAL);
+  ASSERT_TRUE(status.IsOK()) << status;
+
+  const auto& name_to_idx = session_state.GetOrtValueNameIdxMap();
+  int b_idx;
+  int c_idx;
+  ASSERT_TRUE(name_to_idx.GetIdx("B", b_idx).IsOK());
+  ASSERT_TRUE(name_to_idx.GetIdx("C", c_idx).IsOK());
+
+  const auto& initialized_tensors = session_state.GetInitializedTensors();
+  EXPECT_EQ(initialized_tensors.count(b_idx), 0u) << "B is packed by MatMul and should have been released";
+  ASSERT_EQ(initialized_tensors.count(c_idx), 1u);
+  EXPECT_EQ(session_state.GetConstantInitializedTensors().count(b_idx), 0u);
+
+  const Tensor& c_tensor = initialized_tensors.at(c_idx).Get<Tensor>();
+  ASSERT_EQ(c_tensor.Shape().Size(), 3);
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_EQ(c_tensor.Data<float>()[i], static_cast<float>(i + 1));
+  }
+}
+
+INSTANTIATE_TEST_CASE_P(SessionStateTests, SessionStatePrePackTest, testing::Bool());
 }  // namespace test
 }  // namespace onnxruntime
@@ -3,6 +3,7 @@
 
 #include "core/framework/tensor.h"
 #include "core/framework/allocatormgr.h"
+#include "core/framework/string_buffer.h"
 #include "test_utils.h"
 
 #include "gmock/gmock.h"
@@ -168,6 +169,35 @@ TEST(TensorTest, StringTensorTest) {
   }
 }
 
+TEST(TensorTest, StringBufferTest) {
+  TensorShape shape({3});
+  auto alloc = TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault);
+  Tensor t(DataTypeImpl::GetType<std::string>(), shape, alloc);
+  std::string* data = t.template MutableData<std::string>();
+  data[0] = "a";
+  data[2] = "a string longer than the small string buffer";
+
+  StringBuffer buffer;
+  buffer.Assign(t.template Data<std::string>(), 3);
+  ASSERT_EQ(buffer.Size(), 3u);
+  EXPECT_EQ(buffer.Offsets(), (std::vector<size_t>{0, 1, 1, 45}));
+  EXPECT_EQ(buffer.Length(1), 0u);
+  EXPECT_EQ(std::string(buffer.Data(2), buffer.Length(2)), data[2]);
+
+  buffer.Clear();
+  buffer.Append("b", 1);
+  buffer.Extend("cd", 2);
+  buffer.Append(std::string("e"));
+  buffer.Append("", 0);
+  EXPECT_EQ(buffer.String(0), "bcd");
+  EXPECT_EQ(std::string(buffer.Chars().begin(), buffer.Chars().end()), "bcde");
+
+  buffer.CopyTo(data);
+  EXPECT_EQ(data[0], "bcd");
+  EXPECT_EQ(data[1], "e");
+  EXPECT_EQ(data[2], "");
+}
+
 TEST(TensorTest, ConvertToString) {
   TensorShape shape({2, 3, 4});
 
@@ -17,8 +17,11 @@ Abstract:
 #include <stdio.h>
 #include <memory.h>
 #include <algorithm>
+#include <cmath>
 #include <limits>
 #include <memory>
+#include <type_traits>
+#include <vector>
 #include <mlas.h>
 
 #if defined(_WIN32)
@@ -251,6 +254,71 @@ private:
                 printf("mismatch TransA=%d, TransB=%d, M=%zd, N=%zd, K=%zd, alpha=%f, beta=%f  %f %f!\n", TransA, TransB, M, N, K, alpha, beta, float(C[f]), float(CReference[f]));
             }
         }
+
+        TestPackedB(TransA, TransB, M, N, K, alpha, A, lda, B, ldb, beta, C, CReference, ldc);
+    }
+
+    void
+    TestPackedB(
+        CBLAS_TRANSPOSE TransA,
+        CBLAS_TRANSPOSE TransB,
+        size_t M,
+        size_t N,
+        size_t K,
+        float alpha,
+        const float* A,
+        size_t lda,
+        const float* B,
+        size_t ldb,
+        float beta,
+        float* C,
+        const float* CReference,
+        size_t ldc
+        )
+    {
+        //
+        // The packed buffer ends at the guard page, which is aligned beyond
+        // the preferred buffer alignment.
+        //
+
+        size_t PackedBSize = (MlasGemmPackBSize(N, K) + 63) & ~size_t(63);
+        void* PackedB = BufferBPacked.GetBuffer(PackedBSize);
+
+        MlasGemmPackB(TransB, N, K, B, ldb, PackedB);
+
+        std::fill_n(C, M * N, -0.5f);
+
+        MlasGemm(TransA, M, N, K, alpha, A, lda, PackedB, beta, C, ldc, threadpool);
+
+        for (size_t f = 0; f < M * N; f++) {
+            // Sensitive to comparing positive/negative zero.
+            if (C[f] != CReference[f]) {
+                printf("mismatch packed TransA=%d, TransB=%d, M=%zd, N=%zd, K=%zd, alpha=%f, beta=%f  %f %f!\n", TransA, TransB, M, N, K, alpha, beta, C[f], CReference[f]);
+            }
+        }
+    }
+
+    void
+    TestPackedB(
+        CBLAS_TRANSPOSE,
+        CBLAS_TRANSPOSE,
+        size_t,
+        size_t,
+        size_t,
+        float,
+        const double*,
+        size_t,
+        const double*,
+        size_t,
+        float,
+        double*,
+        const double*,
+        size_t
+        )
+    {
+        //
+        // Packing is not implemented for DGEMM.
+        //
     }
 
     void
@@ -366,6 +434,7 @@ private:
     MatrixGuardBuffer<T> BufferB;
     MatrixGuardBuffer<T> BufferC;
     MatrixGuardBuffer<T> BufferCReference;
+    MatrixGuardBuffer<uint8_t> BufferBPacked;
 
 public:
     void
@@ -509,6 +578,28 @@ private:
                 printf("mismatch M=%zd, N=%zd, K=%zd, offa=%d, offb=%d!\n", M, N, K, offa, offb);
             }
         }
+
+        //
+        // Repeat with matrix B packed. The packed buffer ends at the guard
+        // page, which is aligned beyond the preferred buffer alignment.
+        //
+
+        const bool BIsSigned = std::is_signed<xint8_t>::value;
+
+        size_t PackedBSize = (MlasGemmPackBSize(N, K, BIsSigned) + 63) & ~size_t(63);
+        void* PackedB = BufferBPacked.GetBuffer(PackedBSize);
+
+        MlasGemmPackB(N, K, (const uint8_t*)B, ldb, BIsSigned, PackedB);
+
+        std::fill_n(C, M * N, -1);
+
+        MlasGemm(M, N, K, A, lda, offa, PackedB, uint8_t(offb), BIsSigned, C, ldc, threadpool);
+
+        for (size_t f = 0; f < M * N; f++) {
+            if (C[f] != CReference[f]) {
+                printf("mismatch packed M=%zd, N=%zd, K=%zd, offa=%d, offb=%d!\n", M, N, K, offa, offb);
+            }
+        }
     }
 
     void
@@ -550,6 +641,7 @@ private:
     MatrixGuardBuffer<xint8_t> BufferB;
     MatrixGuardBuffer<int32_t> BufferC;
     MatrixGuardBuffer<int32_t> BufferCReference;
+    MatrixGuardBuffer<uint8_t> BufferBPacked;
 
 public:
     void
@@ -640,6 +732,141 @@ public:
 
 #endif
 
+class MlasSparseGemmTest : public MlasTestBase
+{
+private:
+    void
+    Test(
+        size_t M,
+        size_t N,
+        size_t K,
+        size_t Sparsity,
+        float alpha,
+        float beta
+        )
+    {
+        const float* A = BufferA.GetBuffer(K * M);
+        const float* B = BufferB.GetBuffer(N * K);
+        float* C = BufferC.GetBuffer(N * M);
+        float* CReference = BufferCReference.GetBuffer(N * M);
+
+        //
+        // Build the transposed sparse matrix by dropping elements of the
+        // dense matrix in a pattern that leaves some rows empty.
+        //
+
+        std::vector<float> DenseB(B, B + N * K);
+        std::vector<int32_t> RowOffsets(1, 0);
+        std::vector<int32_t> ColumnIndices;
+        std::vector<float> Values;
+
+        for (size_t n = 0; n < N; n++) {
+            for (size_t k = 0; k < K; k++) {
+                float& b = DenseB[k * N + n];
+                if (((n * 7 + k * 3) % 10) < Sparsity || n % 13 == 5) {
+                    b = 0.0f;
+                } else {
+                    ColumnIndices.push_back(int32_t(k));
+                    Values.push_back(b);
+                }
+            }
+            RowOffsets.push_back(int32_t(Values.size()));
+        }
+
+        std::fill_n(C, M * N, -0.5f);
+        std::fill_n(CReference, M * N, -0.5f);
+
+        MlasSparseGemm(M, N, K, alpha, A, K, RowOffsets.data(), ColumnIndices.data(), Values.data(), beta, C, N, threadpool);
+        ReferenceGemm(M, N, K, alpha, A, DenseB.data(), beta, CReference);
+
+        for (size_t f = 0; f < M * N; f++) {
+            // Sensitive to comparing positive/negative zero.
+            if (C[f] != CReference[f]) {
+                printf("mismatch M=%zd, N=%zd, K=%zd, Sparsity=%zd, alpha=%f, beta=%f!\n", M, N, K, Sparsity, alpha, beta);
+                break;
+            }
+        }
+    }
+
+    void
+    ReferenceGemm(
+        size_t M,
+        size_t N,
+        size_t K,
+        float alpha,
+        const float* A,
+        const float* B,
+        float beta,
+        float* C
+        )
+    {
+        for (size_t m = 0; m < M; m++) {
+
+            for (size_t n = 0; n < N; n++) {
+
+                const float* a = A + (m * K);
+                const float* b = B + n;
+                float* c = C + (m * N) + n;
+                float sum = 0.0f;
+
+                for (size_t k = 0; k < K; k++) {
+                    if (*b != 0.0f) {
+                        sum += (*b * *a);
+                    }
+                    b += N;
+                    a += 1;
+                }
+
+                *c = (beta == 0.0f) ? (alpha * sum) : (alpha * sum + beta * *c);
+            }
+        }
+    }
+
+    MatrixGuardBuffer<float> BufferA;
+    MatrixGuardBuffer<float> BufferB;
+    MatrixGuardBuffer<float> BufferC;
+    MatrixGuardBuffer<float> BufferCReference;
+
+public:
+    void
+    ExecuteShort(
+        void
+        ) override
+    {
+        for (size_t b = 1; b < 16; b++) {
+            Test(b, b, b, 8, 1.0f, 0.0f);
+        }
+        for (size_t b = 16; b <= 256; b <<= 1) {
+            Test(b, b, b, 9, 1.0f, 0.0f);
+            Test(b, b, b, 5, 0.5f, 1.0f);
+        }
+        for (size_t b = 1; b < 96; b += 7) {
+            Test(1, b, 32, 8, 1.0f, 0.0f);
+            Test(1, 512, b, 8, 1.0f, 0.0f);
+            Test(b, 64, 128, 9, 2.0f, -1.0f);
+        }
+        Test(3, 17, 19, 10, 1.0f, 0.0f);
+    }
+
+    void
+    ExecuteLong(
+        void
+        ) override
+    {
+        for (size_t Sparsity = 0; Sparsity <= 10; Sparsity++) {
+            for (size_t M = 1; M < 64; M += 3) {
+                for (size_t N = 1; N < 160; N += 13) {
+                    for (size_t K = 1; K < 160; K += 11) {
+                        Test(M, N, K, Sparsity, 1.0f, 0.0f);
+                        Test(M, N, K, Sparsity, 0.25f, 3.0f);
+                    }
+                }
+            }
+            printf("Sparsity %zd\n", Sparsity);
+        }
+    }
+};
+
 class MlasConv2DTest : public MlasTestBase
 {
 protected:
@@ -1876,6 +2103,301 @@ public:
     }
 };
 
+class MlasRequantizeOutputTest : public MlasTestBase
+{
+private:
+    MatrixGuardBuffer<int32_t> BufferInput;
+    MatrixGuardBuffer<uint8_t> BufferOutput;
+    MatrixGuardBuffer<uint8_t> BufferOutputReference;
+
+    void
+    Test(
+        size_t M,
+        size_t N,
+        MLAS_QUANTIZATION_GRANULARITY ScaleGranularity,
+        uint8_t ZeroPoint
+        )
+    {
+        int32_t* Input = BufferInput.GetBuffer(M * N);
+        uint8_t* Output = BufferOutput.GetBuffer(M * N);
+        uint8_t* OutputReference = BufferOutputReference.GetBuffer(M * N);
+
+        std::vector<int32_t> Bias(M);
+        std::vector<float> Scale(std::max(M, N));
+
+        //
+        // Include accumulators that saturate on either end of the output
+        // range, and scaled values that fall halfway between integers.
+        //
+
+        for (size_t f = 0; f < M * N; f++) {
+            Input[f] = int32_t((f * 7919) % 20001) - 10000;
+        }
+        Input[0] = (std::numeric_limits<int32_t>::max)() / 2;
+        Input[M * N - 1] = (std::numeric_limits<int32_t>::min)() / 2;
+
+        for (size_t m = 0; m < M; m++) {
+            Bias[m] = int32_t(m * 31) - 50;
+        }
+
+        for (size_t s = 0; s < Scale.size(); s++) {
+            Scale[s] = 0.5f / float(1 + s % 7);
+        }
+
+        MlasRequantizeOutput(Input, Output, Bias.data(), M, N, Scale.data(), ScaleGranularity, ZeroPoint);
+
+        for (size_t m = 0; m < M; m++) {
+            for (size_t n = 0; n < N; n++) {
+                float s = (ScaleGranularity == MlasPerMatrix) ? Scale[0] :
+                    (ScaleGranularity == MlasPerRow) ? Scale[m] : Scale[n];
+                float Value = std::nearbyint(float(Input[m * N + n] + Bias[m]) * s) + float(ZeroPoint);
+                OutputReference[m * N + n] = uint8_t((std::min)((std::max)(Value, 0.0f), 255.0f));
+            }
+        }
+
+        for (size_t f = 0; f < M * N; f++) {
+            if (Output[f] != OutputReference[f]) {
+                printf("mismatch M=%zd, N=%zd, granularity=%d, zp=%d, f=%zd!\n", M, N, int(ScaleGranularity), ZeroPoint, f);
+                break;
+            }
+        }
+    }
+
+public:
+    void
+    ExecuteShort(
+        void
+        ) override
+    {
+        for (size_t M = 1; M < 6; M++) {
+            for (size_t N = 1; N < 40; N++) {
+                Test(M, N, MlasPerMatrix, 0);
+                Test(M, N, MlasPerRow, 128);
+                Test(M, N, MlasPerColumn, 255);
+            }
+        }
+    }
+
+    void
+    ExecuteLong(
+        void
+        ) override
+    {
+    }
+};
+
+#ifdef MLAS_HAS_QGEMM_U8X8
+
+class MlasQConv2DTest : public MlasTestBase
+{
+private:
+    MatrixGuardBuffer<uint8_t> BufferInput;
+    MatrixGuardBuffer<uint8_t> BufferFilter;
+    MatrixGuardBuffer<uint8_t> BufferWorking;
+    MatrixGuardBuffer<int32_t> BufferOutput;
+    MatrixGuardBuffer<int32_t> BufferOutputReference;
+
+    void
+    Test(
+        size_t BatchCount,
+        size_t GroupCount,
+        size_t InputChannels,
+        size_t InputHeight,
+        size_t InputWidth,
+        size_t FilterCount,
+        size_t KernelHeight,
+        size_t KernelWidth,
+        size_t PaddingLeftHeight,
+        size_t PaddingLeftWidth,
+        size_t PaddingRightHeight,
+        size_t PaddingRightWidth,
+        size_t DilationHeight,
+        size_t DilationWidth,
+        size_t StrideHeight,
+        size_t StrideWidth,
+        uint8_t InputZeroPoint,
+        bool PerChannelFilterZeroPoint
+        )
+    {
+        int64_t OutputHeight64 =
+            ((int64_t(InputHeight) + int64_t(PaddingLeftHeight) + int64_t(PaddingRightHeight)) -
+            (int64_t(DilationHeight) * (int64_t(KernelHeight) - 1) + 1)) / int64_t(StrideHeight) + 1;
+        int64_t OutputWidth64 =
+            ((int64_t(InputWidth) + int64_t(PaddingLeftWidth) + int64_t(PaddingRightWidth)) -
+            (int64_t(DilationWidth) * (int64_t(KernelWidth) - 1) + 1)) / int64_t(StrideWidth) + 1;
+
+        if (OutputHeight64 <= 0 || OutputWidth64 <= 0) {
+            return;
+        }
+
+        size_t OutputHeight = size_t(OutputHeight64);
+        size_t OutputWidth = size_t(OutputWidth64);
+
+        size_t InputSize = InputHeight * InputWidth;
+        size_t KernelSize = KernelHeight * KernelWidth;
+        size_t OutputSize = OutputHeight * OutputWidth;
+
+        size_t InputElements = BatchCount * GroupCount * InputChannels * InputSize;
+        size_t FilterElements = GroupCount * FilterCount * InputChannels * KernelSize;
+        size_t OutputElements = BatchCount * GroupCount * FilterCount * OutputSize;
+
+        const uint8_t* Input = BufferInput.GetBuffer(InputElements);
+        const uint8_t* Filter = BufferFilter.GetBuffer(FilterElements);
+        int32_t* Output = BufferOutput.GetBuffer(OutputElements);
+        int32_t* OutputReference = BufferOutputReference.GetBuffer(OutputElements);
+
+        std::vector<uint8_t> FilterZeroPoint(GroupCount * FilterCount);
+
+        for (size_t f = 0; f < FilterZeroPoint.size(); f++) {
+            FilterZeroPoint[f] = PerChannelFilterZeroPoint ? uint8_t(f * 37 + 5) : 17;
+        }
+
+        int64_t InputShape[] = { int64_t(InputHeight), int64_t(InputWidth) };
+        int64_t KernelShape[] = { int64_t(KernelHeight), int64_t(KernelWidth) };
+        int64_t DilationShape[] = { int64_t(DilationHeight), int64_t(DilationWidth) };
+        int64_t Padding[] = { int64_t(PaddingLeftHeight), int64_t(PaddingLeftWidth), int64_t(PaddingRightHeight), int64_t(PaddingRightWidth) };
+        int64_t StrideShape[] = { int64_t(StrideHeight), int64_t(StrideWidth) };
+        int64_t OutputShape[] = { int64_t(OutputHeight), int64_t(OutputWidth) };
+
+        MLAS_QCONV_PARAMETERS Parameters;
+        size_t WorkingBufferSize;
+
+        MlasQConvPrepare(&Parameters, 2, BatchCount, GroupCount, InputChannels,
+            InputShape, KernelShape, DilationShape, Padding, StrideShape,
+            OutputShape, FilterCount, InputZeroPoint, &WorkingBufferSize, threadpool);
+
+        uint8_t* WorkingBuffer = BufferWorking.GetBuffer(WorkingBufferSize);
+
+        MlasQConv(&Parameters, Input, Filter, FilterZeroPoint.data(),
+            PerChannelFilterZeroPoint, WorkingBuffer, Output, threadpool);
+
+        ReferenceQConv2D(BatchCount, GroupCount, InputChannels, InputHeight,
+            InputWidth, FilterCount, KernelHeight, KernelWidth, PaddingLeftHeight,
+            PaddingLeftWidth, DilationHeight, DilationWidth, StrideHeight,
+            StrideWidth, OutputHeight, OutputWidth, Input, InputZeroPoint,
+            Filter, FilterZeroPoint.data(), OutputReference);
+
+        if (memcmp(Output, OutputReference, OutputElements * sizeof(int32_t)) != 0) {
+            printf("mismatch: batch=%zd,group=%zd,input(%zd,%zd,%zd),filter=%zd,kernel(%zd,%zd),algorithm=%d!!!\n",
+                BatchCount, GroupCount, InputChannels, InputHeight, InputWidth, FilterCount,
+                KernelHeight, KernelWidth, int(Parameters.Algorithm));
+        }
+    }
+
+    void
+    ReferenceQConv2D(
+        size_t BatchCount,
+        size_t GroupCount,
+        size_t InputChannels,
+        size_t InputHeight,
+        size_t InputWidth,
+        size_t FilterCount,
+        size_t KernelHeight,
+        size_t KernelWidth,
+        size_t PaddingLeftHeight,
+        size_t PaddingLeftWidth,
+        size_t DilationHeight,
+        size_t DilationWidth,
+        size_t StrideHeight,
+        size_t StrideWidth,
+        size_t OutputHeight,
+        size_t OutputWidth,
+        const uint8_t* Input,
+        uint8_t InputZeroPoint,
+        const uint8_t* Filter,
+        const uint8_t* FilterZeroPoint,
+        int32_t* Output
+        )
+    {
+        for (size_t b = 0; b < BatchCount; b++) {
+
+            for (size_t g = 0; g < GroupCount; g++) {
+
+                const uint8_t* input = Input + (b * GroupCount + g) * InputChannels * InputHeight * InputWidth;
+
+                for (size_t f = 0; f < FilterCount; f++) {
+
+                    const uint8_t* filter = Filter + (g * FilterCount + f) * InputChannels * KernelHeight * KernelWidth;
+                    const int32_t zp = FilterZeroPoint[g * FilterCount + f];
+
+                    for (size_t oh = 0; oh < OutputHeight; oh++) {
+                        for (size_t ow = 0; ow < OutputWidth; ow++) {
+
+                            int32_t sum = 0;
+
+                            for (size_t ic = 0; ic < InputChannels; ic++) {
+                                for (size_t kh = 0; kh < KernelHeight; kh++) {
+                                    for (size_t kw = 0; kw < KernelWidth; kw++) {
+
+                                        size_t ih = oh * StrideHeight + kh * DilationHeight - PaddingLeftHeight;
+                                        size_t iw = ow * StrideWidth + kw * DilationWidth - PaddingLeftWidth;
+
+                                        int32_t in = InputZeroPoint;
+
+                                        if (ih < InputHeight && iw < InputWidth) {
+                                            in = input[(ic * InputHeight + ih) * InputWidth + iw];
+                                        }
+
+                                        int32_t w = filter[(ic * KernelHeight + kh) * KernelWidth + kw];
+
+                                        sum += (in - int32_t(InputZeroPoint)) * (w - zp);
+                                    }
+                                }
+                            }
+
+                            *Output++ = sum;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+public:
+    void
+    ExecuteShort(
+        void
+        ) override
+    {
+        for (unsigned i = 1; i < 64; i <<= 1) {
+            Test(1, 1, 16, i, i, 32, 3, 3, 0, 0, 0, 0, 1, 1, 1, 1, 0, false);
+            Test(1, 1, 16, i, i, 32, 3, 3, 0, 0, 0, 0, 1, 1, 2, 2, 71, false);
+            Test(1, 1, 16, i, i, 32, 3, 3, 1, 1, 1, 1, 1, 1, 1, 1, 128, true);
+            Test(1, 1, 16, i, i, 32, 3, 3, 1, 1, 1, 1, 2, 2, 1, 1, 255, false);
+            Test(1, 1, 16, i, i, 32, 3, 3, 2, 1, 0, 2, 1, 1, 2, 1, 3, true);
+            Test(1, 1, 16, i, i, 32, 1, 1, 0, 0, 0, 0, 1, 1, 1, 1, 99, false);
+            Test(1, 1, 16, i, i, 32, 1, 1, 0, 0, 0, 0, 1, 1, 1, 1, 99, true);
+            Test(1, 1, 16, i, i, 32, 1, 1, 0, 0, 0, 0, 1, 1, 2, 2, 12, false);
+            Test(1, 1, 16, i, i, 32, 5, 1, 2, 0, 2, 0, 1, 1, 1, 1, 200, true);
+            Test(1, 1, 16, i, 1, 32, 3, 1, 1, 0, 1, 0, 1, 1, 1, 1, 7, false);
+            Test(1, 16, 1, i, i, 1, 3, 3, 1, 1, 1, 1, 1, 1, 1, 1, 131, false);
+            Test(1, 16, 1, i, i, 1, 3, 3, 1, 1, 1, 1, 1, 1, 2, 2, 131, true);
+            Test(2, 16, 1, i, i, 1, 5, 5, 2, 2, 2, 2, 2, 2, 1, 1, 64, true);
+            Test(1, 2, 8, i, i, 12, 3, 3, 1, 1, 1, 1, 1, 1, 1, 1, 33, true);
+            Test(3, 2, 8, i, i, 12, 1, 1, 0, 0, 0, 0, 1, 1, 1, 1, 33, true);
+        }
+
+        Test(1, 1, 64, 40, 40, 16, 3, 3, 1, 1, 1, 1, 1, 1, 1, 1, 90, true);
+        Test(1, 1, 512, 13, 13, 24, 3, 3, 1, 1, 1, 1, 1, 1, 1, 1, 90, false);
+        Test(4, 1, 3, 57, 33, 8, 7, 7, 3, 3, 3, 3, 1, 1, 2, 2, 128, true);
+
+        // Small outputs with many filters, which are split across threads.
+        Test(1, 1, 64, 7, 7, 256, 3, 3, 1, 1, 1, 1, 1, 1, 1, 1, 90, true);
+        Test(1, 1, 64, 7, 7, 200, 3, 3, 1, 1, 1, 1, 1, 1, 1, 1, 90, false);
+        Test(1, 1, 128, 14, 14, 97, 1, 1, 0, 0, 0, 0, 1, 1, 1, 1, 13, true);
+        Test(2, 2, 32, 5, 5, 80, 3, 3, 0, 0, 0, 0, 1, 1, 1, 1, 200, true);
+    }
+
+    void
+    ExecuteLong(
+        void
+        ) override
+    {
+    }
+};
+
+#endif
+
 class MlasActivationTest : public MlasTestBase
 {
 public:
@@ -1994,6 +2516,9 @@ main(
         onnxruntime::make_unique<MlasQgemmU8X8Test<uint8_t>>()->ExecuteShort();
 #endif
 
+        printf("Sparse SGEMM tests.\n");
+        onnxruntime::make_unique<MlasSparseGemmTest>()->ExecuteShort();
+
         printf("Conv2D tests.\n");
         onnxruntime::make_unique<MlasConv2DTest>()->ExecuteShort();
         if (MlasNchwcGetBlockSize() > 1) {
@@ -2009,6 +2534,14 @@ main(
         printf("Pool3D tests.\n");
         onnxruntime::make_unique<MlasPool3DTest>()->ExecuteShort();
 
+        printf("Requantize tests.\n");
+        onnxruntime::make_unique<MlasRequantizeOutputTest>()->ExecuteShort();
+
+#ifdef MLAS_HAS_QGEMM_U8X8
+        printf("QConv2D tests.\n");
+        onnxruntime::make_unique<MlasQConv2DTest>()->ExecuteShort();
+#endif
+
         printf("Activation tests.\n");
         onnxruntime::make_unique<MlasActivationTest>()->ExecuteShort();
 
@@ -29,6 +29,7 @@
 #include "core/optimizer/rule_based_graph_transformer.h"
 #include "core/optimizer/shape_to_initializer.h"
 #include "core/optimizer/slice_elimination.h"
+#include "core/optimizer/sparse_weight_transformer.h"
 #include "core/optimizer/unsqueeze_elimination.h"
 #include "core/optimizer/reshape_fusion.h"
 #include "core/optimizer/attention_fusion.h"
@@ -1325,5 +1326,68 @@ TEST(GraphTransformationTests, EmbedLayerNormFusionFormat2) {
 }
 #endif
 
+#ifndef DISABLE_CONTRIB_OPS
+TEST(GraphTransformationTests, SparseWeightTransformer) {
+  Model model("SparseWeightTransformer", false, DefaultLoggingManager().DefaultLogger());
+  auto& graph = model.MainGraph();
+
+  TypeProto float_tensor_type;
+  float_tensor_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  auto* shape = float_tensor_type.mutable_tensor_type()->mutable_shape();
+  shape->add_dim()->set_dim_value(2);
+  shape->add_dim()->set_dim_value(4);
+
+  // 4x3 weights. 9 of the 12 elements of the first are zero, none of the second.
+  auto add_weight = [&graph](const std::string& name, const std::vector<float>& values) {
+    TensorProto weight;
+    weight.set_name(name);
+    weight.set_data_type(TensorProto_DataType_FLOAT);
+    weight.add_dims(4);
+    weight.add_dims(3);
+    for (float value : values) {
+      weight.add_float_data(value);
+    }
+    graph.AddInitializedTensor(weight);
+    return &graph.GetOrCreateNodeArg(name, nullptr);
+  };
+
+  auto* sparse_weight = add_weight("sparse_weight", {1, 0, 0, 0, 0, 2, 0, 0, 0, 3, 0, 0});
+  auto* dense_weight = add_weight("dense_weight", {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12});
+
+  auto& input = graph.GetOrCreateNodeArg("input", &float_tensor_type);
+  auto& sparse_out = graph.GetOrCreateNodeArg("sparse_out", nullptr);
+  auto& dense_out = graph.GetOrCreateNodeArg("dense_out", nullptr);
+  auto& gemm_out = graph.GetOrCreateNodeArg("gemm_out", nullptr);
+  graph.AddNode("sparse", "MatMul", "Sparse weight", {&input, sparse_weight}, {&sparse_out});
+  graph.AddNode("dense", "MatMul", "Dense weight", {&input, dense_weight}, {&dense_out});
+  graph.AddNode("gemm", "Gemm", "Shares the sparse weight", {&input, sparse_weight}, {&gemm_out});
+
+  auto status = graph.Resolve();
+  ASSERT_TRUE(status.IsOK()) << status;
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  graph_transformation_mgr.Register(onnxruntime::make_unique<SparseWeightTransformer>(0.7f), TransformerLevel::Level2);
+  status = graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level2, DefaultLoggingManager().DefaultLogger());
+  ASSERT_TRUE(status.IsOK()) << status;
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  ASSERT_EQ(op_to_count["MatMul"], 1);
+  ASSERT_EQ(op_to_count["Gemm"], 0);
+  ASSERT_EQ(op_to_count["SparseMatMul"], 2);
+
+  // both nodes use the same converted weight and the dense one is removed
+  const TensorProto* tensor_proto = nullptr;
+  ASSERT_FALSE(graph.GetInitializedTensor("sparse_weight", tensor_proto));
+  for (const auto& node : graph.Nodes()) {
+    if (node.OpType() == "SparseMatMul") {
+      ASSERT_TRUE(graph.GetInitializedTensor(node.InputDefs()[1]->Name(), tensor_proto));
+      EXPECT_EQ(tensor_proto->dims(0), 3);
+      ASSERT_TRUE(graph.GetInitializedTensor(node.InputDefs()[2]->Name(), tensor_proto));
+      EXPECT_EQ(tensor_proto->dims(0), 4);
+    }
+  }
+}
+#endif
+
 }  // namespace test
 }  // namespace onnxruntime
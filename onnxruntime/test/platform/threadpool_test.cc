@@ -39,8 +39,9 @@ void ValidateTestData(TestData& test_data) {
                             [](int i) { return i != 1; }) == 0);
 }
 
-void CreateThreadPoolAndTest(const std::string& name, int num_threads, const std::function<void(ThreadPool*)>& test_body) {
-  auto tp = onnxruntime::make_unique<ThreadPool>(name, num_threads);
+void CreateThreadPoolAndTest(const std::string& name, int num_threads, const std::function<void(ThreadPool*)>& test_body,
+                             const ThreadOptions& thread_options = ThreadOptions()) {
+  auto tp = onnxruntime::make_unique<ThreadPool>(name, num_threads, thread_options);
   test_body(tp.get());
 }
 
@@ -66,6 +67,32 @@ void TestBatchParallelFor(const std::string& name, int num_threads, int num_task
   ValidateTestData(*test_data);
 }
 
+void TestParallelForWithCost(const std::string& name, int num_threads, int num_tasks, double cost_per_unit) {
+  auto test_data = CreateTestData(num_tasks);
+  CreateThreadPoolAndTest(name, num_threads, [&](ThreadPool* tp) {
+    tp->ParallelFor(num_tasks, cost_per_unit, [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+      ASSERT_LT(first, last);
+      for (std::ptrdiff_t i = first; i < last; ++i) {
+        IncrementElement(*test_data, static_cast<int>(i));
+      }
+    });
+  });
+  ValidateTestData(*test_data);
+}
+
+void TestParallelForRange(const std::string& name, int num_threads, int first, int last) {
+  auto test_data = CreateTestData(last);
+  std::fill(test_data->data.begin(), test_data->data.begin() + first, 1);
+  CreateThreadPoolAndTest(name, num_threads, [&](ThreadPool* tp) {
+    tp->ParallelForRange(first, last, [&](int64_t range_first, int64_t range_last) {
+      for (int64_t i = range_first; i < range_last; ++i) {
+        IncrementElement(*test_data, static_cast<int>(i));
+      }
+    });
+  });
+  ValidateTestData(*test_data);
+}
+
 }  // namespace
 
 TEST(ThreadPoolTest, TestParallelFor_2_Thread_NoTask) {
@@ -99,3 +126,93 @@ TEST(ThreadPoolTest, TestBatchParallelFor_2_Thread_50_Task_100_Batch) {
 TEST(ThreadPoolTest, TestBatchParallelFor_2_Thread_81_Task_20_Batch) {
   TestBatchParallelFor("TestBatchParallelFor_2_Thread_81_Task_20_Batch", 2, 81, 20);
 }
+
+TEST(ThreadPoolTest, TestParallelForWithCost_2_Thread_NoTask) {
+  TestParallelForWithCost("TestParallelForWithCost_2_Thread_NoTask", 2, 0, 1.0);
+}
+
+TEST(ThreadPoolTest, TestParallelForWithCost_4_Thread_4096_Task_Cheap) {
+  TestParallelForWithCost("TestParallelForWithCost_4_Thread_4096_Task_Cheap", 4, 4096, 1.0);
+}
+
+TEST(ThreadPoolTest, TestParallelForWithCost_4_Thread_4096_Task_Expensive) {
+  TestParallelForWithCost("TestParallelForWithCost_4_Thread_4096_Task_Expensive", 4, 4096, 1e6);
+}
+
+TEST(ThreadPoolTest, TestParallelForWithCost_4_Thread_3_Task_Expensive) {
+  TestParallelForWithCost("TestParallelForWithCost_4_Thread_3_Task_Expensive", 4, 3, 1e6);
+}
+
+TEST(ThreadPoolTest, TestParallelForWithCost_1_Thread_1000_Task) {
+  TestParallelForWithCost("TestParallelForWithCost_1_Thread_1000_Task", 1, 1000, 1e4);
+}
+
+TEST(ThreadPoolTest, TestParallelForRange_2_Thread_10_To_60) {
+  TestParallelForRange("TestParallelForRange_2_Thread_10_To_60", 2, 10, 60);
+}
+
+TEST(ThreadPoolTest, TestParallelForRange_2_Thread_Single) {
+  TestParallelForRange("TestParallelForRange_2_Thread_Single", 2, 5, 6);
+}
+
+TEST(ThreadPoolTest, TestTryParallelForWithCost_NoThreadPool) {
+  auto test_data = CreateTestData(100);
+  ThreadPool::TryParallelFor(nullptr, 100, 1e6, [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+    for (std::ptrdiff_t i = first; i < last; ++i) {
+      IncrementElement(*test_data, static_cast<int>(i));
+    }
+  });
+  ValidateTestData(*test_data);
+}
+
+TEST(ThreadPoolTest, TestParallelFor_Spinning_4_Thread_1000_Task) {
+  ThreadOptions thread_options;
+  thread_options.spin_duration_us = 1000;
+  auto test_data = CreateTestData(1000);
+  CreateThreadPoolAndTest(
+      "TestParallelFor_Spinning_4_Thread_1000_Task", 4,
+      [&](ThreadPool* tp) {
+        // run several parallel sections back to back so that later ones are picked up by spinning threads
+        for (int section = 0; section < 10; ++section) {
+          tp->ParallelFor(100, 1e6, [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+            for (std::ptrdiff_t i = first; i < last; ++i) {
+              IncrementElement(*test_data, static_cast<int>(section * 100 + i));
+            }
+          });
+        }
+      },
+      thread_options);
+  ValidateTestData(*test_data);
+}
+
+TEST(ThreadPoolTest, TestParallelFor_Affinity_2_Thread_50_Task) {
+  ThreadOptions thread_options;
+  thread_options.affinities = {{0}};
+  auto test_data = CreateTestData(50);
+  CreateThreadPoolAndTest(
+      "TestParallelFor_Affinity_2_Thread_50_Task", 2,
+      [&](ThreadPool* tp) {
+        tp->ParallelFor(50, [&](int i) {
+          IncrementElement(*test_data, i);
+        });
+      },
+      thread_options);
+  ValidateTestData(*test_data);
+}
+
+TEST(ThreadPoolTest, TestParallelFor_SharedPoolView) {
+  auto shared_pool = onnxruntime::make_unique<ThreadPool>("TestParallelFor_SharedPoolView", 4);
+  ThreadPool view(*shared_pool, 2);
+  ASSERT_EQ(view.NumThreads(), 2);
+
+  ThreadPool unlimited_view(*shared_pool, 0);
+  ASSERT_EQ(unlimited_view.NumThreads(), 4);
+
+  auto test_data = CreateTestData(200);
+  view.ParallelFor(200, 1e6, [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+    for (std::ptrdiff_t i = first; i < last; ++i) {
+      IncrementElement(*test_data, static_cast<int>(i));
+    }
+  });
+  ValidateTestData(*test_data);
+}
@@ -276,6 +276,27 @@ TEST(MathOpTest, Add_Broadcast_2x1x1_3x4) {
 #endif
 }
 
+// large enough to be split between threads, with ranges that start within the spans of the broadcast
+TEST(MathOpTest, Add_Broadcast_Large) {
+  const int64_t N = 64, C = 3, S = 700;
+  std::vector<float> a(N * C * S);
+  for (size_t i = 0; i < a.size(); ++i) {
+    a[i] = static_cast<float>(i % 101);
+  }
+  std::vector<float> b{1000.0f, 2000.0f, 3000.0f};
+
+  std::vector<float> c(a.size());
+  for (size_t i = 0; i < c.size(); ++i) {
+    c[i] = a[i] + b[(i / S) % C];
+  }
+
+  OpTester test("Add");
+  test.AddInput<float>("A", {N, C, S}, a);
+  test.AddInput<float>("B", {C, 1}, b);
+  test.AddOutput<float>("C", {N, C, S}, c);
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
+}
+
 // Validate runtime failure has useful error message when ORT_ENFORCE is used
 TEST(MathOpTest, Add_Invalid_Broadcast) {
   OpTester test("Add");
@@ -731,6 +752,45 @@ TEST(MathOpTest, Sum_8_Test2) {
 #endif
 }
 
+TEST(MathOpTest, Sum_8_Broadcast_Large) {
+  const int64_t rows = 200, cols = 700;
+  std::vector<float> data_0(cols), data_1{0.5f}, data_2(rows * cols), data_3(rows);
+  for (int64_t c = 0; c < cols; ++c) {
+    data_0[c] = static_cast<float>(c);
+  }
+  for (int64_t i = 0; i < rows * cols; ++i) {
+    data_2[i] = static_cast<float>(i % 13);
+  }
+  for (int64_t r = 0; r < rows; ++r) {
+    data_3[r] = static_cast<float>(-r);
+  }
+
+  std::vector<float> sum(rows * cols);
+  for (int64_t r = 0; r < rows; ++r) {
+    for (int64_t c = 0; c < cols; ++c) {
+      sum[r * cols + c] = data_0[c] + data_1[0] + data_2[r * cols + c] + data_3[r];
+    }
+  }
+
+  // the first two inputs don't have the shape of the output
+  OpTester test("Sum", 8);
+  test.AddInput<float>("data_0", {cols}, data_0);
+  test.AddInput<float>("data_1", {1}, data_1);
+  test.AddInput<float>("data_2", {rows, cols}, data_2);
+  test.AddInput<float>("data_3", {rows, 1}, data_3);
+  test.AddOutput<float>("sum", {rows, cols}, sum);
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
+
+  // the first two inputs broadcast to the shape of the output
+  OpTester test2("Sum", 8);
+  test2.AddInput<float>("data_3", {rows, 1}, data_3);
+  test2.AddInput<float>("data_0", {cols}, data_0);
+  test2.AddInput<float>("data_2", {rows, cols}, data_2);
+  test2.AddInput<float>("data_1", {1}, data_1);
+  test2.AddOutput<float>("sum", {rows, cols}, sum);
+  test2.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
+}
+
 TEST(MathOpTest, Min_6) {
   OpTester test("Min", 6);
   std::vector<int64_t> dims{3, 3};
@@ -257,5 +257,57 @@ TEST(GemmOpTest, GemmNoBiasOpset11) {
   test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kNGraphExecutionProvider, kTensorrtExecutionProvider});
 }
 
+// B is an initializer, which is pre-packed. K and N span several packed panels.
+TEST(GemmOpTest, GemmConstantB) {
+  constexpr int64_t M = 3;
+  constexpr int64_t K = 130;
+  constexpr int64_t N = 20;
+
+  for (int64_t trans_b = 0; trans_b <= 1; ++trans_b) {
+    OpTester test("Gemm");
+
+    test.AddAttribute("transA", static_cast<int64_t>(0));
+    test.AddAttribute("transB", trans_b);
+    test.AddAttribute("alpha", 0.5f);
+    test.AddAttribute("beta", 2.0f);
+
+    std::vector<float> a_data(M * K);
+    for (int64_t i = 0; i < M * K; ++i) {
+      a_data[i] = static_cast<float>(i % 7 - 3);
+    }
+
+    // b_data holds B as (K, N), b_input holds it in the layout given by transB
+    std::vector<float> b_data(K * N);
+    std::vector<float> b_input(K * N);
+    for (int64_t k = 0; k < K; ++k) {
+      for (int64_t n = 0; n < N; ++n) {
+        b_data[k * N + n] = static_cast<float>((k * N + n) % 5 - 2);
+        b_input[trans_b ? n * K + k : k * N + n] = b_data[k * N + n];
+      }
+    }
+
+    std::vector<float> c_data(N);
+    std::vector<float> expected(M * N);
+    for (int64_t n = 0; n < N; ++n) {
+      c_data[n] = static_cast<float>(n);
+    }
+    for (int64_t m = 0; m < M; ++m) {
+      for (int64_t n = 0; n < N; ++n) {
+        float sum = 0.0f;
+        for (int64_t k = 0; k < K; ++k) {
+          sum += a_data[m * K + k] * b_data[k * N + n];
+        }
+        expected[m * N + n] = 0.5f * sum + 2.0f * c_data[n];
+      }
+    }
+
+    test.AddInput<float>("A", {M, K}, a_data);
+    test.AddInput<float>("B", trans_b ? std::vector<int64_t>{N, K} : std::vector<int64_t>{K, N}, b_input, true);
+    test.AddInput<float>("C", {N}, c_data);
+    test.AddOutput<float>("Y", {M, N}, expected);
+    test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
+  }
+}
+
 }  // namespace test
 }  // namespace onnxruntime
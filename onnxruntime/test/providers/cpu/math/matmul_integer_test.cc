@@ -42,6 +42,17 @@ TEST(MatmulIntegerOpTest, MatMulInteger_WithZero_ZeroPoint) {
   test.Run();
 }
 
+// a constant B is packed by the kernel when the session is initialized
+TEST(MatmulIntegerOpTest, MatMulInteger_2D_ConstantB) {
+  OpTester test("MatMulInteger", 10);
+  test.AddInput<uint8_t>("T1", {4, 3}, {11, 7, 3, 10, 6, 2, 9, 5, 1, 8, 4, 0});
+  test.AddInput<uint8_t>("T2", {3, 2}, {1, 4, 2, 5, 3, 6}, /*is_initializer*/ true);
+  test.AddInput<uint8_t>("a_zero_point", {}, {12});
+  test.AddInput<uint8_t>("b_zero_point", {}, {1});
+  test.AddOutput<int32_t>("T3", {4, 2}, {-23, -68, -26, -80, -29, -92, -32, -104});
+  test.Run();
+}
+
 template <typename T>
 std::vector<T> ToVector(const int* value, int size) {
   std::vector<T> data(size);
@@ -81,7 +81,7 @@ std::vector<MatMulTestData<T>> GenerateTestCases()
 }
 
 template <typename T>
-void RunMatMulTest(int32_t opset_version = 7)
+void RunMatMulTest(int32_t opset_version = 7, bool is_b_constant = false)
 {
   std::vector<T> common_input_vals{0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11};
   for (auto t : GenerateTestCases<T>()) {
@@ -93,7 +93,7 @@ void RunMatMulTest(int32_t opset_version = 7)
 
     int64_t size1 = TensorShape::ReinterpretBaseType(t.input1_dims).SizeHelper(0, t.input1_dims.size());
     std::vector<T> input1_vals(common_input_vals.cbegin(), common_input_vals.cbegin() + size1);
-    test.AddInput<T>("B", t.input1_dims, input1_vals);
+    test.AddInput<T>("B", t.input1_dims, input1_vals, is_b_constant);
 
     test.AddOutput<T>("Y", t.expected_dims, t.expected_vals);
 
@@ -105,6 +105,11 @@ TEST(MathOpTest, MatMulFloatType) {
   RunMatMulTest<float>(7);
 }
 
+// B is an initializer, which a 2-D B is pre-packed from
+TEST(MathOpTest, MatMulFloatTypeInitializer) {
+  RunMatMulTest<float>(7, true);
+}
+
 TEST(MathOpTest, MatMulDoubleType) {
   RunMatMulTest<double>(7);
 }
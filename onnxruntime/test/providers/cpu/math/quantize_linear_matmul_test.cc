@@ -58,5 +58,48 @@ TEST(QuantizeLinearMatmulOpTest, QLinearMatMul) {
   test.AddOutput<uint8_t>("T3", {2, 3}, {168, 115, 255, 1, 66, 151});
   test.Run();
 }
+
+TEST(QuantizeLinearMatmulOpTest, QLinearMatMulInt8PerColumn) {
+  OpTester test("QLinearMatMul", 10);
+  test.AddInput<uint8_t>("T1", {2, 4}, {208, 236, 0, 238, 3, 214, 255, 29});
+  test.AddInput<float>("a_scale", {}, {0.0066f});
+  test.AddInput<uint8_t>("a_zero_point", {}, {113});
+  test.AddInput<int8_t>("T2", {4, 3}, {-104, 51, -12, 60, -26, -1, 0, 127, -128, -27, -100, 93});
+  test.AddInput<float>("b_scale", {3}, {0.00705f, 0.0051f, 0.0126f});
+  test.AddInput<int8_t>("b_zero_point", {3}, {-1, 0, 2});
+  test.AddInput<float>("y_scale", {}, {0.0107f});
+  test.AddInput<uint8_t>("y_zero_point", {}, {118});
+  test.AddOutput<uint8_t>("T3", {2, 3}, {93, 39, 255, 204, 175, 0});
+  test.Run();
+}
+
+// a constant B is packed by the kernel when the session is initialized
+TEST(QuantizeLinearMatmulOpTest, QLinearMatMulConstantB) {
+  OpTester test("QLinearMatMul", 10);
+  test.AddInput<uint8_t>("T1", {2, 4}, {208, 236, 0, 238, 3, 214, 255, 29});
+  test.AddInput<float>("a_scale", {}, {0.0066f});
+  test.AddInput<uint8_t>("a_zero_point", {}, {113});
+  test.AddInput<uint8_t>("T2", {4, 3}, {152, 51, 244, 60, 26, 255, 0, 127, 246, 127, 254, 247}, true);
+  test.AddInput<float>("b_scale", {}, {0.00705f});
+  test.AddInput<uint8_t>("b_zero_point", {}, {114});
+  test.AddInput<float>("y_scale", {}, {0.0107f});
+  test.AddInput<uint8_t>("y_zero_point", {}, {118});
+  test.AddOutput<uint8_t>("T3", {2, 3}, {168, 115, 255, 1, 66, 151});
+  test.Run();
+}
+
+TEST(QuantizeLinearMatmulOpTest, QLinearMatMulInt8PerColumnConstantB) {
+  OpTester test("QLinearMatMul", 10);
+  test.AddInput<uint8_t>("T1", {2, 4}, {208, 236, 0, 238, 3, 214, 255, 29});
+  test.AddInput<float>("a_scale", {}, {0.0066f});
+  test.AddInput<uint8_t>("a_zero_point", {}, {113});
+  test.AddInput<int8_t>("T2", {4, 3}, {-104, 51, -12, 60, -26, -1, 0, 127, -128, -27, -100, 93}, true);
+  test.AddInput<float>("b_scale", {3}, {0.00705f, 0.0051f, 0.0126f});
+  test.AddInput<int8_t>("b_zero_point", {3}, {-1, 0, 2});
+  test.AddInput<float>("y_scale", {}, {0.0107f});
+  test.AddInput<uint8_t>("y_zero_point", {}, {118});
+  test.AddOutput<uint8_t>("T3", {2, 3}, {93, 39, 255, 204, 175, 0});
+  test.Run();
+}
 }  // namespace test
 }  // namespace onnxruntime
@@ -63,6 +63,33 @@ TEST(LabelEncoder, StringToIntOpset2) {
   test.Run();
 }
 
+TEST(LabelEncoder, StringToIntOpset2LargeVocabulary) {
+  // enough keys for the lookup table to grow, with a repeated key mapping to its last value
+  std::vector<std::string> keys;
+  std::vector<std::int64_t> values;
+  for (std::int64_t i = 0; i < 1000; ++i) {
+    keys.push_back("key" + std::to_string(i));
+    values.push_back(i);
+  }
+  keys.push_back("key3");
+  values.push_back(-3);
+
+  std::vector<std::int64_t> dims{6};
+  std::vector<std::string> input{"key0", "key999", "key3", "key1000", "", "key42"};
+  std::vector<std::int64_t> output{0, 999, -3, 5566, 5566, 42};
+
+  OpTester test("LabelEncoder", 2, onnxruntime::kMLDomain);
+
+  test.AddAttribute("keys_strings", keys);
+  test.AddAttribute("values_int64s", values);
+  test.AddAttribute("default_int64", (std::int64_t)5566);
+
+  test.AddInput<std::string>("X", dims, input);
+  test.AddOutput<std::int64_t>("Y", dims, output);
+
+  test.Run();
+}
+
 TEST(LabelEncoder, IntToStringOpset2) {
   std::vector<std::int64_t> dims{1, 5};
 
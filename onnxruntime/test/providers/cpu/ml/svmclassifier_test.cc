@@ -89,6 +89,117 @@ TEST(MLOpTest, SVMClassifierMulticlassLinearSVC) {
   test.Run();
 }
 
+// The kernel evaluates the rows in blocks of 64, split across threads. Repeating the 8 rows of a test 1280 times
+// gives 160 blocks, enough work for even the cheapest of these models to run on several threads.
+static constexpr int64_t kMultipleBlocksRepeats = 1280;
+
+template <typename T>
+static std::vector<T> RepeatRows(const std::vector<T>& values, int64_t repeats) {
+  std::vector<T> result;
+  result.reserve(values.size() * static_cast<size_t>(repeats));
+  for (int64_t i = 0; i < repeats; ++i) {
+    result.insert(result.end(), values.begin(), values.end());
+  }
+  return result;
+}
+
+// The model of SVMClassifierMulticlassSVC with the given kernel. It has 3 features and 6 scores per row.
+static void AddMulticlassSVCAttributes(OpTester& test, const std::string& kernel_type) {
+  std::vector<float> dual_coefficients = {1.14360327f, 1.95968249f, -1.175683f, -1.92760275f, -1.32575698f,
+                                          -1.32575698f, 0.66332785f, 0.66242913f, 0.53120854f, 0.53510444f,
+                                          -1.06631298f, -1.06631298f, 0.66332785f, 0.66242913f, 0.53120854f,
+                                          0.53510444f, 1.f, -1.f};
+  std::vector<float> support_vectors = {0.f, 0.5f, 32.f, 2.f, 2.9f, -32.f, 1.f, 1.5f, 1.f, 3.f,
+                                        13.3f, -11.f, 12.f, 12.9f, -312.f, 43.f, 413.3f, -114.f};
+  std::vector<int64_t> classes = {0, 1, 2, 3};
+  std::vector<int64_t> vectors_per_class = {2, 2, 1, 1};
+  std::vector<float> rho = {0.5279583f, 0.32605162f, 0.32605162f, 0.06663721f, 0.06663721f, 0.f};
+  std::vector<float> kernel_params = {0.001f, 0.f, 3.f};  //gamma, coef0, degree
+
+  test.AddAttribute("kernel_type", kernel_type);
+  test.AddAttribute("coefficients", dual_coefficients);
+  test.AddAttribute("support_vectors", support_vectors);
+  test.AddAttribute("vectors_per_class", vectors_per_class);
+  test.AddAttribute("rho", rho);
+  test.AddAttribute("kernel_params", kernel_params);
+  test.AddAttribute("classlabels_ints", classes);
+}
+
+// Runs the rows of SVMClassifierMulticlassSVC through enough blocks to be split across threads.
+static void RunMulticlassSVCMultipleBlocks(const std::string& kernel_type, const std::vector<int64_t>& predictions,
+                                           const std::vector<float>& scores) {
+  OpTester test("SVMClassifier", 1, onnxruntime::kMLDomain);
+  AddMulticlassSVCAttributes(test, kernel_type);
+
+  std::vector<float> X = {1.f, 0.0f, 0.4f, 3.0f, 44.0f, -3.f, 12.0f, 12.9f, -312.f, 23.0f,
+                          11.3f, -222.f, 23.0f, 11.3f, -222.f, 23.0f, 3311.3f, -222.f, 23.0f,
+                          11.3f, -222.f, 43.0f, 413.3f, -114.f};
+
+  test.AddInput<float>("X", {8 * kMultipleBlocksRepeats, 3}, RepeatRows(X, kMultipleBlocksRepeats));
+  test.AddOutput<int64_t>("Y", {8 * kMultipleBlocksRepeats}, RepeatRows(predictions, kMultipleBlocksRepeats));
+  test.AddOutput<float>("Z", {8 * kMultipleBlocksRepeats, 6}, RepeatRows(scores, kMultipleBlocksRepeats));
+  test.SetOutputRelErr("Z", 0.0001f);
+
+  test.Run();
+}
+
+TEST(MLOpTest, SVMClassifierMulticlassSVCMultipleBlocks) {
+  std::vector<int64_t> predictions = {1, 1, 2, 0, 0, 0, 0, 3};
+  std::vector<float> scores = {
+      -0.956958294f, 0.799815655f, 0.799815655f, 0.988598406f, 0.988598406f, 0,
+      -0.159782529f, 0.407864451f, 0.407864451f, 0.347750872f, 0.347750872f, 0,
+      0.527958274f, -0.999705434f, 0.326051623f, -0.999675810f, 0.0666372105f, 1.00000000f,
+      0.527958274f, 0.325695992f, 0.326051623f, 0.0663511604f, 0.0666372105f, 0.000268258271f,
+      0.527958274f, 0.325695992f, 0.326051623f, 0.0663511604f, 0.0666372105f, 0.000268258271f,
+      0.527958274f, 0.326051623f, 0.326051623f, 0.0666372105f, 0.0666372105f, 0,
+      0.527958274f, 0.325695992f, 0.326051623f, 0.0663511604f, 0.0666372105f, 0.000268258271f,
+      0.527958274f, 0.326051623f, -0.999705434f, 0.0666372105f, -0.999675810f, -1.00000000f};
+
+  RunMulticlassSVCMultipleBlocks("RBF", predictions, scores);
+}
+
+TEST(MLOpTest, SVMClassifierMulticlassSVCPolyKernelMultipleBlocks) {
+  std::vector<int64_t> predictions = {0, 3, 2, 2, 2, 3, 2, 3};
+  std::vector<float> scores = {
+      0.527958214f, 0.327954978f, 0.326052189f, 0.0681676343f, 0.0666372329f, -0.00143523188f,
+      0.0752827823f, -4.50444269f, -8608.28613f, -3.69260812f, -6923.75732f, -6489.7124f,
+      758.203735f, -1234624.88f, -94166.2344f, -992999.562f, -75722.9375f, 860232.f,
+      281.388702f, -448629.688f, -39362.1836f, -360831.844f, -31655.9355f, 308704.781f,
+      281.388702f, -448629.688f, -39362.1836f, -360831.844f, -31655.9355f, 308704.781f,
+      -185550.094f, -1872375.5f, -3.59793203e+09f, -1454342.38f, -2.89378304e+09f, -2.71245747e+09f,
+      281.388702f, -448629.688f, -39362.1836f, -360831.844f, -31655.9355f, 308704.781f,
+      -438.806274f, -94126.3906f, -8484564.f, -75574.3828f, -6824045.5f, -6328790.f};
+
+  RunMulticlassSVCMultipleBlocks("POLY", predictions, scores);
+}
+
+TEST(MLOpTest, SVMClassifierMulticlassSVCLinearKernelMultipleBlocks) {
+  std::vector<int64_t> predictions = {1, 3, 2, 2, 2, 3, 2, 3};
+  std::vector<float> scores = {
+      -4.94580221f, 151.207809f, 5.10938263f, 120.341293f, 2.83359742f, -110.200005f,
+      -920.743164f, -1937.802f, -24630.2539f, -1270.95166f, -19522.6055f, -17116.5996f,
+      1590.29272f, -129429.711f, -54870.6719f, -102331.633f, -42363.4297f, 56238.8398f,
+      1042.90283f, -92336.5312f, -41005.2344f, -72979.4141f, -31693.3965f, 38718.4805f,
+      1042.90283f, -92336.5312f, -41005.2344f, -72979.4141f, -31693.3965f, 38718.4805f,
+      -68738.1094f, -141340.062f, -1841758.f, -92257.1406f, -1459911.88f, -1282601.5f,
+      1042.90283f, -92336.5312f, -41005.2344f, -72979.4141f, -31693.3965f, 38718.4805f,
+      -8175.82666f, -53921.9219f, -245157.484f, -40188.8281f, -194000.547f, -144246.312f};
+
+  RunMulticlassSVCMultipleBlocks("LINEAR", predictions, scores);
+}
+
+TEST(MLOpTest, SVMClassifierTooFewFeatures) {
+  OpTester test("SVMClassifier", 1, onnxruntime::kMLDomain);
+  AddMulticlassSVCAttributes(test, "RBF");
+
+  // the support vectors have 3 features
+  test.AddInput<float>("X", {2, 2}, {1.f, 0.f, 3.f, 44.f});
+  test.AddOutput<int64_t>("Y", {2}, {0, 0});
+  test.AddOutput<float>("Z", {2, 6}, std::vector<float>(12));
+
+  test.Run(OpTester::ExpectResult::kExpectFailure, "The model has 3 features but the input only has 2.");
+}
+
 TEST(MLOpTest, SVMClassifierSVCProbabilities) {
   OpTester test("SVMClassifier", 1, onnxruntime::kMLDomain);
 
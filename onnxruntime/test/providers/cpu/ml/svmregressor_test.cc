@@ -7,7 +7,22 @@
 namespace onnxruntime {
 namespace test {
 
-TEST(MLOpTest, SVMRegressorSVC) {
+// Repeats for the 8 rows of a test to fill 160 row blocks of 64, which the kernel splits across threads even for the
+// cheap liblinear model.
+static constexpr int64_t kMultipleBlocksRepeats = 1280;
+
+template <typename T>
+static std::vector<T> RepeatRows(const std::vector<T>& values, int64_t repeats) {
+  std::vector<T> result;
+  result.reserve(values.size() * static_cast<size_t>(repeats));
+  for (int64_t i = 0; i < repeats; ++i) {
+    result.insert(result.end(), values.begin(), values.end());
+  }
+  return result;
+}
+
+// The support vectors and coefficients of an SVC model, evaluated with kernel_type.
+static void RunSVC(const std::string& kernel_type, const std::vector<float>& predictions, int64_t repeats) {
   OpTester test("SVMRegressor", 1, onnxruntime::kMLDomain);
 
   std::vector<float> dual_coefficients = {-1.54236563f, 0.53485162f, -1.5170623f, 0.69771864f, 1.82685767f};
@@ -17,21 +32,41 @@ TEST(MLOpTest, SVMRegressorSVC) {
 
   //three estimates, for 3 points each, so 9 predictions
   std::vector<float> X = {1.f, 0.0f, 0.4f, 3.0f, 44.0f, -3.f, 12.0f, 12.9f, -312.f, 23.0f, 11.3f, -222.f, 23.0f, 11.3f, -222.f, 23.0f, 3311.3f, -222.f, 23.0f, 11.3f, -222.f, 43.0f, 413.3f, -114.f};
-  std::vector<float> predictions = {1.40283655f, 1.86065906f, 2.66064161f, 1.96311014f, 1.96311014f, 1.96292297f, 1.96311014f, 3.78978065f};
 
-  test.AddAttribute("kernel_type", std::string("RBF"));
+  test.AddAttribute("kernel_type", kernel_type);
   test.AddAttribute("coefficients", dual_coefficients);
   test.AddAttribute("support_vectors", support_vectors);
   test.AddAttribute("rho", rho);
   test.AddAttribute("kernel_params", kernel_params);
   test.AddAttribute("n_supports", static_cast<int64_t>(5));
 
-  test.AddInput<float>("X", {8, 3}, X);
-  test.AddOutput<float>("Y", {8, 1}, predictions);
+  test.AddInput<float>("X", {8 * repeats, 3}, RepeatRows(X, repeats));
+  test.AddOutput<float>("Y", {8 * repeats, 1}, RepeatRows(predictions, repeats));
+  if (kernel_type == "LINEAR") {
+    // the dot products of these vectors are large
+    test.SetOutputRelErr("Y", 0.0001f);
+  }
 
   test.Run();
 }
 
+static const std::vector<float> svc_rbf_predictions = {1.40283655f, 1.86065906f, 2.66064161f, 1.96311014f,
+                                                       1.96311014f, 1.96292297f, 1.96311014f, 3.78978065f};
+
+TEST(MLOpTest, SVMRegressorSVC) {
+  RunSVC("RBF", svc_rbf_predictions, 1);
+}
+
+TEST(MLOpTest, SVMRegressorSVCMultipleBlocks) {
+  RunSVC("RBF", svc_rbf_predictions, kMultipleBlocksRepeats);
+}
+
+TEST(MLOpTest, SVMRegressorSVCLinearKernelMultipleBlocks) {
+  std::vector<float> predictions = {-84.0987854f, 34959.5117f, 143797.031f, 105150.023f,
+                                    105150.023f, 2612069.25f, 105150.023f, 366194.594f};
+  RunSVC("LINEAR", predictions, kMultipleBlocksRepeats);
+}
+
 TEST(MLOpTest, SVMRegressorNuSVC) {
   OpTester test("SVMRegressor", 1, onnxruntime::kMLDomain);
 
@@ -57,7 +92,7 @@ TEST(MLOpTest, SVMRegressorNuSVC) {
   test.Run();
 }
 
-TEST(MLOpTest, SVMRegressorNuSVCPolyKernel) {
+static void RunNuSVCPolyKernel(int64_t repeats) {
   OpTester test("SVMRegressor", 1, onnxruntime::kMLDomain);
 
   std::vector<float> dual_coefficients = {-2.74322388e+01f, 5.81893108e+01f, -1.00000000e+02f, 6.91693781e+01f, 7.62161261e-02f, -2.66618042e-03f};
@@ -76,13 +111,21 @@ TEST(MLOpTest, SVMRegressorNuSVCPolyKernel) {
   test.AddAttribute("kernel_params", kernel_params);
   test.AddAttribute("n_supports", static_cast<int64_t>(6));
 
-  test.AddInput<float>("X", {8, 3}, X);
-  test.AddOutput<float>("Y", {8, 1}, predictions);
+  test.AddInput<float>("X", {8 * repeats, 3}, RepeatRows(X, repeats));
+  test.AddOutput<float>("Y", {8 * repeats, 1}, RepeatRows(predictions, repeats));
   test.SetOutputRelErr("Y", 0.01f);
   test.Run();
 }
 
-TEST(MLOpTest, SVMRegressorLinear) {
+TEST(MLOpTest, SVMRegressorNuSVCPolyKernel) {
+  RunNuSVCPolyKernel(1);
+}
+
+TEST(MLOpTest, SVMRegressorNuSVCPolyKernelMultipleBlocks) {
+  RunNuSVCPolyKernel(kMultipleBlocksRepeats);
+}
+
+static void RunLinear(int64_t repeats) {
   OpTester test("SVMRegressor", 1, onnxruntime::kMLDomain);
   std::vector<float> coefficients = {0.28290501f, -0.0266512f, 0.01674867f};
   std::vector<float> rho = {1.24032312f};
@@ -98,11 +141,39 @@ TEST(MLOpTest, SVMRegressorLinear) {
   test.AddAttribute("kernel_params", kernel_params);
   test.AddAttribute("n_supports", static_cast<int64_t>(0));
 
-  test.AddInput<float>("X", {8, 3}, X);
-  test.AddOutput<float>("Y", {8, 1}, predictions);
+  test.AddInput<float>("X", {8 * repeats, 3}, RepeatRows(X, repeats));
+  test.AddOutput<float>("Y", {8 * repeats, 1}, RepeatRows(predictions, repeats));
 
   test.Run();
 }
 
+TEST(MLOpTest, SVMRegressorLinear) {
+  RunLinear(1);
+}
+
+// liblinear
+TEST(MLOpTest, SVMRegressorLinearMultipleBlocks) {
+  RunLinear(kMultipleBlocksRepeats);
+}
+
+TEST(MLOpTest, SVMRegressorTooFewFeatures) {
+  OpTester test("SVMRegressor", 1, onnxruntime::kMLDomain);
+  std::vector<float> coefficients = {0.28290501f, -0.0266512f, 0.01674867f};
+  std::vector<float> rho = {1.24032312f};
+  std::vector<float> kernel_params = {0.001f, 0.f, 3.f};  //gamma, coef0, degree
+
+  test.AddAttribute("kernel_type", std::string("LINEAR"));
+  test.AddAttribute("coefficients", coefficients);
+  test.AddAttribute("rho", rho);
+  test.AddAttribute("kernel_params", kernel_params);
+  test.AddAttribute("n_supports", static_cast<int64_t>(0));
+
+  // the coefficients are for 3 features
+  test.AddInput<float>("X", {2, 2}, {1.f, 0.f, 3.f, 44.f});
+  test.AddOutput<float>("Y", {2, 1}, {0.f, 0.f});
+
+  test.Run(OpTester::ExpectResult::kExpectFailure, "The model has 3 features but the input only has 2.");
+}
+
 }  // namespace test
 }  // namespace onnxruntime
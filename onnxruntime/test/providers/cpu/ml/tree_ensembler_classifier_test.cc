@@ -151,5 +151,84 @@ TEST(MLOpTest, TreeEnsembleClassifierBinary) {
   test.Run();
 }
 
+TEST(MLOpTest, TreeEnsembleClassifierMissingValues) {
+  OpTester test("TreeEnsembleClassifier", 1, onnxruntime::kMLDomain);
+
+  // nodes are not listed in tree or node order, and the trees use different modes
+  std::vector<int64_t> treeids = {1, 1, 1, 0, 0, 0};
+  std::vector<int64_t> nodeids = {2, 1, 0, 2, 0, 1};
+  std::vector<int64_t> lefts = {0, 0, 1, 0, 1, 0};
+  std::vector<int64_t> rights = {0, 0, 2, 0, 2, 0};
+  std::vector<int64_t> featureids = {0, 0, 1, 0, 0, 0};
+  std::vector<float> thresholds = {0.f, 0.f, 2.f, 0.f, 0.5f, 0.f};
+  std::vector<std::string> modes = {"LEAF", "LEAF", "BRANCH_GT", "LEAF", "BRANCH_LT", "LEAF"};
+  std::vector<int64_t> missing_tracks_true = {0, 0, 0, 0, 1, 0};
+  std::vector<int64_t> class_treeids = {0, 0, 1, 1};
+  std::vector<int64_t> class_nodeids = {1, 2, 1, 2};
+  std::vector<int64_t> class_classids = {0, 1, 1, 2};
+  std::vector<float> class_weights = {1.f, 1.f, 2.f, 0.5f};
+  std::vector<int64_t> classes = {10, 20, 30};
+  const float nan = std::numeric_limits<float>::quiet_NaN();
+  std::vector<float> X = {0.f, 3.f, nan, 0.f, 1.f, nan, 2.f, 5.f};
+  std::vector<int64_t> results = {20, 10, 20, 20};
+  std::vector<float> scores{1.f, 2.f, 0.f, 1.f, 0.f, 0.5f, 0.f, 1.f, 0.5f, 0.f, 3.f, 0.f};
+
+  const int N = 4;
+  test.AddAttribute("nodes_truenodeids", lefts);
+  test.AddAttribute("nodes_falsenodeids", rights);
+  test.AddAttribute("nodes_treeids", treeids);
+  test.AddAttribute("nodes_nodeids", nodeids);
+  test.AddAttribute("nodes_featureids", featureids);
+  test.AddAttribute("nodes_values", thresholds);
+  test.AddAttribute("nodes_modes", modes);
+  test.AddAttribute("nodes_missing_value_tracks_true", missing_tracks_true);
+  test.AddAttribute("class_treeids", class_treeids);
+  test.AddAttribute("class_nodeids", class_nodeids);
+  test.AddAttribute("class_ids", class_classids);
+  test.AddAttribute("class_weights", class_weights);
+  test.AddAttribute("classlabels_int64s", classes);
+
+  test.AddInput<float>("X", {N, 2}, X);
+  test.AddOutput<int64_t>("Y", {N}, results);
+  test.AddOutput<float>("Z", {N, static_cast<int64_t>(classes.size())}, scores);
+  test.Run();
+}
+
+TEST(MLOpTest, TreeEnsembleClassifierInvalidFeature) {
+  OpTester test("TreeEnsembleClassifier", 1, onnxruntime::kMLDomain);
+
+  std::vector<int64_t> treeids = {0, 0, 0};
+  std::vector<int64_t> nodeids = {0, 1, 2};
+  std::vector<int64_t> lefts = {1, 0, 0};
+  std::vector<int64_t> rights = {2, 0, 0};
+  std::vector<int64_t> featureids = {1, 0, 0};
+  std::vector<float> thresholds = {0.5f, 0.f, 0.f};
+  std::vector<std::string> modes = {"BRANCH_LEQ", "LEAF", "LEAF"};
+  std::vector<int64_t> class_treeids = {0, 0};
+  std::vector<int64_t> class_nodeids = {1, 2};
+  std::vector<int64_t> class_classids = {0, 1};
+  std::vector<float> class_weights = {1.f, 1.f};
+  std::vector<int64_t> classes = {0, 1};
+
+  test.AddAttribute("nodes_truenodeids", lefts);
+  test.AddAttribute("nodes_falsenodeids", rights);
+  test.AddAttribute("nodes_treeids", treeids);
+  test.AddAttribute("nodes_nodeids", nodeids);
+  test.AddAttribute("nodes_featureids", featureids);
+  test.AddAttribute("nodes_values", thresholds);
+  test.AddAttribute("nodes_modes", modes);
+  test.AddAttribute("class_treeids", class_treeids);
+  test.AddAttribute("class_nodeids", class_nodeids);
+  test.AddAttribute("class_ids", class_classids);
+  test.AddAttribute("class_weights", class_weights);
+  test.AddAttribute("classlabels_int64s", classes);
+
+  // the tree tests feature 1 but there is only one feature
+  test.AddInput<float>("X", {2, 1}, {0.f, 1.f});
+  test.AddOutput<int64_t>("Y", {2}, {0, 0});
+  test.AddOutput<float>("Z", {2, 2}, {0.f, 0.f, 0.f, 0.f});
+  test.Run(OpTester::ExpectResult::kExpectFailure, "The trees use feature 1 but the input only has 1 features.");
+}
+
 }  // namespace test
 }  // namespace onnxruntime
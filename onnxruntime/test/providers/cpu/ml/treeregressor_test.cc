@@ -52,8 +52,9 @@ void GenTreeAndRunTest(const std::vector<T>& X, const std::vector<float>& base_v
   } // default function is SUM
 
   //fill input data
-  test.AddInput<T>("X", {8, 3}, X);
-  test.AddOutput<float>("Y", {8, 2}, results);
+  const int64_t N = static_cast<int64_t>(X.size() / 3);
+  test.AddInput<T>("X", {N, 3}, X);
+  test.AddOutput<float>("Y", {N, 2}, results);
   test.Run();
 }
 
@@ -85,6 +86,19 @@ TEST(MLOpTest, TreeRegressorMultiTargetMaxDouble) {
   GenTreeAndRunTest<double>(X, base_values, results, "MAX");
 }
 
+TEST(MLOpTest, TreeRegressorMultiTargetMaxManyRows) {
+  // enough rows for the evaluation to be split into blocks of rows
+  std::vector<float> X_block = {1.f, 0.0f, 0.4f, 3.0f, 44.0f, -3.f, 12.0f, 12.9f, -312.f, 23.0f, 11.3f, -222.f, 23.0f, 11.3f, -222.f, 23.0f, 3311.3f, -222.f, 23.0f, 11.3f, -222.f, 43.0f, 413.3f, -114.f};
+  std::vector<float> results_block = {2.f, 41.f, 3.f, 14.f, 2.f, 23.f, 2.f, 23.f, 2.f, 23.f, 3.f, 23.f, 2.f, 23.f, 3.f, 14.f};
+  std::vector<float> X;
+  std::vector<float> results;
+  for (int i = 0; i < 50; ++i) {
+    X.insert(X.end(), X_block.begin(), X_block.end());
+    results.insert(results.end(), results_block.begin(), results_block.end());
+  }
+  std::vector<float> base_values{0.f, 0.f};
+  GenTreeAndRunTest<float>(X, base_values, results, "MAX");
+}
 
 TEST(MLOpTest, TreeRegressorSingleTargetSum) {
   OpTester test("TreeEnsembleRegressor", 1, onnxruntime::kMLDomain);
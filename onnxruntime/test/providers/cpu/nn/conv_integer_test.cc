@@ -47,5 +47,59 @@ TEST(ConvIntegerTest_with_padding, ConvIntegerTest) {
   test.Run();
 }
 
+TEST(ConvIntegerTest, Int8FilterPerChannelZeroPoint) {
+  OpTester test("ConvInteger", 10);
+  std::vector<int64_t> x_dims{1, 1, 3, 3};
+  test.AddInput<uint8_t>("x", x_dims,
+                         {2, 3, 4,
+                          5, 6, 7,
+                          8, 9, 10});
+  std::vector<int64_t> w_dims{2, 1, 2, 2};
+  test.AddInput<int8_t>("w", w_dims,
+                        {3, -2,
+                         1, 4,
+
+                         -8, 6,
+                         -3, 2});
+  test.AddInput<uint8_t>("x_zero_point", {}, {1});
+  test.AddInput<int8_t>("w_zero_point", {2}, {0, 1});
+  std::vector<int64_t> y_dims{1, 2, 2, 2};
+  test.AddOutput<int32_t>("y", y_dims,
+                          {23, 29,
+                           41, 47,
+
+                           -10, -17,
+                           -31, -38});
+  test.Run();
+}
+
+// a constant signed filter is converted to unsigned values once, when the session is initialized
+TEST(ConvIntegerTest, Int8ConstantFilter) {
+  OpTester test("ConvInteger", 10);
+  std::vector<int64_t> x_dims{1, 1, 3, 3};
+  test.AddInput<uint8_t>("x", x_dims,
+                         {2, 3, 4,
+                          5, 6, 7,
+                          8, 9, 10});
+  std::vector<int64_t> w_dims{2, 1, 2, 2};
+  test.AddInput<int8_t>("w", w_dims,
+                        {3, -2,
+                         1, 4,
+
+                         -8, 6,
+                         -3, 2},
+                        /*is_initializer*/ true);
+  test.AddInput<uint8_t>("x_zero_point", {}, {1});
+  test.AddInput<int8_t>("w_zero_point", {2}, {0, 1});
+  std::vector<int64_t> y_dims{1, 2, 2, 2};
+  test.AddOutput<int32_t>("y", y_dims,
+                          {23, 29,
+                           41, 47,
+
+                           -10, -17,
+                           -31, -38});
+  test.Run();
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -176,6 +176,96 @@ TEST(ConvTest, QLinearConv3DTest) {
   test.Run();
 }
 
+TEST(ConvTest, QLinearConv2DInt8FilterPerChannelTest) {
+  OpTester test("QLinearConv", 10);
+
+  test.AddInput<uint8_t>("x", {1, 1, 3, 3}, {2, 3, 4, 5, 6, 7, 8, 9, 10});
+  test.AddInput<float>("x_scale", {}, {0.05f});
+  test.AddInput<uint8_t>("x_zero_point", {}, {5});
+
+  test.AddInput<int8_t>("w", {2, 1, 2, 2}, {3, -2, 1, 4, -8, 6, -3, 2});
+  test.AddInput<float>("w_scale", {2}, {0.02f, 0.03f});
+  test.AddInput<int8_t>("w_zero_point", {2}, {0, 1});
+
+  test.AddInput<float>("y_scale", {}, {0.007f});
+  test.AddInput<uint8_t>("y_zero_point", {}, {100});
+
+  test.AddInput<int32_t>("b", {2}, {20, -30});
+
+  test.AddOutput<uint8_t>("y", {1, 2, 2, 2}, {103, 104, 105, 106, 97, 96, 93, 91});
+
+  test.Run();
+}
+
+TEST(ConvTest, QLinearConv2DInt8FilterPerChannelBatchTest) {
+  OpTester test("QLinearConv", 10);
+
+  test.AddInput<uint8_t>("x", {2, 1, 3, 3}, {2, 3, 4, 5, 6, 7, 8, 9, 10,
+                                             10, 9, 8, 7, 6, 5, 4, 3, 2});
+  test.AddInput<float>("x_scale", {}, {0.05f});
+  test.AddInput<uint8_t>("x_zero_point", {}, {5});
+
+  test.AddInput<int8_t>("w", {2, 1, 2, 2}, {3, -2, 1, 4, -8, 6, -3, 2});
+  test.AddInput<float>("w_scale", {2}, {0.02f, 0.03f});
+  test.AddInput<int8_t>("w_zero_point", {2}, {0, 1});
+
+  test.AddInput<float>("y_scale", {}, {0.007f});
+  test.AddInput<uint8_t>("y_zero_point", {}, {100});
+
+  test.AddInput<int32_t>("b", {2}, {20, -30});
+
+  test.AddOutput<uint8_t>("y", {2, 2, 2, 2}, {103, 104, 105, 106, 97, 96, 93, 91,
+                                              105, 104, 102, 101, 87, 88, 91, 93});
+
+  test.Run();
+}
+
+// a constant signed filter is converted to unsigned values once, when the session is initialized
+TEST(ConvTest, QLinearConv2DInt8ConstantFilterTest) {
+  OpTester test("QLinearConv", 10);
+
+  test.AddInput<uint8_t>("x", {1, 1, 3, 3}, {2, 3, 4, 5, 6, 7, 8, 9, 10});
+  test.AddInput<float>("x_scale", {}, {0.05f});
+  test.AddInput<uint8_t>("x_zero_point", {}, {5});
+
+  test.AddInput<int8_t>("w", {2, 1, 2, 2}, {3, -2, 1, 4, -8, 6, -3, 2}, /*is_initializer*/ true);
+  test.AddInput<float>("w_scale", {2}, {0.02f, 0.03f});
+  test.AddInput<int8_t>("w_zero_point", {2}, {0, 1});
+
+  test.AddInput<float>("y_scale", {}, {0.007f});
+  test.AddInput<uint8_t>("y_zero_point", {}, {100});
+
+  test.AddInput<int32_t>("b", {2}, {20, -30});
+
+  test.AddOutput<uint8_t>("y", {1, 2, 2, 2}, {103, 104, 105, 106, 97, 96, 93, 91});
+
+  test.Run();
+}
+
+TEST(ConvTest, QLinearConv2DDepthwisePaddedTest) {
+  OpTester test("QLinearConv", 10);
+  test.AddAttribute("group", static_cast<int64_t>(2));
+  test.AddAttribute("pads", std::vector<int64_t>{1, 1, 1, 1});
+
+  test.AddInput<uint8_t>("x", {1, 2, 3, 3}, {2, 3, 4, 5, 6, 7, 8, 9, 10, 12, 10, 8, 6, 4, 2, 0, 1, 3});
+  test.AddInput<float>("x_scale", {}, {0.05f});
+  test.AddInput<uint8_t>("x_zero_point", {}, {5});
+
+  test.AddInput<uint8_t>("w", {2, 1, 3, 3}, {1, 2, 1, 0, 3, 0, 1, 2, 1, 4, 0, 4, 1, 1, 1, 2, 0, 2});
+  test.AddInput<float>("w_scale", {}, {0.02f});
+  test.AddInput<uint8_t>("w_zero_point", {}, {1});
+
+  test.AddInput<float>("y_scale", {}, {0.003f});
+  test.AddInput<uint8_t>("y_zero_point", {}, {100});
+
+  test.AddInput<int32_t>("b", {2}, {10, -20});
+
+  test.AddOutput<uint8_t>("y", {1, 2, 3, 3},
+                          {102, 104, 104, 103, 104, 106, 104, 104, 106, 93, 93, 94, 96, 101, 97, 92, 92, 93});
+
+  test.Run();
+}
+
 }  // namespace
 }  // namespace test
 }  // namespace onnxruntime
@@ -200,5 +200,50 @@ TEST(ContribOpTest, StringNormalizerTest) {
   }
 }
 
+TEST(ContribOpTest, StringNormalizerManyStringsTest) {
+  // Enough strings to be filtered and converted in several blocks
+  // - case insensitive approach
+  // - filter out monday in any case
+  // - UPPER
+  OpTester test("StringNormalizer", opset_ver, domain);
+  InitTestAttr(test, "UPPER", false, {"MONDAY"}, test_locale);
+  const std::vector<std::string> days = {std::string("monday"), std::string("Tuesday"),
+                                         std::string("MonDay"), std::string("wednesday")};
+  const std::vector<std::string> upper_days = {std::string("TUESDAY"), std::string("WEDNESDAY")};
+  std::vector<std::string> input;
+  std::vector<std::string> output;
+  for (size_t i = 0; i < 150; ++i) {
+    input.push_back(days[i % days.size()]);
+    if (i % 2 == 1) {
+      output.push_back(upper_days[(i / 2) % upper_days.size()]);
+    }
+  }
+  test.AddInput<std::string>("T", {1, static_cast<int64_t>(input.size())}, input);
+  test.AddOutput<std::string>("Y", {1, static_cast<int64_t>(output.size())}, output);
+  test.Run(OpTester::ExpectResult::kExpectSuccess);
+}
+
+TEST(ContribOpTest, StringNormalizerManyStringsStopwordBlockTest) {
+  // Several blocks, one of which only has stopwords
+  // - case insensitive approach
+  // - filter out monday in any case
+  // - LOWER
+  OpTester test("StringNormalizer", opset_ver, domain);
+  InitTestAttr(test, "LOWER", false, {"monday"}, test_locale);
+  std::vector<std::string> input;
+  std::vector<std::string> output;
+  for (size_t i = 0; i < 200; ++i) {
+    if (i >= 64 && i < 128) {
+      input.push_back(i % 2 == 0 ? "MONDAY" : "Monday");
+    } else {
+      input.push_back("Day" + std::to_string(i));
+      output.push_back("day" + std::to_string(i));
+    }
+  }
+  test.AddInput<std::string>("T", {static_cast<int64_t>(input.size())}, input);
+  test.AddOutput<std::string>("Y", {static_cast<int64_t>(output.size())}, output);
+  test.Run(OpTester::ExpectResult::kExpectSuccess);
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -1,6 +1,9 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <algorithm>
+#include <limits>
+
 #include "core/providers/cpu/reduction/reduction_ops.h"
 #include "gtest/gtest.h"
 #include "test/providers/provider_test_utils.h"
@@ -1369,6 +1372,87 @@ TEST(ReductionOpTest, ArgMin_int32_neg_axis) {
   test.Run();
 }
 
+// reduces on every combination of axes, which covers the leading, trailing and interleaved reduced axes, and
+// compares with a reduction of the values grouped by output
+TEST(ReductionOpTest, ReduceAxesPatterns) {
+  const std::vector<int64_t> dims{3, 4, 1, 5, 6};
+  const size_t rank = dims.size();
+  std::vector<float> data(360);
+  for (size_t i = 0; i < data.size(); ++i) {
+    data[i] = static_cast<float>(static_cast<int>((i * 7) % 11) - 5);
+  }
+
+  for (unsigned mask = 1; mask < (1u << rank); ++mask) {
+    std::vector<int64_t> axes;
+    std::vector<int64_t> expected_dims;
+    for (size_t i = 0; i < rank; ++i) {
+      if (mask & (1u << i)) {
+        axes.push_back(static_cast<int64_t>(i));
+        expected_dims.push_back(1);
+      } else {
+        expected_dims.push_back(dims[i]);
+      }
+    }
+
+    int64_t output_size = 1;
+    for (auto dim : expected_dims) {
+      output_size *= dim;
+    }
+
+    std::vector<float> expected_sum(output_size, 0.0f);
+    std::vector<float> expected_max(output_size, std::numeric_limits<float>::lowest());
+    std::vector<int64_t> index(rank, 0);
+    for (float value : data) {
+      int64_t output = 0;
+      for (size_t i = 0; i < rank; ++i) {
+        output = output * expected_dims[i] + (expected_dims[i] == 1 ? 0 : index[i]);
+      }
+      expected_sum[output] += value;
+      expected_max[output] = std::max(expected_max[output], value);
+
+      for (size_t i = rank; i-- > 0;) {
+        if (++index[i] < dims[i]) {
+          break;
+        }
+        index[i] = 0;
+      }
+    }
+
+    TestReduceOp<float>("ReduceSum", 11, dims, data, axes, 1, expected_dims, expected_sum);
+    TestReduceOp<float>("ReduceMax", 11, dims, data, axes, 1, expected_dims, expected_max);
+  }
+}
+
+// long reductions to few outputs are split between threads
+TEST(ReductionOpTest, ReduceLongAxes) {
+  const int64_t rows = 50000;
+  std::vector<float> data(rows * 3);
+  for (size_t i = 0; i < data.size(); ++i) {
+    data[i] = static_cast<float>(i % 3);
+  }
+  data[rows * 3 / 2] = 7.0f;
+
+  OpTester test("ReduceSum");
+  test.AddAttribute("axes", std::vector<int64_t>{0});
+  test.AddAttribute("keepdims", int64_t(0));
+  test.AddInput<float>("data", {rows, 3}, data);
+  test.AddOutput<float>("reduced", {3}, {7.0f, static_cast<float>(rows), 2.0f * rows});
+  test.Run();
+
+  OpTester test2("ArgMax");
+  test2.AddAttribute("axis", int64_t(0));
+  test2.AddAttribute("keepdims", int64_t(0));
+  test2.AddInput<float>("data", {rows, 3}, data);
+  test2.AddOutput<int64_t>("reduced", {3}, {rows / 2, 0, 0});
+  test2.Run();
+
+  OpTester test3("ReduceMax");
+  test3.AddAttribute("keepdims", int64_t(0));
+  test3.AddInput<float>("data", {3, rows}, data);
+  test3.AddOutput<float>("reduced", {}, {7.0f});
+  test3.Run();
+}
+
 // test that PrepareForReduce handles this case. Called by all reduction ops so any op can be used in the test
 TEST(ReductionOpTest, ReduceDimWithZero) {
   auto run = [](OpTester& tester, const std::string& error_msg = "") {
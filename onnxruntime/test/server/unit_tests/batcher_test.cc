@@ -0,0 +1,134 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <thread>
+
+#include "gtest/gtest.h"
+
+#include "server/batcher.h"
+#include "test_server_environment.h"
+
+namespace onnxruntime {
+namespace server {
+namespace test {
+
+class BatcherTest : public ::testing::Test {
+ protected:
+  BatcherTest() {
+    options_.max_batch_size = 4;
+    // long enough that only a full batch runs the requests
+    options_.batch_timeout = std::chrono::seconds(10);
+  }
+
+  void SetUp() override {
+    ServerEnvironment* env = ServerEnv();
+    env->SetBatchingOptions(options_);
+    env->InitializeModel("testdata/mul_symbolic_batch.onnx", "Batched", "1");
+    env->InitializeModel("testdata/mul_1.onnx", "Fixed", "1");
+  }
+
+  void TearDown() override {
+    ServerEnvironment* env = ServerEnv();
+    env->SetBatchingOptions(BatchingOptions{});
+    env->UnloadModel("Batched", "1");
+    env->UnloadModel("Fixed", "1");
+  }
+
+  BatchingOptions options_;
+};
+
+class ConcurrentBatcherTest : public BatcherTest {
+ protected:
+  ConcurrentBatcherTest() {
+    options_.max_concurrent_batches = 2;
+  }
+};
+
+// Runs requests of 1 row on concurrent threads and checks their outputs.
+static void RunRequests(Batcher* batcher, int num_requests) {
+  Ort::MemoryInfo info = Ort::MemoryInfo::CreateCpu(OrtDeviceAllocator, OrtMemTypeDefault);
+  const std::vector<std::string> input_names{"X"};
+  const std::vector<std::string> output_names{"Y"};
+
+  std::vector<std::vector<float>> results(num_requests);
+  std::vector<std::thread> threads;
+  for (int i = 0; i < num_requests; ++i) {
+    threads.emplace_back([&, i]() {
+      std::vector<int64_t> dims{1, 2};
+      std::vector<float> x{float(i), float(i + 1)};
+      std::vector<Ort::Value> input_values;
+      input_values.push_back(Ort::Value::CreateTensor<float>(info, x.data(), x.size(), dims.data(), dims.size()));
+      ASSERT_TRUE(batcher->CanBatch(input_values));
+
+      Ort::RunOptions run_options;
+      run_options.SetRunTag(("request " + std::to_string(i)).c_str());
+      auto outputs = batcher->Run(run_options, input_names, input_values, output_names);
+      ASSERT_EQ(outputs.size(), 1u);
+      ASSERT_EQ(outputs[0].GetTensorTypeAndShapeInfo().GetShape(), dims);
+      const float* y = outputs[0].GetTensorMutableData<float>();
+      results[i].assign(y, y + 2);
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  for (int i = 0; i < num_requests; ++i) {
+    EXPECT_EQ(results[i], (std::vector<float>{float(i * i), float((i + 1) * (i + 1))}));
+  }
+}
+
+TEST_F(BatcherTest, OnlyModelsWithBatchDimension) {
+  ServerEnvironment* env = ServerEnv();
+  EXPECT_NE(env->GetModel("Batched", "1")->batcher, nullptr);
+  EXPECT_EQ(env->GetModel("Fixed", "1")->batcher, nullptr);
+}
+
+TEST_F(BatcherTest, ConcurrentRequestsShareARun) {
+  auto model = ServerEnv()->GetModel("Batched", "1");
+  Batcher* batcher = model->batcher.get();
+  ASSERT_NE(batcher, nullptr);
+
+  // 4 requests of 1 row fill a batch
+  RunRequests(batcher, 4);
+
+  auto metrics = batcher->GetMetrics();
+  EXPECT_EQ(metrics.batch_count, 1u);
+  EXPECT_EQ(metrics.request_count, 4u);
+  EXPECT_EQ(metrics.row_count, 4u);
+  EXPECT_EQ(metrics.max_batch_size_seen, 4u);
+  EXPECT_EQ(metrics.queue_depth, 0u);
+}
+
+TEST_F(ConcurrentBatcherTest, RequestsFillConcurrentBatches) {
+  auto model = ServerEnv()->GetModel("Batched", "1");
+  Batcher* batcher = model->batcher.get();
+  ASSERT_NE(batcher, nullptr);
+
+  // 8 requests of 1 row fill two batches
+  RunRequests(batcher, 8);
+
+  auto metrics = batcher->GetMetrics();
+  EXPECT_EQ(metrics.batch_count, 2u);
+  EXPECT_EQ(metrics.request_count, 8u);
+  EXPECT_EQ(metrics.row_count, 8u);
+  EXPECT_EQ(metrics.max_batch_size_seen, 4u);
+  EXPECT_EQ(metrics.queue_depth, 0u);
+}
+
+TEST_F(BatcherTest, LargeRequestsAreNotBatched) {
+  auto model = ServerEnv()->GetModel("Batched", "1");
+  Batcher* batcher = model->batcher.get();
+  ASSERT_NE(batcher, nullptr);
+
+  Ort::MemoryInfo info = Ort::MemoryInfo::CreateCpu(OrtDeviceAllocator, OrtMemTypeDefault);
+  std::vector<int64_t> dims{5, 2};
+  std::vector<float> x(10);
+  std::vector<Ort::Value> input_values;
+  input_values.push_back(Ort::Value::CreateTensor<float>(info, x.data(), x.size(), dims.data(), dims.size()));
+  EXPECT_FALSE(batcher->CanBatch(input_values));
+}
+
+}  // namespace test
+}  // namespace server
+}  // namespace onnxruntime
@@ -0,0 +1,177 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <thread>
+
+#include <boost/filesystem.hpp>
+#include <boost/filesystem/fstream.hpp>
+
+#include "gtest/gtest.h"
+
+#include "server/model_repository.h"
+#include "test_server_environment.h"
+
+namespace onnxruntime {
+namespace server {
+namespace test {
+
+namespace fs = boost::filesystem;
+
+static std::shared_ptr<ServerEnvironment> GetEnvironment() {
+  return std::shared_ptr<ServerEnvironment>(ServerEnv(), [](ServerEnvironment*) {});
+}
+
+class ModelRepositoryTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    path_ = fs::temp_directory_path() / fs::unique_path("ort_model_repository_%%%%-%%%%-%%%%");
+    fs::create_directories(path_);
+  }
+
+  void TearDown() override {
+    boost::system::error_code ec;
+    fs::remove_all(path_, ec);
+    fs::remove_all(path_.string() + ".staging", ec);
+  }
+
+  // Stages the version outside the repository and moves it in, so that a poll never sees its model file partly copied
+  void AddVersion(const std::string& name, const std::string& version, const std::string& model_file) {
+    const auto staging = fs::path(path_.string() + ".staging");
+    fs::create_directories(staging);
+    fs::copy_file(model_file, staging / "model.onnx");
+    fs::create_directories(path_ / name);
+    fs::rename(staging, path_ / name / version);
+  }
+
+  fs::path path_;
+};
+
+TEST(ServerEnvironmentTests, LatestVersion) {
+  ServerEnvironment* env = ServerEnv();
+  env->InitializeModel("testdata/mul_1.onnx", "Versions", "2");
+  env->InitializeModel("testdata/mul_1.onnx", "Versions", "10");
+  env->InitializeModel("testdata/mul_1.onnx", "Versions", "9");
+
+  EXPECT_EQ(env->GetModel("Versions", ""), env->GetModel("Versions", "10"));
+  EXPECT_EQ(env->GetModelVersions("Versions"), (std::vector<std::string>{"2", "9", "10"}));
+  EXPECT_THROW(env->GetModel("Versions", "1"), Ort::Exception);
+  EXPECT_THROW(env->GetModel("NoVersions", ""), Ort::Exception);
+
+  env->UnloadModel("Versions", "2");
+  env->UnloadModel("Versions", "10");
+  EXPECT_EQ(env->GetModel("Versions", ""), env->GetModel("Versions", "9"));
+  env->UnloadModel("Versions", "9");
+}
+
+TEST(ServerEnvironmentTests, ReplacedModelOutlivesItsRequests) {
+  ServerEnvironment* env = ServerEnv();
+  env->InitializeModel("testdata/mul_1.onnx", "Replaced", "1");
+
+  // a request running on the model holds on to it
+  auto running = env->GetModel("Replaced", "1");
+  env->ReplaceModel("testdata/mul_1.onnx", "Replaced", "1");
+  EXPECT_NE(env->GetModel("Replaced", "1"), running);
+
+  env->UnloadModel("Replaced", "1");
+  EXPECT_THROW(env->GetModel("Replaced", "1"), Ort::Exception);
+  EXPECT_EQ(running->session.GetOutputCount(), 1u);
+  EXPECT_EQ(running->output_names, std::vector<std::string>{"Y"});
+}
+
+TEST_F(ModelRepositoryTest, LoadsAddedChangedAndRemovedVersions) {
+  ServerEnvironment* env = ServerEnv();
+  ModelRepository repository(GetEnvironment(), path_.string());
+
+  AddVersion("mul", "1", "testdata/mul_1.onnx");
+  // not a version, and a version without a model file
+  AddVersion("mul", "latest", "testdata/mul_1.onnx");
+  fs::create_directories(path_ / "mul" / "3");
+  repository.Poll();
+  EXPECT_EQ(env->GetModelVersions("mul"), std::vector<std::string>{"1"});
+
+  AddVersion("mul", "2", "testdata/mul_1.onnx");
+  repository.Poll();
+  EXPECT_EQ(env->GetModelVersions("mul"), (std::vector<std::string>{"1", "2"}));
+  EXPECT_EQ(env->GetModel("mul", ""), env->GetModel("mul", "2"));
+
+  // an unchanged version isn't reloaded, a changed one is
+  auto version_1 = env->GetModel("mul", "1");
+  auto version_2 = env->GetModel("mul", "2");
+  const auto model_file = path_ / "mul" / "2" / "model.onnx";
+  fs::last_write_time(model_file, fs::last_write_time(model_file) + 10);
+  repository.Poll();
+  EXPECT_EQ(env->GetModel("mul", "1"), version_1);
+  EXPECT_NE(env->GetModel("mul", "2"), version_2);
+
+  fs::remove_all(path_ / "mul" / "2");
+  repository.Poll();
+  EXPECT_EQ(env->GetModelVersions("mul"), std::vector<std::string>{"1"});
+
+  fs::remove_all(path_ / "mul");
+  repository.Poll();
+  EXPECT_TRUE(env->GetModelVersions("mul").empty());
+}
+
+TEST_F(ModelRepositoryTest, KeepsServingWhenAVersionFailsToLoad) {
+  ServerEnvironment* env = ServerEnv();
+  ModelRepository repository(GetEnvironment(), path_.string());
+
+  AddVersion("mul", "1", "testdata/mul_1.onnx");
+  repository.Poll();
+  auto loaded = env->GetModel("mul", "1");
+
+  const auto model_file = path_ / "mul" / "1" / "model.onnx";
+  fs::ofstream(model_file) << "not a model";
+  fs::last_write_time(model_file, fs::last_write_time(model_file) + 10);
+  AddVersion("broken", "1", model_file.string());
+  repository.Poll();
+  EXPECT_EQ(env->GetModel("mul", "1"), loaded);
+  EXPECT_TRUE(env->GetModelVersions("broken").empty());
+
+  fs::remove_all(path_ / "mul");
+  repository.Poll();
+  EXPECT_TRUE(env->GetModelVersions("mul").empty());
+}
+
+TEST_F(ModelRepositoryTest, RetriesAVersionThatFailedToLoad) {
+  ServerEnvironment* env = ServerEnv();
+  ModelRepository repository(GetEnvironment(), path_.string());
+
+  // a model file read while it was partly written, then completed within the same second
+  AddVersion("mul", "1", "testdata/mul_1.onnx");
+  const auto model_file = path_ / "mul" / "1" / "model.onnx";
+  const auto modified = fs::last_write_time(model_file);
+  fs::resize_file(model_file, fs::file_size(model_file) / 2);
+  fs::last_write_time(model_file, modified);
+  repository.Poll();
+  EXPECT_TRUE(env->GetModelVersions("mul").empty());
+
+  fs::copy_file("testdata/mul_1.onnx", model_file, fs::copy_option::overwrite_if_exists);
+  fs::last_write_time(model_file, modified);
+  repository.Poll();
+  EXPECT_EQ(env->GetModelVersions("mul"), std::vector<std::string>{"1"});
+
+  fs::remove_all(path_ / "mul");
+  repository.Poll();
+  EXPECT_TRUE(env->GetModelVersions("mul").empty());
+}
+
+TEST_F(ModelRepositoryTest, PollsInTheBackground) {
+  ServerEnvironment* env = ServerEnv();
+  {
+    ModelRepository repository(GetEnvironment(), path_.string());
+    repository.StartPolling(std::chrono::milliseconds(10));
+
+    AddVersion("mul", "1", "testdata/mul_1.onnx");
+    for (int i = 0; i < 500 && env->GetModelVersions("mul").empty(); ++i) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    EXPECT_EQ(env->GetModelVersions("mul"), std::vector<std::string>{"1"});
+  }
+
+  env->UnloadModel("mul", "1");
+}
+
+}  // namespace test
+}  // namespace server
+}  // namespace onnxruntime
@@ -45,6 +45,70 @@ TEST(ConfigParsingTests, Defaults) {
   EXPECT_EQ(config.logging_level, ORT_LOGGING_LEVEL_INFO);
 }
 
+TEST(ConfigParsingTests, Batching) {
+  char* test_argv[] = {
+      const_cast<char*>("/path/to/binary"),
+      const_cast<char*>("--model_path"), const_cast<char*>("testdata/mul_1.onnx"),
+      const_cast<char*>("--max_batch_size"), const_cast<char*>("32"),
+      const_cast<char*>("--batch_timeout_micros"), const_cast<char*>("500"),
+      const_cast<char*>("--max_concurrent_batches"), const_cast<char*>("3")};
+
+  onnxruntime::server::ServerConfiguration config{};
+  Result res = config.ParseInput(9, test_argv);
+  EXPECT_EQ(res, Result::ContinueSuccess);
+  EXPECT_EQ(config.max_batch_size, 32);
+  EXPECT_EQ(config.batch_timeout_micros, 500);
+  EXPECT_EQ(config.max_concurrent_batches, 3);
+
+  char* bad_argv[] = {
+      const_cast<char*>("/path/to/binary"),
+      const_cast<char*>("--model_path"), const_cast<char*>("testdata/mul_1.onnx"),
+      const_cast<char*>("--max_batch_size"), const_cast<char*>("0")};
+
+  onnxruntime::server::ServerConfiguration bad_config{};
+  res = bad_config.ParseInput(5, bad_argv);
+  EXPECT_EQ(res, Result::ExitFailure);
+}
+
+TEST(ConfigParsingTests, ModelRepository) {
+  char* test_argv[] = {
+      const_cast<char*>("/path/to/binary"),
+      const_cast<char*>("--repository_path"), const_cast<char*>("testdata"),
+      const_cast<char*>("--repository_poll_seconds"), const_cast<char*>("5")};
+
+  onnxruntime::server::ServerConfiguration config{};
+  Result res = config.ParseInput(5, test_argv);
+  EXPECT_EQ(res, Result::ContinueSuccess);
+  EXPECT_EQ(config.repository_path, "testdata");
+  EXPECT_EQ(config.repository_poll_seconds, 5);
+  EXPECT_TRUE(config.model_path.empty());
+
+  // exactly one of a model and a repository
+  char* both_argv[] = {
+      const_cast<char*>("/path/to/binary"),
+      const_cast<char*>("--model_path"), const_cast<char*>("testdata/mul_1.onnx"),
+      const_cast<char*>("--repository_path"), const_cast<char*>("testdata")};
+
+  onnxruntime::server::ServerConfiguration both_config{};
+  res = both_config.ParseInput(5, both_argv);
+  EXPECT_EQ(res, Result::ExitFailure);
+
+  char* neither_argv[] = {
+      const_cast<char*>("/path/to/binary")};
+
+  onnxruntime::server::ServerConfiguration neither_config{};
+  res = neither_config.ParseInput(1, neither_argv);
+  EXPECT_EQ(res, Result::ExitFailure);
+
+  char* file_argv[] = {
+      const_cast<char*>("/path/to/binary"),
+      const_cast<char*>("--repository_path"), const_cast<char*>("testdata/mul_1.onnx")};
+
+  onnxruntime::server::ServerConfiguration file_config{};
+  res = file_config.ParseInput(3, file_argv);
+  EXPECT_EQ(res, Result::ExitFailure);
+}
+
 TEST(ConfigParsingTests, Help) {
   char* test_argv[] = {
       const_cast<char*>("/path/to/binary"),
@@ -10,6 +10,8 @@
 #include <fstream>
 #include <sstream>
 #include <atomic>
+#include <future>
+#include <thread>
 #include <gtest/gtest.h>
 #include "test_allocator.h"
 #include "test_fixture.h"
@@ -424,6 +426,157 @@ TEST_F(CApiTest, override_initializer) {
   ASSERT_EQ(*output_data, f11_input_data[0]);
 }
 
+TEST_F(CApiTest, io_binding) {
+  Ort::Session session(env_, MODEL_URI, Ort::SessionOptions{nullptr});
+  Ort::MemoryInfo info("Cpu", OrtDeviceAllocator, 0, OrtMemTypeDefault);
+
+  std::vector<int64_t> dims = {3, 2};
+  float x[] = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+  Ort::Value input = Ort::Value::CreateTensor<float>(info, x, countof(x), dims.data(), dims.size());
+
+  // the run writes the pre-allocated output in place
+  float y[6] = {};
+  Ort::Value output = Ort::Value::CreateTensor<float>(info, y, countof(y), dims.data(), dims.size());
+
+  Ort::IoBinding binding(session);
+  binding.BindInput("X", input);
+  binding.BindOutput("Y", output);
+
+  const std::vector<float> expected_y = {1.0f, 4.0f, 9.0f, 16.0f, 25.0f, 36.0f};
+  for (int i = 0; i < 2; i++) {
+    session.Run(Ort::RunOptions{nullptr}, binding);
+    ASSERT_EQ(std::vector<float>(y, y + countof(y)), expected_y);
+  }
+
+  // an output bound to a device is allocated by the run
+  binding.ClearBoundOutputs();
+  binding.BindOutput("Y", info);
+  session.Run(Ort::RunOptions{nullptr}, binding);
+
+  std::vector<Ort::Value> outputs = binding.GetOutputValues();
+  ASSERT_EQ(outputs.size(), 1U);
+  ASSERT_EQ(outputs[0].GetTensorTypeAndShapeInfo().GetShape(), dims);
+  const float* allocated_y = outputs[0].GetTensorMutableData<float>();
+  ASSERT_NE(allocated_y, y);
+  ASSERT_EQ(std::vector<float>(allocated_y, allocated_y + expected_y.size()), expected_y);
+}
+
+TEST_F(CApiTest, prepared_run) {
+  Ort::Session session(env_, MODEL_URI, Ort::SessionOptions{nullptr});
+  Ort::MemoryInfo info("Cpu", OrtDeviceAllocator, 0, OrtMemTypeDefault);
+
+  const char* input_names[] = {"X"};
+  const char* output_names[] = {"Y"};
+  Ort::PreparedRun prepared_run(session, input_names, countof(input_names), output_names, countof(output_names));
+
+  std::vector<int64_t> dims = {3, 2};
+  float x[] = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+  Ort::Value input = Ort::Value::CreateTensor<float>(info, x, countof(x), dims.data(), dims.size());
+
+  const std::vector<float> expected_y = {1.0f, 4.0f, 9.0f, 16.0f, 25.0f, 36.0f};
+  for (int i = 0; i < 2; i++) {
+    Ort::Value output{nullptr};
+    session.Run(Ort::RunOptions{nullptr}, prepared_run, &input, 1, &output, 1);
+    const float* y = output.GetTensorMutableData<float>();
+    ASSERT_EQ(std::vector<float>(y, y + expected_y.size()), expected_y);
+  }
+
+  const char* bad_output_names[] = {"Z"};
+  ASSERT_THROW(Ort::PreparedRun(session, input_names, countof(input_names), bad_output_names, countof(bad_output_names)),
+               Ort::Exception);
+}
+
+struct AsyncRunResult {
+  std::promise<OrtErrorCode> done;
+};
+
+static void ORT_API_CALL AsyncRunCallback(void* user_data, OrtValue** /*outputs*/, size_t /*num_outputs*/,
+                                          OrtStatus* status) {
+  auto* result = static_cast<AsyncRunResult*>(user_data);
+  OrtErrorCode code = ORT_OK;
+  if (status != nullptr) {
+    code = Ort::GetApi().GetErrorCode(status);
+    Ort::GetApi().ReleaseStatus(status);
+  }
+  result->done.set_value(code);
+}
+
+TEST_F(CApiTest, run_async) {
+  Ort::SessionOptions session_options;
+  session_options.SetInterOpNumThreads(2);
+  Ort::Session session(env_, MODEL_URI, session_options);
+
+  Ort::MemoryInfo info("Cpu", OrtDeviceAllocator, 0, OrtMemTypeDefault);
+  std::vector<int64_t> dims = {3, 2};
+  float x[] = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+  const char* input_names[] = {"X"};
+  const char* output_names[] = {"Y"};
+
+  // queue more runs than the session has threads. the inputs can be released once RunAsync returns.
+  constexpr size_t num_runs = 8;
+  std::vector<Ort::Value> outputs;
+  std::vector<AsyncRunResult> results(num_runs);
+  for (size_t i = 0; i < num_runs; i++) {
+    outputs.emplace_back(nullptr);
+  }
+  for (size_t i = 0; i < num_runs; i++) {
+    Ort::Value input = Ort::Value::CreateTensor<float>(info, x, countof(x), dims.data(), dims.size());
+    session.RunAsync(Ort::RunOptions{nullptr}, input_names, &input, 1, output_names, &outputs[i], 1,
+                     AsyncRunCallback, &results[i]);
+  }
+
+  const std::vector<float> expected_y = {1.0f, 4.0f, 9.0f, 16.0f, 25.0f, 36.0f};
+  for (size_t i = 0; i < num_runs; i++) {
+    ASSERT_EQ(results[i].done.get_future().get(), ORT_OK);
+    ASSERT_EQ(outputs[i].GetTensorTypeAndShapeInfo().GetShape(), dims);
+    const float* y = outputs[i].GetTensorMutableData<float>();
+    ASSERT_EQ(std::vector<float>(y, y + expected_y.size()), expected_y);
+  }
+
+  // an invalid run reports the error through the callback
+  AsyncRunResult failed;
+  Ort::Value missing_output{nullptr};
+  const char* bad_output_names[] = {"Z"};
+  Ort::Value input = Ort::Value::CreateTensor<float>(info, x, countof(x), dims.data(), dims.size());
+  session.RunAsync(Ort::RunOptions{nullptr}, input_names, &input, 1, bad_output_names, &missing_output, 1,
+                   AsyncRunCallback, &failed);
+  ASSERT_NE(failed.done.get_future().get(), ORT_OK);
+  ASSERT_EQ(missing_output, nullptr);
+}
+
+// Not a CApiTest, as the environment is created with global thread pools.
+TEST(CApiGlobalThreadPoolsTest, SessionsShareTheGlobalThreadPools) {
+  Ort::ThreadingOptions tp_options;
+  ASSERT_THROW(tp_options.SetGlobalIntraOpNumThreads(-1), Ort::Exception);
+  ASSERT_THROW(tp_options.SetGlobalInterOpNumThreads(-1), Ort::Exception);
+  tp_options.SetGlobalIntraOpNumThreads(2).SetGlobalInterOpNumThreads(2);
+  Ort::Env env(tp_options, ORT_LOGGING_LEVEL_WARNING, "GlobalThreadPools");
+
+  Ort::SessionOptions session_options;
+  session_options.DisablePerSessionThreads();
+  Ort::Session session1(env, MODEL_URI, session_options);
+  Ort::Session session2(env, MODEL_URI, session_options);
+
+  std::vector<Input> inputs(1);
+  inputs[0].name = "X";
+  inputs[0].dims = {3, 2};
+  inputs[0].values = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+  const std::vector<int64_t> expected_dims_y = {3, 2};
+  const std::vector<float> expected_values_y = {1.0f, 4.0f, 9.0f, 16.0f, 25.0f, 36.0f};
+
+  // both sessions run at the same time on the shared threads
+  auto run = [&](Ort::Session& session) {
+    MockedOrtAllocator allocator;
+    for (int i = 0; i != 10; ++i) {
+      RunSession<float>(&allocator, session, inputs, "Y", expected_dims_y, expected_values_y, nullptr);
+    }
+  };
+  std::thread thread1(run, std::ref(session1));
+  std::thread thread2(run, std::ref(session2));
+  thread1.join();
+  thread2.join();
+}
+
 int main(int argc, char** argv) {
   ::testing::InitGoogleTest(&argc, argv);
   int ret = RUN_ALL_TESTS();
@@ -12,3 +12,13 @@ TEST_F(CApiTest, session_options_graph_optimization_level) {
   Ort::SessionOptions options;
   options.SetGraphOptimizationLevel(ORT_ENABLE_EXTENDED);
 }
+
+TEST_F(CApiTest, session_options_intra_op_thread_options) {
+  Ort::SessionOptions options;
+  options.SetIntraOpSpinDuration(100);
+  options.SetIntraOpThreadAffinity({0});
+  options.SetIntraOpNumaNode(-1);
+
+  // Negative spin durations are rejected.
+  ASSERT_THROW(options.SetIntraOpSpinDuration(-1), Ort::Exception);
+}
@@ -0,0 +1,23 @@
+import onnx
+from onnx import helper
+from onnx import TensorProto
+
+# Y = X * X with a symbolic batch dimension, for the batching tests of the server
+graph_def = helper.make_graph(
+    nodes = [
+        helper.make_node(op_type = "Mul", inputs = ['X', 'X'], outputs = ['Y'], name = 'mul'),
+    ],
+    name = 'mul_symbolic_batch',
+    inputs = [
+        helper.make_tensor_value_info("X", TensorProto.FLOAT, ['N', 2]),
+    ],
+    outputs = [
+        helper.make_tensor_value_info("Y", TensorProto.FLOAT, ['N', 2]),
+    ]
+)
+
+model = helper.make_model(graph_def, opset_imports=[helper.make_operatorsetid("", 7)])
+model.ir_version = 6
+onnx.checker.check_model(model)
+
+onnx.save_model(model, "mul_symbolic_batch.onnx")